@@ -0,0 +1,12 @@
+/* audiolevel.h - peak and RMS accumulation over float sample blocks */
+#ifndef AUDIOLEVEL_H
+#define AUDIOLEVEL_H
+
+#include <stddef.h>
+
+/* Raise `*peak` to the largest |sample| in `s` and add the sum of squares
+ * to `*sum_sq`. Uses AVX2 or SSE when the CPU has them, plain C otherwise;
+ * all paths give the same peak and sums equal to float rounding. */
+void audio_level_accumulate(const float *s, size_t n, float *peak, double *sum_sq);
+
+#endif /* AUDIOLEVEL_H */
@@ -12,6 +12,9 @@
 #include <time.h>
 #include <stdarg.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <glib/gstdio.h>
 
 /* global flag: if true, commands are dry-run only */
 gboolean g_dry_run = FALSE;
@@ -267,6 +270,273 @@ void open_config_dir(const char *subdir, GtkLabel *status)
     g_free(cmd);
 }
 
+/* Config file saving */
+void file_stamp_take(const char *path, FileStamp *stamp)
+{
+    struct stat st;
+    memset(stamp, 0, sizeof(*stamp));
+    if (stat(path, &st) != 0) return;
+    stamp->exists = TRUE;
+    stamp->dev = (guint64)st.st_dev;
+    stamp->ino = (guint64)st.st_ino;
+    stamp->mtime_ns = (gint64)st.st_mtim.tv_sec * G_GINT64_CONSTANT(1000000000) + st.st_mtim.tv_nsec;
+    stamp->size = (gint64)st.st_size;
+}
+
+gboolean file_stamp_equal(const FileStamp *a, const FileStamp *b)
+{
+    if (a->exists != b->exists) return FALSE;
+    if (!a->exists) return TRUE;
+    return a->dev == b->dev && a->ino == b->ino && a->mtime_ns == b->mtime_ns && a->size == b->size;
+}
+
+static gint compare_names_desc(gconstpointer a, gconstpointer b)
+{
+    return g_strcmp0(*(const char * const *)b, *(const char * const *)a);
+}
+
+/* Write a gzip copy of `data` to the backup directory and drop the oldest
+ * backups of the same file beyond CONFIG_BACKUP_KEEP. Backups are named
+ * <basename>.<hash of the full path>.<time>.gz, so two hyprland.conf in
+ * different directories rotate separately. */
+static gboolean backup_config_contents(const char *path, const char *data, gsize len, GError **error)
+{
+    char *dir = g_build_filename(g_get_user_state_dir(), "aser-settings", "backups", NULL);
+    if (g_mkdir_with_parents(dir, 0700) != 0) {
+        g_set_error(error, G_FILE_ERROR, g_file_error_from_errno(errno), "Cannot create %s: %s", dir, g_strerror(errno));
+        g_free(dir);
+        return FALSE;
+    }
+
+    char *basename = g_path_get_basename(path);
+    char *hash = g_compute_checksum_for_string(G_CHECKSUM_SHA1, path, -1);
+    char *base = g_strdup_printf("%s.%.12s", basename, hash);
+    g_free(basename);
+    g_free(hash);
+    GDateTime *now = g_date_time_new_now_local();
+    char *stamp = g_date_time_format(now, "%Y%m%d-%H%M%S");
+    char *name = g_strdup_printf("%s.%s-%06d.gz", base, stamp, g_date_time_get_microsecond(now));
+    char *bpath = g_build_filename(dir, name, NULL);
+    g_date_time_unref(now);
+    g_free(stamp);
+    g_free(name);
+
+    GFile *file = g_file_new_for_path(bpath);
+    GFileOutputStream *fos = g_file_replace(file, NULL, FALSE, G_FILE_CREATE_PRIVATE, NULL, error);
+    gboolean ok = FALSE;
+    if (fos) {
+        GZlibCompressor *zc = g_zlib_compressor_new(G_ZLIB_COMPRESSOR_FORMAT_GZIP, -1);
+        GOutputStream *cos = g_converter_output_stream_new(G_OUTPUT_STREAM(fos), G_CONVERTER(zc));
+        ok = g_output_stream_write_all(cos, data, len, NULL, NULL, error) &&
+             g_output_stream_close(cos, NULL, error);
+        g_object_unref(cos);
+        g_object_unref(zc);
+        g_object_unref(fos);
+    }
+    g_object_unref(file);
+    g_free(bpath);
+
+    /* rotate: names sort chronologically, newest first after sorting */
+    if (ok) {
+        char *prefix = g_strconcat(base, ".", NULL);
+        GPtrArray *names = g_ptr_array_new_with_free_func(g_free);
+        GDir *gd = g_dir_open(dir, 0, NULL);
+        if (gd) {
+            const char *n;
+            while ((n = g_dir_read_name(gd)) != NULL) {
+                if (g_str_has_prefix(n, prefix) && g_str_has_suffix(n, ".gz")) g_ptr_array_add(names, g_strdup(n));
+            }
+            g_dir_close(gd);
+        }
+        g_ptr_array_sort(names, compare_names_desc);
+        for (guint i = CONFIG_BACKUP_KEEP; i < names->len; i++) {
+            char *old = g_build_filename(dir, g_ptr_array_index(names, i), NULL);
+            g_unlink(old);
+            g_free(old);
+        }
+        g_ptr_array_free(names, TRUE);
+        g_free(prefix);
+    }
+
+    g_free(base);
+    g_free(dir);
+    return ok;
+}
+
+/* Write `contents` to a fresh temp file next to `target`, fsynced, with the
+ * target's mode. Returns the temp path or NULL. */
+static char *stage_config_contents(const char *path, const char *target, const char *contents, gsize clen, GError **error)
+{
+    char *dir = g_path_get_dirname(target);
+    char *base = g_path_get_basename(target);
+    char *tmpl = g_strdup_printf("%s/.%s.XXXXXX", dir, base);
+    g_free(base);
+
+    int fd = g_mkstemp_full(tmpl, O_WRONLY | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        g_set_error(error, G_FILE_ERROR, g_file_error_from_errno(errno), "Cannot create temporary file in %s: %s", dir, g_strerror(errno));
+        g_free(tmpl);
+        g_free(dir);
+        return NULL;
+    }
+    g_free(dir);
+
+    struct stat st;
+    if (stat(target, &st) == 0) fchmod(fd, st.st_mode & 07777);
+
+    gsize written = 0;
+    int saved_errno = 0;
+    while (written < clen) {
+        ssize_t n = write(fd, contents + written, clen - written);
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0) { saved_errno = errno; break; }
+        written += (gsize)n;
+    }
+    if (!saved_errno && fsync(fd) != 0) saved_errno = errno;
+    if (close(fd) != 0 && !saved_errno) saved_errno = errno;
+
+    if (saved_errno) {
+        g_unlink(tmpl);
+        g_set_error(error, G_FILE_ERROR, g_file_error_from_errno(saved_errno), "Failed to write %s: %s", path, g_strerror(saved_errno));
+        g_free(tmpl);
+        return NULL;
+    }
+    return tmpl;
+}
+
+/* make a rename durable */
+static void sync_parent_dir(const char *target)
+{
+    char *dir = g_path_get_dirname(target);
+    int dfd = open(dir, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dfd >= 0) {
+        fsync(dfd);
+        close(dfd);
+    }
+    g_free(dir);
+}
+
+typedef struct {
+    char target[PATH_MAX];
+    char *tmp;        /* staged contents, NULL when unchanged */
+    gboolean existed;
+    gchar *old;       /* previous contents, kept to undo a swap */
+    gsize old_len;
+    gboolean swapped;
+} StagedWrite;
+
+/* Put back a file phase 3 already replaced */
+static gboolean restore_config_file(StagedWrite *s)
+{
+    if (!s->existed) return g_unlink(s->target) == 0;
+    if (!s->old) return FALSE;
+    char *tmp = stage_config_contents(s->target, s->target, s->old, s->old_len, NULL);
+    if (!tmp) return FALSE;
+    gboolean ok = rename(tmp, s->target) == 0;
+    if (!ok) g_unlink(tmp);
+    else sync_parent_dir(s->target);
+    g_free(tmp);
+    return ok;
+}
+
+ConfigSaveResult save_config_files(ConfigWrite *writes, guint n, gboolean force, GError **error)
+{
+    StagedWrite *staged = g_new0(StagedWrite, n);
+    ConfigSaveResult result = CONFIG_SAVE_UNCHANGED;
+    guint i;
+
+    /* phase 1: check every file for conflicts before anything is written */
+    for (i = 0; i < n; i++) {
+        /* write through symlinks (dotfile managers) instead of replacing them */
+        if (!realpath(writes[i].path, staged[i].target)) g_strlcpy(staged[i].target, writes[i].path, PATH_MAX);
+        FileStamp current;
+        file_stamp_take(staged[i].target, &current);
+        staged[i].existed = current.exists;
+        if (writes[i].stamp && !force && !file_stamp_equal(writes[i].stamp, &current)) {
+            g_set_error(error, G_FILE_ERROR, G_FILE_ERROR_EXIST, "%s changed on disk since it was loaded", writes[i].path);
+            result = CONFIG_SAVE_CONFLICT;
+            goto out;
+        }
+    }
+
+    /* phase 2: stage new contents in temp files, backing up what they replace */
+    for (i = 0; i < n; i++) {
+        const char *contents = writes[i].contents;
+        gsize clen = writes[i].len < 0 ? strlen(contents) : (gsize)writes[i].len;
+        gchar *old = NULL;
+        gsize old_len = 0;
+        if (g_file_get_contents(staged[i].target, &staged[i].old, &staged[i].old_len, NULL)) {
+            old = staged[i].old;
+            old_len = staged[i].old_len;
+            gboolean same = FALSE;
+            if (old_len == clen) {
+                char *h_old = g_compute_checksum_for_data(G_CHECKSUM_SHA256, (const guchar *)old, old_len);
+                char *h_new = g_compute_checksum_for_data(G_CHECKSUM_SHA256, (const guchar *)contents, clen);
+                same = g_strcmp0(h_old, h_new) == 0;
+                g_free(h_old);
+                g_free(h_new);
+            }
+            if (same) continue;
+            GError *berr = NULL;
+            if (!backup_config_contents(staged[i].target, old, old_len, &berr)) {
+                DBG("backup of %s failed: %s", writes[i].path, berr ? berr->message : "unknown");
+                g_clear_error(&berr);
+            }
+        }
+        staged[i].tmp = stage_config_contents(writes[i].path, staged[i].target, contents, clen, error);
+        if (!staged[i].tmp) {
+            result = CONFIG_SAVE_FAILED;
+            goto out;
+        }
+    }
+
+    /* phase 3: every file is staged; swap them in, undoing the earlier
+     * swaps if one fails */
+    for (i = 0; i < n; i++) {
+        if (!staged[i].tmp) continue;
+        if (rename(staged[i].tmp, staged[i].target) != 0) {
+            int e = errno;
+            GString *lost = g_string_new(NULL);
+            for (guint j = 0; j < i; j++) {
+                if (staged[j].swapped && !restore_config_file(&staged[j]))
+                    g_string_append_printf(lost, "%s%s", lost->len ? ", " : "", writes[j].path);
+            }
+            if (lost->len)
+                g_set_error(error, G_FILE_ERROR, g_file_error_from_errno(e), "Failed to replace %s: %s (could not restore %s)",
+                            writes[i].path, g_strerror(e), lost->str);
+            else
+                g_set_error(error, G_FILE_ERROR, g_file_error_from_errno(e), "Failed to replace %s: %s", writes[i].path, g_strerror(e));
+            g_string_free(lost, TRUE);
+            result = CONFIG_SAVE_FAILED;
+            goto out;
+        }
+        g_free(staged[i].tmp);
+        staged[i].tmp = NULL;
+        staged[i].swapped = TRUE;
+        sync_parent_dir(staged[i].target);
+        result = CONFIG_SAVE_WRITTEN;
+    }
+
+out:
+    for (i = 0; i < n; i++) {
+        if (staged[i].tmp) {
+            g_unlink(staged[i].tmp);
+            g_free(staged[i].tmp);
+        }
+        g_free(staged[i].old);
+        if ((result == CONFIG_SAVE_WRITTEN || result == CONFIG_SAVE_UNCHANGED) && writes[i].stamp) file_stamp_take(staged[i].target, writes[i].stamp);
+    }
+    g_free(staged);
+    return result;
+}
+
+ConfigSaveResult save_config_file(const char *path, const char *contents, gssize len,
+                                  FileStamp *stamp, gboolean force, GError **error)
+{
+    ConfigWrite w = { path, contents, len, stamp };
+    return save_config_files(&w, 1, force, error);
+}
+
 /* Dialog windows */
 GtkWindow *create_modal_window(GtkWindow *parent, const char *title)
 {
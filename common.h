@@ -40,6 +40,53 @@ void launch_if_found(const char *prog, GtkLabel *status);
  * filesystem containing `path`. Caller must g_free() the returned string. */
 gchar *get_disk_usage(const char *path);
 
+/* Identity of a config file on disk, taken when it is loaded so a later
+ * save can tell whether something else modified it in the meantime. */
+typedef struct {
+    gboolean exists;
+    guint64  dev;
+    guint64  ino;
+    gint64   mtime_ns;
+    gint64   size;
+} FileStamp;
+
+void file_stamp_take(const char *path, FileStamp *stamp);
+gboolean file_stamp_equal(const FileStamp *a, const FileStamp *b);
+
+typedef enum {
+    CONFIG_SAVE_WRITTEN,    /* contents replaced atomically */
+    CONFIG_SAVE_UNCHANGED,  /* identical to the file on disk; nothing written */
+    CONFIG_SAVE_CONFLICT,   /* file changed on disk since `stamp` was taken */
+    CONFIG_SAVE_FAILED      /* see error */
+} ConfigSaveResult;
+
+/* Number of compressed backups kept per file (by full path) under
+ * $XDG_STATE_HOME/aser-settings/backups */
+#define CONFIG_BACKUP_KEEP 10
+
+/* Shared save path for config editors: skips no-op writes, refuses to
+ * overwrite a file that changed since `stamp` (unless `force`), keeps a gzip
+ * backup of the previous contents and replaces the file via temp file, fsync
+ * and rename. Symlinks are followed so dotfile links survive. On success
+ * `stamp` (may be NULL) is updated to the new on-disk identity. */
+ConfigSaveResult save_config_file(const char *path, const char *contents, gssize len,
+                                  FileStamp *stamp, gboolean force, GError **error);
+
+typedef struct {
+    const char *path;
+    const char *contents;
+    gssize      len;        /* -1 for NUL-terminated */
+    FileStamp  *stamp;      /* may be NULL */
+} ConfigWrite;
+
+/* Multi-file variant of save_config_file: all files are checked for
+ * conflicts and staged to fsynced temp files before the first rename, so a
+ * conflict or write error leaves every file untouched. If a rename itself
+ * fails, the files already replaced get their previous contents back (the
+ * error names any that could not be). Returns WRITTEN if any file was
+ * replaced. */
+ConfigSaveResult save_config_files(ConfigWrite *writes, guint n, gboolean force, GError **error);
+
 /* Dialog windows */
 GtkWindow *create_modal_window(GtkWindow *parent, const char *title);
 
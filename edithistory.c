@@ -0,0 +1,248 @@
+/* edithistory.c - bounded undo/redo log shared by the config editors
+ *
+ * The text of every recorded edit (inserted text, or the text a deletion
+ * removed) is appended once to an append-only store of fixed-size blocks, in
+ * the manner of a piece table's "add" buffer. A log entry is then just a
+ * span (block, offset, length) plus the edit position, so undo history never
+ * holds buffer snapshots. Blocks are reference counted by the spans that
+ * point into them: trimming old entries to stay within the limits frees a
+ * block once nothing refers to it anymore. */
+#include "edithistory.h"
+#include <string.h>
+
+#define HISTORY_BLOCK_SIZE   (64 * 1024)
+#define HISTORY_MAX_ENTRIES  20000
+#define HISTORY_MAX_BYTES    (8 * 1024 * 1024)
+#define HISTORY_COALESCE_US  (1500 * 1000)
+
+typedef struct {
+    gsize capacity;
+    gsize used;
+    char data[];
+} Block;
+
+typedef struct {
+    guint8 kind;
+    guint32 group;
+    gint64 pos;
+    glong chars;     /* length in characters, for coalescing */
+    Block *block;    /* ref held */
+    guint32 off;
+    guint32 len;
+} Entry;
+
+struct EditHistory {
+    GArray *entries;
+    guint applied;       /* entries[0..applied) are live, the rest is redo */
+    gsize bytes;         /* text bytes referenced by entries */
+    Block *tail;         /* block receiving appends (ref held) */
+    guint32 next_group;
+    guint32 open_group;
+    int group_depth;
+    guint group_edits;   /* edits recorded in the open group so far */
+    gint64 last_time;
+    gboolean coalesce;
+    gboolean replaying;
+    gboolean enabled;
+    EditApplyFunc apply;
+    gpointer user_data;
+};
+
+static void entry_clear(gpointer p)
+{
+    Entry *e = (Entry *)p;
+    if (e->block) g_rc_box_release(e->block);
+    e->block = NULL;
+}
+
+/* Append text to the store and return the block holding it (new ref) */
+static Block *store_append(EditHistory *h, const char *text, gsize len, guint32 *off)
+{
+    if (len > HISTORY_BLOCK_SIZE / 4) {
+        /* large pastes/deletions get a block of their own */
+        Block *b = g_rc_box_alloc(sizeof(Block) + len);
+        b->capacity = len;
+        b->used = len;
+        memcpy(b->data, text, len);
+        *off = 0;
+        return b;
+    }
+    if (!h->tail || h->tail->capacity - h->tail->used < len) {
+        if (h->tail) g_rc_box_release(h->tail);
+        h->tail = g_rc_box_alloc(sizeof(Block) + HISTORY_BLOCK_SIZE);
+        h->tail->capacity = HISTORY_BLOCK_SIZE;
+        h->tail->used = 0;
+    }
+    *off = (guint32)h->tail->used;
+    memcpy(h->tail->data + h->tail->used, text, len);
+    h->tail->used += len;
+    return g_rc_box_acquire(h->tail);
+}
+
+EditHistory *edit_history_new(EditApplyFunc apply, gpointer user_data, gboolean coalesce_typing)
+{
+    EditHistory *h = g_new0(EditHistory, 1);
+    h->entries = g_array_new(FALSE, TRUE, sizeof(Entry));
+    g_array_set_clear_func(h->entries, entry_clear);
+    h->apply = apply;
+    h->user_data = user_data;
+    h->coalesce = coalesce_typing;
+    h->enabled = TRUE;
+    h->next_group = 1;
+    return h;
+}
+
+static void drop_redo(EditHistory *h)
+{
+    for (guint i = h->applied; i < h->entries->len; i++) {
+        h->bytes -= g_array_index(h->entries, Entry, i).len;
+    }
+    if (h->applied < h->entries->len) g_array_set_size(h->entries, h->applied);
+}
+
+/* Drop whole groups from the front until within limits */
+static void trim(EditHistory *h)
+{
+    guint drop = 0;
+    gsize bytes = h->bytes;
+    guint n = h->entries->len;
+    while (drop < h->applied && (n - drop > HISTORY_MAX_ENTRIES || bytes > HISTORY_MAX_BYTES)) {
+        guint32 g = g_array_index(h->entries, Entry, drop).group;
+        while (drop < h->applied && g_array_index(h->entries, Entry, drop).group == g) {
+            bytes -= g_array_index(h->entries, Entry, drop).len;
+            drop++;
+        }
+    }
+    if (drop == 0) return;
+    g_array_remove_range(h->entries, 0, drop);
+    h->applied -= drop;
+    h->bytes = bytes;
+}
+
+static gboolean try_coalesce(EditHistory *h, EditKind kind, gint64 pos, const char *text, gsize len, glong chars, gint64 now)
+{
+    /* a group that already holds other edits (a paste over a selection, a
+     * multi-edit action) stays one step; a group around a single keystroke,
+     * as GtkTextView wraps every one, may join the typing run */
+    if (!h->coalesce || (h->group_depth > 0 && h->group_edits > 0) || h->applied == 0) return FALSE;
+    if (now - h->last_time > HISTORY_COALESCE_US || memchr(text, '\n', len)) return FALSE;
+
+    Entry *prev = &g_array_index(h->entries, Entry, h->applied - 1);
+    if (prev->kind != kind || memchr(prev->block->data + prev->off, '\n', prev->len)) return FALSE;
+
+    if (kind == EDIT_INSERT) {
+        /* typing: extend the previous span in place when it ends the store */
+        if (pos != prev->pos + prev->chars) return FALSE;
+        if (prev->block != h->tail || prev->off + prev->len != h->tail->used) return FALSE;
+        if (h->tail->capacity - h->tail->used < len) return FALSE;
+        memcpy(h->tail->data + h->tail->used, text, len);
+        h->tail->used += len;
+        prev->len += (guint32)len;
+        prev->chars += chars;
+        h->bytes += len;
+        return TRUE;
+    }
+    /* backspace (ends where the previous deletion started) or delete key */
+    if (pos + chars != prev->pos && pos != prev->pos) return FALSE;
+    guint32 off;
+    Entry e = { kind, prev->group, pos, chars, store_append(h, text, len, &off), 0, (guint32)len };
+    e.off = off;
+    g_array_append_val(h->entries, e);
+    h->applied++;
+    h->bytes += len;
+    return TRUE;
+}
+
+void edit_history_record(EditHistory *h, EditKind kind, gint64 pos, const char *text, gsize len)
+{
+    if (!h->enabled || h->replaying || len == 0) return;
+    drop_redo(h);
+
+    gint64 now = g_get_monotonic_time();
+    glong chars = g_utf8_strlen(text, (gssize)len);
+    if (try_coalesce(h, kind, pos, text, len, chars, now)) {
+        /* the rest of the open group belongs to the step it joined */
+        if (h->group_depth > 0) h->open_group = g_array_index(h->entries, Entry, h->applied - 1).group;
+    } else {
+        guint32 off;
+        Entry e = { kind, 0, pos, chars, store_append(h, text, len, &off), 0, (guint32)len };
+        e.off = off;
+        e.group = h->group_depth > 0 ? h->open_group : h->next_group++;
+        g_array_append_val(h->entries, e);
+        h->applied++;
+        h->bytes += len;
+    }
+    if (h->group_depth > 0) h->group_edits++;
+    h->last_time = now;
+    trim(h);
+}
+
+void edit_history_begin_group(EditHistory *h)
+{
+    if (h->group_depth++ == 0) {
+        h->open_group = h->next_group++;
+        h->group_edits = 0;
+    }
+}
+
+void edit_history_end_group(EditHistory *h)
+{
+    if (h->group_depth > 0) h->group_depth--;
+}
+
+void edit_history_set_enabled(EditHistory *h, gboolean enabled)
+{
+    h->enabled = enabled;
+}
+
+void edit_history_clear(EditHistory *h)
+{
+    g_array_set_size(h->entries, 0);
+    h->applied = 0;
+    h->bytes = 0;
+    if (h->tail) g_rc_box_release(h->tail);
+    h->tail = NULL;
+}
+
+gboolean edit_history_can_undo(EditHistory *h)
+{
+    return h->applied > 0;
+}
+
+gboolean edit_history_can_redo(EditHistory *h)
+{
+    return h->applied < h->entries->len;
+}
+
+gboolean edit_history_undo(EditHistory *h)
+{
+    if (h->applied == 0) return FALSE;
+    guint32 g = g_array_index(h->entries, Entry, h->applied - 1).group;
+    h->replaying = TRUE;
+    while (h->applied > 0) {
+        Entry *e = &g_array_index(h->entries, Entry, h->applied - 1);
+        if (e->group != g) break;
+        h->apply(e->kind == EDIT_INSERT ? EDIT_DELETE : EDIT_INSERT, e->pos,
+                 e->block->data + e->off, e->len, h->user_data);
+        h->applied--;
+    }
+    h->replaying = FALSE;
+    h->last_time = 0; /* never coalesce across an undo */
+    return TRUE;
+}
+
+gboolean edit_history_redo(EditHistory *h)
+{
+    if (h->applied >= h->entries->len) return FALSE;
+    guint32 g = g_array_index(h->entries, Entry, h->applied).group;
+    h->replaying = TRUE;
+    while (h->applied < h->entries->len) {
+        Entry *e = &g_array_index(h->entries, Entry, h->applied);
+        if (e->group != g) break;
+        h->apply((EditKind)e->kind, e->pos, e->block->data + e->off, e->len, h->user_data);
+        h->applied++;
+    }
+    h->replaying = FALSE;
+    h->last_time = 0;
+    return TRUE;
+}
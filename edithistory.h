@@ -0,0 +1,41 @@
+/* edithistory.h - bounded undo/redo log shared by the config editors */
+#ifndef EDITHISTORY_H
+#define EDITHISTORY_H
+
+#include <glib.h>
+
+typedef struct EditHistory EditHistory;
+
+typedef enum {
+    EDIT_INSERT,
+    EDIT_DELETE
+} EditKind;
+
+/* Replays one edit on the owning editor. `pos` is in the editor's own units
+ * (character offset for text buffers, row index for the binds list). */
+typedef void (*EditApplyFunc)(EditKind kind, gint64 pos, const char *text, gsize len, gpointer user_data);
+
+/* `coalesce_typing`: merge runs of adjacent single-line inserts/deletes into
+ * one undo step, as text editors do for typing and backspacing. */
+EditHistory *edit_history_new(EditApplyFunc apply, gpointer user_data, gboolean coalesce_typing);
+
+/* Record an edit that has just been (or is about to be) applied by the
+ * editor. Ignored while the history itself is replaying or is disabled. */
+void edit_history_record(EditHistory *h, EditKind kind, gint64 pos, const char *text, gsize len);
+
+/* Edits recorded between begin/end (nestable) form a single undo step. With
+ * `coalesce_typing`, a group whose first edit extends the typing run joins
+ * that run's step, since text views wrap every keystroke in a group. */
+void edit_history_begin_group(EditHistory *h);
+void edit_history_end_group(EditHistory *h);
+
+/* Stop recording (e.g. while bulk-loading a file) */
+void edit_history_set_enabled(EditHistory *h, gboolean enabled);
+void edit_history_clear(EditHistory *h);
+
+gboolean edit_history_undo(EditHistory *h);
+gboolean edit_history_redo(EditHistory *h);
+gboolean edit_history_can_undo(EditHistory *h);
+gboolean edit_history_can_redo(EditHistory *h);
+
+#endif /* EDITHISTORY_H */
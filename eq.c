@@ -0,0 +1,245 @@
+/* eq.c - parametric equalizer as a PipeWire filter-chain sink */
+#include "eq.h"
+#include "common.h"
+#include <gio/gio.h>
+#include <glib/gstdio.h>
+#include <string.h>
+#include <errno.h>
+#include <math.h>
+
+/* Sink and filter names in the generated graph */
+#define EQ_SINK_NAME "effect_input.aser_eq"
+#define EQ_OUTPUT_NAME "effect_output.aser_eq"
+
+static const struct {
+    const char *label;
+    const char *key;      /* record in the drop-in, and bq_<key> builtin */
+} band_types[EQ_N_TYPES] = {
+    [EQ_PEAKING]    = { "Peaking",    "peaking" },
+    [EQ_LOW_SHELF]  = { "Low shelf",  "lowshelf" },
+    [EQ_HIGH_SHELF] = { "High shelf", "highshelf" },
+    [EQ_LOW_PASS]   = { "Low pass",   "lowpass" },
+    [EQ_HIGH_PASS]  = { "High pass",  "highpass" },
+};
+
+const char *eq_band_type_label(EqBandType t)
+{
+    return t < EQ_N_TYPES ? band_types[t].label : "";
+}
+
+void eq_band_coeffs(const EqBand *b, double rate, double c[5])
+{
+    double A = pow(10.0, b->gain / 40.0);
+    double w0 = 2.0 * G_PI * CLAMP(b->freq, 1.0, rate * 0.499) / rate;
+    double cw = cos(w0);
+    double alpha = sin(w0) / (2.0 * MAX(b->q, 0.01));
+    double sa = 2.0 * sqrt(A) * alpha;
+    double b0, b1, b2, a0, a1, a2;
+
+    switch (b->type) {
+    case EQ_LOW_SHELF:
+        b0 = A * ((A + 1) - (A - 1) * cw + sa);
+        b1 = 2 * A * ((A - 1) - (A + 1) * cw);
+        b2 = A * ((A + 1) - (A - 1) * cw - sa);
+        a0 = (A + 1) + (A - 1) * cw + sa;
+        a1 = -2 * ((A - 1) + (A + 1) * cw);
+        a2 = (A + 1) + (A - 1) * cw - sa;
+        break;
+    case EQ_HIGH_SHELF:
+        b0 = A * ((A + 1) + (A - 1) * cw + sa);
+        b1 = -2 * A * ((A - 1) + (A + 1) * cw);
+        b2 = A * ((A + 1) + (A - 1) * cw - sa);
+        a0 = (A + 1) - (A - 1) * cw + sa;
+        a1 = 2 * ((A - 1) - (A + 1) * cw);
+        a2 = (A + 1) - (A - 1) * cw - sa;
+        break;
+    case EQ_LOW_PASS:
+        b0 = b2 = (1 - cw) / 2;
+        b1 = 1 - cw;
+        a0 = 1 + alpha;
+        a1 = -2 * cw;
+        a2 = 1 - alpha;
+        break;
+    case EQ_HIGH_PASS:
+        b0 = b2 = (1 + cw) / 2;
+        b1 = -(1 + cw);
+        a0 = 1 + alpha;
+        a1 = -2 * cw;
+        a2 = 1 - alpha;
+        break;
+    case EQ_PEAKING:
+    default:
+        b0 = 1 + alpha * A;
+        b1 = -2 * cw;
+        b2 = 1 - alpha * A;
+        a0 = 1 + alpha / A;
+        a1 = -2 * cw;
+        a2 = 1 - alpha / A;
+        break;
+    }
+    c[0] = b0 / a0;
+    c[1] = b1 / a0;
+    c[2] = b2 / a0;
+    c[3] = a1 / a0;
+    c[4] = a2 / a0;
+}
+
+double eq_response_db(const EqBand *bands, guint n, double rate, double freq)
+{
+    double w = 2.0 * G_PI * freq / rate;
+    double c1 = cos(w), s1 = sin(w), c2 = cos(2 * w), s2 = sin(2 * w);
+    double db = 0;
+
+    /* |H(e^jw)| per section; the cascade multiplies, so dB add */
+    for (guint i = 0; i < n; i++) {
+        double c[5];
+        eq_band_coeffs(&bands[i], rate, c);
+        double nr = c[0] + c[1] * c1 + c[2] * c2, ni = -(c[1] * s1 + c[2] * s2);
+        double dr = 1 + c[3] * c1 + c[4] * c2, di = -(c[3] * s1 + c[4] * s2);
+        double mag2 = (nr * nr + ni * ni) / MAX(dr * dr + di * di, 1e-30);
+        db += 10.0 * log10(MAX(mag2, 1e-30));
+    }
+    return db;
+}
+
+char *eq_config_path(void)
+{
+    return g_build_filename(g_get_user_config_dir(), "pipewire", "pipewire.conf.d", "91-aser-eq.conf", NULL);
+}
+
+static const EqBand default_bands[] = {
+    { EQ_LOW_SHELF,  80,    0, 0.7 },
+    { EQ_PEAKING,    250,   0, 1.0 },
+    { EQ_PEAKING,    1000,  0, 1.0 },
+    { EQ_PEAKING,    4000,  0, 1.0 },
+    { EQ_HIGH_SHELF, 10000, 0, 0.7 },
+};
+
+/* The drop-in starts with one comment per band:
+ *   # band peaking 1000.00 3.00 1.00
+ * followed by "# enabled yes|no" */
+GArray *eq_load(gboolean *enabled)
+{
+    GArray *bands = g_array_new(FALSE, FALSE, sizeof(EqBand));
+    char *path = eq_config_path();
+    char *contents = NULL;
+    gboolean on = FALSE, found = FALSE;
+
+    if (g_file_get_contents(path, &contents, NULL, NULL)) {
+        char **lines = g_strsplit(contents, "\n", -1);
+        for (char **l = lines; *l; l++) {
+            if (g_str_has_prefix(*l, "# enabled ")) {
+                on = g_str_has_prefix(*l + 10, "yes");
+                found = TRUE;
+                continue;
+            }
+            if (!g_str_has_prefix(*l, "# band ") || bands->len >= EQ_MAX_BANDS) continue;
+            char **f = g_strsplit(*l + 7, " ", -1);
+            if (g_strv_length(f) == 4) {
+                for (int t = 0; t < EQ_N_TYPES; t++) {
+                    if (strcmp(f[0], band_types[t].key) != 0) continue;
+                    EqBand b = { t, g_ascii_strtod(f[1], NULL), g_ascii_strtod(f[2], NULL), g_ascii_strtod(f[3], NULL) };
+                    g_array_append_val(bands, b);
+                }
+            }
+            g_strfreev(f);
+        }
+        g_strfreev(lines);
+        g_free(contents);
+    }
+    g_free(path);
+
+    if (!found) g_array_append_vals(bands, default_bands, G_N_ELEMENTS(default_bands));
+    if (enabled) *enabled = on;
+    return bands;
+}
+
+/* Numbers in the config must not follow the locale's decimal separator */
+static const char *num(char buf[G_ASCII_DTOSTR_BUF_SIZE], double v)
+{
+    return g_ascii_formatd(buf, G_ASCII_DTOSTR_BUF_SIZE, "%.2f", v);
+}
+
+gboolean eq_save(const EqBand *bands, guint n, gboolean enabled, GError **error)
+{
+    char *path = eq_config_path();
+    char *dir = g_path_get_dirname(path);
+    char f[G_ASCII_DTOSTR_BUF_SIZE], g[G_ASCII_DTOSTR_BUF_SIZE], q[G_ASCII_DTOSTR_BUF_SIZE];
+
+    if (g_mkdir_with_parents(dir, 0700) != 0) {
+        g_set_error(error, G_FILE_ERROR, g_file_error_from_errno(errno), "Cannot create %s: %s", dir, g_strerror(errno));
+        g_free(dir);
+        g_free(path);
+        return FALSE;
+    }
+    g_free(dir);
+
+    GString *conf = g_string_new("# Written by aser-settings (Audio > Equalizer)\n");
+    for (guint i = 0; i < n; i++) {
+        g_string_append_printf(conf, "# band %s %s %s %s\n", band_types[bands[i].type].key,
+                               num(f, bands[i].freq), num(g, bands[i].gain), num(q, bands[i].q));
+    }
+    g_string_append_printf(conf, "# enabled %s\n", enabled ? "yes" : "no");
+
+    if (enabled && n > 0) {
+        g_string_append(conf,
+            "context.modules = [\n"
+            "    { name = libpipewire-module-filter-chain\n"
+            "        args = {\n"
+            "            node.description = \"Equalizer\"\n"
+            "            media.name = \"Equalizer\"\n"
+            "            filter.graph = {\n"
+            "                nodes = [\n");
+        for (guint i = 0; i < n; i++) {
+            g_string_append_printf(conf,
+                "                    { type = builtin name = eq_band_%u label = bq_%s\n"
+                "                      control = { \"Freq\" = %s \"Q\" = %s \"Gain\" = %s } }\n",
+                i + 1, band_types[bands[i].type].key, num(f, bands[i].freq), num(q, bands[i].q), num(g, bands[i].gain));
+        }
+        g_string_append(conf, "                ]\n"
+                              "                links = [\n");
+        for (guint i = 1; i < n; i++) {
+            g_string_append_printf(conf, "                    { output = \"eq_band_%u:Out\" input = \"eq_band_%u:In\" }\n", i, i + 1);
+        }
+        g_string_append(conf,
+            "                ]\n"
+            "            }\n"
+            "            audio.channels = 2\n"
+            "            audio.position = [ FL FR ]\n"
+            "            capture.props = {\n"
+            "                node.name = \"" EQ_SINK_NAME "\"\n"
+            "                media.class = Audio/Sink\n"
+            "            }\n"
+            "            playback.props = {\n"
+            "                node.name = \"" EQ_OUTPUT_NAME "\"\n"
+            "                node.passive = true\n"
+            "            }\n"
+            "        }\n"
+            "    }\n"
+            "]\n");
+    }
+
+    gboolean ok = save_config_file(path, conf->str, (gssize)conf->len, NULL, TRUE, error) != CONFIG_SAVE_FAILED;
+    g_string_free(conf, TRUE);
+    g_free(path);
+    return ok;
+}
+
+gboolean eq_set_live(const EqBand *bands, guint n, GError **error)
+{
+    char f[G_ASCII_DTOSTR_BUF_SIZE], g[G_ASCII_DTOSTR_BUF_SIZE], q[G_ASCII_DTOSTR_BUF_SIZE];
+    GString *params = g_string_new("{ params = [");
+    for (guint i = 0; i < n; i++) {
+        g_string_append_printf(params, " \"eq_band_%u:Freq\" %s \"eq_band_%u:Q\" %s \"eq_band_%u:Gain\" %s",
+                               i + 1, num(f, bands[i].freq), i + 1, num(q, bands[i].q), i + 1, num(g, bands[i].gain));
+    }
+    g_string_append(params, " ] }");
+
+    /* not waited on; callers debounce edits, so these do not pile up */
+    const char *argv[] = { "pw-cli", "set-param", EQ_SINK_NAME, "Props", params->str, NULL };
+    GSubprocess *p = g_subprocess_newv(argv, G_SUBPROCESS_FLAGS_STDOUT_SILENCE | G_SUBPROCESS_FLAGS_STDERR_SILENCE, error);
+    g_string_free(params, TRUE);
+    if (!p) return FALSE;
+    g_object_unref(p);
+    return TRUE;
+}
@@ -0,0 +1,49 @@
+/* eq.h - parametric equalizer as a PipeWire filter-chain sink */
+#ifndef EQ_H
+#define EQ_H
+
+#include <glib.h>
+
+#define EQ_MAX_BANDS 10
+
+/* Biquad shapes, as the filter-chain builtins bq_peaking, bq_lowshelf, ... */
+typedef enum {
+    EQ_PEAKING,
+    EQ_LOW_SHELF,
+    EQ_HIGH_SHELF,
+    EQ_LOW_PASS,
+    EQ_HIGH_PASS,
+    EQ_N_TYPES
+} EqBandType;
+
+typedef struct {
+    EqBandType type;
+    double freq;   /* Hz */
+    double gain;   /* dB; unused by the pass filters */
+    double q;
+} EqBand;
+
+/* "Peaking", "Low shelf", ... */
+const char *eq_band_type_label(EqBandType t);
+
+/* Normalized coefficients { b0, b1, b2, a1, a2 } (a0 = 1), the same
+ * cookbook formulas the filter-chain builtins use */
+void eq_band_coeffs(const EqBand *b, double rate, double c[5]);
+/* Gain of the whole cascade at `freq`, in dB */
+double eq_response_db(const EqBand *bands, guint n, double rate, double freq);
+
+/* The drop-in the equalizer lives in:
+ * $XDG_CONFIG_HOME/pipewire/pipewire.conf.d/91-aser-eq.conf
+ * It also records the bands, so it is the only state there is. */
+char *eq_config_path(void);
+
+/* Bands from the drop-in, or a flat five-band default; GArray of EqBand */
+GArray *eq_load(gboolean *enabled);
+/* Rewrite the drop-in. The sink ("Equalizer") is declared only when
+ * `enabled` and there are bands; PipeWire picks it up on restart. */
+gboolean eq_save(const EqBand *bands, guint n, gboolean enabled, GError **error);
+/* Push frequencies, gains and Qs to the running sink without a restart.
+ * Only valid while its bands and their types match what PipeWire loaded. */
+gboolean eq_set_live(const EqBand *bands, guint n, GError **error);
+
+#endif /* EQ_H */
@@ -1,7 +1,17 @@
 /* hypr.c - Hyprland configuration editor and large message dialog */
 #include "hypr.h"
+#include "common.h"
+#include "hyprcheck.h"
+#include "hyprlint.h"
+#include "hyprwatch.h"
+#include "edithistory.h"
+#include "hyprsearch.h"
+#include "hyprinput.h"
+#include "hyprlog.h"
 #include <glib.h>
 #include <glib/gstdio.h>
+#include <pango/pangocairo.h>
+#include <string.h>
 
 /* Show a large modal error/info dialog with the provided text. Caller may
  * pass NULL for title to use a default. This is used for save errors or
@@ -42,31 +52,549 @@ void show_big_message_dialog(const char *title, const char *text)
     gtk_window_present(GTK_WINDOW(dlg));
 }
 
-/* Data for hyprland save callback */
+/* Large-file handling for the editor. The file is read on a worker thread and
+ * handed to the main loop in chunks; each idle dispatch inserts at most one
+ * chunk so the frame clock keeps running while a multi-MB config streams in.
+ * Wrapping re-lays out every paragraph on each width change, so it is only
+ * offered for files below HYPR_WRAP_MAX_BYTES. */
+#define HYPR_LOAD_CHUNK_BYTES (64 * 1024)
+#define HYPR_WRAP_MAX_BYTES   (512 * 1024)
+#define HYPR_LINT_MAX_ROWS    500
+
+/* Per-page state for the Hyprland editor */
 typedef struct {
     GtkTextView *tv;
+    GtkTextBuffer *buf;
+    GtkWidget *gutter;      /* line-number drawing area in the left text window */
+    GtkWidget *wrap_btn;
+    GtkWidget *save_btn;
+    GtkWidget *undo_btn;
+    GtkWidget *redo_btn;
+    EditHistory *history;   /* survives saves and on-disk merges */
+    HyprChecker *checker;
+    HyprWatch *watch;
+    GtkWidget *lint_expander;
+    GtkWidget *lint_list;
+    GCancellable *lint_cancel; /* the lint whose result is wanted */
     char *path;
     GtkLabel *status;
-} HyprlandSaveData;
+    FileStamp stamp;        /* on-disk identity when loaded/saved */
+    gboolean force_save;    /* set after a conflict: next Save overwrites */
+
+    /* progressive load state */
+    GAsyncQueue *load_queue; /* GBytes chunks; an empty GBytes marks the end */
+    gsize load_total;       /* file size from `stamp`, for the progress */
+    gsize load_done;        /* bytes inserted so far */
+    gboolean loading;
+    int gutter_digits;
+} HyprlandPageData;
+
+typedef struct {
+    char *path;
+    GAsyncQueue *queue;
+    HyprlandPageData *page;     /* only passed back to the main thread */
+} HyprLoadJob;
+
+static gboolean hypr_load_step(gpointer user_data);
+
+/* Hand one chunk to the main thread; each push schedules exactly one
+ * low-priority step, so the main loop sleeps while the worker waits on I/O */
+static void hypr_load_push(HyprLoadJob *job, GBytes *chunk)
+{
+    g_async_queue_push(job->queue, chunk);
+    g_main_context_invoke_full(NULL, G_PRIORITY_DEFAULT_IDLE, hypr_load_step, job->page, NULL);
+}
+
+/* Worker: read the file in fixed-size chunks, cut each chunk on a line (or at
+ * least a UTF-8 character) boundary and validate it so the main thread can
+ * insert it as-is. */
+static gpointer hypr_load_thread(gpointer user_data)
+{
+    HyprLoadJob *job = (HyprLoadJob *)user_data;
+    GFile *file = g_file_new_for_path(job->path);
+    GFileInputStream *in = g_file_read(file, NULL, NULL);
+    GByteArray *pending = g_byte_array_new();
+
+    if (in) {
+        guint8 *rbuf = g_malloc(HYPR_LOAD_CHUNK_BYTES);
+        for (;;) {
+            gssize n = g_input_stream_read(G_INPUT_STREAM(in), rbuf, HYPR_LOAD_CHUNK_BYTES, NULL, NULL);
+            if (n > 0) g_byte_array_append(pending, rbuf, (guint)n);
+            gboolean eof = n <= 0;
+            if (pending->len == 0) {
+                if (eof) break;
+                continue;
+            }
+            if (!eof && pending->len < HYPR_LOAD_CHUNK_BYTES) continue;
+
+            /* prefer to cut after the last newline; fall back to the last
+             * complete UTF-8 character for very long lines */
+            gsize cut = pending->len;
+            if (!eof) {
+                gsize nl = pending->len;
+                while (nl > 0 && pending->data[nl - 1] != '\n') nl--;
+                if (nl > 0) {
+                    cut = nl;
+                } else {
+                    const gchar *end = NULL;
+                    g_utf8_validate((const gchar *)pending->data, pending->len, &end);
+                    cut = (gsize)(end - (const gchar *)pending->data);
+                    if (cut == 0) cut = pending->len;
+                }
+            }
+
+            gchar *valid = g_utf8_make_valid((const gchar *)pending->data, (gssize)cut);
+            hypr_load_push(job, g_bytes_new_take(valid, strlen(valid)));
+            g_byte_array_remove_range(pending, 0, (guint)cut);
+            if (eof && pending->len == 0) break;
+        }
+        g_free(rbuf);
+        g_object_unref(in);
+    }
+
+    /* end-of-stream marker */
+    hypr_load_push(job, g_bytes_new(NULL, 0));
+
+    g_byte_array_free(pending, TRUE);
+    g_object_unref(file);
+    g_async_queue_unref(job->queue);
+    g_free(job->path);
+    g_free(job);
+    return NULL;
+}
+
+static void update_gutter_width(HyprlandPageData *d)
+{
+    int lines = gtk_text_buffer_get_line_count(d->buf);
+    int digits = 1;
+    while (lines >= 10) { lines /= 10; digits++; }
+    if (digits < 3) digits = 3;
+    if (digits == d->gutter_digits) return;
+    d->gutter_digits = digits;
+
+    char sample[16];
+    memset(sample, '0', (size_t)digits);
+    sample[digits] = '\0';
+    PangoLayout *layout = gtk_widget_create_pango_layout(d->gutter, sample);
+    int w = 0;
+    pango_layout_get_pixel_size(layout, &w, NULL);
+    g_object_unref(layout);
+    gtk_widget_set_size_request(d->gutter, w + 12, -1);
+}
+
+/* Draw line numbers for the visible lines only; cost is O(visible rows)
+ * regardless of buffer size. */
+static void draw_line_numbers(GtkDrawingArea *area, cairo_t *cr, int width, int height, gpointer user_data)
+{
+    HyprlandPageData *d = (HyprlandPageData *)user_data;
+    GdkRectangle visible;
+    gtk_text_view_get_visible_rect(d->tv, &visible);
+
+    GdkRGBA fg;
+    gtk_widget_get_color(GTK_WIDGET(area), &fg);
+    fg.alpha *= 0.55f;
+    gdk_cairo_set_source_rgba(cr, &fg);
+
+    GtkTextIter iter;
+    int line_top = 0;
+    gtk_text_view_get_line_at_y(d->tv, &iter, visible.y, &line_top);
+
+    PangoLayout *layout = gtk_widget_create_pango_layout(GTK_WIDGET(area), NULL);
+    char num[16];
+    for (;;) {
+        int y = 0, h = 0;
+        gtk_text_view_get_line_yrange(d->tv, &iter, &y, &h);
+        if (y > visible.y + visible.height) break;
+
+        int wx = 0, wy = 0;
+        gtk_text_view_buffer_to_window_coords(d->tv, GTK_TEXT_WINDOW_LEFT, 0, y, &wx, &wy);
+        g_snprintf(num, sizeof(num), "%d", gtk_text_iter_get_line(&iter) + 1);
+        pango_layout_set_text(layout, num, -1);
+        int tw = 0;
+        pango_layout_get_pixel_size(layout, &tw, NULL);
+        cairo_move_to(cr, width - tw - 6, wy);
+        pango_cairo_show_layout(cr, layout);
+
+        if (!gtk_text_iter_forward_line(&iter)) break;
+    }
+    g_object_unref(layout);
+}
+
+static void on_editor_scrolled(GtkAdjustment *adj, gpointer user_data)
+{
+    HyprlandPageData *d = (HyprlandPageData *)user_data;
+    gtk_widget_queue_draw(d->gutter);
+}
+
+static void update_undo_buttons(HyprlandPageData *d)
+{
+    gtk_widget_set_sensitive(d->undo_btn, !d->loading && edit_history_can_undo(d->history));
+    gtk_widget_set_sensitive(d->redo_btn, !d->loading && edit_history_can_redo(d->history));
+}
+
+static void on_editor_buffer_changed(GtkTextBuffer *buf, gpointer user_data)
+{
+    HyprlandPageData *d = (HyprlandPageData *)user_data;
+    update_gutter_width(d);
+    gtk_widget_queue_draw(d->gutter);
+    update_undo_buttons(d);
+}
+
+/* Edit history: GTK's own undo stack is disabled in favour of EditHistory,
+ * which is bounded and keeps its entries across saves and reloads. Both
+ * handlers run before the buffer's default handler, so offsets and the
+ * deleted text still describe the pre-edit buffer. */
+static void on_editor_insert_text(GtkTextBuffer *buf, GtkTextIter *location, const char *text, int len, gpointer user_data)
+{
+    HyprlandPageData *d = (HyprlandPageData *)user_data;
+    edit_history_record(d->history, EDIT_INSERT, gtk_text_iter_get_offset(location), text, (gsize)len);
+}
+
+static void on_editor_delete_range(GtkTextBuffer *buf, GtkTextIter *start, GtkTextIter *end, gpointer user_data)
+{
+    HyprlandPageData *d = (HyprlandPageData *)user_data;
+    char *text = gtk_text_buffer_get_slice(buf, start, end, TRUE);
+    edit_history_record(d->history, EDIT_DELETE, gtk_text_iter_get_offset(start), text, strlen(text));
+    g_free(text);
+}
+
+static void on_editor_begin_user_action(GtkTextBuffer *buf, gpointer user_data)
+{
+    edit_history_begin_group(((HyprlandPageData *)user_data)->history);
+}
+
+static void on_editor_end_user_action(GtkTextBuffer *buf, gpointer user_data)
+{
+    edit_history_end_group(((HyprlandPageData *)user_data)->history);
+}
+
+static void hypr_history_apply(EditKind kind, gint64 pos, const char *text, gsize len, gpointer user_data)
+{
+    HyprlandPageData *d = (HyprlandPageData *)user_data;
+    GtkTextIter a;
+    gtk_text_buffer_get_iter_at_offset(d->buf, &a, (int)pos);
+    if (kind == EDIT_INSERT) {
+        gtk_text_buffer_insert(d->buf, &a, text, (int)len);
+    } else {
+        GtkTextIter b = a;
+        gtk_text_iter_forward_chars(&b, (int)g_utf8_strlen(text, (gssize)len));
+        gtk_text_buffer_delete(d->buf, &a, &b);
+    }
+    gtk_text_buffer_place_cursor(d->buf, &a);
+}
+
+static void hypr_editor_undo(HyprlandPageData *d, gboolean redo)
+{
+    if (d->loading) return;
+    gboolean done = redo ? edit_history_redo(d->history) : edit_history_undo(d->history);
+    if (!done) return;
+    gtk_text_view_scroll_mark_onscreen(d->tv, gtk_text_buffer_get_insert(d->buf));
+    update_undo_buttons(d);
+}
+
+static void on_undo_clicked(GtkButton *btn, gpointer user_data)
+{
+    hypr_editor_undo((HyprlandPageData *)user_data, FALSE);
+}
+
+static void on_redo_clicked(GtkButton *btn, gpointer user_data)
+{
+    hypr_editor_undo((HyprlandPageData *)user_data, TRUE);
+}
+
+static gboolean on_undo_shortcut(GtkWidget *widget, GVariant *args, gpointer user_data)
+{
+    hypr_editor_undo((HyprlandPageData *)user_data, g_variant_get_boolean(args));
+    return TRUE;
+}
+
+static void on_wrap_toggled(GtkCheckButton *btn, gpointer user_data)
+{
+    HyprlandPageData *d = (HyprlandPageData *)user_data;
+    gboolean wrap = gtk_check_button_get_active(btn);
+    gtk_text_view_set_wrap_mode(d->tv, wrap ? GTK_WRAP_WORD_CHAR : GTK_WRAP_NONE);
+    gtk_widget_queue_draw(d->gutter);
+}
+
+static void hypr_editor_goto_line(HyprlandPageData *d, int line)
+{
+    GtkTextIter it;
+    gtk_text_buffer_get_iter_at_line(d->buf, &it, line);
+    gtk_text_buffer_place_cursor(d->buf, &it);
+    gtk_text_view_scroll_to_mark(d->tv, gtk_text_buffer_get_insert(d->buf), 0.1, TRUE, 0.0, 0.3);
+    gtk_widget_grab_focus(GTK_WIDGET(d->tv));
+}
+
+static void on_lint_row_activated(GtkListBox *box, GtkListBoxRow *row, gpointer user_data)
+{
+    HyprlandPageData *d = (HyprlandPageData *)user_data;
+    int line = GPOINTER_TO_INT(g_object_get_data(G_OBJECT(row), "hypr-line")) - 1;
+    if (line >= 0) hypr_editor_goto_line(d, line);
+}
+
+static void on_lint_done(GObject *source, GAsyncResult *res, gpointer user_data)
+{
+    HyprlandPageData *d = (HyprlandPageData *)user_data;
+    GError *err = NULL;
+    GPtrArray *items = hypr_lint_finish(res, &err);
+
+    /* superseded by a newer lint */
+    if (g_error_matches(err, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+        g_error_free(err);
+        return;
+    }
+
+    GtkWidget *child;
+    while ((child = gtk_widget_get_first_child(d->lint_list)) != NULL) {
+        gtk_list_box_remove(GTK_LIST_BOX(d->lint_list), child);
+    }
+
+    if (!items) {
+        char *title = g_strdup_printf("Lint report (unavailable: %s)", err ? err->message : "unknown error");
+        gtk_expander_set_label(GTK_EXPANDER(d->lint_expander), title);
+        g_free(title);
+        g_clear_error(&err);
+        return;
+    }
+
+    for (guint i = 0; i < items->len && i < HYPR_LINT_MAX_ROWS; i++) {
+        HyprLintItem *it = g_ptr_array_index(items, i);
+        char *text = g_strdup_printf("Line %d: %s: %s", it->line + 1, it->error ? "error" : "warning", it->message);
+        GtkWidget *lab = gtk_label_new(text);
+        gtk_widget_set_halign(lab, GTK_ALIGN_START);
+        gtk_label_set_selectable(GTK_LABEL(lab), FALSE);
+        gtk_list_box_append(GTK_LIST_BOX(d->lint_list), lab);
+        g_object_set_data(G_OBJECT(gtk_widget_get_parent(lab)), "hypr-line", GINT_TO_POINTER(it->line + 1));
+        g_free(text);
+    }
+
+    char *title;
+    if (items->len == 0) title = g_strdup("Lint report (all options valid)");
+    else if (items->len > HYPR_LINT_MAX_ROWS) title = g_strdup_printf("Lint report (%u issues, first %d shown)", items->len, HYPR_LINT_MAX_ROWS);
+    else title = g_strdup_printf("Lint report (%u issues)", items->len);
+    gtk_expander_set_label(GTK_EXPANDER(d->lint_expander), title);
+    if (items->len > 0) gtk_expander_set_expanded(GTK_EXPANDER(d->lint_expander), TRUE);
+    g_free(title);
+    g_ptr_array_unref(items);
+}
+
+static void hypr_start_lint(HyprlandPageData *d)
+{
+    GtkTextIter start, end;
+    gtk_text_buffer_get_bounds(d->buf, &start, &end);
+    char *txt = gtk_text_buffer_get_text(d->buf, &start, &end, FALSE);
+    gtk_expander_set_label(GTK_EXPANDER(d->lint_expander), "Lint report (checking…)");
+    /* only the latest text's report may reach the list */
+    if (d->lint_cancel) {
+        g_cancellable_cancel(d->lint_cancel);
+        g_object_unref(d->lint_cancel);
+    }
+    d->lint_cancel = g_cancellable_new();
+    hypr_lint_async(txt, d->lint_cancel, on_lint_done, d);
+    g_free(txt);
+}
+
+static void on_lint_clicked(GtkButton *btn, gpointer user_data)
+{
+    HyprlandPageData *d = (HyprlandPageData *)user_data;
+    if (!d->loading) hypr_start_lint(d);
+}
+
+static void on_log_clicked(GtkButton *btn, gpointer user_data)
+{
+    HyprlandPageData *d = (HyprlandPageData *)user_data;
+    show_hypr_log_window(d->status);
+}
+
+/* Low-priority step, one per pushed chunk: insert it so redraws interleave */
+static gboolean hypr_load_step(gpointer user_data)
+{
+    HyprlandPageData *d = (HyprlandPageData *)user_data;
+    GBytes *chunk = g_async_queue_try_pop(d->load_queue);
+    if (!chunk) return G_SOURCE_REMOVE;
+
+    gsize len = 0;
+    const char *data = g_bytes_get_data(chunk, &len);
+    if (len == 0) {
+        g_bytes_unref(chunk);
+        edit_history_clear(d->history);
+        edit_history_set_enabled(d->history, TRUE);
+        gtk_text_buffer_set_modified(d->buf, FALSE);
+        GtkTextIter start;
+        gtk_text_buffer_get_start_iter(d->buf, &start);
+        gtk_text_buffer_place_cursor(d->buf, &start);
+        gtk_text_view_set_editable(d->tv, TRUE);
+        gtk_widget_set_sensitive(d->save_btn, TRUE);
+        gtk_widget_set_sensitive(d->wrap_btn, d->load_done <= HYPR_WRAP_MAX_BYTES);
+        d->loading = FALSE;
+        update_undo_buttons(d);
+        hypr_checker_set_blocked(d->checker, FALSE);
+        hypr_start_lint(d);
+        g_async_queue_unref(d->load_queue);
+        d->load_queue = NULL;
+        set_status(d->status, "Loaded %s (%d lines)", d->path, gtk_text_buffer_get_line_count(d->buf));
+        return G_SOURCE_REMOVE;
+    }
+
+    GtkTextIter end;
+    gtk_text_buffer_get_end_iter(d->buf, &end);
+    gtk_text_buffer_insert(d->buf, &end, data, (int)len);
+    d->load_done += len;
+    g_bytes_unref(chunk);
+
+    if (d->load_total > 0) {
+        set_status(d->status, "Loading %s… %d%%", d->path,
+                   (int)MIN(100, d->load_done * 100 / d->load_total));
+    }
+    return G_SOURCE_REMOVE;
+}
+
+static void hypr_start_load(HyprlandPageData *d)
+{
+    if (d->loading) return;
+    if (!g_file_test(d->path, G_FILE_TEST_EXISTS)) {
+        /* leave empty and inform status */
+        set_status(d->status, "Could not read %s (it may not exist)", d->path);
+        return;
+    }
+
+    file_stamp_take(d->path, &d->stamp);
+    d->loading = TRUE;
+    d->load_done = 0;
+    /* taken here rather than by the worker, which must not touch `d` */
+    d->load_total = d->stamp.exists ? (gsize)d->stamp.size : 0;
+    gtk_text_view_set_editable(d->tv, FALSE);
+    gtk_widget_set_sensitive(d->save_btn, FALSE);
+    gtk_widget_set_sensitive(d->wrap_btn, FALSE);
+    hypr_checker_set_blocked(d->checker, TRUE);
+    /* loading is not an undoable user edit */
+    edit_history_set_enabled(d->history, FALSE);
+    update_undo_buttons(d);
+    gtk_text_buffer_set_text(d->buf, "", 0);
+
+    d->load_queue = g_async_queue_new_full((GDestroyNotify)g_bytes_unref);
+    HyprLoadJob *job = g_new0(HyprLoadJob, 1);
+    job->path = g_strdup(d->path);
+    job->queue = g_async_queue_ref(d->load_queue);
+    job->page = d;
+    g_thread_unref(g_thread_new("hypr-load", hypr_load_thread, job));
+}
+
+/* Replace only the region of the buffer that differs from `text`: the common
+ * prefix (cut back to a line start) and common suffix are left untouched, so
+ * tags, the cursor and the incremental checker only see the changed lines. */
+static void hypr_buffer_merge(HyprlandPageData *d, const char *text, gsize new_len)
+{
+    GtkTextIter start, end;
+    gtk_text_buffer_get_bounds(d->buf, &start, &end);
+    char *old = gtk_text_buffer_get_text(d->buf, &start, &end, TRUE);
+    gsize old_len = strlen(old);
+
+    gsize pre = 0;
+    gsize lim = MIN(old_len, new_len);
+    while (pre < lim && old[pre] == text[pre]) pre++;
+    if (pre == old_len && pre == new_len) {
+        g_free(old);
+        return;
+    }
+    while (pre > 0 && old[pre - 1] != '\n') pre--;
+
+    gsize suf = 0;
+    lim = MIN(old_len, new_len) - pre;
+    while (suf < lim && old[old_len - 1 - suf] == text[new_len - 1 - suf]) suf++;
+    /* old end of the changed region must sit on a line start */
+    gsize old_cut = old_len - suf;
+    while (old_cut < old_len && old_cut > pre && old[old_cut - 1] != '\n') old_cut++;
+    suf = old_len - old_cut;
+
+    int first_line = 0, cut_line = 0;
+    for (gsize i = 0; i < old_cut; i++) {
+        if (old[i] != '\n') continue;
+        if (i < pre) first_line++;
+        cut_line++;
+    }
+    g_free(old);
+
+    GtkTextIter a, b;
+    gtk_text_buffer_get_iter_at_line(d->buf, &a, first_line);
+    if (old_cut >= old_len) gtk_text_buffer_get_end_iter(d->buf, &b);
+    else gtk_text_buffer_get_iter_at_line(d->buf, &b, cut_line);
+
+    gtk_text_buffer_begin_user_action(d->buf);
+    gtk_text_buffer_delete(d->buf, &a, &b);
+    gtk_text_buffer_insert(d->buf, &a, text + pre, (int)(new_len - suf - pre));
+    gtk_text_buffer_end_user_action(d->buf);
+}
+
+static void on_hypr_file_changed(const char *path, gpointer user_data)
+{
+    HyprlandPageData *d = (HyprlandPageData *)user_data;
+    if (g_strcmp0(path, d->path) != 0) {
+        /* a sourced file: its $variables feed the diagnostics */
+        set_status(d->status, "%s changed on disk", path);
+        hypr_checker_recheck(d->checker);
+        return;
+    }
+
+    FileStamp now;
+    file_stamp_take(d->path, &now);
+    if (file_stamp_equal(&now, &d->stamp) || d->loading) return; /* our own save */
+
+    if (gtk_text_buffer_get_modified(d->buf)) {
+        set_status(d->status, "%s changed on disk while you have unsaved edits; Save will ask before overwriting", d->path);
+        return;
+    }
+
+    gchar *content = NULL;
+    gsize len = 0;
+    if (!now.exists || !g_file_get_contents(d->path, &content, &len, NULL)) {
+        set_status(d->status, "%s was removed on disk", d->path);
+        return;
+    }
+    gchar *valid = g_utf8_make_valid(content, (gssize)len);
+    g_free(content);
+
+    hypr_buffer_merge(d, valid, strlen(valid));
+    g_free(valid);
+    d->stamp = now;
+    gtk_text_buffer_set_modified(d->buf, FALSE);
+    set_status(d->status, "Reloaded changes to %s from disk", d->path);
+}
 
 static void on_hyprland_save_clicked(GtkButton *btn, gpointer user_data)
 {
-    HyprlandSaveData *d = (HyprlandSaveData *)user_data;
-    if (!d) return;
-    GtkTextBuffer *buf = gtk_text_view_get_buffer(d->tv);
+    HyprlandPageData *d = (HyprlandPageData *)user_data;
+    if (!d || d->loading) return;
     GtkTextIter start, end;
-    gtk_text_buffer_get_start_iter(buf, &start);
-    gtk_text_buffer_get_end_iter(buf, &end);
-    char *txt = gtk_text_buffer_get_text(buf, &start, &end, FALSE);
+    gtk_text_buffer_get_start_iter(d->buf, &start);
+    gtk_text_buffer_get_end_iter(d->buf, &end);
+    char *txt = gtk_text_buffer_get_text(d->buf, &start, &end, FALSE);
     GError *err = NULL;
-    if (!g_file_set_contents(d->path, txt, -1, &err)) {
+    ConfigSaveResult r = save_config_file(d->path, txt, -1, &d->stamp, d->force_save, &err);
+    d->force_save = FALSE;
+    switch (r) {
+    case CONFIG_SAVE_WRITTEN:
+        gtk_text_buffer_set_modified(d->buf, FALSE);
+        set_status(d->status, "Saved %s", d->path);
+        hypr_start_lint(d);
+        break;
+    case CONFIG_SAVE_UNCHANGED:
+        gtk_text_buffer_set_modified(d->buf, FALSE);
+        set_status(d->status, "No changes to save in %s", d->path);
+        break;
+    case CONFIG_SAVE_CONFLICT:
+        /* the next Save is a deliberate overwrite */
+        d->force_save = TRUE;
+        set_status(d->status, "%s changed on disk since it was loaded; press Save again to overwrite it", d->path);
+        break;
+    case CONFIG_SAVE_FAILED: {
         char *msg = g_strdup_printf("Failed to write %s:\n%s", d->path, err ? err->message : "unknown");
         show_big_message_dialog("Error saving hyprland.conf", msg);
         g_free(msg);
-        if (err) g_clear_error(&err);
-    } else {
-        set_status(d->status, "Saved %s", d->path);
+        break;
+    }
     }
+    g_clear_error(&err);
     g_free(txt);
 }
 
@@ -82,7 +610,7 @@ GtkWidget *create_hyprland_page(GtkLabel *status_label)
     gtk_widget_set_halign(label, GTK_ALIGN_START);
     gtk_box_append(GTK_BOX(vbox), label);
 
-    GtkWidget *desc = gtk_label_new("Edit your ~/.config/hypr/hyprland.conf below. Use Save to write changes. Errors/output will be shown in a large dialog.");
+    GtkWidget *desc = gtk_label_new("Edit your ~/.config/hypr/hyprland.conf below. Problems are underlined as you type (hover for details). Use Save to write changes. Errors/output will be shown in a large dialog.");
     gtk_label_set_wrap(GTK_LABEL(desc), TRUE);
     gtk_box_append(GTK_BOX(vbox), desc);
 
@@ -91,35 +619,97 @@ GtkWidget *create_hyprland_page(GtkLabel *status_label)
     gtk_widget_set_hexpand(scroller, TRUE);
     gtk_box_append(GTK_BOX(vbox), scroller);
 
+    HyprlandPageData *d = g_new0(HyprlandPageData, 1);
+    d->status = status_label;
+    d->path = g_build_filename(g_get_home_dir(), ".config", "hypr", "hyprland.conf", NULL);
+
     GtkWidget *tv = gtk_text_view_new();
-    gtk_text_view_set_wrap_mode(GTK_TEXT_VIEW(tv), GTK_WRAP_WORD_CHAR);
+    /* no wrapping by default: keeps layout per line and independent of width */
+    gtk_text_view_set_wrap_mode(GTK_TEXT_VIEW(tv), GTK_WRAP_NONE);
     gtk_text_view_set_monospace(GTK_TEXT_VIEW(tv), TRUE);
     gtk_scrolled_window_set_child(GTK_SCROLLED_WINDOW(scroller), tv);
+    d->tv = GTK_TEXT_VIEW(tv);
+    d->buf = gtk_text_view_get_buffer(d->tv);
 
-    /* load file contents */
-    char *path = g_build_filename(g_get_home_dir(), ".config", "hypr", "hyprland.conf", NULL);
-    gchar *content = NULL;
-    if (g_file_get_contents(path, &content, NULL, NULL)) {
-        GtkTextBuffer *buf = gtk_text_view_get_buffer(GTK_TEXT_VIEW(tv));
-        gtk_text_buffer_set_text(buf, content, -1);
-        g_free(content);
-    } else {
-        /* leave empty and inform status */
-        set_status(status_label, "Could not read %s (it may not exist)", path);
-    }
+    /* line-number gutter */
+    d->gutter = gtk_drawing_area_new();
+    gtk_drawing_area_set_draw_func(GTK_DRAWING_AREA(d->gutter), draw_line_numbers, d, NULL);
+    gtk_text_view_set_gutter(d->tv, GTK_TEXT_WINDOW_LEFT, d->gutter);
+    update_gutter_width(d);
+    g_signal_connect(gtk_scrollable_get_vadjustment(GTK_SCROLLABLE(tv)), "value-changed",
+                     G_CALLBACK(on_editor_scrolled), d);
+    g_signal_connect(d->buf, "changed", G_CALLBACK(on_editor_buffer_changed), d);
+
+    /* undo/redo through the shared edit history */
+    gtk_text_buffer_set_enable_undo(d->buf, FALSE);
+    d->history = edit_history_new(hypr_history_apply, d, TRUE);
+    g_signal_connect(d->buf, "insert-text", G_CALLBACK(on_editor_insert_text), d);
+    g_signal_connect(d->buf, "delete-range", G_CALLBACK(on_editor_delete_range), d);
+    g_signal_connect(d->buf, "begin-user-action", G_CALLBACK(on_editor_begin_user_action), d);
+    g_signal_connect(d->buf, "end-user-action", G_CALLBACK(on_editor_end_user_action), d);
+    GtkEventController *keys = gtk_shortcut_controller_new();
+    gtk_event_controller_set_propagation_phase(keys, GTK_PHASE_CAPTURE);
+    GtkShortcut *sc = gtk_shortcut_new(gtk_shortcut_trigger_parse_string("<Control>z"),
+                                       gtk_callback_action_new(on_undo_shortcut, d, NULL));
+    gtk_shortcut_set_arguments(sc, g_variant_new_boolean(FALSE));
+    gtk_shortcut_controller_add_shortcut(GTK_SHORTCUT_CONTROLLER(keys), sc);
+    sc = gtk_shortcut_new(gtk_alternative_trigger_new(gtk_shortcut_trigger_parse_string("<Control><Shift>z"),
+                                                      gtk_shortcut_trigger_parse_string("<Control>y")),
+                          gtk_callback_action_new(on_undo_shortcut, d, NULL));
+    gtk_shortcut_set_arguments(sc, g_variant_new_boolean(TRUE));
+    gtk_shortcut_controller_add_shortcut(GTK_SHORTCUT_CONTROLLER(keys), sc);
+    gtk_widget_add_controller(tv, keys);
+
+    /* Schema lint report; activating a row jumps to the line */
+    d->lint_expander = gtk_expander_new("Lint report");
+    GtkWidget *lint_sc = gtk_scrolled_window_new();
+    gtk_widget_set_size_request(lint_sc, -1, 140);
+    d->lint_list = gtk_list_box_new();
+    gtk_list_box_set_activate_on_single_click(GTK_LIST_BOX(d->lint_list), TRUE);
+    g_signal_connect(d->lint_list, "row-activated", G_CALLBACK(on_lint_row_activated), d);
+    gtk_scrolled_window_set_child(GTK_SCROLLED_WINDOW(lint_sc), d->lint_list);
+    gtk_expander_set_child(GTK_EXPANDER(d->lint_expander), lint_sc);
+    gtk_box_append(GTK_BOX(vbox), d->lint_expander);
 
-    /* Save button */
+    /* Keyboard layout, applied live through `keyword` */
+    gtk_box_append(GTK_BOX(vbox), hypr_input_panel_new(status_label));
+
+    /* Regex find/replace across this file and everything it sources */
+    gtk_box_append(GTK_BOX(vbox), hypr_search_panel_new(d->path, d->tv, &d->stamp, status_label));
+
+    /* Diagnostics summary, wrap toggle and Save button */
     GtkWidget *h = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 8);
-    GtkWidget *btn_save = gtk_button_new_with_label("Save hyprland.conf");
-    gtk_box_append(GTK_BOX(h), btn_save);
-    gtk_widget_set_halign(h, GTK_ALIGN_END);
+    GtkWidget *diag_label = gtk_label_new("");
+    gtk_widget_set_hexpand(diag_label, TRUE);
+    gtk_widget_set_halign(diag_label, GTK_ALIGN_START);
+    gtk_box_append(GTK_BOX(h), diag_label);
+    d->checker = hypr_checker_attach(d->tv, d->path, GTK_LABEL(diag_label));
+    d->wrap_btn = gtk_check_button_new_with_label("Wrap lines");
+    g_signal_connect(d->wrap_btn, "toggled", G_CALLBACK(on_wrap_toggled), d);
+    gtk_box_append(GTK_BOX(h), d->wrap_btn);
+    d->undo_btn = gtk_button_new_with_label("Undo");
+    g_signal_connect(d->undo_btn, "clicked", G_CALLBACK(on_undo_clicked), d);
+    gtk_box_append(GTK_BOX(h), d->undo_btn);
+    d->redo_btn = gtk_button_new_with_label("Redo");
+    g_signal_connect(d->redo_btn, "clicked", G_CALLBACK(on_redo_clicked), d);
+    gtk_box_append(GTK_BOX(h), d->redo_btn);
+    GtkWidget *btn_lint = gtk_button_new_with_label("Lint");
+    g_signal_connect(btn_lint, "clicked", G_CALLBACK(on_lint_clicked), d);
+    gtk_box_append(GTK_BOX(h), btn_lint);
+    GtkWidget *btn_log = gtk_button_new_with_label("Hyprland log");
+    g_signal_connect(btn_log, "clicked", G_CALLBACK(on_log_clicked), d);
+    gtk_box_append(GTK_BOX(h), btn_log);
+    d->save_btn = gtk_button_new_with_label("Save hyprland.conf");
+    gtk_box_append(GTK_BOX(h), d->save_btn);
     gtk_box_append(GTK_BOX(vbox), h);
 
-    HyprlandSaveData *sd = g_new0(HyprlandSaveData, 1);
-    sd->tv = GTK_TEXT_VIEW(tv);
-    sd->path = path;
-    sd->status = status_label;
-    g_signal_connect(btn_save, "clicked", G_CALLBACK(on_hyprland_save_clicked), sd);
+    g_signal_connect(d->save_btn, "clicked", G_CALLBACK(on_hyprland_save_clicked), d);
+
+    update_undo_buttons(d);
+
+    /* load file contents in the background */
+    hypr_start_load(d);
+    d->watch = hypr_watch_new(d->path, TRUE, on_hypr_file_changed, d);
 
     return vbox;
 }
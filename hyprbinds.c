@@ -0,0 +1,192 @@
+/* hyprbinds.c - bind line parser with normalized modifiers and triggers */
+#include "hyprbinds.h"
+#include "hyprconf.h"
+#include <string.h>
+
+static const struct {
+    const char *name;
+    guint mask;
+} mod_names[] = {
+    { "SHIFT", HYPR_MOD_SHIFT },
+    { "CAPS", HYPR_MOD_CAPS },
+    { "CTRL", HYPR_MOD_CTRL },
+    { "CONTROL", HYPR_MOD_CTRL },
+    { "ALT", HYPR_MOD_ALT },
+    { "MOD1", HYPR_MOD_ALT },
+    { "MOD2", HYPR_MOD_MOD2 },
+    { "MOD3", HYPR_MOD_MOD3 },
+    { "SUPER", HYPR_MOD_SUPER },
+    { "WIN", HYPR_MOD_SUPER },
+    { "LOGO", HYPR_MOD_SUPER },
+    { "MOD4", HYPR_MOD_SUPER },
+    { "META", HYPR_MOD_SUPER },
+    { "MOD5", HYPR_MOD_MOD5 },
+};
+
+/* Names used when printing a mask, one per bit */
+static const char *mod_bit_names[] = { "SHIFT", "CAPS", "CTRL", "ALT", "MOD2", "MOD3", "SUPER", "MOD5" };
+
+static gboolean is_var_char(char c)
+{
+    return g_ascii_isalnum(c) || c == '_';
+}
+
+/* Append `s` to `out` with $variables replaced. Values may refer to other
+ * variables; `depth` stops definitions that refer to themselves. */
+static gboolean expand_vars(GString *out, const char *s, GHashTable *vars, int depth, char **unknown)
+{
+    while (*s) {
+        if (*s != '$' || !is_var_char(s[1])) {
+            g_string_append_c(out, *s++);
+            continue;
+        }
+        const char *name = ++s;
+        while (is_var_char(*s)) s++;
+        char *key = g_strndup(name, (gsize)(s - name));
+        const char *value = vars ? g_hash_table_lookup(vars, key) : NULL;
+        if (!value || depth > 4) {
+            *unknown = key;
+            return FALSE;
+        }
+        g_free(key);
+        if (!expand_vars(out, value, vars, depth + 1, unknown)) return FALSE;
+    }
+    return TRUE;
+}
+
+/* Same test Hyprland applies: each name found anywhere in the string sets
+ * its bit, so "SUPER_SHIFT", "SUPER SHIFT" and "SUPERSHIFT" agree. */
+static guint mods_from_string(const char *s)
+{
+    char *up = g_ascii_strup(s, -1);
+    guint mask = 0;
+    for (guint i = 0; i < G_N_ELEMENTS(mod_names); i++) {
+        if (strstr(up, mod_names[i].name)) mask |= mod_names[i].mask;
+    }
+    g_free(up);
+    return mask;
+}
+
+gboolean hypr_bind_parse(const char *line, GHashTable *vars, HyprBind *out)
+{
+    memset(out, 0, sizeof(*out));
+    HyprLine hl;
+    hypr_conf_scan_line(line, -1, &hl);
+    if (hl.kind != HYPR_LINE_ASSIGN || hl.key_len < 4 || strncmp(hl.key, "bind", 4) != 0) return FALSE;
+
+    out->flags = g_strndup(hl.key + 4, hl.key_len - 4);
+    for (const char *f = out->flags; *f; f++) {
+        if (!strchr(HYPR_BIND_FLAGS, *f)) {
+            out->error = g_strdup_printf("unknown bind flag '%c'", *f);
+            return TRUE;
+        }
+    }
+
+    gboolean described = strchr(out->flags, 'd') != NULL;
+    int n_fields = described ? 5 : 4;
+    char *value = g_strndup(hl.value, hl.value_len);
+    char **parts = g_strsplit(value, ",", n_fields);
+    g_free(value);
+    int n = (int)g_strv_length(parts);
+    for (int i = 0; i < n; i++) g_strstrip(parts[i]);
+
+    if (n < n_fields - 1) {
+        out->error = g_strdup(described ? "expected MODS, key, description, dispatcher[, args]"
+                                        : "expected MODS, key, dispatcher[, args]");
+        g_strfreev(parts);
+        return TRUE;
+    }
+
+    GString *mods = g_string_new(NULL);
+    char *unknown = NULL;
+    if (!expand_vars(mods, parts[0], vars, 0, &unknown)) {
+        out->error = g_strdup_printf("unknown variable $%s", unknown);
+        g_free(unknown);
+    }
+    out->mods = mods_from_string(mods->str);
+    g_string_free(mods, TRUE);
+
+    int d = described ? 3 : 2;
+    out->key = g_strdup(parts[1]);
+    out->description = described ? g_strdup(parts[2]) : NULL;
+    out->dispatcher = g_strdup(parts[d]);
+    out->args = g_strdup(d + 1 < n ? parts[d + 1] : "");
+    g_strfreev(parts);
+
+    if (!out->error && out->key[0] == '\0') out->error = g_strdup("missing key");
+    if (!out->error && out->dispatcher[0] == '\0') out->error = g_strdup("missing dispatcher");
+    return TRUE;
+}
+
+void hypr_bind_clear(HyprBind *b)
+{
+    g_free(b->flags);
+    g_free(b->key);
+    g_free(b->description);
+    g_free(b->dispatcher);
+    g_free(b->args);
+    g_free(b->error);
+    memset(b, 0, sizeof(*b));
+}
+
+char *hypr_bind_mods_to_string(guint mods)
+{
+    GString *s = g_string_new(NULL);
+    for (guint i = 0; i < G_N_ELEMENTS(mod_bit_names); i++) {
+        if (!(mods & (1u << i))) continue;
+        if (s->len) g_string_append_c(s, ' ');
+        g_string_append(s, mod_bit_names[i]);
+    }
+    return g_string_free(s, FALSE);
+}
+
+char *hypr_bind_trigger(const HyprBind *b, const char *submap)
+{
+    if (b->error || !b->key) return NULL;
+    char *key = g_ascii_strdown(b->key, -1);
+    /* release and mouse binds react to different input than plain presses */
+    char kind = strchr(b->flags, 'm') ? 'm' : strchr(b->flags, 'r') ? 'r' : 'p';
+    char *t;
+    if (strchr(b->flags, 'i')) t = g_strdup_printf("%s\x1f*\x1f%s\x1f%c", submap, key, kind);
+    else t = g_strdup_printf("%s\x1f%u\x1f%s\x1f%c", submap, b->mods, key, kind);
+    g_free(key);
+    return t;
+}
+
+gboolean hypr_bind_same_action(const HyprBind *a, const HyprBind *b)
+{
+    return g_ascii_strcasecmp(a->dispatcher, b->dispatcher) == 0 && g_strcmp0(a->args, b->args) == 0;
+}
+
+GHashTable *hypr_bind_vars_load(const char *root)
+{
+    GHashTable *vars = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+    GPtrArray *paths = hypr_conf_include_graph(root);
+    for (guint f = 0; f < paths->len; f++) {
+        gchar *content = NULL;
+        if (!g_file_get_contents(g_ptr_array_index(paths, f), &content, NULL, NULL)) continue;
+        gchar **lines = g_strsplit(content, "\n", -1);
+        g_free(content);
+        for (gint l = 0; lines[l]; l++) {
+            HyprLine hl;
+            hypr_conf_scan_line(lines[l], -1, &hl);
+            if (hl.kind != HYPR_LINE_VARIABLE) continue;
+            g_hash_table_replace(vars, g_strndup(hl.key, hl.key_len), g_strndup(hl.value, hl.value_len));
+        }
+        g_strfreev(lines);
+    }
+    g_ptr_array_unref(paths);
+    return vars;
+}
+
+const char *hypr_bind_submap_after(const char *line, gssize len, const char *current)
+{
+    HyprLine hl;
+    hypr_conf_scan_line(line, len, &hl);
+    if (hl.kind != HYPR_LINE_ASSIGN || hl.key_len != 6 || strncmp(hl.key, "submap", 6) != 0) return current;
+    if (hl.value_len == 5 && strncmp(hl.value, "reset", 5) == 0) return g_intern_static_string("");
+    char *name = g_strndup(hl.value, hl.value_len);
+    const char *interned = g_intern_string(name);
+    g_free(name);
+    return interned;
+}
@@ -0,0 +1,57 @@
+/* hyprbinds.h - bind line parser with normalized modifiers and triggers */
+#ifndef HYPRBINDS_H
+#define HYPRBINDS_H
+
+#include <glib.h>
+
+/* Modifier bits, in the order Hyprland reports them */
+enum {
+    HYPR_MOD_SHIFT = 1 << 0,
+    HYPR_MOD_CAPS  = 1 << 1,
+    HYPR_MOD_CTRL  = 1 << 2,
+    HYPR_MOD_ALT   = 1 << 3,
+    HYPR_MOD_MOD2  = 1 << 4,
+    HYPR_MOD_MOD3  = 1 << 5,
+    HYPR_MOD_SUPER = 1 << 6,
+    HYPR_MOD_MOD5  = 1 << 7
+};
+
+/* One parsed `bind[flags] = MODS, key, [description,] dispatcher, args` line.
+ * On a parse error only `error` (and whatever was read before it) is set. */
+typedef struct {
+    char *flags;           /* letters after "bind", e.g. "el" */
+    guint mods;            /* HYPR_MOD_* after $variable expansion */
+    char *key;             /* as written, trimmed */
+    char *description;     /* "d" flag only */
+    char *dispatcher;
+    char *args;
+    char *error;
+} HyprBind;
+
+/* Parse `line` if it is a bind line. Returns FALSE for anything else
+ * (comments, other keywords), leaving `out` cleared. `vars` maps variable
+ * names (without '$') to values and may be NULL. */
+gboolean hypr_bind_parse(const char *line, GHashTable *vars, HyprBind *out);
+void hypr_bind_clear(HyprBind *b);
+
+/* "SUPER SHIFT", "" for no modifiers */
+char *hypr_bind_mods_to_string(guint mods);
+
+/* What makes two binds fire on the same input: submap, modifiers (unless
+ * the "i" flag ignores them), key (case-insensitive) and press/release.
+ * NULL for binds with an error. */
+char *hypr_bind_trigger(const HyprBind *b, const char *submap);
+
+/* Same dispatcher (case-insensitive) and arguments */
+gboolean hypr_bind_same_action(const HyprBind *a, const HyprBind *b);
+
+/* Variable values of `root` and everything it sources; later definitions
+ * win, as in Hyprland. Reads files. */
+GHashTable *hypr_bind_vars_load(const char *root);
+
+/* Track `submap = name` / `submap = reset` lines. Returns the interned name
+ * of the submap in effect after `line` ("" for the global map). `len` may
+ * be -1. */
+const char *hypr_bind_submap_after(const char *line, gssize len, const char *current);
+
+#endif /* HYPRBINDS_H */
@@ -0,0 +1,447 @@
+/* hyprcheck.c - on-the-fly diagnostics for the Hyprland config editor
+ *
+ * The checker keeps one LineState per buffer line. Buffer edits only shift
+ * that array and mark the touched lines dirty; after a short debounce the
+ * dirty span is copied out and scanned on a worker (string work, sourced-file
+ * reads). The result is spliced back and a cheap integer pass over all lines
+ * resolves brace depth and variable definitions. Tags are only touched on
+ * lines whose diagnostic level actually changed. */
+#include "hyprcheck.h"
+#include "hyprconf.h"
+#include "common.h"
+#include <string.h>
+
+#define HYPR_CHECK_DEBOUNCE_MS 300
+
+enum {
+    DIAG_NONE = 0,
+    DIAG_WARNING,
+    DIAG_ERROR,
+    DIAG_UNKNOWN /* tag state on the buffer unknown: force re-apply */
+};
+
+typedef struct {
+    guint kind : 4;
+    guint dirty : 1;
+    guint known : 1;    /* known top-level keyword / category name */
+    guint is_exec : 1;  /* exec lines: $VARS belong to the shell */
+    guint applied : 2;  /* level currently tagged on the buffer */
+    guint level : 2;    /* level from the last global pass */
+    guint16 opens;
+    guint16 closes;
+    GQuark name;
+    GQuark *defines;    /* 0-terminated or NULL */
+    GQuark *uses;       /* 0-terminated or NULL */
+    char *msg;
+} LineState;
+
+struct HyprChecker {
+    GtkTextView *tv;
+    GtkTextBuffer *buf;
+    GtkLabel *summary;
+    char *dir;
+    GArray *lines;
+    GtkTextTag *tag_error;
+    GtkTextTag *tag_warning;
+    guint timeout_id;
+    guint gen;
+    gboolean blocked;
+};
+
+typedef struct {
+    char *text;
+    char *dir;
+    int first;
+    int count;
+    guint gen;
+    LineState *out;
+} CheckJob;
+
+static void line_state_clear(gpointer p)
+{
+    LineState *ls = (LineState *)p;
+    g_free(ls->defines);
+    g_free(ls->uses);
+    g_free(ls->msg);
+    ls->defines = NULL;
+    ls->uses = NULL;
+    ls->msg = NULL;
+}
+
+static void check_job_free(CheckJob *job)
+{
+    g_free(job->text);
+    g_free(job->dir);
+    g_free(job->out);
+    g_free(job);
+}
+
+static GQuark quark_from_span(const char *s, gsize len)
+{
+    char *tmp = g_strndup(s, len);
+    GQuark q = g_quark_from_string(tmp);
+    g_free(tmp);
+    return q;
+}
+
+static void collect_use(const char *name, gsize len, gpointer user_data)
+{
+    GQuark q = quark_from_span(name, len);
+    g_array_append_val((GArray *)user_data, q);
+}
+
+static GQuark *finish_quarks(GArray *a)
+{
+    if (a->len == 0) {
+        g_array_free(a, TRUE);
+        return NULL;
+    }
+    GQuark zero = 0;
+    g_array_append_val(a, zero);
+    return (GQuark *)g_array_free(a, FALSE);
+}
+
+/* Worker-side scan of a single line */
+static void scan_line(LineState *ls, const char *line, gsize len, const char *dir)
+{
+    HyprLine hl;
+    hypr_conf_scan_line(line, (gssize)len, &hl);
+    ls->kind = hl.kind;
+    ls->opens = (guint16)MIN(hl.opens, G_MAXUINT16);
+    ls->closes = (guint16)MIN(hl.closes, G_MAXUINT16);
+    if (hl.key_len > 0) ls->name = quark_from_span(hl.key, hl.key_len);
+
+    GArray *uses = g_array_new(FALSE, FALSE, sizeof(GQuark));
+    GArray *defs = g_array_new(FALSE, FALSE, sizeof(GQuark));
+    switch (hl.kind) {
+    case HYPR_LINE_ASSIGN:
+        ls->known = hypr_conf_is_toplevel_keyword(hl.key, hl.key_len);
+        ls->is_exec = hypr_conf_is_exec_keyword(hl.key, hl.key_len);
+        hypr_conf_foreach_variable_use(hl.value, hl.value_len, collect_use, uses);
+        if (hl.key_len == 6 && strncmp(hl.key, "source", 6) == 0) {
+            /* a source line "defines" whatever the sourced files define */
+            GPtrArray *srcs = hypr_conf_resolve_source(hl.value, hl.value_len, dir);
+            for (guint i = 0; i < srcs->len; i++) {
+                hypr_conf_collect_variables(g_ptr_array_index(srcs, i), defs, NULL);
+            }
+            g_ptr_array_unref(srcs);
+        }
+        break;
+    case HYPR_LINE_VARIABLE:
+        g_array_append_val(defs, ls->name);
+        hypr_conf_foreach_variable_use(hl.value, hl.value_len, collect_use, uses);
+        break;
+    case HYPR_LINE_CATEGORY_OPEN:
+        ls->known = hypr_conf_is_category(hl.key, hl.key_len);
+        break;
+    default:
+        break;
+    }
+    ls->uses = finish_quarks(uses);
+    ls->defines = finish_quarks(defs);
+}
+
+static void check_thread(GTask *task, gpointer source, gpointer task_data, GCancellable *cancellable)
+{
+    CheckJob *job = (CheckJob *)task_data;
+    job->out = g_new0(LineState, job->count);
+
+    const char *p = job->text;
+    const char *end = job->text + strlen(job->text);
+    for (int i = 0; i < job->count; i++) {
+        const char *nl = memchr(p, '\n', (gsize)(end - p));
+        gsize ll = nl ? (gsize)(nl - p) : (gsize)(end - p);
+        scan_line(&job->out[i], p, ll, job->dir);
+        p = nl ? nl + 1 : end;
+    }
+    g_task_return_boolean(task, TRUE);
+}
+
+static void apply_line_tag(HyprChecker *c, int line, guint level)
+{
+    GtkTextIter s, e;
+    gtk_text_buffer_get_iter_at_line(c->buf, &s, line);
+    e = s;
+    if (!gtk_text_iter_ends_line(&e)) gtk_text_iter_forward_to_line_end(&e);
+    gtk_text_buffer_remove_tag(c->buf, c->tag_error, &s, &e);
+    gtk_text_buffer_remove_tag(c->buf, c->tag_warning, &s, &e);
+    if (level == DIAG_ERROR) gtk_text_buffer_apply_tag(c->buf, c->tag_error, &s, &e);
+    else if (level == DIAG_WARNING) gtk_text_buffer_apply_tag(c->buf, c->tag_warning, &s, &e);
+}
+
+static void set_diag(LineState *ls, guint level, char *msg)
+{
+    /* keep the first (most structural) error on a line */
+    if (level < ls->level || (level == ls->level && ls->msg)) {
+        g_free(msg);
+        return;
+    }
+    g_free(ls->msg);
+    ls->msg = msg;
+    ls->level = level;
+}
+
+/* Whole-buffer pass over cached line states: brace balance and variable
+ * resolution need global context but no string work. */
+static void global_pass(HyprChecker *c)
+{
+    guint n = c->lines->len;
+    GHashTable *vars = g_hash_table_new(NULL, NULL);
+    for (guint i = 0; i < n; i++) {
+        LineState *ls = &g_array_index(c->lines, LineState, i);
+        for (GQuark *q = ls->defines; q && *q; q++) g_hash_table_add(vars, GUINT_TO_POINTER(*q));
+    }
+
+    GArray *open_stack = g_array_new(FALSE, FALSE, sizeof(guint));
+    int depth = 0;
+    for (guint i = 0; i < n; i++) {
+        LineState *ls = &g_array_index(c->lines, LineState, i);
+        g_free(ls->msg);
+        ls->msg = NULL;
+        ls->level = DIAG_NONE;
+
+        switch (ls->kind) {
+        case HYPR_LINE_ASSIGN:
+            if (depth == 0 && !ls->known) {
+                set_diag(ls, DIAG_ERROR, g_strdup_printf("Unknown keyword '%s'", g_quark_to_string(ls->name)));
+            }
+            break;
+        case HYPR_LINE_CATEGORY_OPEN:
+            if (depth == 0 && !ls->known) {
+                set_diag(ls, DIAG_WARNING, g_strdup_printf("Unknown category '%s'", g_quark_to_string(ls->name)));
+            }
+            break;
+        case HYPR_LINE_INVALID:
+            set_diag(ls, DIAG_ERROR, g_strdup("Expected 'key = value', 'category {' or '}'"));
+            break;
+        default:
+            break;
+        }
+
+        if (!ls->is_exec) {
+            for (GQuark *q = ls->uses; q && *q; q++) {
+                if (!g_hash_table_contains(vars, GUINT_TO_POINTER(*q))) {
+                    set_diag(ls, DIAG_WARNING, g_strdup_printf("Undefined variable $%s", g_quark_to_string(*q)));
+                    break;
+                }
+            }
+        }
+
+        for (guint k = 0; k < ls->opens; k++) {
+            g_array_append_val(open_stack, i);
+            depth++;
+        }
+        for (guint k = 0; k < ls->closes; k++) {
+            if (depth == 0) {
+                set_diag(ls, DIAG_ERROR, g_strdup("Unmatched '}'"));
+                continue;
+            }
+            g_array_set_size(open_stack, open_stack->len - 1);
+            depth--;
+        }
+    }
+    for (guint k = 0; k < open_stack->len; k++) {
+        guint li = g_array_index(open_stack, guint, k);
+        LineState *ls = &g_array_index(c->lines, LineState, li);
+        g_free(ls->msg);
+        ls->msg = g_strdup("Unclosed '{' (missing '}')");
+        ls->level = DIAG_ERROR;
+    }
+    g_array_free(open_stack, TRUE);
+    g_hash_table_destroy(vars);
+
+    int errors = 0, warnings = 0;
+    for (guint i = 0; i < n; i++) {
+        LineState *ls = &g_array_index(c->lines, LineState, i);
+        if (ls->level == DIAG_ERROR) errors++;
+        else if (ls->level == DIAG_WARNING) warnings++;
+        if (ls->applied != ls->level) {
+            apply_line_tag(c, (int)i, ls->level);
+            ls->applied = ls->level;
+        }
+    }
+
+    if (c->summary) {
+        if (errors == 0 && warnings == 0) {
+            gtk_label_set_text(c->summary, "No problems found");
+        } else {
+            char *s = g_strdup_printf("%d error(s), %d warning(s) — hover underlined lines for details", errors, warnings);
+            gtk_label_set_text(c->summary, s);
+            g_free(s);
+        }
+    }
+}
+
+static void on_check_done(GObject *source, GAsyncResult *res, gpointer user_data)
+{
+    HyprChecker *c = (HyprChecker *)user_data;
+    CheckJob *job = g_task_get_task_data(G_TASK(res));
+
+    /* a newer edit has already scheduled another run; drop stale results */
+    if (job->gen != c->gen || job->first + job->count > (int)c->lines->len) {
+        for (int i = 0; i < job->count; i++) line_state_clear(&job->out[i]);
+        return;
+    }
+
+    for (int i = 0; i < job->count; i++) {
+        LineState *dst = &g_array_index(c->lines, LineState, job->first + i);
+        guint applied = dst->applied;
+        line_state_clear(dst);
+        *dst = job->out[i];
+        dst->applied = applied;
+        dst->dirty = 0;
+    }
+    /* ownership of the per-line arrays moved into c->lines */
+    memset(job->out, 0, sizeof(LineState) * (gsize)job->count);
+
+    global_pass(c);
+}
+
+static gboolean run_check(gpointer user_data)
+{
+    HyprChecker *c = (HyprChecker *)user_data;
+    c->timeout_id = 0;
+
+    int lo = -1, hi = -1;
+    for (guint i = 0; i < c->lines->len; i++) {
+        if (!g_array_index(c->lines, LineState, i).dirty) continue;
+        if (lo < 0) lo = (int)i;
+        hi = (int)i;
+    }
+    if (lo < 0) {
+        /* only line shifts (e.g. joined lines): structure may still change */
+        global_pass(c);
+        return G_SOURCE_REMOVE;
+    }
+
+    GtkTextIter s, e;
+    gtk_text_buffer_get_iter_at_line(c->buf, &s, lo);
+    if (!gtk_text_buffer_get_iter_at_line(c->buf, &e, hi + 1)) gtk_text_buffer_get_end_iter(c->buf, &e);
+
+    CheckJob *job = g_new0(CheckJob, 1);
+    job->text = gtk_text_buffer_get_text(c->buf, &s, &e, TRUE);
+    job->dir = g_strdup(c->dir);
+    job->first = lo;
+    job->count = hi - lo + 1;
+    job->gen = c->gen;
+
+    GTask *task = g_task_new(NULL, NULL, on_check_done, c);
+    g_task_set_task_data(task, job, (GDestroyNotify)check_job_free);
+    g_task_run_in_thread(task, check_thread);
+    g_object_unref(task);
+    return G_SOURCE_REMOVE;
+}
+
+static void schedule_check(HyprChecker *c)
+{
+    c->gen++;
+    if (c->blocked) return;
+    if (c->timeout_id) g_source_remove(c->timeout_id);
+    c->timeout_id = g_timeout_add(HYPR_CHECK_DEBOUNCE_MS, run_check, c);
+}
+
+static void mark_dirty(HyprChecker *c, int first, int last)
+{
+    for (int i = first; i <= last && i < (int)c->lines->len; i++) {
+        LineState *ls = &g_array_index(c->lines, LineState, i);
+        ls->dirty = 1;
+        ls->applied = DIAG_UNKNOWN;
+    }
+}
+
+/* Runs before the default handler, so `loc` still points at the insertion
+ * point in the old text. */
+static void on_insert_text(GtkTextBuffer *buf, GtkTextIter *loc, const char *text, int len, gpointer user_data)
+{
+    HyprChecker *c = (HyprChecker *)user_data;
+    int line = gtk_text_iter_get_line(loc);
+    guint nl = 0;
+    for (int i = 0; i < len; i++) if (text[i] == '\n') nl++;
+    if (nl > 0) {
+        LineState *fresh = g_new0(LineState, nl);
+        g_array_insert_vals(c->lines, (guint)line + 1, fresh, nl);
+        g_free(fresh);
+    }
+    mark_dirty(c, line, line + (int)nl);
+    schedule_check(c);
+}
+
+static void on_delete_range(GtkTextBuffer *buf, GtkTextIter *start, GtkTextIter *end, gpointer user_data)
+{
+    HyprChecker *c = (HyprChecker *)user_data;
+    int a = gtk_text_iter_get_line(start);
+    int b = gtk_text_iter_get_line(end);
+    if (a > b) { int t = a; a = b; b = t; }
+    if (b > a) g_array_remove_range(c->lines, (guint)a + 1, (guint)(b - a));
+    mark_dirty(c, a, a);
+    schedule_check(c);
+}
+
+static gboolean on_query_tooltip(GtkWidget *w, int x, int y, gboolean keyboard_mode, GtkTooltip *tooltip, gpointer user_data)
+{
+    HyprChecker *c = (HyprChecker *)user_data;
+    int bx = 0, by = 0;
+    GtkTextIter iter;
+    if (keyboard_mode) {
+        gtk_text_buffer_get_iter_at_mark(c->buf, &iter, gtk_text_buffer_get_insert(c->buf));
+    } else {
+        gtk_text_view_window_to_buffer_coords(c->tv, GTK_TEXT_WINDOW_WIDGET, x, y, &bx, &by);
+        if (!gtk_text_view_get_iter_at_location(c->tv, &iter, bx, by)) return FALSE;
+    }
+    int line = gtk_text_iter_get_line(&iter);
+    if (line < 0 || line >= (int)c->lines->len) return FALSE;
+    LineState *ls = &g_array_index(c->lines, LineState, line);
+    if (!ls->msg) return FALSE;
+    gtk_tooltip_set_text(tooltip, ls->msg);
+    return TRUE;
+}
+
+HyprChecker *hypr_checker_attach(GtkTextView *tv, const char *path, GtkLabel *summary)
+{
+    HyprChecker *c = g_new0(HyprChecker, 1);
+    c->tv = tv;
+    c->buf = gtk_text_view_get_buffer(tv);
+    c->summary = summary;
+    c->dir = g_path_get_dirname(path);
+
+    c->lines = g_array_new(FALSE, TRUE, sizeof(LineState));
+    g_array_set_clear_func(c->lines, line_state_clear);
+    g_array_set_size(c->lines, (guint)gtk_text_buffer_get_line_count(c->buf));
+    mark_dirty(c, 0, (int)c->lines->len - 1);
+
+    c->tag_error = gtk_text_buffer_create_tag(c->buf, "hypr-error",
+                                              "underline", PANGO_UNDERLINE_ERROR,
+                                              "underline-rgba", &(GdkRGBA){ 0.86f, 0.15f, 0.15f, 1.0f },
+                                              NULL);
+    c->tag_warning = gtk_text_buffer_create_tag(c->buf, "hypr-warning",
+                                                "underline", PANGO_UNDERLINE_ERROR,
+                                                "underline-rgba", &(GdkRGBA){ 0.93f, 0.60f, 0.05f, 1.0f },
+                                                NULL);
+
+    g_signal_connect(c->buf, "insert-text", G_CALLBACK(on_insert_text), c);
+    g_signal_connect(c->buf, "delete-range", G_CALLBACK(on_delete_range), c);
+    gtk_widget_set_has_tooltip(GTK_WIDGET(tv), TRUE);
+    g_signal_connect(tv, "query-tooltip", G_CALLBACK(on_query_tooltip), c);
+
+    schedule_check(c);
+    return c;
+}
+
+void hypr_checker_set_blocked(HyprChecker *c, gboolean blocked)
+{
+    c->blocked = blocked;
+    if (blocked) {
+        if (c->timeout_id) {
+            g_source_remove(c->timeout_id);
+            c->timeout_id = 0;
+        }
+        return;
+    }
+    hypr_checker_recheck(c);
+}
+
+void hypr_checker_recheck(HyprChecker *c)
+{
+    mark_dirty(c, 0, (int)c->lines->len - 1);
+    schedule_check(c);
+}
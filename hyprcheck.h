@@ -0,0 +1,22 @@
+/* hyprcheck.h - on-the-fly diagnostics for the Hyprland config editor */
+#ifndef HYPRCHECK_H
+#define HYPRCHECK_H
+
+#include <gtk/gtk.h>
+
+typedef struct HyprChecker HyprChecker;
+
+/* Attach a checker to `tv`. Edits schedule a debounced re-scan of the changed
+ * lines on a worker; results are shown as error/warning tags with tooltips and
+ * summarised in `summary` (may be NULL). `path` is used to resolve `source =`
+ * lines relative to the config directory. */
+HyprChecker *hypr_checker_attach(GtkTextView *tv, const char *path, GtkLabel *summary);
+
+/* While blocked (e.g. during a bulk load) line tracking continues but no
+ * checks are scheduled; unblocking re-checks the whole buffer. */
+void hypr_checker_set_blocked(HyprChecker *c, gboolean blocked);
+
+/* Re-check the whole buffer, e.g. after a sourced file changed on disk. */
+void hypr_checker_recheck(HyprChecker *c);
+
+#endif /* HYPRCHECK_H */
@@ -0,0 +1,336 @@
+/* hyprclients.c - live model of Hyprland's clients (windows) */
+#include "hyprclients.h"
+#include "hypripc.h"
+#include <json-glib/json-glib.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Settle time before re-reading clients after events that leave size/pid
+ * unknown; a burst of events costs one request */
+#define HYPR_CLIENTS_RESYNC_MS 300
+
+struct _HyprClient {
+    GObject parent_instance;
+    char *address;
+    char *klass;
+    char *title;
+    char *initial_class;
+    char *initial_title;
+    char *workspace;
+    int workspace_id;
+    int width, height;
+    gboolean floating;
+    int pid;
+};
+
+enum {
+    PROP_0,
+    PROP_CLASS,
+    PROP_TITLE,
+    PROP_INITIAL_CLASS,
+    PROP_INITIAL_TITLE,
+    PROP_WORKSPACE,
+    PROP_SIZE,
+    PROP_FLOATING,
+    PROP_PID,
+    N_PROPS
+};
+
+static GParamSpec *props[N_PROPS];
+
+G_DEFINE_FINAL_TYPE(HyprClient, hypr_client, G_TYPE_OBJECT)
+
+static void hypr_client_finalize(GObject *obj)
+{
+    HyprClient *c = HYPR_CLIENT(obj);
+    g_free(c->address);
+    g_free(c->klass);
+    g_free(c->title);
+    g_free(c->initial_class);
+    g_free(c->initial_title);
+    g_free(c->workspace);
+    G_OBJECT_CLASS(hypr_client_parent_class)->finalize(obj);
+}
+
+static void hypr_client_get_property(GObject *obj, guint id, GValue *value, GParamSpec *pspec)
+{
+    HyprClient *c = HYPR_CLIENT(obj);
+    switch (id) {
+    case PROP_CLASS: g_value_set_string(value, c->klass); break;
+    case PROP_TITLE: g_value_set_string(value, c->title); break;
+    case PROP_INITIAL_CLASS: g_value_set_string(value, c->initial_class); break;
+    case PROP_INITIAL_TITLE: g_value_set_string(value, c->initial_title); break;
+    case PROP_WORKSPACE: g_value_set_string(value, c->workspace); break;
+    case PROP_SIZE: g_value_take_string(value, g_strdup_printf("%d×%d", c->width, c->height)); break;
+    case PROP_FLOATING: g_value_set_boolean(value, c->floating); break;
+    case PROP_PID: g_value_set_int(value, c->pid); break;
+    default: G_OBJECT_WARN_INVALID_PROPERTY_ID(obj, id, pspec);
+    }
+}
+
+static void hypr_client_class_init(HyprClientClass *klass)
+{
+    GObjectClass *oc = G_OBJECT_CLASS(klass);
+    oc->finalize = hypr_client_finalize;
+    oc->get_property = hypr_client_get_property;
+    props[PROP_CLASS] = g_param_spec_string("class", NULL, NULL, NULL, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
+    props[PROP_TITLE] = g_param_spec_string("title", NULL, NULL, NULL, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
+    props[PROP_INITIAL_CLASS] = g_param_spec_string("initial-class", NULL, NULL, NULL, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
+    props[PROP_INITIAL_TITLE] = g_param_spec_string("initial-title", NULL, NULL, NULL, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
+    props[PROP_WORKSPACE] = g_param_spec_string("workspace", NULL, NULL, NULL, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
+    props[PROP_SIZE] = g_param_spec_string("size", NULL, NULL, NULL, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
+    props[PROP_FLOATING] = g_param_spec_boolean("floating", NULL, NULL, FALSE, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
+    props[PROP_PID] = g_param_spec_int("pid", NULL, NULL, -1, G_MAXINT, 0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
+    g_object_class_install_properties(oc, N_PROPS, props);
+}
+
+static void hypr_client_init(HyprClient *c)
+{
+    c->workspace_id = -1;
+    c->pid = -1;
+}
+
+const char *hypr_client_get_address(HyprClient *c) { return c->address; }
+const char *hypr_client_get_class(HyprClient *c) { return c->klass ? c->klass : ""; }
+const char *hypr_client_get_title(HyprClient *c) { return c->title ? c->title : ""; }
+const char *hypr_client_get_initial_class(HyprClient *c) { return c->initial_class ? c->initial_class : hypr_client_get_class(c); }
+const char *hypr_client_get_initial_title(HyprClient *c) { return c->initial_title ? c->initial_title : hypr_client_get_title(c); }
+const char *hypr_client_get_workspace(HyprClient *c) { return c->workspace ? c->workspace : ""; }
+int hypr_client_get_workspace_id(HyprClient *c) { return c->workspace_id; }
+int hypr_client_get_width(HyprClient *c) { return c->width; }
+int hypr_client_get_height(HyprClient *c) { return c->height; }
+gboolean hypr_client_get_floating(HyprClient *c) { return c->floating; }
+int hypr_client_get_pid(HyprClient *c) { return c->pid; }
+
+/* Setters notify only when the value actually changes */
+static void set_str(HyprClient *c, char **field, const char *v, int prop)
+{
+    if (!v || g_strcmp0(*field, v) == 0) return;
+    g_free(*field);
+    *field = g_strdup(v);
+    if (prop) g_object_notify_by_pspec(G_OBJECT(c), props[prop]);
+}
+
+static void set_workspace(HyprClient *c, int id, const char *name)
+{
+    gboolean changed = c->workspace_id != id;
+    c->workspace_id = id;
+    if (name && g_strcmp0(c->workspace, name) != 0) {
+        g_free(c->workspace);
+        c->workspace = g_strdup(name);
+        changed = TRUE;
+    }
+    if (changed) g_object_notify_by_pspec(G_OBJECT(c), props[PROP_WORKSPACE]);
+}
+
+static void set_size(HyprClient *c, int w, int h)
+{
+    if (c->width == w && c->height == h) return;
+    c->width = w;
+    c->height = h;
+    g_object_notify_by_pspec(G_OBJECT(c), props[PROP_SIZE]);
+}
+
+static void set_floating(HyprClient *c, gboolean f)
+{
+    if (c->floating == f) return;
+    c->floating = f;
+    g_object_notify_by_pspec(G_OBJECT(c), props[PROP_FLOATING]);
+}
+
+static void set_pid(HyprClient *c, int pid)
+{
+    if (c->pid == pid) return;
+    c->pid = pid;
+    g_object_notify_by_pspec(G_OBJECT(c), props[PROP_PID]);
+}
+
+/* The shared model */
+typedef struct {
+    GListStore *store;
+    GHashTable *by_address;  /* address -> HyprClient (borrowed from store) */
+    HyprEvents *events;
+    guint resync_id;
+    gboolean resync_running;
+    gboolean resync_again;
+} ClientsModel;
+
+static ClientsModel *model;
+
+static const char *strip_0x(const char *addr)
+{
+    return g_str_has_prefix(addr, "0x") ? addr + 2 : addr;
+}
+
+static HyprClient *lookup(const char *addr)
+{
+    return g_hash_table_lookup(model->by_address, strip_0x(addr));
+}
+
+static HyprClient *add_client(const char *addr)
+{
+    HyprClient *c = g_object_new(HYPR_TYPE_CLIENT, NULL);
+    c->address = g_strdup(strip_0x(addr));
+    g_hash_table_insert(model->by_address, c->address, c);
+    g_list_store_append(model->store, c);
+    g_object_unref(c);
+    return c;
+}
+
+static void remove_client(HyprClient *c)
+{
+    guint pos;
+    g_hash_table_remove(model->by_address, c->address);
+    if (g_list_store_find(model->store, c, &pos)) g_list_store_remove(model->store, pos);
+}
+
+static void apply_clients_json(const char *json)
+{
+    JsonParser *parser = json_parser_new();
+    if (!json_parser_load_from_data(parser, json, -1, NULL) || !JSON_NODE_HOLDS_ARRAY(json_parser_get_root(parser))) {
+        g_object_unref(parser);
+        return;
+    }
+    JsonArray *arr = json_node_get_array(json_parser_get_root(parser));
+    GHashTable *seen = g_hash_table_new(g_str_hash, g_str_equal);
+
+    for (guint i = 0; i < json_array_get_length(arr); i++) {
+        JsonObject *o = json_array_get_object_element(arr, i);
+        const char *addr = o ? json_object_get_string_member_with_default(o, "address", NULL) : NULL;
+        if (!addr) continue;
+        HyprClient *c = lookup(addr);
+        if (!c) c = add_client(addr);
+        g_hash_table_add(seen, c->address);
+
+        set_str(c, &c->klass, json_object_get_string_member_with_default(o, "class", ""), PROP_CLASS);
+        set_str(c, &c->title, json_object_get_string_member_with_default(o, "title", ""), PROP_TITLE);
+        set_str(c, &c->initial_class, json_object_get_string_member_with_default(o, "initialClass", ""), PROP_INITIAL_CLASS);
+        set_str(c, &c->initial_title, json_object_get_string_member_with_default(o, "initialTitle", ""), PROP_INITIAL_TITLE);
+        JsonObject *ws = json_object_has_member(o, "workspace") ? json_object_get_object_member(o, "workspace") : NULL;
+        if (ws) set_workspace(c, (int)json_object_get_int_member_with_default(ws, "id", -1),
+                              json_object_get_string_member_with_default(ws, "name", ""));
+        JsonArray *size = json_object_has_member(o, "size") ? json_object_get_array_member(o, "size") : NULL;
+        if (size && json_array_get_length(size) == 2) {
+            set_size(c, (int)json_array_get_int_element(size, 0), (int)json_array_get_int_element(size, 1));
+        }
+        set_floating(c, json_object_get_boolean_member_with_default(o, "floating", FALSE));
+        set_pid(c, (int)json_object_get_int_member_with_default(o, "pid", -1));
+    }
+
+    /* drop clients that closed without us seeing the event */
+    for (guint i = g_list_model_get_n_items(G_LIST_MODEL(model->store)); i-- > 0;) {
+        HyprClient *c = g_list_model_get_item(G_LIST_MODEL(model->store), i);
+        if (!g_hash_table_contains(seen, c->address)) remove_client(c);
+        g_object_unref(c);
+    }
+    g_hash_table_destroy(seen);
+    g_object_unref(parser);
+}
+
+static void schedule_resync(void);
+
+static void on_clients_read(GObject *source, GAsyncResult *res, gpointer user_data)
+{
+    gchar *reply = hypr_ipc_request_finish(res, NULL);
+    model->resync_running = FALSE;
+    if (reply) apply_clients_json(reply);
+    g_free(reply);
+    if (model->resync_again) {
+        model->resync_again = FALSE;
+        schedule_resync();
+    }
+}
+
+static gboolean do_resync(gpointer user_data)
+{
+    model->resync_id = 0;
+    if (model->resync_running) {
+        model->resync_again = TRUE;
+        return G_SOURCE_REMOVE;
+    }
+    model->resync_running = TRUE;
+    hypr_ipc_request_async("j/clients", 3000, NULL, on_clients_read, NULL);
+    return G_SOURCE_REMOVE;
+}
+
+static void schedule_resync(void)
+{
+    if (model->resync_id) g_source_remove(model->resync_id);
+    model->resync_id = g_timeout_add(HYPR_CLIENTS_RESYNC_MS, do_resync, NULL);
+}
+
+static void on_event(const char *event, const char *data, gpointer user_data)
+{
+    if (!event) {
+        /* compositor exited; keep the last known state on screen */
+        hypr_events_free(model->events);
+        model->events = NULL;
+        return;
+    }
+
+    /* the last field keeps any further commas (titles may contain them) */
+    if (strcmp(event, "openwindow") == 0) {
+        gchar **f = g_strsplit(data, ",", 4);
+        if (g_strv_length(f) == 4 && !lookup(f[0])) {
+            HyprClient *c = add_client(f[0]);
+            set_str(c, &c->klass, f[2], PROP_CLASS);
+            set_str(c, &c->title, f[3], PROP_TITLE);
+            set_workspace(c, -1, f[1]);
+        }
+        g_strfreev(f);
+        schedule_resync();  /* size, pid, workspace id */
+    } else if (strcmp(event, "closewindow") == 0) {
+        HyprClient *c = lookup(data);
+        if (c) remove_client(c);
+    } else if (strcmp(event, "movewindowv2") == 0) {
+        gchar **f = g_strsplit(data, ",", 3);
+        HyprClient *c = g_strv_length(f) == 3 ? lookup(f[0]) : NULL;
+        if (c) set_workspace(c, atoi(f[1]), f[2]);
+        g_strfreev(f);
+        schedule_resync();  /* the move may have tiled it to a new size */
+    } else if (strcmp(event, "windowtitlev2") == 0) {
+        gchar **f = g_strsplit(data, ",", 2);
+        HyprClient *c = g_strv_length(f) == 2 ? lookup(f[0]) : NULL;
+        if (c) set_str(c, &c->title, f[1], PROP_TITLE);
+        g_strfreev(f);
+    } else if (strcmp(event, "changefloatingmode") == 0) {
+        gchar **f = g_strsplit(data, ",", 2);
+        HyprClient *c = g_strv_length(f) == 2 ? lookup(f[0]) : NULL;
+        if (c) set_floating(c, f[1][0] == '1');
+        g_strfreev(f);
+        schedule_resync();
+    } else if (strcmp(event, "renameworkspace") == 0) {
+        gchar **f = g_strsplit(data, ",", 2);
+        if (g_strv_length(f) == 2) {
+            int id = atoi(f[0]);
+            for (guint i = 0; i < g_list_model_get_n_items(G_LIST_MODEL(model->store)); i++) {
+                HyprClient *c = g_list_model_get_item(G_LIST_MODEL(model->store), i);
+                if (c->workspace_id == id) set_workspace(c, id, f[1]);
+                g_object_unref(c);
+            }
+        }
+        g_strfreev(f);
+    } else if (strcmp(event, "fullscreen") == 0 || strcmp(event, "moveworkspacev2") == 0 ||
+               strcmp(event, "monitorremoved") == 0 || strcmp(event, "monitoradded") == 0) {
+        schedule_resync();
+    }
+}
+
+GListModel *hypr_clients_get_default(void)
+{
+    if (model) return G_LIST_MODEL(model->store);
+    model = g_new0(ClientsModel, 1);
+    model->store = g_list_store_new(HYPR_TYPE_CLIENT);
+    model->by_address = g_hash_table_new(g_str_hash, g_str_equal);
+
+    /* subscribe before the initial read so nothing falls in between; the
+     * read is applied as a diff either way */
+    model->events = hypr_events_subscribe(on_event, NULL, NULL);
+    if (model->events) do_resync(NULL);
+    return G_LIST_MODEL(model->store);
+}
+
+gboolean hypr_clients_is_live(void)
+{
+    return model && model->events;
+}
@@ -0,0 +1,33 @@
+/* hyprclients.h - live model of Hyprland's clients (windows) */
+#ifndef HYPRCLIENTS_H
+#define HYPRCLIENTS_H
+
+#include <gio/gio.h>
+
+#define HYPR_TYPE_CLIENT (hypr_client_get_type())
+G_DECLARE_FINAL_TYPE(HyprClient, hypr_client, HYPR, CLIENT, GObject)
+
+/* Address without the "0x" prefix, as the event socket reports it */
+const char *hypr_client_get_address(HyprClient *c);
+const char *hypr_client_get_class(HyprClient *c);
+const char *hypr_client_get_title(HyprClient *c);
+const char *hypr_client_get_initial_class(HyprClient *c);
+const char *hypr_client_get_initial_title(HyprClient *c);
+const char *hypr_client_get_workspace(HyprClient *c);
+int hypr_client_get_workspace_id(HyprClient *c);
+int hypr_client_get_width(HyprClient *c);
+int hypr_client_get_height(HyprClient *c);
+gboolean hypr_client_get_floating(HyprClient *c);
+int hypr_client_get_pid(HyprClient *c);
+
+/* Shared GListModel of HyprClient. Created on first use from one `j/clients`
+ * request, then kept current by applying event-socket deltas to the existing
+ * items (properties are notified individually); fields the events do not
+ * carry (size, pid) are refreshed by a debounced re-read that is diffed in
+ * place. Empty when Hyprland is not running. */
+GListModel *hypr_clients_get_default(void);
+
+/* Whether the model is connected to a running compositor */
+gboolean hypr_clients_is_live(void);
+
+#endif /* HYPRCLIENTS_H */
@@ -0,0 +1,268 @@
+/* hyprconf.c - Hyprland config line scanner and include-graph helpers */
+#include "hyprconf.h"
+#include <string.h>
+
+/* Keywords accepted outside any category (hyprlang "special" handlers). */
+static const char *toplevel_keywords[] = {
+    "monitor", "workspace", "source", "env", "envd",
+    "exec", "exec-once", "execr", "execr-once", "exec-shutdown",
+    "unbind", "windowrule", "windowrulev2", "layerrule",
+    "animation", "bezier", "submap", "plugin", "permission",
+    "blurls", "gesture",
+    NULL
+};
+
+/* Categories (top-level and nested) known to Hyprland. */
+static const char *categories[] = {
+    "general", "decoration", "animations", "input", "gestures", "group",
+    "misc", "binds", "xwayland", "opengl", "render", "cursor", "debug",
+    "ecosystem", "experimental", "dwindle", "master", "device", "plugin",
+    "blur", "shadow", "touchpad", "touchdevice", "tablet", "groupbar",
+    "snap", "virtualkeyboard", "quirks",
+    NULL
+};
+
+static const char *exec_keywords[] = {
+    "exec", "exec-once", "execr", "execr-once", "exec-shutdown", NULL
+};
+
+static gboolean in_table(const char **table, const char *s, gsize len)
+{
+    for (int i = 0; table[i]; i++) {
+        if (strlen(table[i]) == len && strncmp(table[i], s, len) == 0) return TRUE;
+    }
+    return FALSE;
+}
+
+/* bind, binde, bindl, bindm, ... : "bind" followed only by flag letters */
+static gboolean is_bind_keyword(const char *key, gsize len)
+{
+    if (len < 4 || strncmp(key, "bind", 4) != 0) return FALSE;
+    for (gsize i = 4; i < len; i++) {
+        if (!strchr(HYPR_BIND_FLAGS, key[i])) return FALSE;
+    }
+    return TRUE;
+}
+
+gboolean hypr_conf_is_toplevel_keyword(const char *key, gsize len)
+{
+    if (in_table(toplevel_keywords, key, len) || is_bind_keyword(key, len)) return TRUE;
+    /* category:option = value is valid at the top level */
+    const char *colon = memchr(key, ':', len);
+    if (colon) return hypr_conf_is_category(key, (gsize)(colon - key));
+    return FALSE;
+}
+
+gboolean hypr_conf_is_category(const char *name, gsize len)
+{
+    /* device[name] { ... } is the legacy per-device form */
+    const char *br = memchr(name, '[', len);
+    if (br) len = (gsize)(br - name);
+    return in_table(categories, name, len);
+}
+
+gboolean hypr_conf_is_exec_keyword(const char *key, gsize len)
+{
+    return in_table(exec_keywords, key, len);
+}
+
+static void trim_span(const char **s, gsize *len)
+{
+    while (*len > 0 && g_ascii_isspace((*s)[0])) { (*s)++; (*len)--; }
+    while (*len > 0 && g_ascii_isspace((*s)[*len - 1])) (*len)--;
+}
+
+void hypr_conf_scan_line(const char *line, gssize len, HyprLine *out)
+{
+    memset(out, 0, sizeof(*out));
+    gsize n = len < 0 ? strlen(line) : (gsize)len;
+
+    /* '#' starts a comment; '##' is an escaped literal '#' */
+    gsize code_len = n;
+    gboolean has_comment = FALSE;
+    for (gsize i = 0; i < n; i++) {
+        if (line[i] != '#') continue;
+        if (i + 1 < n && line[i + 1] == '#') { i++; continue; }
+        code_len = i;
+        has_comment = TRUE;
+        break;
+    }
+
+    const char *s = line;
+    gsize sl = code_len;
+    trim_span(&s, &sl);
+    if (sl == 0) {
+        out->kind = has_comment ? HYPR_LINE_COMMENT : HYPR_LINE_BLANK;
+        return;
+    }
+
+    const char *eq = memchr(s, '=', sl);
+    const char *ob = memchr(s, '{', sl);
+
+    if (s[0] == '}') {
+        out->kind = HYPR_LINE_CATEGORY_CLOSE;
+        for (gsize i = 0; i < sl; i++) if (s[i] == '}') out->closes++;
+        return;
+    }
+
+    if (ob && (!eq || ob < eq)) {
+        out->kind = HYPR_LINE_CATEGORY_OPEN;
+        out->key = s;
+        out->key_len = (gsize)(ob - s);
+        trim_span(&out->key, &out->key_len);
+        for (gsize i = 0; i < sl; i++) {
+            if (s[i] == '{') out->opens++;
+            else if (s[i] == '}') out->closes++;
+        }
+        return;
+    }
+
+    if (!eq) {
+        out->kind = HYPR_LINE_INVALID;
+        out->key = s;
+        out->key_len = sl;
+        return;
+    }
+
+    out->key = s;
+    out->key_len = (gsize)(eq - s);
+    trim_span(&out->key, &out->key_len);
+    out->value = eq + 1;
+    out->value_len = sl - (gsize)(eq + 1 - s);
+    trim_span(&out->value, &out->value_len);
+
+    if (out->key_len > 0 && out->key[0] == '$') {
+        out->kind = HYPR_LINE_VARIABLE;
+        out->key++;
+        out->key_len--;
+    } else {
+        out->kind = HYPR_LINE_ASSIGN;
+    }
+}
+
+void hypr_conf_foreach_variable_use(const char *value, gsize len, HyprVarFunc fn, gpointer user_data)
+{
+    for (gsize i = 0; i < len; i++) {
+        if (value[i] != '$') continue;
+        gsize j = i + 1;
+        while (j < len && (g_ascii_isalnum(value[j]) || value[j] == '_')) j++;
+        if (j > i + 1) fn(value + i + 1, j - i - 1, user_data);
+        i = j - 1;
+    }
+}
+
+GPtrArray *hypr_conf_resolve_source(const char *value, gsize len, const char *base_dir)
+{
+    GPtrArray *out = g_ptr_array_new_with_free_func(g_free);
+    char *v = g_strndup(value, len);
+    char *path;
+    if (v[0] == '~') {
+        path = g_build_filename(g_get_home_dir(), v + 1, NULL);
+    } else if (g_path_is_absolute(v)) {
+        path = g_strdup(v);
+    } else {
+        path = g_build_filename(base_dir, v, NULL);
+    }
+    g_free(v);
+
+    char *base = g_path_get_basename(path);
+    if (strpbrk(base, "*?")) {
+        char *dir = g_path_get_dirname(path);
+        GDir *d = g_dir_open(dir, 0, NULL);
+        if (d) {
+            const char *name;
+            while ((name = g_dir_read_name(d)) != NULL) {
+                if (g_pattern_match_simple(base, name)) {
+                    g_ptr_array_add(out, g_build_filename(dir, name, NULL));
+                }
+            }
+            g_dir_close(d);
+        }
+        g_free(dir);
+        g_free(path);
+    } else {
+        g_ptr_array_add(out, path);
+    }
+    g_free(base);
+    return out;
+}
+
+void hypr_conf_collect_variables(const char *path, GArray *quarks, GHashTable *visited)
+{
+    gboolean own_visited = visited == NULL;
+    if (own_visited) visited = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+    if (g_hash_table_contains(visited, path)) goto out;
+    g_hash_table_add(visited, g_strdup(path));
+
+    gchar *content = NULL;
+    gsize clen = 0;
+    if (!g_file_get_contents(path, &content, &clen, NULL)) goto out;
+
+    char *dir = g_path_get_dirname(path);
+    const char *p = content;
+    const char *end = content + clen;
+    while (p < end) {
+        const char *nl = memchr(p, '\n', (gsize)(end - p));
+        gsize ll = nl ? (gsize)(nl - p) : (gsize)(end - p);
+        HyprLine hl;
+        hypr_conf_scan_line(p, (gssize)ll, &hl);
+        if (hl.kind == HYPR_LINE_VARIABLE) {
+            char *name = g_strndup(hl.key, hl.key_len);
+            GQuark q = g_quark_from_string(name);
+            g_array_append_val(quarks, q);
+            g_free(name);
+        } else if (hl.kind == HYPR_LINE_ASSIGN && hl.key_len == 6 && strncmp(hl.key, "source", 6) == 0) {
+            GPtrArray *srcs = hypr_conf_resolve_source(hl.value, hl.value_len, dir);
+            for (guint i = 0; i < srcs->len; i++) {
+                hypr_conf_collect_variables(g_ptr_array_index(srcs, i), quarks, visited);
+            }
+            g_ptr_array_unref(srcs);
+        }
+        p += ll + 1;
+    }
+    g_free(dir);
+    g_free(content);
+
+out:
+    if (own_visited) g_hash_table_destroy(visited);
+}
+
+static void include_graph_visit(const char *path, GPtrArray *out, GHashTable *seen)
+{
+    if (g_hash_table_contains(seen, path)) return;
+    g_hash_table_add(seen, g_strdup(path));
+    g_ptr_array_add(out, g_strdup(path));
+
+    gchar *content = NULL;
+    gsize clen = 0;
+    if (!g_file_get_contents(path, &content, &clen, NULL)) return;
+
+    char *dir = g_path_get_dirname(path);
+    const char *p = content;
+    const char *end = content + clen;
+    while (p < end) {
+        const char *nl = memchr(p, '\n', (gsize)(end - p));
+        gsize ll = nl ? (gsize)(nl - p) : (gsize)(end - p);
+        HyprLine hl;
+        hypr_conf_scan_line(p, (gssize)ll, &hl);
+        if (hl.kind == HYPR_LINE_ASSIGN && hl.key_len == 6 && strncmp(hl.key, "source", 6) == 0) {
+            GPtrArray *srcs = hypr_conf_resolve_source(hl.value, hl.value_len, dir);
+            for (guint i = 0; i < srcs->len; i++) {
+                include_graph_visit(g_ptr_array_index(srcs, i), out, seen);
+            }
+            g_ptr_array_unref(srcs);
+        }
+        p += ll + 1;
+    }
+    g_free(dir);
+    g_free(content);
+}
+
+GPtrArray *hypr_conf_include_graph(const char *root)
+{
+    GPtrArray *out = g_ptr_array_new_with_free_func(g_free);
+    GHashTable *seen = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+    include_graph_visit(root, out, seen);
+    g_hash_table_destroy(seen);
+    return out;
+}
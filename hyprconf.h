@@ -0,0 +1,57 @@
+/* hyprconf.h - Hyprland config line scanner and include-graph helpers */
+#ifndef HYPRCONF_H
+#define HYPRCONF_H
+
+#include <glib.h>
+
+typedef enum {
+    HYPR_LINE_BLANK,
+    HYPR_LINE_COMMENT,
+    HYPR_LINE_ASSIGN,          /* key = value */
+    HYPR_LINE_VARIABLE,        /* $name = value */
+    HYPR_LINE_CATEGORY_OPEN,   /* name { */
+    HYPR_LINE_CATEGORY_CLOSE,  /* } */
+    HYPR_LINE_INVALID
+} HyprLineKind;
+
+/* Result of scanning one line. key/value point into the scanned line and are
+ * not NUL-terminated; lengths exclude surrounding whitespace and comments. */
+typedef struct {
+    HyprLineKind kind;
+    const char *key;
+    gsize key_len;
+    const char *value;
+    gsize value_len;
+    int opens;   /* '{' outside comments */
+    int closes;  /* '}' outside comments */
+} HyprLine;
+
+/* Scan a single line (without the trailing newline). `len` may be -1. */
+void hypr_conf_scan_line(const char *line, gssize len, HyprLine *out);
+
+/* Flag letters Hyprland accepts after "bind" (binde, bindl, bindm, ...) */
+#define HYPR_BIND_FLAGS "lrcgoenmtidspu"
+
+/* Keyword tables */
+gboolean hypr_conf_is_toplevel_keyword(const char *key, gsize len);
+gboolean hypr_conf_is_category(const char *name, gsize len);
+gboolean hypr_conf_is_exec_keyword(const char *key, gsize len);
+
+/* Call `fn` for each "$name" reference in `value`. */
+typedef void (*HyprVarFunc)(const char *name, gsize len, gpointer user_data);
+void hypr_conf_foreach_variable_use(const char *value, gsize len, HyprVarFunc fn, gpointer user_data);
+
+/* Resolve the value of a `source =` line (handles ~, relative paths and a
+ * glob in the last component). Returns a GPtrArray of newly-allocated
+ * absolute paths; free with g_ptr_array_unref(). */
+GPtrArray *hypr_conf_resolve_source(const char *value, gsize len, const char *base_dir);
+
+/* Collect the quarks of every $variable defined in `path` and the files it
+ * sources. `visited` guards against include cycles (may be NULL). */
+void hypr_conf_collect_variables(const char *path, GArray *quarks, GHashTable *visited);
+
+/* `root` followed by every file it sources, recursively, without duplicates.
+ * Reads files; call from a worker for large configs. */
+GPtrArray *hypr_conf_include_graph(const char *root);
+
+#endif /* HYPRCONF_H */
@@ -0,0 +1,339 @@
+/* hyprinput.c - keyboard layout section of the Hyprland page */
+#include "hyprinput.h"
+#include "hypripc.h"
+#include "xkbreg.h"
+#include "common.h"
+#include <json-glib/json-glib.h>
+#include <string.h>
+
+/* Rows shown for a search; the registry has ~1500 entries */
+#define HYPR_INPUT_MAX_RESULTS 200
+
+static const char *kb_options[] = { "input:kb_layout", "input:kb_variant", "input:kb_options" };
+
+typedef struct {
+    GtkLabel *status;
+    GtkWidget *entries[3];  /* parallel to kb_options */
+    GtkWidget *search_entry;
+    GtkWidget *summary;
+    GtkWidget *apply_btn;
+    GtkStringList *model;   /* display rows, parallel to `hits` */
+    GArray *hits;           /* guint registry indices */
+    XkbRegistry *reg;
+    gboolean started;
+} HyprInput;
+
+typedef struct {
+    HyprInput *in;
+    int which;
+} OptionRead;
+
+static void on_option_read(GObject *source, GAsyncResult *res, gpointer user_data)
+{
+    OptionRead *r = user_data;
+    gchar *reply = hypr_ipc_request_finish(res, NULL);
+    JsonParser *parser = json_parser_new();
+    if (reply && json_parser_load_from_data(parser, reply, -1, NULL) &&
+        JSON_NODE_HOLDS_OBJECT(json_parser_get_root(parser))) {
+        JsonObject *o = json_node_get_object(json_parser_get_root(parser));
+        const char *str = json_object_get_string_member_with_default(o, "str", "");
+        /* Hyprland reports an unset string option as "[[EMPTY]]" */
+        if (strcmp(str, "[[EMPTY]]") == 0) str = "";
+        gtk_editable_set_text(GTK_EDITABLE(r->in->entries[r->which]), str);
+    }
+    g_object_unref(parser);
+    g_free(reply);
+    g_free(r);
+}
+
+static void read_current(HyprInput *in)
+{
+    char *sock = hypr_ipc_socket_path(".socket.sock");
+    if (!sock) return;
+    g_free(sock);
+    for (int i = 0; i < 3; i++) {
+        OptionRead *r = g_new0(OptionRead, 1);
+        r->in = in;
+        r->which = i;
+        char *req = g_strdup_printf("j/getoption %s", kb_options[i]);
+        hypr_ipc_request_async(req, 3000, NULL, on_option_read, r);
+        g_free(req);
+    }
+}
+
+static void run_search(HyprInput *in)
+{
+    if (!in->reg) return;
+    const char *q = gtk_editable_get_text(GTK_EDITABLE(in->search_entry));
+    g_array_set_size(in->hits, 0);
+    GArray *found = *q ? xkb_reg_search(in->reg, q, HYPR_INPUT_MAX_RESULTS) : NULL;
+    if (found) {
+        g_array_append_vals(in->hits, found->data, found->len);
+        g_array_unref(found);
+    }
+
+    guint n = 0;
+    const XkbRegEntry *all = xkb_reg_entries(in->reg, &n);
+    const char **rows = g_new0(const char *, in->hits->len + 1);
+    for (guint i = 0; i < in->hits->len; i++) {
+        const XkbRegEntry *e = &all[g_array_index(in->hits, guint, i)];
+        switch (e->kind) {
+        case XKB_REG_VARIANT:
+            rows[i] = g_strdup_printf("Variant: %s(%s) — %s", e->parent >= 0 ? all[e->parent].name : "?",
+                                      e->name, e->description);
+            break;
+        case XKB_REG_OPTION:
+            rows[i] = g_strdup_printf("Option: %s — %s", e->name, e->description);
+            break;
+        default:
+            rows[i] = g_strdup_printf("Layout: %s — %s", e->name, e->description);
+            break;
+        }
+    }
+    gtk_string_list_splice(in->model, 0, g_list_model_get_n_items(G_LIST_MODEL(in->model)), (const char * const *)rows);
+    for (guint i = 0; i < in->hits->len; i++) g_free((char *)rows[i]);
+    g_free(rows);
+
+    char *summary = *q ? g_strdup_printf("%u match%s%s", in->hits->len, in->hits->len == 1 ? "" : "es",
+                                         in->hits->len == HYPR_INPUT_MAX_RESULTS ? " (showing the best)" : "")
+                       : g_strdup_printf("%u layouts, variants and options indexed", n);
+    gtk_label_set_text(GTK_LABEL(in->summary), summary);
+    g_free(summary);
+}
+
+static void on_registry_loaded(GObject *source, GAsyncResult *res, gpointer user_data)
+{
+    HyprInput *in = user_data;
+    GError *err = NULL;
+    in->reg = xkb_reg_load_finish(res, &err);
+    if (!in->reg) {
+        gtk_label_set_text(GTK_LABEL(in->summary), err ? err->message : "XKB registry unavailable");
+        g_clear_error(&err);
+        return;
+    }
+    gtk_widget_set_sensitive(in->search_entry, TRUE);
+    run_search(in);
+}
+
+static void on_expanded(GObject *exp, GParamSpec *pspec, gpointer user_data)
+{
+    HyprInput *in = user_data;
+    if (in->started || !gtk_expander_get_expanded(GTK_EXPANDER(exp))) return;
+    in->started = TRUE;
+    gtk_label_set_text(GTK_LABEL(in->summary), "Loading XKB registry…");
+    xkb_reg_load_async(NULL, on_registry_loaded, in);
+    read_current(in);
+}
+
+static void on_search_changed(GtkSearchEntry *e, gpointer user_data)
+{
+    run_search((HyprInput *)user_data);
+}
+
+/* Comma lists are positional: variant i belongs to layout i */
+static GPtrArray *split_list(GtkWidget *entry)
+{
+    GPtrArray *out = g_ptr_array_new_with_free_func(g_free);
+    const char *text = gtk_editable_get_text(GTK_EDITABLE(entry));
+    if (!*text) return out;
+    gchar **parts = g_strsplit(text, ",", -1);
+    for (guint i = 0; parts[i]; i++) g_ptr_array_add(out, g_strdup(g_strstrip(parts[i])));
+    g_strfreev(parts);
+    return out;
+}
+
+static void join_list(GtkWidget *entry, GPtrArray *items, gboolean drop_if_empty)
+{
+    gboolean any = FALSE;
+    for (guint i = 0; i < items->len; i++) any |= *(char *)g_ptr_array_index(items, i) != '\0';
+    g_ptr_array_add(items, NULL);
+    char *text = drop_if_empty && !any ? g_strdup("") : g_strjoinv(",", (char **)items->pdata);
+    g_ptr_array_remove_index(items, items->len - 1);
+    gtk_editable_set_text(GTK_EDITABLE(entry), text);
+    g_free(text);
+}
+
+static void add_layout(HyprInput *in, const char *layout, const char *variant)
+{
+    GPtrArray *layouts = split_list(in->entries[0]);
+    GPtrArray *variants = split_list(in->entries[1]);
+    while (variants->len < layouts->len) g_ptr_array_add(variants, g_strdup(""));
+    g_ptr_array_set_size(variants, layouts->len);
+
+    gboolean placed = FALSE;
+    for (guint i = 0; i < layouts->len && !placed; i++) {
+        if (strcmp(g_ptr_array_index(layouts, i), layout) != 0) continue;
+        const char *cur = g_ptr_array_index(variants, i);
+        if (!variant) placed = TRUE;
+        else if (!*cur || strcmp(cur, variant) == 0) {
+            g_free(g_ptr_array_index(variants, i));
+            g_ptr_array_index(variants, i) = g_strdup(variant);
+            placed = TRUE;
+        }
+    }
+    if (!placed) {
+        g_ptr_array_add(layouts, g_strdup(layout));
+        g_ptr_array_add(variants, g_strdup(variant ? variant : ""));
+    }
+    join_list(in->entries[0], layouts, FALSE);
+    join_list(in->entries[1], variants, TRUE);
+    g_ptr_array_unref(layouts);
+    g_ptr_array_unref(variants);
+}
+
+static void toggle_option(HyprInput *in, const char *option)
+{
+    GPtrArray *opts = split_list(in->entries[2]);
+    gboolean removed = FALSE;
+    for (guint i = opts->len; i-- > 0;) {
+        if (strcmp(g_ptr_array_index(opts, i), option) == 0) {
+            g_ptr_array_remove_index(opts, i);
+            removed = TRUE;
+        }
+    }
+    if (!removed) g_ptr_array_add(opts, g_strdup(option));
+    join_list(in->entries[2], opts, TRUE);
+    g_ptr_array_unref(opts);
+}
+
+static void on_result_activated(GtkListView *view, guint position, gpointer user_data)
+{
+    HyprInput *in = user_data;
+    if (!in->reg || position >= in->hits->len) return;
+    const XkbRegEntry *all = xkb_reg_entries(in->reg, NULL);
+    const XkbRegEntry *e = &all[g_array_index(in->hits, guint, position)];
+    if (e->kind == XKB_REG_LAYOUT) add_layout(in, e->name, NULL);
+    else if (e->kind == XKB_REG_VARIANT && e->parent >= 0) add_layout(in, all[e->parent].name, e->name);
+    else if (e->kind == XKB_REG_OPTION) toggle_option(in, e->name);
+}
+
+static void on_applied(GObject *source, GAsyncResult *res, gpointer user_data)
+{
+    HyprInput *in = user_data;
+    GError *err = NULL;
+    gchar *reply = hypr_ipc_request_finish(res, &err);
+    gtk_widget_set_sensitive(in->apply_btn, TRUE);
+    if (!reply) {
+        set_status(in->status, "Applying the keyboard layout failed: %s", err ? err->message : "unknown error");
+        g_clear_error(&err);
+        return;
+    }
+    /* a batch answers "ok" per command; anything else is an error text */
+    char *p = reply;
+    while (g_str_has_prefix(p, "ok")) {
+        p += 2;
+        while (*p && g_ascii_isspace(*p)) p++;
+    }
+    if (*p) set_status(in->status, "Hyprland reported: %s", g_strstrip(p));
+    else set_status(in->status, "Keyboard layout applied");
+    g_free(reply);
+}
+
+static void on_apply_clicked(GtkButton *btn, gpointer user_data)
+{
+    HyprInput *in = user_data;
+    GString *batch = g_string_new("[[BATCH]]");
+    for (int i = 0; i < 3; i++) {
+        const char *v = gtk_editable_get_text(GTK_EDITABLE(in->entries[i]));
+        if (strchr(v, ';')) {
+            set_status(in->status, "%s must not contain ';'", kb_options[i]);
+            g_string_free(batch, TRUE);
+            return;
+        }
+        g_string_append_printf(batch, "%skeyword %s %s", i ? ";" : "", kb_options[i], v);
+    }
+    if (g_dry_run) {
+        set_status(in->status, "Dry run: would send %s", batch->str);
+        g_string_free(batch, TRUE);
+        return;
+    }
+    gtk_widget_set_sensitive(in->apply_btn, FALSE);
+    hypr_ipc_request_async(batch->str, 3000, NULL, on_applied, in);
+    g_string_free(batch, TRUE);
+}
+
+static void on_reset_clicked(GtkButton *btn, gpointer user_data)
+{
+    read_current((HyprInput *)user_data);
+}
+
+static void result_setup(GtkSignalListItemFactory *f, GtkListItem *li, gpointer user_data)
+{
+    GtkWidget *label = gtk_label_new("");
+    gtk_label_set_xalign(GTK_LABEL(label), 0);
+    gtk_label_set_ellipsize(GTK_LABEL(label), PANGO_ELLIPSIZE_END);
+    gtk_list_item_set_child(li, label);
+}
+
+static void result_bind(GtkSignalListItemFactory *f, GtkListItem *li, gpointer user_data)
+{
+    GtkStringObject *so = gtk_list_item_get_item(li);
+    gtk_label_set_text(GTK_LABEL(gtk_list_item_get_child(li)), gtk_string_object_get_string(so));
+}
+
+GtkWidget *hypr_input_panel_new(GtkLabel *status)
+{
+    HyprInput *in = g_new0(HyprInput, 1);
+    in->status = status;
+    in->model = gtk_string_list_new(NULL);
+    in->hits = g_array_new(FALSE, FALSE, sizeof(guint));
+
+    GtkWidget *exp = gtk_expander_new("Input: keyboard layout");
+    g_signal_connect(exp, "notify::expanded", G_CALLBACK(on_expanded), in);
+    GtkWidget *v = gtk_box_new(GTK_ORIENTATION_VERTICAL, 6);
+    gtk_expander_set_child(GTK_EXPANDER(exp), v);
+
+    static const char *titles[] = { "Layouts", "Variants", "Options" };
+    static const char *hints[] = { "us,de", "one per layout, e.g. ,nodeadkeys", "caps:escape,grp:alt_shift_toggle" };
+    GtkWidget *grid = gtk_grid_new();
+    gtk_grid_set_row_spacing(GTK_GRID(grid), 6);
+    gtk_grid_set_column_spacing(GTK_GRID(grid), 8);
+    for (int i = 0; i < 3; i++) {
+        GtkWidget *l = gtk_label_new(titles[i]);
+        gtk_widget_set_halign(l, GTK_ALIGN_START);
+        gtk_grid_attach(GTK_GRID(grid), l, 0, i, 1, 1);
+        in->entries[i] = gtk_entry_new();
+        gtk_entry_set_placeholder_text(GTK_ENTRY(in->entries[i]), hints[i]);
+        gtk_widget_set_hexpand(in->entries[i], TRUE);
+        gtk_grid_attach(GTK_GRID(grid), in->entries[i], 1, i, 1, 1);
+    }
+    gtk_box_append(GTK_BOX(v), grid);
+
+    in->search_entry = gtk_search_entry_new();
+    gtk_search_entry_set_placeholder_text(GTK_SEARCH_ENTRY(in->search_entry), "Search layouts, variants and options");
+    gtk_search_entry_set_search_delay(GTK_SEARCH_ENTRY(in->search_entry), 50);
+    gtk_widget_set_sensitive(in->search_entry, FALSE);
+    g_signal_connect(in->search_entry, "search-changed", G_CALLBACK(on_search_changed), in);
+    gtk_box_append(GTK_BOX(v), in->search_entry);
+
+    in->summary = gtk_label_new("");
+    gtk_widget_set_halign(in->summary, GTK_ALIGN_START);
+    gtk_box_append(GTK_BOX(v), in->summary);
+
+    GtkListItemFactory *f = gtk_signal_list_item_factory_new();
+    g_signal_connect(f, "setup", G_CALLBACK(result_setup), NULL);
+    g_signal_connect(f, "bind", G_CALLBACK(result_bind), NULL);
+    GtkWidget *list = gtk_list_view_new(GTK_SELECTION_MODEL(gtk_single_selection_new(G_LIST_MODEL(g_object_ref(in->model)))), f);
+    gtk_list_view_set_single_click_activate(GTK_LIST_VIEW(list), TRUE);
+    g_signal_connect(list, "activate", G_CALLBACK(on_result_activated), in);
+    GtkWidget *sc = gtk_scrolled_window_new();
+    gtk_widget_set_size_request(sc, -1, 160);
+    gtk_scrolled_window_set_child(GTK_SCROLLED_WINDOW(sc), list);
+    gtk_box_append(GTK_BOX(v), sc);
+
+    GtkWidget *h = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 8);
+    GtkWidget *hint = gtk_label_new("Click a result to add it (options toggle). Apply takes effect immediately and is not saved to the config.");
+    gtk_label_set_wrap(GTK_LABEL(hint), TRUE);
+    gtk_widget_set_hexpand(hint, TRUE);
+    gtk_widget_set_halign(hint, GTK_ALIGN_START);
+    gtk_box_append(GTK_BOX(h), hint);
+    GtkWidget *reset = gtk_button_new_with_label("Reset");
+    g_signal_connect(reset, "clicked", G_CALLBACK(on_reset_clicked), in);
+    gtk_box_append(GTK_BOX(h), reset);
+    in->apply_btn = gtk_button_new_with_label("Apply");
+    g_signal_connect(in->apply_btn, "clicked", G_CALLBACK(on_apply_clicked), in);
+    gtk_box_append(GTK_BOX(h), in->apply_btn);
+    gtk_box_append(GTK_BOX(v), h);
+
+    return exp;
+}
@@ -0,0 +1,13 @@
+/* hyprinput.h - keyboard layout section of the Hyprland page */
+#ifndef HYPRINPUT_H
+#define HYPRINPUT_H
+
+#include <gtk/gtk.h>
+
+/* Expander with input:kb_layout/kb_variant/kb_options, filled from the
+ * running compositor, plus a fuzzy search over the XKB registry (loaded on
+ * first expand). Apply sets all three with one `keyword` batch; nothing is
+ * written to the config. */
+GtkWidget *hypr_input_panel_new(GtkLabel *status);
+
+#endif /* HYPRINPUT_H */
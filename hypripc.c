@@ -0,0 +1,228 @@
+/* hypripc.c - minimal client for Hyprland's UNIX-socket IPC */
+#include "hypripc.h"
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <glib-unix.h>
+
+#define HYPR_IPC_DEFAULT_TIMEOUT_MS 5000
+
+char *hypr_ipc_socket_path(const char *socket_name)
+{
+    const char *sig = g_getenv("HYPRLAND_INSTANCE_SIGNATURE");
+    if (!sig || !*sig) return NULL;
+
+    const char *runtime = g_getenv("XDG_RUNTIME_DIR");
+    if (runtime && *runtime) {
+        char *p = g_build_filename(runtime, "hypr", sig, socket_name, NULL);
+        if (g_file_test(p, G_FILE_TEST_EXISTS)) return p;
+        g_free(p);
+    }
+    /* pre-0.40 location */
+    char *legacy = g_build_filename("/tmp", "hypr", sig, socket_name, NULL);
+    if (g_file_test(legacy, G_FILE_TEST_EXISTS)) return legacy;
+    g_free(legacy);
+    return NULL;
+}
+
+/* Connected socket fd for `socket_name`, or -1 */
+static int ipc_connect(const char *socket_name, guint timeout_ms, GError **error)
+{
+    char *path = hypr_ipc_socket_path(socket_name);
+    if (!path) {
+        g_set_error(error, G_IO_ERROR, G_IO_ERROR_NOT_FOUND, "Hyprland is not running (no IPC socket)");
+        return -1;
+    }
+
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        g_set_error(error, G_IO_ERROR, G_IO_ERROR_FILENAME_TOO_LONG, "IPC socket path too long: %s", path);
+        g_free(path);
+        return -1;
+    }
+    g_strlcpy(addr.sun_path, path, sizeof(addr.sun_path));
+    g_free(path);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        g_set_error(error, G_IO_ERROR, g_io_error_from_errno(errno), "socket: %s", g_strerror(errno));
+        return -1;
+    }
+
+    if (timeout_ms) {
+        struct timeval tv = { timeout_ms / 1000, (timeout_ms % 1000) * 1000 };
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+        setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+    }
+
+    if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+        g_set_error(error, G_IO_ERROR, g_io_error_from_errno(errno), "connect: %s", g_strerror(errno));
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static gchar *ipc_request_with_timeout(const char *request, guint timeout_ms, GError **error)
+{
+    int fd = ipc_connect(".socket.sock", timeout_ms, error);
+    if (fd < 0) return NULL;
+
+    gsize len = strlen(request);
+    gsize sent = 0;
+    while (sent < len) {
+        ssize_t n = write(fd, request + sent, len - sent);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) {
+            g_set_error(error, G_IO_ERROR, g_io_error_from_errno(errno), "write: %s", g_strerror(errno));
+            close(fd);
+            return NULL;
+        }
+        sent += (gsize)n;
+    }
+
+    /* Hyprland writes the whole reply and closes the connection */
+    GString *reply = g_string_new(NULL);
+    char buf[8192];
+    for (;;) {
+        ssize_t n = read(fd, buf, sizeof(buf));
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0) {
+            int e = errno;
+            g_set_error(error, G_IO_ERROR, e == EAGAIN || e == EWOULDBLOCK ? G_IO_ERROR_TIMED_OUT : g_io_error_from_errno(e),
+                        "read: %s", e == EAGAIN || e == EWOULDBLOCK ? "timed out" : g_strerror(e));
+            g_string_free(reply, TRUE);
+            close(fd);
+            return NULL;
+        }
+        if (n == 0) break;
+        g_string_append_len(reply, buf, n);
+    }
+    close(fd);
+    return g_string_free(reply, FALSE);
+}
+
+gchar *hypr_ipc_request(const char *request, GError **error)
+{
+    return ipc_request_with_timeout(request, HYPR_IPC_DEFAULT_TIMEOUT_MS, error);
+}
+
+typedef struct {
+    char *request;
+    guint timeout_ms;
+} IpcJob;
+
+static void ipc_job_free(IpcJob *job)
+{
+    g_free(job->request);
+    g_free(job);
+}
+
+static void ipc_thread(GTask *task, gpointer source, gpointer task_data, GCancellable *cancellable)
+{
+    IpcJob *job = (IpcJob *)task_data;
+    GError *err = NULL;
+    gchar *reply = ipc_request_with_timeout(job->request, job->timeout_ms, &err);
+    if (reply) g_task_return_pointer(task, reply, g_free);
+    else g_task_return_error(task, err);
+}
+
+void hypr_ipc_request_async(const char *request, guint timeout_ms, GCancellable *cancellable,
+                            GAsyncReadyCallback callback, gpointer user_data)
+{
+    IpcJob *job = g_new0(IpcJob, 1);
+    job->request = g_strdup(request);
+    job->timeout_ms = timeout_ms ? timeout_ms : HYPR_IPC_DEFAULT_TIMEOUT_MS;
+
+    GTask *task = g_task_new(NULL, cancellable, callback, user_data);
+    g_task_set_task_data(task, job, (GDestroyNotify)ipc_job_free);
+    g_task_set_return_on_cancel(task, TRUE);
+    g_task_run_in_thread(task, ipc_thread);
+    g_object_unref(task);
+}
+
+gchar *hypr_ipc_request_finish(GAsyncResult *res, GError **error)
+{
+    return g_task_propagate_pointer(G_TASK(res), error);
+}
+
+/* Event socket */
+struct HyprEvents {
+    int fd;
+    guint watch_id;
+    GString *pending;      /* partial line carried between reads */
+    HyprEventFunc func;
+    gpointer user_data;
+};
+
+static void events_dispatch_lines(HyprEvents *ev)
+{
+    gsize start = 0;
+    for (gsize i = 0; i < ev->pending->len; i++) {
+        if (ev->pending->str[i] != '\n') continue;
+        ev->pending->str[i] = '\0';
+        char *line = ev->pending->str + start;
+        char *sep = strstr(line, ">>");
+        if (sep) {
+            *sep = '\0';
+            ev->func(line, sep + 2, ev->user_data);
+        }
+        start = i + 1;
+    }
+    g_string_erase(ev->pending, 0, (gssize)start);
+}
+
+static gboolean on_events_readable(gint fd, GIOCondition cond, gpointer user_data)
+{
+    HyprEvents *ev = user_data;
+    char buf[8192];
+    for (;;) {
+        ssize_t n = read(fd, buf, sizeof(buf));
+        if (n > 0) {
+            g_string_append_len(ev->pending, buf, n);
+            continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        /* EOF or error: the compositor went away */
+        events_dispatch_lines(ev);
+        ev->watch_id = 0;
+        close(ev->fd);
+        ev->fd = -1;
+        ev->func(NULL, NULL, ev->user_data);
+        return G_SOURCE_REMOVE;
+    }
+    events_dispatch_lines(ev);
+    return G_SOURCE_CONTINUE;
+}
+
+HyprEvents *hypr_events_subscribe(HyprEventFunc func, gpointer user_data, GError **error)
+{
+    int fd = ipc_connect(".socket2.sock", 0, error);
+    if (fd < 0) return NULL;
+    if (!g_unix_set_fd_nonblocking(fd, TRUE, error)) {
+        close(fd);
+        return NULL;
+    }
+    HyprEvents *ev = g_new0(HyprEvents, 1);
+    ev->fd = fd;
+    ev->pending = g_string_new(NULL);
+    ev->func = func;
+    ev->user_data = user_data;
+    ev->watch_id = g_unix_fd_add(fd, G_IO_IN | G_IO_HUP | G_IO_ERR, on_events_readable, ev);
+    return ev;
+}
+
+void hypr_events_free(HyprEvents *ev)
+{
+    if (!ev) return;
+    if (ev->watch_id) g_source_remove(ev->watch_id);
+    if (ev->fd >= 0) close(ev->fd);
+    g_string_free(ev->pending, TRUE);
+    g_free(ev);
+}
@@ -0,0 +1,30 @@
+/* hypripc.h - minimal client for Hyprland's UNIX-socket IPC */
+#ifndef HYPRIPC_H
+#define HYPRIPC_H
+
+#include <gio/gio.h>
+
+/* Path of a file in the running instance's directory (".socket.sock" for
+ * requests, ".socket2.sock" for events, "hyprland.log"), or NULL when
+ * Hyprland is not running. */
+char *hypr_ipc_socket_path(const char *socket_name);
+
+/* Send one request (e.g. "j/monitors", "reload", "[[BATCH]]...") and return
+ * the full reply. Blocks; call from a worker or use the async variant. */
+gchar *hypr_ipc_request(const char *request, GError **error);
+
+/* Run hypr_ipc_request on a worker thread. Cancelling returns immediately
+ * with G_IO_ERROR_CANCELLED; the reply (if any) is discarded. */
+void hypr_ipc_request_async(const char *request, guint timeout_ms, GCancellable *cancellable,
+                            GAsyncReadyCallback callback, gpointer user_data);
+gchar *hypr_ipc_request_finish(GAsyncResult *res, GError **error);
+
+/* Subscription to the event socket (".socket2.sock"). `func` runs on the
+ * main loop once per "EVENT>>DATA" line; when the compositor closes the
+ * socket it is called a last time with event == NULL. */
+typedef struct HyprEvents HyprEvents;
+typedef void (*HyprEventFunc)(const char *event, const char *data, gpointer user_data);
+HyprEvents *hypr_events_subscribe(HyprEventFunc func, gpointer user_data, GError **error);
+void hypr_events_free(HyprEvents *ev);
+
+#endif /* HYPRIPC_H */
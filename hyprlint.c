@@ -0,0 +1,436 @@
+/* hyprlint.c - schema-driven lint of Hyprland option values
+ *
+ * Hyprland describes every option (type, range, choices) via the
+ * `descriptions` IPC request. That reply is ~100 KiB of JSON, so it is
+ * fetched once per Hyprland build, converted to a GVariant (compact,
+ * mmap-able, no parsing on load) and stored in the user cache directory keyed
+ * by the build's commit hash. */
+#include "hyprlint.h"
+#include "hyprconf.h"
+#include "hypripc.h"
+#include <json-glib/json-glib.h>
+#include <glib/gstdio.h>
+#include <math.h>
+#include <string.h>
+
+#define SCHEMA_FORMAT_VERSION 1
+#define SCHEMA_VARIANT_TYPE "(usa(syddas))"
+
+/* Option types as numbered by Hyprland's ConfigDescriptions */
+enum {
+    OPT_BOOL = 0,
+    OPT_INT,
+    OPT_FLOAT,
+    OPT_STRING_SHORT,
+    OPT_STRING_LONG,
+    OPT_COLOR,
+    OPT_CHOICE,
+    OPT_GRADIENT,
+    OPT_VECTOR
+};
+
+typedef struct {
+    guint8 type;
+    double min;    /* NAN when unbounded */
+    double max;
+    char **choices;
+} OptDesc;
+
+typedef struct {
+    GHashTable *options;     /* full name -> OptDesc* */
+    GHashTable *categories;  /* every "a", "a:b" prefix that owns options */
+} HyprSchema;
+
+G_LOCK_DEFINE_STATIC(schema_lock);
+static HyprSchema *g_schema = NULL;
+
+void hypr_lint_item_free(HyprLintItem *item)
+{
+    if (!item) return;
+    g_free(item->message);
+    g_free(item);
+}
+
+static void opt_desc_free(gpointer p)
+{
+    OptDesc *o = (OptDesc *)p;
+    g_strfreev(o->choices);
+    g_free(o);
+}
+
+/* Build the binary schema from the `j/descriptions` reply */
+static GVariant *schema_variant_from_json(const char *json, const char *key, GError **error)
+{
+    JsonParser *parser = json_parser_new();
+    if (!json_parser_load_from_data(parser, json, -1, error)) {
+        g_object_unref(parser);
+        return NULL;
+    }
+    JsonNode *root = json_parser_get_root(parser);
+    if (!root || !JSON_NODE_HOLDS_ARRAY(root)) {
+        g_set_error(error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA, "Unexpected descriptions reply");
+        g_object_unref(parser);
+        return NULL;
+    }
+
+    GVariantBuilder b;
+    g_variant_builder_init(&b, G_VARIANT_TYPE("a(syddas)"));
+    JsonArray *arr = json_node_get_array(root);
+    for (guint i = 0; i < json_array_get_length(arr); i++) {
+        JsonNode *n = json_array_get_element(arr, i);
+        if (!JSON_NODE_HOLDS_OBJECT(n)) continue;
+        JsonObject *o = json_node_get_object(n);
+        const char *name = json_object_get_string_member_with_default(o, "value", NULL);
+        if (!name) continue;
+        guint8 type = (guint8)json_object_get_int_member_with_default(o, "type", OPT_STRING_SHORT);
+
+        double min = NAN, max = NAN;
+        char **choices = NULL;
+        JsonNode *dn = json_object_get_member(o, "data");
+        if (dn && JSON_NODE_HOLDS_OBJECT(dn)) {
+            JsonObject *data = json_node_get_object(dn);
+            if (json_object_has_member(data, "min")) min = json_object_get_double_member(data, "min");
+            if (json_object_has_member(data, "max")) max = json_object_get_double_member(data, "max");
+            const char *opts = json_object_get_string_member_with_default(data, "options", NULL);
+            if (!opts) opts = json_object_get_string_member_with_default(data, "choices", NULL);
+            if (opts) choices = g_strsplit(opts, ",", -1);
+        }
+        if (!choices) choices = g_new0(char *, 1);
+        for (char **c = choices; *c; c++) g_strstrip(*c);
+
+        g_variant_builder_add(&b, "(sydd@as)", name, type, min, max,
+                              g_variant_new_strv((const gchar * const *)choices, -1));
+        g_strfreev(choices);
+    }
+    g_object_unref(parser);
+
+    return g_variant_ref_sink(g_variant_new("(us@a(syddas))", SCHEMA_FORMAT_VERSION, key,
+                                            g_variant_builder_end(&b)));
+}
+
+static HyprSchema *schema_from_variant(GVariant *v)
+{
+    HyprSchema *s = g_new0(HyprSchema, 1);
+    s->options = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, opt_desc_free);
+    s->categories = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+
+    guint32 fmt = 0;
+    const char *key = NULL;
+    GVariantIter *it = NULL;
+    g_variant_get(v, "(u&sa(syddas))", &fmt, &key, &it);
+
+    const char *name;
+    guint8 type;
+    double min, max;
+    char **choices;
+    while (g_variant_iter_next(it, "(&sydd^as)", &name, &type, &min, &max, &choices)) {
+        OptDesc *o = g_new0(OptDesc, 1);
+        o->type = type;
+        o->min = min;
+        o->max = max;
+        o->choices = choices;
+        g_hash_table_replace(s->options, g_strdup(name), o);
+        for (const char *c = strchr(name, ':'); c; c = strchr(c + 1, ':')) {
+            g_hash_table_add(s->categories, g_strndup(name, (gsize)(c - name)));
+        }
+    }
+    g_variant_iter_free(it);
+    return s;
+}
+
+static GVariant *schema_load_cached(const char *path, const char *key)
+{
+    GMappedFile *mf = g_mapped_file_new(path, FALSE, NULL);
+    if (!mf) return NULL;
+    GBytes *bytes = g_mapped_file_get_bytes(mf);
+    g_mapped_file_unref(mf);
+
+    GVariant *v = g_variant_ref_sink(g_variant_new_from_bytes(G_VARIANT_TYPE(SCHEMA_VARIANT_TYPE), bytes, FALSE));
+    g_bytes_unref(bytes);
+
+    guint32 fmt = 0;
+    const char *vkey = NULL;
+    g_variant_get_child(v, 0, "u", &fmt);
+    g_variant_get_child(v, 1, "&s", &vkey);
+    if (fmt != SCHEMA_FORMAT_VERSION || g_strcmp0(vkey, key) != 0) {
+        g_variant_unref(v);
+        return NULL;
+    }
+    return v;
+}
+
+/* Key the cache by commit hash (or a digest of the whole version reply for
+ * builds that do not report one). */
+static char *schema_cache_key(const char *version_json)
+{
+    char *key = NULL;
+    JsonParser *parser = json_parser_new();
+    if (json_parser_load_from_data(parser, version_json, -1, NULL)) {
+        JsonNode *root = json_parser_get_root(parser);
+        if (root && JSON_NODE_HOLDS_OBJECT(root)) {
+            JsonObject *o = json_node_get_object(root);
+            const char *commit = json_object_get_string_member_with_default(o, "commit", NULL);
+            gboolean dirty = json_object_get_boolean_member_with_default(o, "dirty", FALSE);
+            if (commit && *commit && !dirty) key = g_strdup(commit);
+        }
+    }
+    g_object_unref(parser);
+    if (!key) key = g_compute_checksum_for_string(G_CHECKSUM_SHA1, version_json, -1);
+    return key;
+}
+
+static HyprSchema *schema_get(GError **error)
+{
+    G_LOCK(schema_lock);
+    if (g_schema) {
+        G_UNLOCK(schema_lock);
+        return g_schema;
+    }
+
+    HyprSchema *result = NULL;
+    gchar *version = hypr_ipc_request("j/version", error);
+    if (!version) goto out;
+
+    char *key = schema_cache_key(version);
+    char *dir = g_build_filename(g_get_user_cache_dir(), "aser-settings", NULL);
+    char *name = g_strdup_printf("hypr-schema-%s.gvariant", key);
+    char *path = g_build_filename(dir, name, NULL);
+
+    GVariant *v = schema_load_cached(path, key);
+    if (!v) {
+        gchar *json = hypr_ipc_request("j/descriptions", error);
+        if (json) {
+            v = schema_variant_from_json(json, key, error);
+            g_free(json);
+        }
+        if (v) {
+            g_mkdir_with_parents(dir, 0700);
+            g_file_set_contents(path, g_variant_get_data(v), (gssize)g_variant_get_size(v), NULL);
+        }
+    }
+    if (v) {
+        result = g_schema = schema_from_variant(v);
+        g_variant_unref(v);
+    }
+
+    g_free(path);
+    g_free(name);
+    g_free(dir);
+    g_free(key);
+    g_free(version);
+out:
+    G_UNLOCK(schema_lock);
+    return result;
+}
+
+/* Value checkers */
+
+static gboolean parse_number(const char *v, gboolean integer, double *out)
+{
+    char *end = NULL;
+    if (integer) {
+        gint64 i = g_ascii_strtoll(v, &end, 0);
+        *out = (double)i;
+    } else {
+        *out = g_ascii_strtod(v, &end);
+    }
+    return end && end != v && *end == '\0';
+}
+
+static gboolean is_hex(const char *s, gsize n)
+{
+    for (gsize i = 0; i < n; i++) if (!g_ascii_isxdigit(s[i])) return FALSE;
+    return TRUE;
+}
+
+static gboolean is_color(const char *v)
+{
+    gsize n = strlen(v);
+    if (g_str_has_prefix(v, "0x")) return n == 10 && is_hex(v + 2, 8);
+    if (g_str_has_prefix(v, "rgba(") && v[n - 1] == ')') {
+        if (n == 14 && is_hex(v + 5, 8)) return TRUE;
+        return strchr(v, ',') != NULL;
+    }
+    if (g_str_has_prefix(v, "rgb(") && v[n - 1] == ')') {
+        if (n == 11 && is_hex(v + 4, 6)) return TRUE;
+        return strchr(v, ',') != NULL;
+    }
+    double d;
+    return parse_number(v, TRUE, &d);
+}
+
+static gboolean is_gradient(const char *v)
+{
+    char **toks = g_strsplit_set(v, " \t", -1);
+    int colors = 0;
+    gboolean ok = TRUE;
+    for (int i = 0; toks[i] && ok; i++) {
+        if (!*toks[i]) continue;
+        if (g_str_has_suffix(toks[i], "deg") && !toks[i + 1]) break;
+        if (is_color(toks[i])) colors++;
+        else ok = FALSE;
+    }
+    g_strfreev(toks);
+    return ok && colors > 0;
+}
+
+static gboolean is_bool(const char *v)
+{
+    static const char *ok[] = { "true", "false", "yes", "no", "on", "off", "1", "0", NULL };
+    for (int i = 0; ok[i]; i++) if (g_ascii_strcasecmp(v, ok[i]) == 0) return TRUE;
+    return FALSE;
+}
+
+static char *check_value(const OptDesc *o, const char *name, const char *v)
+{
+    double d;
+    switch (o->type) {
+    case OPT_BOOL:
+        if (!is_bool(v)) return g_strdup_printf("%s: expected a boolean, got '%s'", name, v);
+        break;
+    case OPT_INT:
+    case OPT_FLOAT:
+        if (!parse_number(v, o->type == OPT_INT, &d)) {
+            return g_strdup_printf("%s: expected %s, got '%s'", name, o->type == OPT_INT ? "an integer" : "a number", v);
+        }
+        if ((!isnan(o->min) && d < o->min) || (!isnan(o->max) && d > o->max)) {
+            return g_strdup_printf("%s: %s is outside [%g, %g]", name, v, o->min, o->max);
+        }
+        break;
+    case OPT_COLOR:
+        if (!is_color(v)) return g_strdup_printf("%s: '%s' is not a color (rgba(RRGGBBAA), rgb(RRGGBB) or 0xAARRGGBB)", name, v);
+        break;
+    case OPT_GRADIENT:
+        if (!is_gradient(v)) return g_strdup_printf("%s: '%s' is not a gradient (colors optionally followed by an angle, e.g. 45deg)", name, v);
+        break;
+    case OPT_CHOICE:
+        if (o->choices && o->choices[0] && !g_strv_contains((const gchar * const *)o->choices, v) && !parse_number(v, TRUE, &d)) {
+            char *list = g_strjoinv(", ", o->choices);
+            char *msg = g_strdup_printf("%s: '%s' is not one of %s", name, v, list);
+            g_free(list);
+            return msg;
+        }
+        break;
+    case OPT_VECTOR: {
+        char **parts = g_strsplit_set(v, " ,", -1);
+        int nums = 0;
+        gboolean ok = TRUE;
+        for (int i = 0; parts[i]; i++) {
+            if (!*parts[i]) continue;
+            if (parse_number(parts[i], FALSE, &d)) nums++;
+            else ok = FALSE;
+        }
+        g_strfreev(parts);
+        if (!ok || nums != 2) return g_strdup_printf("%s: expected two numbers, got '%s'", name, v);
+        break;
+    }
+    default:
+        break;
+    }
+    return NULL;
+}
+
+static void add_item(GPtrArray *items, int line, gboolean error, char *message)
+{
+    HyprLintItem *it = g_new0(HyprLintItem, 1);
+    it->line = line;
+    it->error = error;
+    it->message = message;
+    g_ptr_array_add(items, it);
+}
+
+/* Single pass over the text tracking the category path */
+static GPtrArray *lint_text(HyprSchema *schema, const char *text)
+{
+    GPtrArray *items = g_ptr_array_new_with_free_func((GDestroyNotify)hypr_lint_item_free);
+    GPtrArray *stack = g_ptr_array_new_with_free_func(g_free);
+    int opaque_depth = 0;  /* inside device/plugin blocks: options not described */
+    GString *full = g_string_new(NULL);
+
+    const char *p = text;
+    const char *end = text + strlen(text);
+    for (int line = 0; p <= end; line++) {
+        const char *nl = memchr(p, '\n', (gsize)(end - p));
+        gsize ll = nl ? (gsize)(nl - p) : (gsize)(end - p);
+        HyprLine hl;
+        hypr_conf_scan_line(p, (gssize)ll, &hl);
+        p += ll + 1;
+
+        if (hl.kind == HYPR_LINE_CATEGORY_OPEN) {
+            char *cat = g_strndup(hl.key, hl.key_len);
+            if (opaque_depth > 0 || g_str_has_prefix(cat, "device") || g_str_equal(cat, "plugin")) opaque_depth++;
+            g_ptr_array_add(stack, cat);
+            for (int k = 0; k < hl.closes && stack->len > 0; k++) {
+                g_ptr_array_remove_index(stack, stack->len - 1);
+                if (opaque_depth > 0) opaque_depth--;
+            }
+            continue;
+        }
+        if (hl.kind == HYPR_LINE_CATEGORY_CLOSE) {
+            for (int k = 0; k < hl.closes && stack->len > 0; k++) {
+                g_ptr_array_remove_index(stack, stack->len - 1);
+                if (opaque_depth > 0) opaque_depth--;
+            }
+            continue;
+        }
+        if (hl.kind != HYPR_LINE_ASSIGN || opaque_depth > 0) continue;
+        if (stack->len == 0 && !memchr(hl.key, ':', hl.key_len)) continue; /* keyword, not an option */
+
+        g_string_truncate(full, 0);
+        for (guint i = 0; i < stack->len; i++) {
+            g_string_append(full, g_ptr_array_index(stack, i));
+            g_string_append_c(full, ':');
+        }
+        g_string_append_len(full, hl.key, (gssize)hl.key_len);
+
+        const OptDesc *o = g_hash_table_lookup(schema->options, full->str);
+        if (!o) {
+            /* only flag typos inside categories the schema knows about */
+            char *colon = strrchr(full->str, ':');
+            char *cat = colon ? g_strndup(full->str, (gsize)(colon - full->str)) : NULL;
+            if (cat && g_hash_table_contains(schema->categories, cat)) {
+                add_item(items, line, FALSE, g_strdup_printf("Unknown option '%s'", full->str));
+            }
+            g_free(cat);
+            continue;
+        }
+
+        char *value = g_strndup(hl.value, hl.value_len);
+        if (!strchr(value, '$')) { /* variables are only known at runtime */
+            char *msg = check_value(o, full->str, value);
+            if (msg) add_item(items, line, TRUE, msg);
+        }
+        g_free(value);
+        if (!nl) break;
+    }
+
+    g_string_free(full, TRUE);
+    g_ptr_array_free(stack, TRUE);
+    return items;
+}
+
+static void lint_thread(GTask *task, gpointer source, gpointer task_data, GCancellable *cancellable)
+{
+    GError *err = NULL;
+    HyprSchema *schema = schema_get(&err);
+    if (!schema) {
+        g_task_return_error(task, err);
+        return;
+    }
+    GPtrArray *items = lint_text(schema, (const char *)task_data);
+    g_task_return_pointer(task, items, (GDestroyNotify)g_ptr_array_unref);
+}
+
+void hypr_lint_async(const char *text, GCancellable *cancellable,
+                     GAsyncReadyCallback callback, gpointer user_data)
+{
+    GTask *task = g_task_new(NULL, cancellable, callback, user_data);
+    g_task_set_task_data(task, g_strdup(text), g_free);
+    g_task_run_in_thread(task, lint_thread);
+    g_object_unref(task);
+}
+
+GPtrArray *hypr_lint_finish(GAsyncResult *res, GError **error)
+{
+    return g_task_propagate_pointer(G_TASK(res), error);
+}
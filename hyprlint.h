@@ -0,0 +1,23 @@
+/* hyprlint.h - schema-driven lint of Hyprland option values */
+#ifndef HYPRLINT_H
+#define HYPRLINT_H
+
+#include <gio/gio.h>
+
+typedef struct {
+    int line;          /* 0-based line in the linted text */
+    gboolean error;    /* FALSE: warning */
+    char *message;
+} HyprLintItem;
+
+void hypr_lint_item_free(HyprLintItem *item);
+
+/* Type-check every option in `text` against Hyprland's option descriptions.
+ * The schema is fetched over IPC once per Hyprland build and cached under
+ * ~/.cache/aser-settings in binary form. Runs on a worker thread; the result
+ * is a GPtrArray of HyprLintItem* ordered by line. */
+void hypr_lint_async(const char *text, GCancellable *cancellable,
+                     GAsyncReadyCallback callback, gpointer user_data);
+GPtrArray *hypr_lint_finish(GAsyncResult *res, GError **error);
+
+#endif /* HYPRLINT_H */
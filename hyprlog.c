@@ -0,0 +1,477 @@
+/* hyprlog.c - viewer for the running instance's hyprland.log
+ *
+ * The file is memory-mapped (GMappedFile, remapped when it grows) and line
+ * starts are indexed in idle slices, so the first screen shows before a
+ * large log has been scanned. The list model creates a row object only for
+ * lines the view asks for. Level/substring filters scan the mapping on a
+ * worker; lines that arrive later are filtered as they are indexed. */
+#include "hyprlog.h"
+#include "hypripc.h"
+#include "common.h"
+#include <string.h>
+
+/* Bytes scanned for newlines per idle dispatch */
+#define HYPR_LOG_INDEX_SLICE (8 * 1024 * 1024)
+
+enum {
+    LEVEL_ALL,
+    LEVEL_WARN,   /* warnings and errors */
+    LEVEL_ERR
+};
+
+#define HYPR_TYPE_LOG_MODEL (hypr_log_model_get_type())
+G_DECLARE_FINAL_TYPE(HyprLogModel, hypr_log_model, HYPR, LOG_MODEL, GObject)
+
+typedef struct {
+    char *path;
+    GMappedFile *map;
+    const char *data;
+    gsize size;
+    GArray *starts;        /* guint64 line start offsets, see n_lines() */
+    gsize indexed;         /* bytes already scanned for newlines */
+    guint index_id;
+    GFileMonitor *mon;
+    /* filter */
+    int level;
+    char *needle;
+    GArray *rows;          /* guint line numbers passing the filter; NULL when unfiltered */
+    GCancellable *filter_cancel;
+    gboolean filtering;
+    HyprLogModel *model;
+    GtkWidget *list;
+    GtkWidget *summary;
+    GtkWidget *follow_btn;
+    GtkWidget *level_dd;
+    GtkWidget *search;
+} HyprLogView;
+
+/* GListModel over the view's lines; rows are GtkStringObjects made on demand */
+struct _HyprLogModel {
+    GObject parent_instance;
+    HyprLogView *view;     /* NULL once the window is gone */
+};
+
+/* starts[] holds the offset of line 0 plus the offset after every newline
+ * seen, so the last entry opens a line that is not complete yet */
+static guint n_lines(HyprLogView *v)
+{
+    return v->starts->len - 1;
+}
+
+static void hypr_log_model_iface_init(GListModelInterface *iface);
+G_DEFINE_FINAL_TYPE_WITH_CODE(HyprLogModel, hypr_log_model, G_TYPE_OBJECT,
+                              G_IMPLEMENT_INTERFACE(G_TYPE_LIST_MODEL, hypr_log_model_iface_init))
+
+static void hypr_log_model_class_init(HyprLogModelClass *klass) { }
+static void hypr_log_model_init(HyprLogModel *m) { }
+
+static GType model_get_item_type(GListModel *list)
+{
+    return GTK_TYPE_STRING_OBJECT;
+}
+
+static guint model_get_n_items(GListModel *list)
+{
+    HyprLogView *v = ((HyprLogModel *)list)->view;
+    if (!v) return 0;
+    return v->rows ? v->rows->len : n_lines(v);
+}
+
+static void line_span(HyprLogView *v, guint line, const char **s, gsize *len)
+{
+    guint64 start = g_array_index(v->starts, guint64, line);
+    guint64 end = g_array_index(v->starts, guint64, line + 1);
+    *s = v->data + start;
+    *len = end - start;
+    while (*len > 0 && ((*s)[*len - 1] == '\n' || (*s)[*len - 1] == '\r')) (*len)--;
+}
+
+static gpointer model_get_item(GListModel *list, guint pos)
+{
+    HyprLogView *v = ((HyprLogModel *)list)->view;
+    if (!v || pos >= model_get_n_items(list)) return NULL;
+    guint line = v->rows ? g_array_index(v->rows, guint, pos) : pos;
+    const char *s;
+    gsize len;
+    line_span(v, line, &s, &len);
+    char *text = g_utf8_make_valid(s, (gssize)len);
+    GtkStringObject *so = gtk_string_object_new(text);
+    g_free(text);
+    return so;
+}
+
+static void hypr_log_model_iface_init(GListModelInterface *iface)
+{
+    iface->get_item_type = model_get_item_type;
+    iface->get_n_items = model_get_n_items;
+    iface->get_item = model_get_item;
+}
+
+/* Filtering, shared by the worker and the main loop */
+
+static gboolean line_passes(const char *s, gsize len, int level, const char *needle, gsize nlen)
+{
+    if (level != LEVEL_ALL) {
+        /* the tag is near the start, after an optional timestamp */
+        gsize head = MIN(len, 48);
+        gboolean err = g_strstr_len(s, (gssize)head, "[ERR]") || g_strstr_len(s, (gssize)head, "[CRITICAL]");
+        gboolean warn = !err && g_strstr_len(s, (gssize)head, "[WARN]");
+        if (!err && !(warn && level == LEVEL_WARN)) return FALSE;
+    }
+    if (nlen > 0) {
+        if (len < nlen) return FALSE;
+        for (gsize i = 0; i + nlen <= len; i++) {
+            const char *hit = memchr(s + i, needle[0], len - nlen - i + 1);
+            if (!hit) return FALSE;
+            if (memcmp(hit, needle, nlen) == 0) return TRUE;
+            i = (gsize)(hit - s);
+        }
+        return FALSE;
+    }
+    return TRUE;
+}
+
+typedef struct {
+    GMappedFile *map;
+    gsize limit;           /* scan complete lines below this offset */
+    int level;
+    char *needle;
+} FilterJob;
+
+typedef struct {
+    GArray *rows;
+    guint lines;           /* lines scanned */
+} FilterResult;
+
+static void filter_job_free(gpointer p)
+{
+    FilterJob *job = p;
+    g_mapped_file_unref(job->map);
+    g_free(job->needle);
+    g_free(job);
+}
+
+static void filter_result_free(gpointer p)
+{
+    FilterResult *r = p;
+    g_array_unref(r->rows);
+    g_free(r);
+}
+
+static void filter_thread(GTask *task, gpointer source, gpointer task_data, GCancellable *cancellable)
+{
+    FilterJob *job = task_data;
+    const char *data = g_mapped_file_get_contents(job->map);
+    gsize nlen = job->needle ? strlen(job->needle) : 0;
+    FilterResult *r = g_new0(FilterResult, 1);
+    r->rows = g_array_new(FALSE, FALSE, sizeof(guint));
+
+    gsize off = 0;
+    while (off < job->limit) {
+        const char *nl = memchr(data + off, '\n', job->limit - off);
+        if (!nl) break;
+        gsize len = (gsize)(nl - (data + off));
+        if (len > 0 && data[off + len - 1] == '\r') len--;
+        if (line_passes(data + off, len, job->level, job->needle, nlen)) g_array_append_val(r->rows, r->lines);
+        r->lines++;
+        off = (gsize)(nl - data) + 1;
+        if ((r->lines & 0xffff) == 0 && g_cancellable_is_cancelled(cancellable)) {
+            filter_result_free(r);
+            g_task_return_error_if_cancelled(task);
+            return;
+        }
+    }
+    g_task_return_pointer(task, r, filter_result_free);
+}
+
+static void update_summary(HyprLogView *v)
+{
+    char *text;
+    gboolean done = v->indexed >= v->size;
+    if (v->filtering) text = g_strdup_printf("Filtering %u lines…", n_lines(v));
+    else if (v->rows) text = g_strdup_printf("%u of %u lines%s", v->rows->len, n_lines(v), done ? "" : " (indexing…)");
+    else text = g_strdup_printf("%u lines, %.1f MiB%s", n_lines(v), v->size / (1024.0 * 1024.0), done ? "" : " (indexing…)");
+    gtk_label_set_text(GTK_LABEL(v->summary), text);
+    g_free(text);
+}
+
+static void follow_tail(HyprLogView *v)
+{
+    guint n = model_get_n_items(G_LIST_MODEL(v->model));
+    if (n > 0 && gtk_check_button_get_active(GTK_CHECK_BUTTON(v->follow_btn))) {
+        gtk_list_view_scroll_to(GTK_LIST_VIEW(v->list), n - 1, GTK_LIST_SCROLL_NONE, NULL);
+    }
+}
+
+/* Filter lines [from, n_lines) on the main loop and append them */
+static void filter_tail(HyprLogView *v, guint from)
+{
+    if (!v->rows || v->filtering) return;
+    guint before = v->rows->len;
+    gsize nlen = v->needle ? strlen(v->needle) : 0;
+    for (guint line = from; line < n_lines(v); line++) {
+        const char *s;
+        gsize len;
+        line_span(v, line, &s, &len);
+        if (line_passes(s, len, v->level, v->needle, nlen)) g_array_append_val(v->rows, line);
+    }
+    if (v->rows->len > before) g_list_model_items_changed(G_LIST_MODEL(v->model), before, 0, v->rows->len - before);
+}
+
+static gboolean index_slice(gpointer user_data)
+{
+    HyprLogView *v = user_data;
+    guint before = n_lines(v);
+    gsize end = MIN(v->size, v->indexed + HYPR_LOG_INDEX_SLICE);
+    gsize off = v->indexed;
+    const char *nl;
+    while (off < end && (nl = memchr(v->data + off, '\n', end - off))) {
+        off = (gsize)(nl - v->data) + 1;
+        guint64 next = off;
+        g_array_append_val(v->starts, next);
+    }
+    v->indexed = end;
+
+    guint added = n_lines(v) - before;
+    if (added > 0) {
+        if (v->rows) filter_tail(v, before);
+        else g_list_model_items_changed(G_LIST_MODEL(v->model), before, 0, added);
+        follow_tail(v);
+    }
+    update_summary(v);
+    if (v->indexed >= v->size) {
+        v->index_id = 0;
+        return G_SOURCE_REMOVE;
+    }
+    return G_SOURCE_CONTINUE;
+}
+
+static void start_indexing(HyprLogView *v)
+{
+    if (!v->index_id && v->indexed < v->size) v->index_id = g_idle_add(index_slice, v);
+}
+
+static void on_filtered(GObject *source, GAsyncResult *res, gpointer user_data)
+{
+    GError *err = NULL;
+    FilterResult *r = g_task_propagate_pointer(G_TASK(res), &err);
+    if (!r) {
+        /* cancelled: a newer filter (or the window closing) took over */
+        g_clear_error(&err);
+        return;
+    }
+    HyprLogView *v = user_data;
+    guint old = model_get_n_items(G_LIST_MODEL(v->model));
+    if (v->rows) g_array_unref(v->rows);
+    v->rows = g_array_ref(r->rows);
+    v->filtering = FALSE;
+    g_clear_object(&v->filter_cancel);
+    g_list_model_items_changed(G_LIST_MODEL(v->model), 0, old, v->rows->len);
+    filter_tail(v, r->lines);
+    filter_result_free(r);
+    update_summary(v);
+    follow_tail(v);
+}
+
+static void apply_filter(HyprLogView *v)
+{
+    if (v->filter_cancel) {
+        g_cancellable_cancel(v->filter_cancel);
+        g_clear_object(&v->filter_cancel);
+    }
+    const char *q = gtk_editable_get_text(GTK_EDITABLE(v->search));
+    g_free(v->needle);
+    v->needle = *q ? g_strdup(q) : NULL;
+    v->level = (int)gtk_drop_down_get_selected(GTK_DROP_DOWN(v->level_dd));
+    v->filtering = FALSE;
+
+    guint old = model_get_n_items(G_LIST_MODEL(v->model));
+    if (v->level == LEVEL_ALL && !v->needle) {
+        g_clear_pointer(&v->rows, g_array_unref);
+        g_list_model_items_changed(G_LIST_MODEL(v->model), 0, old, n_lines(v));
+        update_summary(v);
+        follow_tail(v);
+        return;
+    }
+
+    /* keep showing the previous result until the new one is ready */
+    v->filtering = TRUE;
+    FilterJob *job = g_new0(FilterJob, 1);
+    job->map = g_mapped_file_ref(v->map);
+    job->limit = (gsize)g_array_index(v->starts, guint64, n_lines(v));
+    job->level = v->level;
+    job->needle = g_strdup(v->needle);
+    v->filter_cancel = g_cancellable_new();
+    GTask *task = g_task_new(NULL, v->filter_cancel, on_filtered, v);
+    g_task_set_task_data(task, job, filter_job_free);
+    g_task_run_in_thread(task, filter_thread);
+    g_object_unref(task);
+    update_summary(v);
+}
+
+static void on_filter_changed(GObject *obj, GParamSpec *pspec, gpointer user_data)
+{
+    apply_filter((HyprLogView *)user_data);
+}
+
+static void on_search_changed(GtkSearchEntry *e, gpointer user_data)
+{
+    apply_filter((HyprLogView *)user_data);
+}
+
+/* Map (or remap after growth) the file; a shorter file means a new log */
+static gboolean log_remap(HyprLogView *v, GError **error)
+{
+    GMappedFile *map = g_mapped_file_new(v->path, FALSE, error);
+    if (!map) return FALSE;
+    gsize size = g_mapped_file_get_length(map);
+    gboolean truncated = v->map && size < v->size;
+    if (truncated) {
+        guint old = model_get_n_items(G_LIST_MODEL(v->model));
+        g_array_set_size(v->starts, 1);
+        v->indexed = 0;
+        if (v->rows) g_array_set_size(v->rows, 0);
+        if (old) g_list_model_items_changed(G_LIST_MODEL(v->model), 0, old, 0);
+    }
+    if (v->map) g_mapped_file_unref(v->map);
+    v->map = map;
+    v->data = g_mapped_file_get_contents(map);
+    v->size = size;
+    /* any filter result refers to the old lines */
+    if (truncated) apply_filter(v);
+    return TRUE;
+}
+
+static void on_log_changed(GFileMonitor *mon, GFile *file, GFile *other, GFileMonitorEvent event, gpointer user_data)
+{
+    HyprLogView *v = user_data;
+    if (event != G_FILE_MONITOR_EVENT_CHANGED && event != G_FILE_MONITOR_EVENT_CREATED) return;
+    if (!log_remap(v, NULL)) return;
+    start_indexing(v);
+    /* a filter running on the old mapping covers the old lines only;
+     * on_filtered picks up the rest */
+}
+
+static void on_window_destroy(GtkWidget *win, gpointer user_data)
+{
+    HyprLogView *v = user_data;
+    if (v->filter_cancel) g_cancellable_cancel(v->filter_cancel);
+    g_clear_object(&v->filter_cancel);
+    if (v->index_id) g_source_remove(v->index_id);
+    if (v->mon) {
+        g_file_monitor_cancel(v->mon);
+        g_object_unref(v->mon);
+    }
+    v->model->view = NULL;
+    g_object_unref(v->model);
+    g_mapped_file_unref(v->map);
+    g_array_unref(v->starts);
+    if (v->rows) g_array_unref(v->rows);
+    g_free(v->needle);
+    g_free(v->path);
+    g_free(v);
+}
+
+static void row_setup(GtkSignalListItemFactory *f, GtkListItem *li, gpointer user_data)
+{
+    GtkWidget *label = gtk_label_new("");
+    gtk_label_set_xalign(GTK_LABEL(label), 0);
+    gtk_label_set_ellipsize(GTK_LABEL(label), PANGO_ELLIPSIZE_END);
+    gtk_label_set_single_line_mode(GTK_LABEL(label), TRUE);
+    gtk_widget_add_css_class(label, "monospace");
+    gtk_list_item_set_child(li, label);
+}
+
+static void row_bind(GtkSignalListItemFactory *f, GtkListItem *li, gpointer user_data)
+{
+    GtkStringObject *so = gtk_list_item_get_item(li);
+    const char *text = gtk_string_object_get_string(so);
+    GtkWidget *label = gtk_list_item_get_child(li);
+    gtk_label_set_text(GTK_LABEL(label), text);
+    gtk_widget_set_tooltip_text(label, strlen(text) > 120 ? text : NULL);
+}
+
+void show_hypr_log_window(GtkLabel *status)
+{
+    char *path = hypr_ipc_socket_path("hyprland.log");
+    if (!path) {
+        set_status(status, "Hyprland is not running; no log to show");
+        return;
+    }
+
+    HyprLogView *v = g_new0(HyprLogView, 1);
+    v->path = path;
+    v->starts = g_array_new(FALSE, FALSE, sizeof(guint64));
+    guint64 zero = 0;
+    g_array_append_val(v->starts, zero);
+    GError *err = NULL;
+    if (!log_remap(v, &err)) {
+        set_status(status, "Could not open %s: %s", path, err->message);
+        g_error_free(err);
+        g_array_unref(v->starts);
+        g_free(v->path);
+        g_free(v);
+        return;
+    }
+    v->model = g_object_new(HYPR_TYPE_LOG_MODEL, NULL);
+    v->model->view = v;
+
+    GtkWidget *dlg = gtk_window_new();
+    gtk_window_set_default_size(GTK_WINDOW(dlg), 900, 600);
+    gtk_window_set_title(GTK_WINDOW(dlg), "Hyprland log");
+
+    GtkWidget *box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 6);
+    gtk_widget_set_margin_start(box, 8);
+    gtk_widget_set_margin_end(box, 8);
+    gtk_widget_set_margin_top(box, 8);
+    gtk_widget_set_margin_bottom(box, 8);
+    gtk_window_set_child(GTK_WINDOW(dlg), box);
+
+    GtkWidget *bar = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 8);
+    static const char *levels[] = { "All levels", "Warnings and errors", "Errors only", NULL };
+    v->level_dd = gtk_drop_down_new_from_strings(levels);
+    g_signal_connect(v->level_dd, "notify::selected", G_CALLBACK(on_filter_changed), v);
+    gtk_box_append(GTK_BOX(bar), v->level_dd);
+    v->search = gtk_search_entry_new();
+    gtk_search_entry_set_placeholder_text(GTK_SEARCH_ENTRY(v->search), "Show lines containing…");
+    gtk_widget_set_hexpand(v->search, TRUE);
+    g_signal_connect(v->search, "search-changed", G_CALLBACK(on_search_changed), v);
+    gtk_box_append(GTK_BOX(bar), v->search);
+    v->follow_btn = gtk_check_button_new_with_label("Follow");
+    gtk_check_button_set_active(GTK_CHECK_BUTTON(v->follow_btn), TRUE);
+    gtk_box_append(GTK_BOX(bar), v->follow_btn);
+    gtk_box_append(GTK_BOX(box), bar);
+
+    GtkListItemFactory *f = gtk_signal_list_item_factory_new();
+    g_signal_connect(f, "setup", G_CALLBACK(row_setup), NULL);
+    g_signal_connect(f, "bind", G_CALLBACK(row_bind), NULL);
+    v->list = gtk_list_view_new(GTK_SELECTION_MODEL(gtk_no_selection_new(G_LIST_MODEL(g_object_ref(v->model)))), f);
+    GtkWidget *sc = gtk_scrolled_window_new();
+    gtk_widget_set_vexpand(sc, TRUE);
+    gtk_widget_set_hexpand(sc, TRUE);
+    gtk_scrolled_window_set_child(GTK_SCROLLED_WINDOW(sc), v->list);
+    gtk_box_append(GTK_BOX(box), sc);
+
+    GtkWidget *h = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 8);
+    v->summary = gtk_label_new("");
+    gtk_widget_set_hexpand(v->summary, TRUE);
+    gtk_widget_set_halign(v->summary, GTK_ALIGN_START);
+    gtk_box_append(GTK_BOX(h), v->summary);
+    GtkWidget *btn = gtk_button_new_with_label("Close");
+    g_signal_connect_swapped(btn, "clicked", G_CALLBACK(gtk_window_destroy), dlg);
+    gtk_box_append(GTK_BOX(h), btn);
+    gtk_box_append(GTK_BOX(box), h);
+
+    GFile *file = g_file_new_for_path(v->path);
+    v->mon = g_file_monitor_file(file, G_FILE_MONITOR_NONE, NULL, NULL);
+    g_object_unref(file);
+    if (v->mon) {
+        g_file_monitor_set_rate_limit(v->mon, 250);
+        g_signal_connect(v->mon, "changed", G_CALLBACK(on_log_changed), v);
+    }
+    g_signal_connect(dlg, "destroy", G_CALLBACK(on_window_destroy), v);
+
+    start_indexing(v);
+    update_summary(v);
+    gtk_window_present(GTK_WINDOW(dlg));
+}
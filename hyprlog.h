@@ -0,0 +1,13 @@
+/* hyprlog.h - viewer for the running instance's hyprland.log */
+#ifndef HYPRLOG_H
+#define HYPRLOG_H
+
+#include <gtk/gtk.h>
+
+/* Open a window on hyprland.log, laid out like show_big_message_dialog()
+ * but backed by a memory-mapped file and a virtualized list, so logs of
+ * hundreds of MB open at once. Appends are followed while it is open.
+ * Reports to `status` when Hyprland is not running. */
+void show_hypr_log_window(GtkLabel *status);
+
+#endif /* HYPRLOG_H */
@@ -0,0 +1,743 @@
+/* hyprrules.c - windowrulev2 rules compiled once and matched against live clients */
+#include "hyprrules.h"
+#include <stdlib.h>
+#include <string.h>
+
+typedef enum {
+    FIELD_CLASS,
+    FIELD_TITLE,
+    FIELD_INITIAL_CLASS,
+    FIELD_INITIAL_TITLE,
+    FIELD_FLOATING,
+    FIELD_WORKSPACE
+} FieldKind;
+
+static const struct {
+    const char *name;
+    FieldKind kind;
+} checked_fields[] = {
+    { "class", FIELD_CLASS },
+    { "title", FIELD_TITLE },
+    { "initialClass", FIELD_INITIAL_CLASS },
+    { "initialTitle", FIELD_INITIAL_TITLE },
+    { "floating", FIELD_FLOATING },
+    { "workspace", FIELD_WORKSPACE },
+};
+
+/* Matchers Hyprland accepts that the client list cannot answer */
+static const char *unchecked_fields[] = {
+    "xwayland", "fullscreen", "pinned", "focus", "group", "onworkspace",
+    "tag", "content", "xdgTag", "fullscreenstate", NULL
+};
+
+/* Effects that accumulate instead of the last matching rule winning */
+static const char *stacking_effects[] = { "tag", NULL };
+
+typedef struct {
+    FieldKind kind;
+    gboolean negative;
+    GRegex *re;            /* class/title fields */
+    char *value;           /* floating/workspace fields */
+} RuleField;
+
+typedef enum {
+    CLASS_NONE,            /* rule has an error and matches nothing */
+    CLASS_ANY,             /* no class matcher */
+    CLASS_LITERAL,         /* class pattern is a plain name or alternation of names */
+    CLASS_REGEX
+} ClassKind;
+
+struct _HyprRule {
+    GObject parent_instance;
+    char *text;
+    char *effect;
+    char *error;
+    char *unchecked;
+    GArray *fields;        /* RuleField */
+    int class_idx;         /* field used for indexing, -1 when none */
+    ClassKind class_kind;
+    char **class_keys;     /* CLASS_LITERAL: the exact classes accepted */
+    GPtrArray *matches;    /* HyprClient* */
+    HyprRule *shadowed_by;
+    int file, line;
+};
+
+enum {
+    PROP_0,
+    PROP_TEXT,
+    PROP_MATCHES,
+    PROP_SHADOWED_BY,
+    N_PROPS
+};
+
+static GParamSpec *props[N_PROPS];
+
+G_DEFINE_FINAL_TYPE(HyprRule, hypr_rule, G_TYPE_OBJECT)
+
+static void rule_field_clear(gpointer p)
+{
+    RuleField *f = p;
+    if (f->re) g_regex_unref(f->re);
+    g_free(f->value);
+}
+
+static void hypr_rule_finalize(GObject *obj)
+{
+    HyprRule *r = HYPR_RULE(obj);
+    g_free(r->text);
+    g_free(r->effect);
+    g_free(r->error);
+    g_free(r->unchecked);
+    g_array_unref(r->fields);
+    g_strfreev(r->class_keys);
+    g_ptr_array_unref(r->matches);
+    G_OBJECT_CLASS(hypr_rule_parent_class)->finalize(obj);
+}
+
+static void hypr_rule_get_property(GObject *obj, guint id, GValue *value, GParamSpec *pspec)
+{
+    HyprRule *r = HYPR_RULE(obj);
+    switch (id) {
+    case PROP_TEXT: g_value_set_string(value, r->text); break;
+    case PROP_MATCHES: g_value_set_uint(value, r->matches->len); break;
+    case PROP_SHADOWED_BY: g_value_set_object(value, r->shadowed_by); break;
+    default: G_OBJECT_WARN_INVALID_PROPERTY_ID(obj, id, pspec);
+    }
+}
+
+static void hypr_rule_class_init(HyprRuleClass *klass)
+{
+    GObjectClass *oc = G_OBJECT_CLASS(klass);
+    oc->finalize = hypr_rule_finalize;
+    oc->get_property = hypr_rule_get_property;
+    props[PROP_TEXT] = g_param_spec_string("text", NULL, NULL, NULL, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
+    props[PROP_MATCHES] = g_param_spec_uint("matches", NULL, NULL, 0, G_MAXUINT, 0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
+    props[PROP_SHADOWED_BY] = g_param_spec_object("shadowed-by", NULL, NULL, HYPR_TYPE_RULE, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
+    g_object_class_install_properties(oc, N_PROPS, props);
+}
+
+static void hypr_rule_init(HyprRule *r)
+{
+    r->fields = g_array_new(FALSE, TRUE, sizeof(RuleField));
+    g_array_set_clear_func(r->fields, rule_field_clear);
+    r->matches = g_ptr_array_new();
+    r->class_idx = -1;
+}
+
+const char *hypr_rule_get_text(HyprRule *r) { return r->text; }
+const char *hypr_rule_get_effect(HyprRule *r) { return r->effect; }
+const char *hypr_rule_get_error(HyprRule *r) { return r->error; }
+const char *hypr_rule_get_unchecked(HyprRule *r) { return r->unchecked; }
+GPtrArray *hypr_rule_get_matches(HyprRule *r) { return r->matches; }
+HyprRule *hypr_rule_get_shadowed_by(HyprRule *r) { return r->shadowed_by; }
+
+void hypr_rule_get_origin(HyprRule *r, int *file, int *line)
+{
+    if (file) *file = r->file;
+    if (line) *line = r->line;
+}
+
+/* The exact classes a class pattern accepts when it has no regex syntax
+ * beyond anchors, one group and alternation ("^(foo|bar)$"), else NULL */
+static char **literal_classes(const char *pat)
+{
+    gsize len = strlen(pat);
+    if (len > 0 && pat[0] == '^') pat++, len--;
+    if (len > 0 && pat[len - 1] == '$' && (len < 2 || pat[len - 2] != '\\')) len--;
+    if (len >= 2 && pat[0] == '(' && pat[len - 1] == ')') pat++, len -= 2;
+    for (gsize i = 0; i < len; i++) {
+        if (strchr(".^$*+?()[]{}\\", pat[i])) return NULL;
+    }
+    char *core = g_strndup(pat, len);
+    char **keys = g_strsplit(core, "|", -1);
+    g_free(core);
+    return keys;
+}
+
+/* Parse and compile `text`. Hyprland splits on commas, but regexes may
+ * contain them, so a piece that does not start with a known "field:" is
+ * glued back onto the previous one. Patterns must match the whole value. */
+static void rule_parse(HyprRule *r, const char *text)
+{
+    g_free(r->text);
+    r->text = g_strdup(text);
+    g_clear_pointer(&r->effect, g_free);
+    g_clear_pointer(&r->error, g_free);
+    g_clear_pointer(&r->unchecked, g_free);
+    g_clear_pointer(&r->class_keys, g_strfreev);
+    g_array_set_size(r->fields, 0);
+    r->class_idx = -1;
+    r->class_kind = CLASS_ANY;
+
+    gchar **pieces = g_strsplit(text, ",", -1);
+    GPtrArray *specs = g_ptr_array_new_with_free_func(g_free);
+    GString *unchecked = g_string_new(NULL);
+    char *effect = g_strstrip(g_strdup(pieces[0] ? pieces[0] : ""));
+    char *space = strpbrk(effect, " \t");
+    r->effect = space ? g_strndup(effect, space - effect) : g_strdup(effect);
+    g_free(effect);
+
+    for (guint i = 1; pieces[0] && pieces[i]; i++) {
+        const char *p = pieces[i];
+        while (g_ascii_isspace(*p)) p++;
+        const char *colon = strchr(p, ':');
+        gboolean known = FALSE;
+        if (colon) {
+            for (guint k = 0; k < G_N_ELEMENTS(checked_fields) && !known; k++) {
+                known = strlen(checked_fields[k].name) == (gsize)(colon - p) &&
+                        strncmp(p, checked_fields[k].name, colon - p) == 0;
+            }
+            for (guint k = 0; unchecked_fields[k] && !known; k++) {
+                known = strlen(unchecked_fields[k]) == (gsize)(colon - p) &&
+                        strncmp(p, unchecked_fields[k], colon - p) == 0;
+            }
+        }
+        if (known || specs->len == 0) {
+            g_ptr_array_add(specs, g_strdup(p));
+        } else {
+            char *prev = g_ptr_array_index(specs, specs->len - 1);
+            g_ptr_array_index(specs, specs->len - 1) = g_strconcat(prev, ",", pieces[i], NULL);
+            g_free(prev);
+        }
+    }
+    g_strfreev(pieces);
+
+    for (guint i = 0; i < specs->len && !r->error; i++) {
+        char *spec = g_strchomp(g_ptr_array_index(specs, i));
+        char *colon = strchr(spec, ':');
+        if (!colon) {
+            r->error = g_strdup_printf("\"%s\" is not a field:value matcher", spec);
+            break;
+        }
+        *colon = '\0';
+        const char *val = colon + 1;
+        int kind = -1;
+        for (guint k = 0; k < G_N_ELEMENTS(checked_fields); k++) {
+            if (strcmp(spec, checked_fields[k].name) == 0) kind = checked_fields[k].kind;
+        }
+        if (kind < 0) {
+            gboolean listed = FALSE;
+            for (guint k = 0; unchecked_fields[k]; k++) listed |= strcmp(spec, unchecked_fields[k]) == 0;
+            if (!listed) {
+                r->error = g_strdup_printf("unknown matcher \"%s\"", spec);
+                break;
+            }
+            if (unchecked->len) g_string_append(unchecked, ", ");
+            g_string_append(unchecked, spec);
+            continue;
+        }
+
+        RuleField f = { (FieldKind)kind, FALSE, NULL, NULL };
+        if (g_str_has_prefix(val, "negative:")) {
+            f.negative = TRUE;
+            val += 9;
+        }
+        if (kind == FIELD_FLOATING || kind == FIELD_WORKSPACE) {
+            f.value = g_strdup(val);
+        } else {
+            GError *err = NULL;
+            char *anchored = g_strdup_printf("^(?:%s)$", val);
+            f.re = g_regex_new(anchored, G_REGEX_OPTIMIZE | G_REGEX_DOLLAR_ENDONLY, 0, &err);
+            g_free(anchored);
+            if (!f.re) {
+                r->error = g_strdup_printf("%s: %s", spec, err->message);
+                g_error_free(err);
+                break;
+            }
+            if (kind == FIELD_CLASS && r->class_idx < 0) {
+                r->class_idx = (int)r->fields->len;
+                r->class_keys = f.negative ? NULL : literal_classes(val);
+                r->class_kind = r->class_keys ? CLASS_LITERAL : CLASS_REGEX;
+            }
+        }
+        g_array_append_val(r->fields, f);
+    }
+    g_ptr_array_unref(specs);
+
+    if (r->error) {
+        g_array_set_size(r->fields, 0);
+        g_clear_pointer(&r->class_keys, g_strfreev);
+        r->class_idx = -1;
+        r->class_kind = CLASS_NONE;
+    }
+    if (unchecked->len) r->unchecked = g_string_free(unchecked, FALSE);
+    else g_string_free(unchecked, TRUE);
+}
+
+static gboolean field_matches(const RuleField *f, HyprClient *c)
+{
+    gboolean ok = FALSE;
+    switch (f->kind) {
+    case FIELD_CLASS: ok = g_regex_match(f->re, hypr_client_get_class(c), 0, NULL); break;
+    case FIELD_TITLE: ok = g_regex_match(f->re, hypr_client_get_title(c), 0, NULL); break;
+    case FIELD_INITIAL_CLASS: ok = g_regex_match(f->re, hypr_client_get_initial_class(c), 0, NULL); break;
+    case FIELD_INITIAL_TITLE: ok = g_regex_match(f->re, hypr_client_get_initial_title(c), 0, NULL); break;
+    case FIELD_FLOATING: ok = hypr_client_get_floating(c) == (atoi(f->value) != 0); break;
+    case FIELD_WORKSPACE:
+        ok = g_str_has_prefix(f->value, "name:")
+            ? strcmp(hypr_client_get_workspace(c), f->value + 5) == 0
+            : hypr_client_get_workspace_id(c) == atoi(f->value);
+        break;
+    }
+    return ok != f->negative;
+}
+
+static gboolean class_matches(HyprRule *r, const char *klass)
+{
+    const RuleField *f = &g_array_index(r->fields, RuleField, r->class_idx);
+    return g_regex_match(f->re, klass, 0, NULL) != f->negative;
+}
+
+/* All matchers except the indexed class one, which the caller has settled */
+static gboolean rule_accepts(HyprRule *r, HyprClient *c)
+{
+    for (guint i = 0; i < r->fields->len; i++) {
+        if ((int)i == r->class_idx) continue;
+        if (!field_matches(&g_array_index(r->fields, RuleField, i), c)) return FALSE;
+    }
+    return TRUE;
+}
+
+/* Rule set */
+
+typedef struct {
+    char *klass;
+    GPtrArray *clients;    /* ClientState* */
+    GHashTable *regex_ok;  /* HyprRule* whose class regex accepts klass */
+} ClassBucket;
+
+typedef struct {
+    HyprClient *client;
+    ClassBucket *bucket;
+    GPtrArray *rules;      /* HyprRule* currently matching */
+    gulong notify_id;
+} ClientState;
+
+struct HyprRuleSet {
+    GListStore *rules;
+    GListModel *clients;
+    gulong items_id;
+    GHashTable *literal;   /* class -> GPtrArray of CLASS_LITERAL rules */
+    GPtrArray *regex_rules;
+    GPtrArray *any_rules;
+    GHashTable *buckets;   /* class -> ClassBucket* */
+    GHashTable *states;    /* HyprClient* -> ClientState* */
+    GHashTable *touched;   /* rules whose matches changed since the last flush */
+    guint flush_id;
+};
+
+static void bucket_free(gpointer p)
+{
+    ClassBucket *b = p;
+    g_free(b->klass);
+    g_ptr_array_unref(b->clients);
+    g_hash_table_destroy(b->regex_ok);
+    g_free(b);
+}
+
+static ClassBucket *bucket_get(HyprRuleSet *set, const char *klass)
+{
+    ClassBucket *b = g_hash_table_lookup(set->buckets, klass);
+    if (b) return b;
+    b = g_new0(ClassBucket, 1);
+    b->klass = g_strdup(klass);
+    b->clients = g_ptr_array_new();
+    b->regex_ok = g_hash_table_new(g_direct_hash, g_direct_equal);
+    for (guint i = 0; i < set->regex_rules->len; i++) {
+        HyprRule *r = g_ptr_array_index(set->regex_rules, i);
+        if (class_matches(r, klass)) g_hash_table_add(b->regex_ok, r);
+    }
+    g_hash_table_insert(set->buckets, b->klass, b);
+    return b;
+}
+
+static void bucket_leave(HyprRuleSet *set, ClientState *cs)
+{
+    ClassBucket *b = cs->bucket;
+    g_ptr_array_remove_fast(b->clients, cs);
+    cs->bucket = NULL;
+    if (b->clients->len == 0) g_hash_table_remove(set->buckets, b->klass);
+}
+
+static gboolean flush_idle(gpointer user_data);
+
+static void touch(HyprRuleSet *set, HyprRule *r)
+{
+    g_hash_table_add(set->touched, r);
+    if (!set->flush_id) set->flush_id = g_idle_add(flush_idle, set);
+}
+
+static void link_match(HyprRuleSet *set, HyprRule *r, ClientState *cs)
+{
+    g_ptr_array_add(r->matches, cs->client);
+    g_ptr_array_add(cs->rules, r);
+    touch(set, r);
+}
+
+static void unlink_match(HyprRuleSet *set, HyprRule *r, ClientState *cs)
+{
+    g_ptr_array_remove_fast(r->matches, cs->client);
+    g_ptr_array_remove_fast(cs->rules, r);
+    touch(set, r);
+}
+
+/* Re-check one client against the rules that can apply to its class */
+static void client_evaluate(HyprRuleSet *set, ClientState *cs)
+{
+    GPtrArray *now = g_ptr_array_new();
+    GPtrArray *lit = g_hash_table_lookup(set->literal, cs->bucket->klass);
+    for (guint i = 0; lit && i < lit->len; i++) {
+        HyprRule *r = g_ptr_array_index(lit, i);
+        if (rule_accepts(r, cs->client)) g_ptr_array_add(now, r);
+    }
+    for (guint i = 0; i < set->any_rules->len; i++) {
+        HyprRule *r = g_ptr_array_index(set->any_rules, i);
+        if (rule_accepts(r, cs->client)) g_ptr_array_add(now, r);
+    }
+    GHashTableIter it;
+    gpointer key;
+    g_hash_table_iter_init(&it, cs->bucket->regex_ok);
+    while (g_hash_table_iter_next(&it, &key, NULL)) {
+        if (rule_accepts(key, cs->client)) g_ptr_array_add(now, key);
+    }
+
+    for (guint i = cs->rules->len; i-- > 0;) {
+        HyprRule *r = g_ptr_array_index(cs->rules, i);
+        if (!g_ptr_array_find(now, r, NULL)) unlink_match(set, r, cs);
+    }
+    for (guint i = 0; i < now->len; i++) {
+        HyprRule *r = g_ptr_array_index(now, i);
+        if (!g_ptr_array_find(cs->rules, r, NULL)) link_match(set, r, cs);
+    }
+    g_ptr_array_unref(now);
+}
+
+static void on_client_notify(GObject *obj, GParamSpec *pspec, gpointer user_data)
+{
+    HyprRuleSet *set = user_data;
+    ClientState *cs = g_hash_table_lookup(set->states, obj);
+    if (!cs) return;
+    const char *name = g_param_spec_get_name(pspec);
+    if (strcmp(name, "class") == 0 && strcmp(cs->bucket->klass, hypr_client_get_class(cs->client)) != 0) {
+        bucket_leave(set, cs);
+        cs->bucket = bucket_get(set, hypr_client_get_class(cs->client));
+        g_ptr_array_add(cs->bucket->clients, cs);
+    }
+    if (strcmp(name, "size") != 0 && strcmp(name, "pid") != 0) client_evaluate(set, cs);
+}
+
+static void track_client(HyprRuleSet *set, HyprClient *c)
+{
+    if (g_hash_table_contains(set->states, c)) return;
+    ClientState *cs = g_new0(ClientState, 1);
+    cs->client = g_object_ref(c);
+    cs->rules = g_ptr_array_new();
+    cs->bucket = bucket_get(set, hypr_client_get_class(c));
+    g_ptr_array_add(cs->bucket->clients, cs);
+    cs->notify_id = g_signal_connect(c, "notify", G_CALLBACK(on_client_notify), set);
+    g_hash_table_insert(set->states, c, cs);
+    client_evaluate(set, cs);
+}
+
+static void untrack_client(HyprRuleSet *set, ClientState *cs)
+{
+    while (cs->rules->len > 0) unlink_match(set, g_ptr_array_index(cs->rules, 0), cs);
+    bucket_leave(set, cs);
+    g_signal_handler_disconnect(cs->client, cs->notify_id);
+    g_hash_table_remove(set->states, cs->client);
+    g_ptr_array_unref(cs->rules);
+    g_object_unref(cs->client);
+    g_free(cs);
+}
+
+static void on_clients_changed(GListModel *model, guint pos, guint removed, guint added, gpointer user_data)
+{
+    HyprRuleSet *set = user_data;
+    if (removed > 0) {
+        /* removed items are not reported; sweep for the ones that are gone */
+        GHashTable *present = g_hash_table_new(g_direct_hash, g_direct_equal);
+        for (guint i = 0; i < g_list_model_get_n_items(model); i++) {
+            gpointer c = g_list_model_get_item(model, i);
+            g_hash_table_add(present, c);
+            g_object_unref(c);
+        }
+        GPtrArray *gone = g_ptr_array_new();
+        GHashTableIter it;
+        gpointer key, value;
+        g_hash_table_iter_init(&it, set->states);
+        while (g_hash_table_iter_next(&it, &key, &value)) {
+            if (!g_hash_table_contains(present, key)) g_ptr_array_add(gone, value);
+        }
+        for (guint i = 0; i < gone->len; i++) untrack_client(set, g_ptr_array_index(gone, i));
+        g_ptr_array_unref(gone);
+        g_hash_table_destroy(present);
+    }
+    for (guint i = pos; i < pos + added; i++) {
+        HyprClient *c = g_list_model_get_item(model, i);
+        track_client(set, c);
+        g_object_unref(c);
+    }
+}
+
+static void rule_index(HyprRuleSet *set, HyprRule *r)
+{
+    GHashTableIter it;
+    gpointer value;
+    switch (r->class_kind) {
+    case CLASS_LITERAL:
+        for (guint i = 0; r->class_keys[i]; i++) {
+            GPtrArray *list = g_hash_table_lookup(set->literal, r->class_keys[i]);
+            if (!list) {
+                list = g_ptr_array_new();
+                g_hash_table_insert(set->literal, g_strdup(r->class_keys[i]), list);
+            }
+            if (!g_ptr_array_find(list, r, NULL)) g_ptr_array_add(list, r);
+        }
+        break;
+    case CLASS_REGEX:
+        g_ptr_array_add(set->regex_rules, r);
+        g_hash_table_iter_init(&it, set->buckets);
+        while (g_hash_table_iter_next(&it, NULL, &value)) {
+            ClassBucket *b = value;
+            if (class_matches(r, b->klass)) g_hash_table_add(b->regex_ok, r);
+        }
+        break;
+    case CLASS_ANY:
+        g_ptr_array_add(set->any_rules, r);
+        break;
+    case CLASS_NONE:
+        break;
+    }
+}
+
+static void rule_unindex(HyprRuleSet *set, HyprRule *r)
+{
+    GHashTableIter it;
+    gpointer value;
+    switch (r->class_kind) {
+    case CLASS_LITERAL:
+        for (guint i = 0; r->class_keys[i]; i++) {
+            GPtrArray *list = g_hash_table_lookup(set->literal, r->class_keys[i]);
+            if (!list) continue;
+            g_ptr_array_remove(list, r);
+            if (list->len == 0) g_hash_table_remove(set->literal, r->class_keys[i]);
+        }
+        break;
+    case CLASS_REGEX:
+        g_ptr_array_remove(set->regex_rules, r);
+        g_hash_table_iter_init(&it, set->buckets);
+        while (g_hash_table_iter_next(&it, NULL, &value)) g_hash_table_remove(((ClassBucket *)value)->regex_ok, r);
+        break;
+    case CLASS_ANY:
+        g_ptr_array_remove(set->any_rules, r);
+        break;
+    case CLASS_NONE:
+        break;
+    }
+}
+
+static void bucket_collect(ClassBucket *b, HyprRule *r, GPtrArray *now)
+{
+    for (guint i = 0; i < b->clients->len; i++) {
+        ClientState *cs = g_ptr_array_index(b->clients, i);
+        if (rule_accepts(r, cs->client)) g_ptr_array_add(now, cs);
+    }
+}
+
+/* Re-check one rule against the clients whose class it can accept */
+static void rule_evaluate(HyprRuleSet *set, HyprRule *r)
+{
+    GPtrArray *now = g_ptr_array_new();
+    GHashTableIter it;
+    gpointer value;
+    switch (r->class_kind) {
+    case CLASS_LITERAL:
+        for (guint i = 0; r->class_keys[i]; i++) {
+            ClassBucket *b = g_hash_table_lookup(set->buckets, r->class_keys[i]);
+            gboolean repeated = FALSE;
+            for (guint k = 0; k < i; k++) repeated |= strcmp(r->class_keys[k], r->class_keys[i]) == 0;
+            if (b && !repeated) bucket_collect(b, r, now);
+        }
+        break;
+    case CLASS_REGEX:
+        g_hash_table_iter_init(&it, set->buckets);
+        while (g_hash_table_iter_next(&it, NULL, &value)) {
+            ClassBucket *b = value;
+            if (g_hash_table_contains(b->regex_ok, r)) bucket_collect(b, r, now);
+        }
+        break;
+    case CLASS_ANY:
+        g_hash_table_iter_init(&it, set->buckets);
+        while (g_hash_table_iter_next(&it, NULL, &value)) bucket_collect(value, r, now);
+        break;
+    case CLASS_NONE:
+        break;
+    }
+
+    GHashTable *keep = g_hash_table_new(g_direct_hash, g_direct_equal);
+    for (guint i = 0; i < now->len; i++) g_hash_table_add(keep, ((ClientState *)g_ptr_array_index(now, i))->client);
+    for (guint i = r->matches->len; i-- > 0;) {
+        HyprClient *c = g_ptr_array_index(r->matches, i);
+        if (!g_hash_table_contains(keep, c)) unlink_match(set, r, g_hash_table_lookup(set->states, c));
+    }
+    for (guint i = 0; i < now->len; i++) {
+        ClientState *cs = g_ptr_array_index(now, i);
+        if (!g_ptr_array_find(cs->rules, r, NULL)) link_match(set, r, cs);
+    }
+    g_hash_table_destroy(keep);
+    g_ptr_array_unref(now);
+    touch(set, r);
+}
+
+/* `later` covers `r` when every window `r` matches also matches `later` */
+static gboolean rule_covers(HyprRuleSet *set, HyprRule *later, HyprRule *r)
+{
+    if (later->error || later->unchecked || later->matches->len < r->matches->len) return FALSE;
+    for (guint i = 0; i < r->matches->len; i++) {
+        ClientState *cs = g_hash_table_lookup(set->states, g_ptr_array_index(r->matches, i));
+        if (!g_ptr_array_find(cs->rules, later, NULL)) return FALSE;
+    }
+    return TRUE;
+}
+
+/* Notify changed match sets and recompute shadowing once per main-loop
+ * turn. Walking the rules backwards, each effect keeps the later rules
+ * seen so far; the nearest one covering a rule is what overrides it. */
+static gboolean flush_idle(gpointer user_data)
+{
+    HyprRuleSet *set = user_data;
+    set->flush_id = 0;
+    GHashTable *later = g_hash_table_new_full(g_str_hash, g_str_equal, NULL, (GDestroyNotify)g_ptr_array_unref);
+    GListModel *rules = G_LIST_MODEL(set->rules);
+
+    for (guint i = g_list_model_get_n_items(rules); i-- > 0;) {
+        HyprRule *r = g_list_model_get_item(rules, i);
+        HyprRule *shadow = NULL;
+        GPtrArray *same = g_hash_table_lookup(later, r->effect);
+        if (!same) {
+            same = g_ptr_array_new();
+            g_hash_table_insert(later, r->effect, same);
+        }
+        if (r->matches->len > 0 && !g_strv_contains((const char *const *)stacking_effects, r->effect)) {
+            for (guint k = same->len; k-- > 0 && !shadow;) {
+                if (rule_covers(set, g_ptr_array_index(same, k), r)) shadow = g_ptr_array_index(same, k);
+            }
+        }
+        g_ptr_array_add(same, r);
+        if (r->shadowed_by != shadow) {
+            r->shadowed_by = shadow;
+            g_object_notify_by_pspec(G_OBJECT(r), props[PROP_SHADOWED_BY]);
+        }
+        if (g_hash_table_remove(set->touched, r)) g_object_notify_by_pspec(G_OBJECT(r), props[PROP_MATCHES]);
+        g_object_unref(r);
+    }
+    g_hash_table_destroy(later);
+    g_hash_table_remove_all(set->touched);
+    return G_SOURCE_REMOVE;
+}
+
+static void literal_list_free(gpointer p)
+{
+    g_ptr_array_unref(p);
+}
+
+HyprRuleSet *hypr_rule_set_new(GListModel *clients)
+{
+    HyprRuleSet *set = g_new0(HyprRuleSet, 1);
+    set->rules = g_list_store_new(HYPR_TYPE_RULE);
+    set->clients = g_object_ref(clients);
+    set->literal = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, literal_list_free);
+    set->regex_rules = g_ptr_array_new();
+    set->any_rules = g_ptr_array_new();
+    set->buckets = g_hash_table_new_full(g_str_hash, g_str_equal, NULL, bucket_free);
+    set->states = g_hash_table_new(g_direct_hash, g_direct_equal);
+    set->touched = g_hash_table_new(g_direct_hash, g_direct_equal);
+    on_clients_changed(clients, 0, 0, g_list_model_get_n_items(clients), set);
+    set->items_id = g_signal_connect(clients, "items-changed", G_CALLBACK(on_clients_changed), set);
+    return set;
+}
+
+void hypr_rule_set_free(HyprRuleSet *set)
+{
+    if (!set) return;
+    hypr_rule_set_clear(set);
+    g_signal_handler_disconnect(set->clients, set->items_id);
+    GList *states = g_hash_table_get_values(set->states);
+    for (GList *l = states; l; l = l->next) untrack_client(set, l->data);
+    g_list_free(states);
+    if (set->flush_id) g_source_remove(set->flush_id);
+    g_object_unref(set->rules);
+    g_object_unref(set->clients);
+    g_hash_table_destroy(set->literal);
+    g_ptr_array_unref(set->regex_rules);
+    g_ptr_array_unref(set->any_rules);
+    g_hash_table_destroy(set->buckets);
+    g_hash_table_destroy(set->states);
+    g_hash_table_destroy(set->touched);
+    g_free(set);
+}
+
+GListModel *hypr_rule_set_get_model(HyprRuleSet *set)
+{
+    return G_LIST_MODEL(set->rules);
+}
+
+HyprRule *hypr_rule_set_append(HyprRuleSet *set, const char *text, int file, int line)
+{
+    HyprRule *r = g_object_new(HYPR_TYPE_RULE, NULL);
+    r->file = file;
+    r->line = line;
+    rule_parse(r, text);
+    rule_index(set, r);
+    g_list_store_append(set->rules, r);
+    rule_evaluate(set, r);
+    g_object_unref(r);
+    return r;
+}
+
+void hypr_rule_set_change(HyprRuleSet *set, HyprRule *r, const char *text)
+{
+    if (g_strcmp0(r->text, text) == 0) return;
+    rule_unindex(set, r);
+    rule_parse(r, text);
+    rule_index(set, r);
+    rule_evaluate(set, r);
+    g_object_notify_by_pspec(G_OBJECT(r), props[PROP_TEXT]);
+}
+
+static void rule_detach(HyprRuleSet *set, HyprRule *r)
+{
+    rule_unindex(set, r);
+    while (r->matches->len > 0) {
+        unlink_match(set, r, g_hash_table_lookup(set->states, g_ptr_array_index(r->matches, 0)));
+    }
+    g_hash_table_remove(set->touched, r);
+}
+
+void hypr_rule_set_remove(HyprRuleSet *set, HyprRule *r)
+{
+    guint pos;
+    if (!g_list_store_find(set->rules, r, &pos)) return;
+    rule_detach(set, r);
+    /* nothing may keep pointing at the rule until the next flush */
+    for (guint i = 0; i < g_list_model_get_n_items(G_LIST_MODEL(set->rules)); i++) {
+        HyprRule *o = g_list_model_get_item(G_LIST_MODEL(set->rules), i);
+        if (o->shadowed_by == r) {
+            o->shadowed_by = NULL;
+            g_object_notify_by_pspec(G_OBJECT(o), props[PROP_SHADOWED_BY]);
+        }
+        g_object_unref(o);
+    }
+    g_list_store_remove(set->rules, pos);
+}
+
+void hypr_rule_set_clear(HyprRuleSet *set)
+{
+    for (guint i = 0; i < g_list_model_get_n_items(G_LIST_MODEL(set->rules)); i++) {
+        HyprRule *r = g_list_model_get_item(G_LIST_MODEL(set->rules), i);
+        rule_detach(set, r);
+        r->shadowed_by = NULL;
+        g_object_unref(r);
+    }
+    g_list_store_remove_all(set->rules);
+}
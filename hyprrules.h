@@ -0,0 +1,45 @@
+/* hyprrules.h - windowrulev2 rules compiled once and matched against live clients */
+#ifndef HYPRRULES_H
+#define HYPRRULES_H
+
+#include <gio/gio.h>
+#include "hyprclients.h"
+
+#define HYPR_TYPE_RULE (hypr_rule_get_type())
+G_DECLARE_FINAL_TYPE(HyprRule, hypr_rule, HYPR, RULE, GObject)
+
+/* Value as written after "windowrulev2 =" */
+const char *hypr_rule_get_text(HyprRule *r);
+/* Effect keyword, e.g. "float" or "opacity" */
+const char *hypr_rule_get_effect(HyprRule *r);
+/* Regex compile error; a rule with an error matches nothing */
+const char *hypr_rule_get_error(HyprRule *r);
+/* Comma-separated matcher fields that cannot be checked against the client
+ * list (e.g. "fullscreen"); such rules may match fewer windows than shown */
+const char *hypr_rule_get_unchecked(HyprRule *r);
+/* Matching clients (HyprClient*, owned by the rule set). The "matches"
+ * property holds the count and is notified whenever the set changes. */
+GPtrArray *hypr_rule_get_matches(HyprRule *r);
+/* Later rule with the same effect that matches every window this one does,
+ * so this one has no visible effect right now; NULL when not shadowed */
+HyprRule *hypr_rule_get_shadowed_by(HyprRule *r);
+/* Where the rule was read from; file is -1 for rules added in the editor */
+void hypr_rule_get_origin(HyprRule *r, int *file, int *line);
+
+/* An ordered list of rules kept evaluated against a GListModel of
+ * HyprClient. Rules are indexed by class: a pattern such as "^(kitty)$" or
+ * "^(foo|bar)$" is looked up by exact class, and real regexes are tested
+ * once per distinct class and cached, so a client change re-checks only the
+ * rules that can apply to it and a rule edit re-checks only that rule. */
+typedef struct HyprRuleSet HyprRuleSet;
+
+HyprRuleSet *hypr_rule_set_new(GListModel *clients);
+void hypr_rule_set_free(HyprRuleSet *set);
+/* GListModel of HyprRule in config order */
+GListModel *hypr_rule_set_get_model(HyprRuleSet *set);
+HyprRule *hypr_rule_set_append(HyprRuleSet *set, const char *text, int file, int line);
+void hypr_rule_set_change(HyprRuleSet *set, HyprRule *r, const char *text);
+void hypr_rule_set_remove(HyprRuleSet *set, HyprRule *r);
+void hypr_rule_set_clear(HyprRuleSet *set);
+
+#endif /* HYPRRULES_H */
@@ -0,0 +1,589 @@
+/* hyprsearch.c - regex find/replace across the Hyprland include graph */
+#include "hyprsearch.h"
+#include "hyprconf.h"
+#include "hypr.h"
+#include <string.h>
+
+/* Results beyond this are not collected; Apply is refused for a truncated
+ * result set since it would only replace part of the matches. */
+#define HYPR_SEARCH_MAX_MATCHES 100000
+#define HYPR_SEARCH_BATCH       512
+
+typedef struct {
+    guint file;           /* index into HyprSearch.files */
+    int line;             /* 0-based */
+    gsize start, end;     /* byte offsets in the file */
+    glong cstart, cend;   /* character offsets, for the editor buffer */
+    char *replacement;    /* expanded replacement, preview only */
+} HyprMatch;
+
+typedef struct {
+    char *path;
+    gboolean is_root;
+    FileStamp stamp;      /* identity when searched; guards Apply */
+} HyprSearchFile;
+
+typedef struct {
+    char *root;
+    GtkTextView *tv;
+    GtkTextBuffer *buf;
+    FileStamp *root_stamp;
+    GtkLabel *status;
+    GtkWidget *find_entry;
+    GtkWidget *replace_entry;
+    GtkWidget *case_btn;
+    GtkWidget *apply_btn;
+    GtkWidget *summary;
+    GtkStringList *model;  /* display rows, parallel to `matches` */
+    GPtrArray *matches;    /* HyprMatch* */
+    GPtrArray *files;      /* HyprSearchFile* */
+    GCancellable *cancel;
+    guint gen;
+    gboolean running;
+    gboolean preview;
+    gboolean truncated;
+    gboolean stale;        /* buffer edited since the search */
+    guint files_scanned;
+} HyprSearch;
+
+typedef struct {
+    HyprSearch *s;
+    guint gen;
+    GRegex *regex;
+    char *replacement;     /* NULL for a plain search */
+    char *root;
+    char *root_text;
+    GCancellable *cancel;
+} SearchJob;
+
+/* Handed from the worker to the main loop, in order */
+typedef struct {
+    HyprSearch *s;
+    guint gen;
+    HyprSearchFile *file;  /* first batch of a file carries it */
+    GPtrArray *matches;
+    GPtrArray *labels;
+    gboolean done;
+    gboolean truncated;
+    guint files_scanned;
+    char *error;
+} SearchBatch;
+
+static void match_free(gpointer p)
+{
+    HyprMatch *m = p;
+    g_free(m->replacement);
+    g_free(m);
+}
+
+static void search_file_free(gpointer p)
+{
+    HyprSearchFile *f = p;
+    if (!f) return;
+    g_free(f->path);
+    g_free(f);
+}
+
+static void batch_free(SearchBatch *b)
+{
+    search_file_free(b->file);
+    if (b->matches) g_ptr_array_unref(b->matches);
+    if (b->labels) g_ptr_array_unref(b->labels);
+    g_free(b->error);
+    g_free(b);
+}
+
+static void update_summary(HyprSearch *s)
+{
+    char *text;
+    if (s->running) {
+        text = g_strdup_printf("Searching… %u match(es) in %u file(s) so far", s->matches->len, s->files_scanned);
+    } else if (s->truncated) {
+        text = g_strdup_printf("Stopped after %u matches; narrow the pattern to replace", s->matches->len);
+    } else {
+        text = g_strdup_printf("%u match(es) in %u of %u file(s)%s", s->matches->len, s->files->len, s->files_scanned,
+                               s->preview && s->matches->len > 0 ? " — review, then Apply" : "");
+    }
+    gtk_label_set_text(GTK_LABEL(s->summary), text);
+    g_free(text);
+    gtk_widget_set_sensitive(s->apply_btn, !s->running && s->preview && !s->truncated && !s->stale && s->matches->len > 0);
+}
+
+static gboolean search_deliver(gpointer user_data)
+{
+    SearchBatch *b = user_data;
+    HyprSearch *s = b->s;
+    if (b->gen != s->gen) {
+        batch_free(b);
+        return G_SOURCE_REMOVE;
+    }
+
+    if (b->file) {
+        g_ptr_array_add(s->files, b->file);
+        b->file = NULL;
+    }
+    if (b->matches && b->matches->len > 0) {
+        guint pos = s->matches->len;
+        for (guint i = 0; i < b->matches->len; i++) {
+            HyprMatch *m = g_ptr_array_index(b->matches, i);
+            m->file = s->files->len - 1;
+            g_ptr_array_add(s->matches, m);
+        }
+        g_ptr_array_set_free_func(b->matches, NULL);
+        g_ptr_array_add(b->labels, NULL);
+        gtk_string_list_splice(s->model, pos, 0, (const char * const *)b->labels->pdata);
+    }
+    s->files_scanned = b->files_scanned;
+    if (b->done) {
+        s->running = FALSE;
+        s->truncated = b->truncated;
+        if (b->error) set_status(s->status, "Search: %s", b->error);
+    }
+    update_summary(s);
+    batch_free(b);
+    return G_SOURCE_REMOVE;
+}
+
+static SearchBatch *batch_new(SearchJob *job)
+{
+    SearchBatch *b = g_new0(SearchBatch, 1);
+    b->s = job->s;
+    b->gen = job->gen;
+    b->matches = g_ptr_array_new_with_free_func(match_free);
+    b->labels = g_ptr_array_new_with_free_func(g_free);
+    return b;
+}
+
+static char *match_label(const char *rel, int line, const char *text, gsize ls, gsize le, gsize ms, gsize me, const char *repl)
+{
+    while (ls < ms && g_ascii_isspace(text[ls])) ls++;
+    if (repl) {
+        return g_strdup_printf("%s:%d: %.*s[%.*s → %s]%.*s", rel, line + 1,
+                               (int)(ms - ls), text + ls, (int)(me - ms), text + ms, repl,
+                               (int)(le - me), text + me);
+    }
+    return g_strdup_printf("%s:%d: %.*s", rel, line + 1, (int)(le - ls), text + ls);
+}
+
+/* Scan one file, pushing batches as they fill. Returns FALSE to stop. */
+static gboolean search_one(SearchJob *job, HyprSearchFile *file, const char *text, gsize len, guint *total, guint files_scanned)
+{
+    char *dir = g_path_get_dirname(job->root);
+    const char *rel = g_str_has_prefix(file->path, dir) && file->path[strlen(dir)] == '/'
+                      ? file->path + strlen(dir) + 1 : file->path;
+
+    SearchBatch *b = batch_new(job);
+    b->file = file;
+    gboolean keep_going = TRUE;
+    int line = 0;
+    gsize line_start = 0, last = 0;
+    glong chars = 0;
+
+    GMatchInfo *mi = NULL;
+    g_regex_match_full(job->regex, text, (gssize)len, 0, 0, &mi, NULL);
+    while (g_match_info_matches(mi)) {
+        int ms = 0, me = 0;
+        g_match_info_fetch_pos(mi, 0, &ms, &me);
+        for (gsize i = last; i < (gsize)ms; i++) {
+            if (text[i] == '\n') {
+                line++;
+                line_start = i + 1;
+            }
+        }
+        chars += g_utf8_strlen(text + last, ms - (glong)last);
+        last = (gsize)ms;
+        const char *nl = memchr(text + ms, '\n', len - (gsize)ms);
+        gsize line_end = nl ? (gsize)(nl - text) : len;
+
+        HyprMatch *m = g_new0(HyprMatch, 1);
+        m->line = line;
+        m->start = (gsize)ms;
+        m->end = (gsize)me;
+        m->cstart = chars;
+        m->cend = chars + g_utf8_strlen(text + ms, me - ms);
+        if (job->replacement) m->replacement = g_match_info_expand_references(mi, job->replacement, NULL);
+        g_ptr_array_add(b->matches, m);
+        g_ptr_array_add(b->labels, match_label(rel, line, text, line_start, line_end, (gsize)ms, MIN((gsize)me, line_end), m->replacement ? m->replacement : (job->replacement ? "" : NULL)));
+
+        if (++*total >= HYPR_SEARCH_MAX_MATCHES) {
+            keep_going = FALSE;
+            break;
+        }
+        if (b->matches->len >= HYPR_SEARCH_BATCH) {
+            if (g_cancellable_is_cancelled(job->cancel)) {
+                keep_going = FALSE;
+                break;
+            }
+            b->files_scanned = files_scanned;
+            g_idle_add(search_deliver, b);
+            b = batch_new(job);
+        }
+        g_match_info_next(mi, NULL);
+    }
+    g_match_info_free(mi);
+    g_free(dir);
+
+    /* files without matches are not listed */
+    if (b->matches->len == 0 && b->file) {
+        batch_free(b);
+        return keep_going;
+    }
+    b->files_scanned = files_scanned;
+    g_idle_add(search_deliver, b);
+    return keep_going;
+}
+
+static gpointer search_thread(gpointer user_data)
+{
+    SearchJob *job = user_data;
+    GPtrArray *graph = hypr_conf_include_graph(job->root);
+    guint total = 0, scanned = 0, skipped = 0;
+    gboolean stopped = FALSE;
+
+    for (guint i = 0; i < graph->len && !stopped; i++) {
+        if (g_cancellable_is_cancelled(job->cancel)) break;
+        const char *path = g_ptr_array_index(graph, i);
+        HyprSearchFile *file = g_new0(HyprSearchFile, 1);
+        file->path = g_strdup(path);
+        file->is_root = i == 0;
+
+        gchar *content = NULL;
+        gsize len = 0;
+        if (file->is_root) {
+            content = g_strdup(job->root_text);
+            len = strlen(content);
+        } else {
+            file_stamp_take(path, &file->stamp);
+            if (!g_file_get_contents(path, &content, &len, NULL) || !g_utf8_validate(content, (gssize)len, NULL)) {
+                /* offsets must match the bytes on disk, so no lossy repair */
+                skipped++;
+                g_free(content);
+                search_file_free(file);
+                continue;
+            }
+        }
+        scanned++;
+        stopped = !search_one(job, file, content, len, &total, scanned);
+        g_free(content);
+    }
+
+    SearchBatch *done = batch_new(job);
+    done->done = TRUE;
+    done->files_scanned = scanned;
+    done->truncated = total >= HYPR_SEARCH_MAX_MATCHES;
+    if (skipped) done->error = g_strdup_printf("skipped %u file(s) that are not valid UTF-8", skipped);
+    g_idle_add(search_deliver, done);
+
+    g_ptr_array_unref(graph);
+    g_regex_unref(job->regex);
+    g_object_unref(job->cancel);
+    g_free(job->replacement);
+    g_free(job->root);
+    g_free(job->root_text);
+    g_free(job);
+    return NULL;
+}
+
+static void search_reset(HyprSearch *s)
+{
+    if (s->cancel) {
+        g_cancellable_cancel(s->cancel);
+        g_clear_object(&s->cancel);
+    }
+    s->gen++;
+    s->running = FALSE;
+    s->truncated = FALSE;
+    s->stale = FALSE;
+    s->files_scanned = 0;
+    g_ptr_array_set_size(s->matches, 0);
+    g_ptr_array_set_size(s->files, 0);
+    gtk_string_list_splice(s->model, 0, g_list_model_get_n_items(G_LIST_MODEL(s->model)), NULL);
+}
+
+static void search_start(HyprSearch *s, gboolean preview)
+{
+    const char *pattern = gtk_editable_get_text(GTK_EDITABLE(s->find_entry));
+    search_reset(s);
+    s->preview = preview;
+    if (!pattern || !*pattern) {
+        gtk_label_set_text(GTK_LABEL(s->summary), "");
+        gtk_widget_set_sensitive(s->apply_btn, FALSE);
+        return;
+    }
+
+    /* compiled once per search and shared read-only with the worker;
+     * G_REGEX_OPTIMIZE enables the PCRE JIT */
+    GRegexCompileFlags flags = G_REGEX_OPTIMIZE | G_REGEX_MULTILINE;
+    if (!gtk_check_button_get_active(GTK_CHECK_BUTTON(s->case_btn))) flags |= G_REGEX_CASELESS;
+    GError *err = NULL;
+    GRegex *regex = g_regex_new(pattern, flags, 0, &err);
+    if (!regex) {
+        char *msg = g_strdup_printf("Invalid pattern: %s", err->message);
+        gtk_label_set_text(GTK_LABEL(s->summary), msg);
+        g_free(msg);
+        g_error_free(err);
+        gtk_widget_set_sensitive(s->apply_btn, FALSE);
+        return;
+    }
+
+    const char *repl = gtk_editable_get_text(GTK_EDITABLE(s->replace_entry));
+    if (preview && !g_regex_check_replacement(repl, NULL, &err)) {
+        char *msg = g_strdup_printf("Invalid replacement: %s", err->message);
+        gtk_label_set_text(GTK_LABEL(s->summary), msg);
+        g_free(msg);
+        g_error_free(err);
+        g_regex_unref(regex);
+        gtk_widget_set_sensitive(s->apply_btn, FALSE);
+        return;
+    }
+
+    GtkTextIter start, end;
+    gtk_text_buffer_get_bounds(s->buf, &start, &end);
+
+    SearchJob *job = g_new0(SearchJob, 1);
+    job->s = s;
+    job->gen = s->gen;
+    job->regex = regex;
+    job->replacement = preview ? g_strdup(repl) : NULL;
+    job->root = g_strdup(s->root);
+    job->root_text = gtk_text_buffer_get_text(s->buf, &start, &end, TRUE);
+    s->cancel = g_cancellable_new();
+    job->cancel = g_object_ref(s->cancel);
+    s->running = TRUE;
+    update_summary(s);
+    g_thread_unref(g_thread_new("hypr-search", search_thread, job));
+}
+
+static void on_find_clicked(GtkWidget *w, gpointer user_data)
+{
+    search_start((HyprSearch *)user_data, FALSE);
+}
+
+static void on_preview_clicked(GtkButton *btn, gpointer user_data)
+{
+    search_start((HyprSearch *)user_data, TRUE);
+}
+
+/* Splice the replacements for file `fi` into `text`; NULL when the match
+ * offsets do not fit it, i.e. it is not the text they were found in */
+static GString *apply_to_text(HyprSearch *s, guint fi, const char *text, gsize len)
+{
+    GString *out = g_string_sized_new(len);
+    gsize pos = 0;
+    for (guint i = 0; i < s->matches->len; i++) {
+        HyprMatch *m = g_ptr_array_index(s->matches, i);
+        if (m->file != fi) continue;
+        if (m->start < pos || m->end < m->start || m->end > len) {
+            g_string_free(out, TRUE);
+            return NULL;
+        }
+        g_string_append_len(out, text + pos, (gssize)(m->start - pos));
+        g_string_append(out, m->replacement ? m->replacement : "");
+        pos = m->end;
+    }
+    g_string_append_len(out, text + pos, (gssize)(len - pos));
+    return out;
+}
+
+static void on_apply_clicked(GtkButton *btn, gpointer user_data)
+{
+    HyprSearch *s = user_data;
+    if (s->running || !s->preview || s->truncated || s->matches->len == 0) return;
+    if (s->stale) {
+        set_status(s->status, "The config was edited after the preview; run Preview again");
+        return;
+    }
+
+    guint n = s->files->len;
+    ConfigWrite *writes = g_new0(ConfigWrite, n);
+    GString **texts = g_new0(GString *, n);
+    gint root_index = -1;
+    GError *err = NULL;
+    gboolean ok = TRUE, conflict = FALSE;
+
+    for (guint i = 0; i < n && ok; i++) {
+        HyprSearchFile *f = g_ptr_array_index(s->files, i);
+        gchar *content = NULL;
+        gsize len = 0;
+        if (f->is_root) {
+            GtkTextIter start, end;
+            gtk_text_buffer_get_bounds(s->buf, &start, &end);
+            content = gtk_text_buffer_get_text(s->buf, &start, &end, TRUE);
+            len = strlen(content);
+            root_index = (gint)i;
+        } else {
+            /* the offsets are only valid for the file as it was searched */
+            FileStamp now;
+            file_stamp_take(f->path, &now);
+            if (!file_stamp_equal(&now, &f->stamp)) {
+                conflict = TRUE;
+                break;
+            }
+            if (!g_file_get_contents(f->path, &content, &len, &err)) {
+                ok = FALSE;
+                break;
+            }
+        }
+        texts[i] = apply_to_text(s, i, content, len);
+        g_free(content);
+        if (!texts[i]) {
+            conflict = TRUE;
+            break;
+        }
+        writes[i].path = f->path;
+        writes[i].contents = texts[i]->str;
+        writes[i].len = (gssize)texts[i]->len;
+        /* the root is written with the editor's text, so the editor's stamp
+         * is what must still match the disk */
+        writes[i].stamp = f->is_root ? s->root_stamp : &f->stamp;
+    }
+
+    ConfigSaveResult r = conflict ? CONFIG_SAVE_CONFLICT
+                       : ok ? save_config_files(writes, n, FALSE, &err) : CONFIG_SAVE_FAILED;
+    guint n_matches = s->matches->len;
+    switch (r) {
+    case CONFIG_SAVE_WRITTEN:
+    case CONFIG_SAVE_UNCHANGED:
+        if (root_index >= 0) {
+            /* mirror the root file's replacements in the buffer, back to
+             * front so earlier offsets stay valid; one user action is one
+             * undo step */
+            gtk_text_buffer_begin_user_action(s->buf);
+            for (guint i = s->matches->len; i-- > 0;) {
+                HyprMatch *m = g_ptr_array_index(s->matches, i);
+                if (m->file != (guint)root_index) continue;
+                GtkTextIter a, b;
+                gtk_text_buffer_get_iter_at_offset(s->buf, &a, (int)m->cstart);
+                gtk_text_buffer_get_iter_at_offset(s->buf, &b, (int)m->cend);
+                gtk_text_buffer_delete(s->buf, &a, &b);
+                if (m->replacement) gtk_text_buffer_insert(s->buf, &a, m->replacement, -1);
+            }
+            gtk_text_buffer_end_user_action(s->buf);
+            gtk_text_buffer_set_modified(s->buf, FALSE);
+        }
+        search_reset(s);
+        gtk_label_set_text(GTK_LABEL(s->summary), "");
+        gtk_widget_set_sensitive(s->apply_btn, FALSE);
+        set_status(s->status, "Replaced %u match(es) in %u file(s)", n_matches, n);
+        break;
+    case CONFIG_SAVE_CONFLICT:
+        set_status(s->status, "%s; run Preview again", err ? err->message : "A file changed on disk");
+        break;
+    case CONFIG_SAVE_FAILED: {
+        char *msg = g_strdup_printf("No files were changed:\n%s", err ? err->message : "unknown error");
+        show_big_message_dialog("Error applying replacements", msg);
+        g_free(msg);
+        break;
+    }
+    }
+    g_clear_error(&err);
+    for (guint i = 0; i < n; i++) if (texts[i]) g_string_free(texts[i], TRUE);
+    g_free(texts);
+    g_free(writes);
+}
+
+static void on_result_activated(GtkListView *view, guint position, gpointer user_data)
+{
+    HyprSearch *s = user_data;
+    if (position >= s->matches->len) return;
+    HyprMatch *m = g_ptr_array_index(s->matches, position);
+    HyprSearchFile *f = g_ptr_array_index(s->files, m->file);
+    if (!f->is_root || s->stale) {
+        set_status(s->status, "%s line %d", f->path, m->line + 1);
+        return;
+    }
+    GtkTextIter a, b;
+    gtk_text_buffer_get_iter_at_offset(s->buf, &a, (int)m->cstart);
+    gtk_text_buffer_get_iter_at_offset(s->buf, &b, (int)m->cend);
+    gtk_text_buffer_select_range(s->buf, &a, &b);
+    gtk_text_view_scroll_to_mark(s->tv, gtk_text_buffer_get_insert(s->buf), 0.1, TRUE, 0.0, 0.3);
+    gtk_widget_grab_focus(GTK_WIDGET(s->tv));
+}
+
+static void on_root_buffer_changed(GtkTextBuffer *buf, gpointer user_data)
+{
+    HyprSearch *s = user_data;
+    if (s->matches->len == 0 && !s->running) return;
+    if (!s->stale) {
+        s->stale = TRUE;
+        update_summary(s);
+    }
+}
+
+static void setup_result_row(GtkSignalListItemFactory *f, GtkListItem *item, gpointer user_data)
+{
+    GtkWidget *lab = gtk_label_new(NULL);
+    gtk_label_set_xalign(GTK_LABEL(lab), 0.0f);
+    gtk_label_set_ellipsize(GTK_LABEL(lab), PANGO_ELLIPSIZE_END);
+    gtk_label_set_single_line_mode(GTK_LABEL(lab), TRUE);
+    gtk_widget_add_css_class(lab, "monospace");
+    gtk_list_item_set_child(item, lab);
+}
+
+static void bind_result_row(GtkSignalListItemFactory *f, GtkListItem *item, gpointer user_data)
+{
+    GtkStringObject *obj = gtk_list_item_get_item(item);
+    gtk_label_set_text(GTK_LABEL(gtk_list_item_get_child(item)), gtk_string_object_get_string(obj));
+}
+
+GtkWidget *hypr_search_panel_new(const char *root, GtkTextView *tv, FileStamp *root_stamp, GtkLabel *status)
+{
+    HyprSearch *s = g_new0(HyprSearch, 1);
+    s->root = g_strdup(root);
+    s->tv = tv;
+    s->buf = gtk_text_view_get_buffer(tv);
+    s->root_stamp = root_stamp;
+    s->status = status;
+    s->matches = g_ptr_array_new_with_free_func(match_free);
+    s->files = g_ptr_array_new_with_free_func(search_file_free);
+    s->model = gtk_string_list_new(NULL);
+    g_signal_connect(s->buf, "changed", G_CALLBACK(on_root_buffer_changed), s);
+
+    GtkWidget *exp = gtk_expander_new("Find / replace in all config files");
+    GtkWidget *v = gtk_box_new(GTK_ORIENTATION_VERTICAL, 6);
+    gtk_expander_set_child(GTK_EXPANDER(exp), v);
+
+    GtkWidget *h = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 8);
+    s->find_entry = gtk_entry_new();
+    gtk_entry_set_placeholder_text(GTK_ENTRY(s->find_entry), "Regular expression, e.g. \\$mainMod\\b");
+    gtk_widget_set_hexpand(s->find_entry, TRUE);
+    g_signal_connect(s->find_entry, "activate", G_CALLBACK(on_find_clicked), s);
+    gtk_box_append(GTK_BOX(h), s->find_entry);
+    s->replace_entry = gtk_entry_new();
+    gtk_entry_set_placeholder_text(GTK_ENTRY(s->replace_entry), "Replacement (\\1 for groups)");
+    gtk_widget_set_hexpand(s->replace_entry, TRUE);
+    gtk_box_append(GTK_BOX(h), s->replace_entry);
+    s->case_btn = gtk_check_button_new_with_label("Match case");
+    gtk_check_button_set_active(GTK_CHECK_BUTTON(s->case_btn), TRUE);
+    gtk_box_append(GTK_BOX(h), s->case_btn);
+    GtkWidget *find_btn = gtk_button_new_with_label("Find");
+    g_signal_connect(find_btn, "clicked", G_CALLBACK(on_find_clicked), s);
+    gtk_box_append(GTK_BOX(h), find_btn);
+    GtkWidget *preview_btn = gtk_button_new_with_label("Preview replace");
+    g_signal_connect(preview_btn, "clicked", G_CALLBACK(on_preview_clicked), s);
+    gtk_box_append(GTK_BOX(h), preview_btn);
+    s->apply_btn = gtk_button_new_with_label("Apply");
+    gtk_widget_set_sensitive(s->apply_btn, FALSE);
+    g_signal_connect(s->apply_btn, "clicked", G_CALLBACK(on_apply_clicked), s);
+    gtk_box_append(GTK_BOX(h), s->apply_btn);
+    gtk_box_append(GTK_BOX(v), h);
+
+    s->summary = gtk_label_new("");
+    gtk_widget_set_halign(s->summary, GTK_ALIGN_START);
+    gtk_box_append(GTK_BOX(v), s->summary);
+
+    /* only visible rows get widgets, however many matches stream in */
+    GtkListItemFactory *factory = gtk_signal_list_item_factory_new();
+    g_signal_connect(factory, "setup", G_CALLBACK(setup_result_row), s);
+    g_signal_connect(factory, "bind", G_CALLBACK(bind_result_row), s);
+    GtkSelectionModel *sel = GTK_SELECTION_MODEL(gtk_single_selection_new(G_LIST_MODEL(g_object_ref(s->model))));
+    GtkWidget *list = gtk_list_view_new(sel, factory);
+    gtk_list_view_set_single_click_activate(GTK_LIST_VIEW(list), TRUE);
+    g_signal_connect(list, "activate", G_CALLBACK(on_result_activated), s);
+    GtkWidget *sc = gtk_scrolled_window_new();
+    gtk_widget_set_size_request(sc, -1, 180);
+    gtk_scrolled_window_set_child(GTK_SCROLLED_WINDOW(sc), list);
+    gtk_box_append(GTK_BOX(v), sc);
+
+    return exp;
+}
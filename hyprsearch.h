@@ -0,0 +1,17 @@
+/* hyprsearch.h - regex find/replace across the Hyprland include graph */
+#ifndef HYPRSEARCH_H
+#define HYPRSEARCH_H
+
+#include <gtk/gtk.h>
+#include "common.h"
+
+/* Build the search panel for the editor showing `root`. Searches run on a
+ * worker over `root` (taken from the editor buffer, so unsaved edits count)
+ * and every file it sources; matches stream into a list as they are found.
+ * Preview computes the replacements, Apply writes every affected file in one
+ * save_config_files() call and applies the root file's replacements to the
+ * buffer as a single undoable edit. `root_stamp` is the editor's stamp of
+ * `root` and is updated on write. */
+GtkWidget *hypr_search_panel_new(const char *root, GtkTextView *tv, FileStamp *root_stamp, GtkLabel *status);
+
+#endif /* HYPRSEARCH_H */
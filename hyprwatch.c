@@ -0,0 +1,140 @@
+/* hyprwatch.c - watch a Hyprland config and everything it sources */
+#include "hyprwatch.h"
+#include "hyprconf.h"
+#include <stdlib.h>
+#include <limits.h>
+
+/* editors and sync tools often write in several steps; wait for them */
+#define HYPR_WATCH_SETTLE_MS 200
+
+struct HyprWatch {
+    char *root;
+    gboolean follow_sources;
+    GHashTable *monitors;  /* graph path -> GFileMonitor */
+    GHashTable *pending;   /* graph paths changed since the last flush */
+    guint flush_id;
+    gboolean graph_running;
+    gboolean graph_stale;
+    HyprWatchFunc func;
+    gpointer user_data;
+};
+
+static void refresh_graph(HyprWatch *w);
+
+static gboolean flush_pending(gpointer user_data)
+{
+    HyprWatch *w = (HyprWatch *)user_data;
+    w->flush_id = 0;
+
+    GHashTable *batch = w->pending;
+    w->pending = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+
+    GHashTableIter it;
+    gpointer key;
+    g_hash_table_iter_init(&it, batch);
+    while (g_hash_table_iter_next(&it, &key, NULL)) w->func((const char *)key, w->user_data);
+    g_hash_table_destroy(batch);
+
+    /* any file may have gained or lost `source =` lines */
+    if (w->follow_sources) refresh_graph(w);
+    return G_SOURCE_REMOVE;
+}
+
+static void on_monitor_event(GFileMonitor *mon, GFile *file, GFile *other, GFileMonitorEvent event, gpointer user_data)
+{
+    HyprWatch *w = (HyprWatch *)user_data;
+    if (event == G_FILE_MONITOR_EVENT_ATTRIBUTE_CHANGED ||
+        event == G_FILE_MONITOR_EVENT_PRE_UNMOUNT ||
+        event == G_FILE_MONITOR_EVENT_UNMOUNTED) return;
+
+    const char *path = g_object_get_data(G_OBJECT(mon), "hypr-watch-path");
+    if (!path) return;
+    g_hash_table_add(w->pending, g_strdup(path));
+    if (w->flush_id) g_source_remove(w->flush_id);
+    w->flush_id = g_timeout_add(HYPR_WATCH_SETTLE_MS, flush_pending, w);
+}
+
+static void add_monitor(HyprWatch *w, const char *path)
+{
+    if (g_hash_table_contains(w->monitors, path)) return;
+
+    /* watch the real file so symlinked dotfiles report changes to the target */
+    char resolved[PATH_MAX];
+    GFile *f = g_file_new_for_path(realpath(path, resolved) ? resolved : path);
+    GFileMonitor *mon = g_file_monitor_file(f, G_FILE_MONITOR_NONE, NULL, NULL);
+    g_object_unref(f);
+    if (!mon) return;
+
+    g_object_set_data_full(G_OBJECT(mon), "hypr-watch-path", g_strdup(path), g_free);
+    g_signal_connect(mon, "changed", G_CALLBACK(on_monitor_event), w);
+    g_hash_table_insert(w->monitors, g_strdup(path), mon);
+}
+
+static void graph_thread(GTask *task, gpointer source, gpointer task_data, GCancellable *cancellable)
+{
+    g_task_return_pointer(task, hypr_conf_include_graph((const char *)task_data), (GDestroyNotify)g_ptr_array_unref);
+}
+
+static void on_graph_done(GObject *source, GAsyncResult *res, gpointer user_data)
+{
+    HyprWatch *w = (HyprWatch *)user_data;
+    GPtrArray *graph = g_task_propagate_pointer(G_TASK(res), NULL);
+    w->graph_running = FALSE;
+    if (!graph) return;
+
+    GHashTable *keep = g_hash_table_new(g_str_hash, g_str_equal);
+    for (guint i = 0; i < graph->len; i++) {
+        const char *p = g_ptr_array_index(graph, i);
+        g_hash_table_add(keep, (gpointer)p);
+        add_monitor(w, p);
+    }
+
+    GHashTableIter it;
+    gpointer key;
+    g_hash_table_iter_init(&it, w->monitors);
+    while (g_hash_table_iter_next(&it, &key, NULL)) {
+        if (!g_hash_table_contains(keep, key)) g_hash_table_iter_remove(&it);
+    }
+    g_hash_table_destroy(keep);
+    g_ptr_array_unref(graph);
+
+    if (w->graph_stale) {
+        w->graph_stale = FALSE;
+        refresh_graph(w);
+    }
+}
+
+static void refresh_graph(HyprWatch *w)
+{
+    if (w->graph_running) {
+        w->graph_stale = TRUE;
+        return;
+    }
+    w->graph_running = TRUE;
+    GTask *task = g_task_new(NULL, NULL, on_graph_done, w);
+    g_task_set_task_data(task, g_strdup(w->root), g_free);
+    g_task_run_in_thread(task, graph_thread);
+    g_object_unref(task);
+}
+
+static void monitor_free(gpointer p)
+{
+    GFileMonitor *mon = G_FILE_MONITOR(p);
+    g_file_monitor_cancel(mon);
+    g_object_unref(mon);
+}
+
+HyprWatch *hypr_watch_new(const char *root, gboolean follow_sources, HyprWatchFunc func, gpointer user_data)
+{
+    HyprWatch *w = g_new0(HyprWatch, 1);
+    w->root = g_strdup(root);
+    w->follow_sources = follow_sources;
+    w->func = func;
+    w->user_data = user_data;
+    w->monitors = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, monitor_free);
+    w->pending = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+
+    add_monitor(w, root);
+    if (follow_sources) refresh_graph(w);
+    return w;
+}
@@ -0,0 +1,17 @@
+/* hyprwatch.h - watch a Hyprland config and everything it sources */
+#ifndef HYPRWATCH_H
+#define HYPRWATCH_H
+
+#include <gio/gio.h>
+
+typedef struct HyprWatch HyprWatch;
+
+/* Called once per changed (or deleted/recreated) file after a short settle
+ * delay. `path` is the path as it appears in the include graph. */
+typedef void (*HyprWatchFunc)(const char *path, gpointer user_data);
+
+/* Watch `root` and, if `follow_sources` is set, its whole include graph. The
+ * graph is recomputed on a worker whenever one of its files changes. */
+HyprWatch *hypr_watch_new(const char *root, gboolean follow_sources, HyprWatchFunc func, gpointer user_data);
+
+#endif /* HYPRWATCH_H */
@@ -27,6 +27,9 @@
 #include "pages/defaultapps.h"
 #include "pages/config.h"
 #include "pages/audio.h"
+#include "pages/monitors.h"
+#include "pages/workspaces.h"
+#include "pages/windowrules.h"
 
 /* Sidebar list row selection callback */
 static void on_row_selected(GtkListBox *list, GtkListBoxRow *row, GtkStack *stack)
@@ -40,6 +43,9 @@ static void on_row_selected(GtkListBox *list, GtkListBoxRow *row, GtkStack *stac
         "Users",
         "Appearance",
         "Hyprland",
+        "Monitors",
+        "Workspaces",
+        "Window Rules",
         "Audio",
         "Devices",
         "Disks",
@@ -81,6 +87,9 @@ static void on_activate(GApplication *app, gpointer user_data)
     GtkWidget *row2 = gtk_label_new("Users");
     GtkWidget *row3 = gtk_label_new("Appearance");
     GtkWidget *row_hypr = gtk_label_new("Hyprland");
+    GtkWidget *row_monitors = gtk_label_new("Monitors");
+    GtkWidget *row_workspaces = gtk_label_new("Workspaces");
+    GtkWidget *row_windowrules = gtk_label_new("Window Rules");
     GtkWidget *row_audio = gtk_label_new("Audio");
     GtkWidget *row_devices = gtk_label_new("Devices");
     GtkWidget *row_disks = gtk_label_new("Disks");
@@ -95,6 +104,9 @@ static void on_activate(GApplication *app, gpointer user_data)
     gtk_list_box_insert(GTK_LIST_BOX(list), row2, -1);
     gtk_list_box_insert(GTK_LIST_BOX(list), row3, -1);
     gtk_list_box_insert(GTK_LIST_BOX(list), row_hypr, -1);
+    gtk_list_box_insert(GTK_LIST_BOX(list), row_monitors, -1);
+    gtk_list_box_insert(GTK_LIST_BOX(list), row_workspaces, -1);
+    gtk_list_box_insert(GTK_LIST_BOX(list), row_windowrules, -1);
     gtk_list_box_insert(GTK_LIST_BOX(list), row_audio, -1);
     gtk_list_box_insert(GTK_LIST_BOX(list), row_devices, -1);
     gtk_list_box_insert(GTK_LIST_BOX(list), row_disks, -1);
@@ -127,6 +139,9 @@ static void on_activate(GApplication *app, gpointer user_data)
     GtkWidget *users_page = create_users_page(window, GTK_LABEL(status_label));
     GtkWidget *appearance_page = create_appearance_page(GTK_LABEL(status_label));
     GtkWidget *hyprland_page = create_hyprland_page(GTK_LABEL(status_label));
+    GtkWidget *monitors_page = create_monitors_page(GTK_LABEL(status_label));
+    GtkWidget *workspaces_page = create_workspaces_page(GTK_LABEL(status_label));
+    GtkWidget *windowrules_page = create_windowrules_page(GTK_LABEL(status_label));
     GtkWidget *audio_page = create_audio_page(GTK_LABEL(status_label));
     GtkWidget *devices_page = create_devices_page(GTK_LABEL(status_label));
     GtkWidget *disks_page = create_disks_page(GTK_LABEL(status_label));
@@ -142,6 +157,9 @@ static void on_activate(GApplication *app, gpointer user_data)
     gtk_stack_add_named(GTK_STACK(stack), users_page, "Users");
     gtk_stack_add_named(GTK_STACK(stack), appearance_page, "Appearance");
     gtk_stack_add_named(GTK_STACK(stack), hyprland_page, "Hyprland");
+    gtk_stack_add_named(GTK_STACK(stack), monitors_page, "Monitors");
+    gtk_stack_add_named(GTK_STACK(stack), workspaces_page, "Workspaces");
+    gtk_stack_add_named(GTK_STACK(stack), windowrules_page, "Window Rules");
     gtk_stack_add_named(GTK_STACK(stack), audio_page, "Audio");
     gtk_stack_add_named(GTK_STACK(stack), devices_page, "Devices");
     gtk_stack_add_named(GTK_STACK(stack), disks_page, "Disks");
@@ -0,0 +1,422 @@
+/* pacdb.c - read-only pacman database queries (pending updates, vercmp)
+ *
+ * The local database is a directory of "<name>-<pkgver>-<pkgrel>" entries,
+ * so installed versions come from a single directory listing. Each sync
+ * database is a (normally gzip-compressed) tar archive with one such
+ * directory per package; only the tar headers are read, the package
+ * descriptions are skipped over. */
+#include "pacdb.h"
+#include <gio/gio.h>
+#include <string.h>
+
+void pac_update_free(PacUpdate *u)
+{
+    if (!u) return;
+    g_free(u->name);
+    g_free(u->local_version);
+    g_free(u->new_version);
+    g_free(u->repo);
+    g_free(u);
+}
+
+/* ---- version comparison ---- */
+
+/* rpmvercmp: alternating runs of digits and letters, compared run by run;
+ * separators only matter by their length */
+static int rpmvercmp(const char *a, const char *b)
+{
+    if (strcmp(a, b) == 0) return 0;
+
+    const char *one = a, *two = b;
+    while (*one && *two) {
+        const char *sep1 = one, *sep2 = two;
+        while (*one && !g_ascii_isalnum(*one)) one++;
+        while (*two && !g_ascii_isalnum(*two)) two++;
+        if (!*one || !*two) break;
+        if (one - sep1 != two - sep2) return one - sep1 < two - sep2 ? -1 : 1;
+
+        const char *end1 = one, *end2 = two;
+        gboolean isnum = g_ascii_isdigit(*one);
+        if (isnum) {
+            while (g_ascii_isdigit(*end1)) end1++;
+            while (g_ascii_isdigit(*end2)) end2++;
+        } else {
+            while (g_ascii_isalpha(*end1)) end1++;
+            while (g_ascii_isalpha(*end2)) end2++;
+        }
+        /* a number against letters: the number is newer */
+        if (end2 == two) return isnum ? 1 : -1;
+
+        if (isnum) {
+            while (one < end1 && *one == '0') one++;
+            while (two < end2 && *two == '0') two++;
+            if (end1 - one != end2 - two) return end1 - one > end2 - two ? 1 : -1;
+        }
+        gsize len1 = (gsize)(end1 - one), len2 = (gsize)(end2 - two);
+        int rc = memcmp(one, two, MIN(len1, len2));
+        if (rc == 0 && len1 != len2) rc = len1 < len2 ? -1 : 1;
+        if (rc) return rc < 0 ? -1 : 1;
+        one = end1;
+        two = end2;
+    }
+    if (!*one && !*two) return 0;
+    /* a remaining letter run (1.0a) is older than nothing (1.0); anything
+     * else remaining (1.0.1) is newer */
+    return (!*one && !g_ascii_isalpha(*two)) || g_ascii_isalpha(*one) ? -1 : 1;
+}
+
+/* Split [epoch:]version[-release] in place; epoch defaults to "0" */
+static void parse_evr(char *evr, const char **epoch, const char **version, const char **release)
+{
+    char *s = evr;
+    while (g_ascii_isdigit(*s)) s++;
+    char *dash = strrchr(s, '-');
+    if (*s == ':') {
+        *epoch = evr;
+        *s++ = '\0';
+        *version = s;
+        if (**epoch == '\0') *epoch = "0";
+    } else {
+        *epoch = "0";
+        *version = evr;
+    }
+    *release = NULL;
+    if (dash) {
+        *dash = '\0';
+        *release = dash + 1;
+    }
+}
+
+int pac_vercmp(const char *a, const char *b)
+{
+    if (!a || !b) return !a ? (!b ? 0 : -1) : 1;
+    if (strcmp(a, b) == 0) return 0;
+
+    char *ca = g_strdup(a), *cb = g_strdup(b);
+    const char *e1, *v1, *r1, *e2, *v2, *r2;
+    parse_evr(ca, &e1, &v1, &r1);
+    parse_evr(cb, &e2, &v2, &r2);
+
+    int ret = rpmvercmp(e1, e2);
+    if (ret == 0) {
+        ret = rpmvercmp(v1, v2);
+        if (ret == 0 && r1 && r2) ret = rpmvercmp(r1, r2);
+    }
+    g_free(ca);
+    g_free(cb);
+    return ret;
+}
+
+/* ---- databases ---- */
+
+/* "<name>-<pkgver>-<pkgrel>" -> name and "<pkgver>-<pkgrel>" (pkgver may
+ * carry an epoch, neither part contains '-') */
+static gboolean split_entry(const char *entry, gsize len, char **name, char **version)
+{
+    const char *rel = NULL, *ver = NULL;
+    for (const char *p = entry + len; p > entry; p--) {
+        if (p[-1] != '-') continue;
+        if (!rel) {
+            rel = p;
+        } else {
+            ver = p;
+            break;
+        }
+    }
+    if (!ver || ver - 1 == entry) return FALSE;
+    *name = g_strndup(entry, (gsize)(ver - 1 - entry));
+    *version = g_strndup(ver, (gsize)(entry + len - ver));
+    return TRUE;
+}
+
+typedef struct {
+    char *version;
+    const char *repo;
+} SyncPkg;
+
+static void sync_pkg_free(gpointer p)
+{
+    SyncPkg *sp = p;
+    g_free(sp->version);
+    g_free(sp);
+}
+
+static guint64 tar_octal(const guchar *field, gsize len)
+{
+    guint64 v = 0;
+    for (gsize i = 0; i < len && field[i] >= '0' && field[i] <= '7'; i++) v = v * 8 + (field[i] - '0');
+    return v;
+}
+
+/* Longest GNU long-name or pax header read; larger ones are skipped */
+#define TAR_META_MAX 65536
+
+/* The "path" record of a pax extended header ("<len> path=<value>\n"), or
+ * NULL */
+static char *pax_path(const char *data, gsize len)
+{
+    const char *p = data, *end = data + len;
+    while (p < end) {
+        char *rest = NULL;
+        guint64 reclen = g_ascii_strtoull(p, &rest, 10);
+        if (reclen == 0 || rest >= end || *rest != ' ' || reclen > (guint64)(end - p)) break;
+        const char *rec_end = p + reclen, *key = rest + 1;
+        const char *eq = memchr(key, '=', (gsize)(rec_end - key));
+        if (eq && eq - key == 4 && memcmp(key, "path", 4) == 0 && rec_end[-1] == '\n')
+            return g_strndup(eq + 1, (gsize)(rec_end - 1 - (eq + 1)));
+        p = rec_end;
+    }
+    return NULL;
+}
+
+/* Add every package of one sync database to `pkgs` unless an earlier
+ * repository already has it */
+static gboolean read_sync_db(const char *path, const char *repo, GHashTable *pkgs, GError **error)
+{
+    GMappedFile *mf = g_mapped_file_new(path, FALSE, error);
+    if (!mf) return FALSE;
+    const guchar *data = (const guchar *)g_mapped_file_get_contents(mf);
+    gsize size = g_mapped_file_get_length(mf);
+
+    GBytes *bytes = g_mapped_file_get_bytes(mf);
+    GInputStream *in = g_memory_input_stream_new_from_bytes(bytes);
+    g_bytes_unref(bytes);
+    if (size >= 2 && data[0] == 0x1f && data[1] == 0x8b) {
+        GConverter *gz = G_CONVERTER(g_zlib_decompressor_new(G_ZLIB_COMPRESSOR_FORMAT_GZIP));
+        GInputStream *conv = g_converter_input_stream_new(in, gz);
+        g_object_unref(gz);
+        g_object_unref(in);
+        in = conv;
+    } else if (!(size >= 262 && memcmp(data + 257, "ustar", 5) == 0)) {
+        /* zstd or xz databases would need another decompressor */
+        g_set_error(error, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED, "%s: unsupported compression", path);
+        g_object_unref(in);
+        g_mapped_file_unref(mf);
+        return FALSE;
+    }
+
+    gboolean ok = TRUE;
+    guchar hdr[512];
+    char *long_name = NULL;  /* from a GNU 'L' or pax 'x' entry, for the next header */
+    for (;;) {
+        gsize got = 0;
+        if (!g_input_stream_read_all(in, hdr, sizeof(hdr), &got, NULL, error)) {
+            ok = FALSE;
+            break;
+        }
+        if (got < sizeof(hdr) || hdr[0] == '\0') break;  /* end of archive */
+
+        guint64 len = tar_octal(hdr + 124, 12);
+        goffset skip = (goffset)((len + 511) & ~(guint64)511);
+
+        /* a name too long for the header comes in an entry of its own */
+        if ((hdr[156] == 'L' || hdr[156] == 'x') && len <= TAR_META_MAX) {
+            char *meta = g_malloc((gsize)skip + 1);
+            if (!g_input_stream_read_all(in, meta, (gsize)skip, &got, NULL, error)) ok = FALSE;
+            if (!ok || got < (gsize)skip) {
+                g_free(meta);
+                break;
+            }
+            meta[len] = '\0';
+            g_free(long_name);
+            long_name = hdr[156] == 'L' ? g_strdup(meta) : pax_path(meta, (gsize)len);
+            g_free(meta);
+            continue;
+        }
+
+        /* the package directory, or its desc file when the archive has no
+         * directory entries; POSIX ustar splits long names into prefix and
+         * name */
+        char *name;
+        if (long_name)
+            name = g_steal_pointer(&long_name);
+        else if (memcmp(hdr + 257, "ustar\0", 6) == 0 && hdr[345])
+            name = g_strdup_printf("%.*s/%.*s", (int)strnlen((const char *)hdr + 345, 155), hdr + 345,
+                                   (int)strnlen((const char *)hdr, 100), hdr);
+        else
+            name = g_strndup((const char *)hdr, 100);
+        const char *slash = strchr(name, '/');
+        if (slash && hdr[156] != 'x' && hdr[156] != 'g' && hdr[156] != 'L') {
+            char *pkg = NULL, *version = NULL;
+            if (split_entry(name, (gsize)(slash - name), &pkg, &version) && !g_hash_table_contains(pkgs, pkg)) {
+                SyncPkg *sp = g_new0(SyncPkg, 1);
+                sp->version = version;
+                sp->repo = repo;
+                g_hash_table_insert(pkgs, pkg, sp);
+            } else {
+                g_free(pkg);
+                g_free(version);
+            }
+        }
+        g_free(name);
+
+        while (skip > 0) {
+            gssize n = g_input_stream_skip(in, (gsize)skip, NULL, error);
+            if (n <= 0) {
+                ok = n == 0;
+                break;
+            }
+            skip -= n;
+        }
+        if (!ok || skip > 0) break;
+    }
+    g_free(long_name);
+    g_object_unref(in);
+    g_mapped_file_unref(mf);
+    return ok;
+}
+
+typedef struct {
+    char *dbpath;
+    GPtrArray *repos;     /* in pacman.conf order */
+    GPtrArray *ignore;    /* IgnorePkg patterns */
+} PacConf;
+
+static void pac_conf_clear(PacConf *pc)
+{
+    g_free(pc->dbpath);
+    g_ptr_array_unref(pc->repos);
+    g_ptr_array_unref(pc->ignore);
+}
+
+static gint compare_names(gconstpointer a, gconstpointer b)
+{
+    return strcmp(*(const char * const *)a, *(const char * const *)b);
+}
+
+/* The parts of pacman.conf the query needs; Include files only list
+ * servers, so they are not followed */
+static void pac_conf_read(const char *path, PacConf *pc)
+{
+    pc->dbpath = NULL;
+    pc->repos = g_ptr_array_new_with_free_func(g_free);
+    pc->ignore = g_ptr_array_new_with_free_func(g_free);
+
+    char *contents = NULL;
+    if (g_file_get_contents(path, &contents, NULL, NULL)) {
+        char **lines = g_strsplit(contents, "\n", -1);
+        gboolean options = FALSE;
+        for (char **l = lines; *l; l++) {
+            char *hash = strchr(*l, '#');
+            if (hash) *hash = '\0';
+            char *line = g_strstrip(*l);
+            gsize n = strlen(line);
+            if (n > 2 && line[0] == '[' && line[n - 1] == ']') {
+                char *section = g_strndup(line + 1, n - 2);
+                options = strcmp(section, "options") == 0;
+                if (options) g_free(section);
+                else g_ptr_array_add(pc->repos, section);
+                continue;
+            }
+            char *eq = strchr(line, '=');
+            if (!options || !eq) continue;
+            *eq = '\0';
+            char *key = g_strstrip(line), *value = g_strstrip(eq + 1);
+            if (strcmp(key, "DBPath") == 0) {
+                g_free(pc->dbpath);
+                pc->dbpath = g_strdup(value);
+            } else if (strcmp(key, "IgnorePkg") == 0) {
+                char **pats = g_strsplit_set(value, " \t", -1);
+                for (char **p = pats; *p; p++) {
+                    if (**p) g_ptr_array_add(pc->ignore, g_strdup(*p));
+                }
+                g_strfreev(pats);
+            }
+        }
+        g_strfreev(lines);
+        g_free(contents);
+    }
+    if (!pc->dbpath) pc->dbpath = g_strdup(PACDB_DEFAULT_DBPATH);
+
+    /* no usable config: every sync database, alphabetically */
+    if (pc->repos->len == 0) {
+        char *sync = g_build_filename(pc->dbpath, "sync", NULL);
+        GDir *dir = g_dir_open(sync, 0, NULL);
+        const char *e;
+        while (dir && (e = g_dir_read_name(dir))) {
+            if (g_str_has_suffix(e, ".db")) g_ptr_array_add(pc->repos, g_strndup(e, strlen(e) - 3));
+        }
+        if (dir) g_dir_close(dir);
+        g_ptr_array_sort(pc->repos, compare_names);
+        g_free(sync);
+    }
+}
+
+static gboolean is_ignored(PacConf *pc, const char *name)
+{
+    for (guint i = 0; i < pc->ignore->len; i++) {
+        if (g_pattern_match_simple(g_ptr_array_index(pc->ignore, i), name)) return TRUE;
+    }
+    return FALSE;
+}
+
+static gint compare_updates(gconstpointer a, gconstpointer b)
+{
+    const PacUpdate *ua = *(PacUpdate * const *)a, *ub = *(PacUpdate * const *)b;
+    return strcmp(ua->name, ub->name);
+}
+
+GPtrArray *pac_db_pending_updates(const char *conf, GError **error)
+{
+    PacConf pc;
+    pac_conf_read(conf ? conf : PACDB_CONF, &pc);
+
+    GHashTable *pkgs = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, sync_pkg_free);
+    guint read = 0;
+    GError *first = NULL;
+    for (guint i = 0; i < pc.repos->len; i++) {
+        const char *repo = g_ptr_array_index(pc.repos, i);
+        char *file = g_strconcat(repo, ".db", NULL);
+        char *path = g_build_filename(pc.dbpath, "sync", file, NULL);
+        GError *err = NULL;
+        if (read_sync_db(path, repo, pkgs, &err)) {
+            read++;
+        } else {
+            g_warning("Skipping sync database %s: %s", path, err->message);
+            if (!first) first = err;
+            else g_error_free(err);
+        }
+        g_free(file);
+        g_free(path);
+    }
+
+    GPtrArray *updates = NULL;
+    GDir *dir = NULL;
+    if (read == 0) {
+        if (first) g_propagate_error(error, g_steal_pointer(&first));
+        else g_set_error(error, G_IO_ERROR, G_IO_ERROR_NOT_FOUND, "No sync databases found in %s", pc.dbpath);
+    } else {
+        char *local = g_build_filename(pc.dbpath, "local", NULL);
+        dir = g_dir_open(local, 0, error);
+        g_free(local);
+    }
+    g_clear_error(&first);
+
+    if (dir) {
+        updates = g_ptr_array_new_with_free_func((GDestroyNotify)pac_update_free);
+        const char *e;
+        while ((e = g_dir_read_name(dir))) {
+            char *name = NULL, *version = NULL;
+            if (!split_entry(e, strlen(e), &name, &version)) continue;  /* ALPM_DB_VERSION */
+            SyncPkg *sp = g_hash_table_lookup(pkgs, name);
+            if (sp && pac_vercmp(sp->version, version) > 0) {
+                PacUpdate *u = g_new0(PacUpdate, 1);
+                u->name = name;
+                u->local_version = version;
+                u->new_version = g_strdup(sp->version);
+                u->repo = g_strdup(sp->repo);
+                u->ignored = is_ignored(&pc, name);
+                g_ptr_array_add(updates, u);
+            } else {
+                g_free(name);
+                g_free(version);
+            }
+        }
+        g_dir_close(dir);
+        g_ptr_array_sort(updates, compare_updates);
+    }
+
+    g_hash_table_destroy(pkgs);
+    pac_conf_clear(&pc);
+    return updates;
+}
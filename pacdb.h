@@ -0,0 +1,33 @@
+/* pacdb.h - read-only pacman database queries (pending updates, vercmp) */
+#ifndef PACDB_H
+#define PACDB_H
+
+#include <glib.h>
+
+#define PACDB_CONF "/etc/pacman.conf"
+#define PACDB_DEFAULT_DBPATH "/var/lib/pacman/"
+
+typedef struct {
+    char *name;
+    char *local_version;
+    char *new_version;
+    char *repo;
+    gboolean ignored;   /* matches IgnorePkg; pacman -Syu would skip it */
+} PacUpdate;
+
+void pac_update_free(PacUpdate *u);
+
+/* Compare two [epoch:]version[-release] strings the way pacman does
+ * (alpm_pkg_vercmp / rpmvercmp): <0, 0 or >0 */
+int pac_vercmp(const char *a, const char *b);
+
+/* Installed packages with a newer version in a sync database, sorted by
+ * name; the equivalent of `pacman -Qu`. DBPath, the repository order and
+ * IgnorePkg come from `conf` (PACDB_CONF when NULL); the first repository
+ * carrying a package wins, as in pacman. Reads the local database
+ * directory names and the sync database archives directly, so nothing is
+ * spawned and no lock is taken. Returns a GPtrArray of PacUpdate, or NULL
+ * when no database could be read. */
+GPtrArray *pac_db_pending_updates(const char *conf, GError **error);
+
+#endif /* PACDB_H */
@@ -1,320 +1,1121 @@
 #include "../common.h"
+#include "../pulse.h"
+#include "../pwgraph.h"
+#include "../pwtune.h"
+#include "../eq.h"
 #include "audio.h"
 #include <string.h>
+#include <math.h>
 #include <gdk/gdk.h>
 
 /*
  * Audio page with PipeWire integration:
- * - Volume slider that uses `pactl` (works with PipeWire's pulse compatibility)
- * - Mute toggle (disables slider when active)
- * - Periodic refresh to reflect external changes
- * - Non-editable text view showing PipeWire info
+ * - Volume slider and mute toggle bound to the default sink, kept current by
+ *   a persistent pulse connection (events, no polling)
+ * - Default output/input pickers and card profiles
+ * - Peak/RMS level meters for the default output and input
+ * - Per-application mixer: volume, mute and output device for each stream
+ * - PipeWire graph (nodes, ports, links) as an expandable tree, refreshed
+ *   in place when devices or the server change
+ * - Clock rate and quantum, forcing them live or across restarts, and
+ *   per-node timing and xruns from pw-top while that panel is open
+ * - Parametric equalizer sink (filter-chain) with its frequency response
  * - Button to refresh PipeWire info
  * - Button to restart PipeWire services
  * - Button to open `pavucontrol`
  */
 
+#define PIPEWIRE_RESTART_CMD "systemctl --user restart pipewire pipewire-pulse pipewire-media-session wireplumber 2>/dev/null && echo 'PipeWire stuff restarted ✅'"
+
+/* Burst of device events (e.g. a PipeWire restart) costs one info refresh */
+#define AUDIO_INFO_SETTLE_MS 300
+/* Meter scale and how fast the shown level falls back */
+#define METER_FLOOR_DB -60.0
+#define METER_FALL_DB_PER_S 24.0
+/* Pause between pw-top samples while the latency panel is open; each
+ * sample itself takes about a second */
+#define TUNE_POLL_S 1
+/* Equalizer edits are saved, and pushed to the running sink, once they
+ * pause this long */
+#define EQ_SETTLE_MS 150
+#define EQ_PLOT_RATE 48000.0
+#define EQ_PLOT_RANGE_DB 18.0
+
+/* A level meter bar. It records only while on screen and repaints on frame
+ * clock ticks when the level moved. */
+typedef struct {
+    GtkWidget  *area;
+    PulseServer *server;
+    PulseMeter *meter;
+    char       *source;   /* what it records, or NULL */
+    double      peak, rms; /* shown, 0..1 on the dB scale */
+    gint64      last_us;
+} LevelMeter;
+
+
 typedef struct {
     GtkScale    *scale;
     GtkLabel    *vol_label;
     GtkCheckButton *mute_btn;
     GtkLabel    *status;
-    GtkTextView *info_tv;
-    gint64       last_set_time_us;
+    GtkLabel    *version_label;
+    LevelMeter  *out_meter, *in_meter;
+    PwGraph     *graph;         /* NULL once the page is gone */
+    GCancellable *graph_cancel;
+    GtkWidget   *no_streams;
+    PulseServer *server;
+    PulseDevice *sink;          /* default sink the controls follow, or NULL */
+    gulong       volume_id, muted_id;
+    gboolean     updating;      /* controls are being set from the model */
+    gboolean     devices_changing; /* sink or source list is emitting items-changed */
+    gboolean     picking;       /* pickers are being set from the model */
+    GtkDropDown *out_dd, *in_dd;
+    guint        info_id;
     gboolean     refresh_in_progress;
+    gboolean     refresh_again;
+    GtkWidget   *tune_box;      /* latency panel contents; mapped while open */
+    GtkLabel    *clock_label, *nodes_label;
+    GtkDropDown *quantum_dd, *rate_dd;
+    GtkCheckButton *persist_btn;
+    guint        tune_id;
+    gboolean     tune_in_progress;
+    gboolean     tune_syncing;  /* latency pickers are being set from PipeWire */
+    gboolean     tune_setting, tune_set_again;  /* forced values being written / picked again since */
+    GArray      *eq_bands;      /* EqBand */
+    gboolean     eq_enabled;
+    gboolean     eq_restart;    /* bands or on/off differ from what PipeWire loaded */
+    GtkWidget   *eq_rows, *eq_plot, *eq_add, *eq_apply;
+    guint        eq_settle_id;
 } AudioUI;
 
-/* Helper: parse percentage from `pactl get-sink-volume @DEFAULT_SINK@` output */
-static int parse_volume_percent(const char *out)
-{
-    if (!out) return -1;
-    /* find first ' %' and then backtrack to number */
-    const char *p = strchr(out, '%');
-    while (p) {
-        /* back up to find digits before percent */
-        const char *q = p;
-        while (q > out && (*(q-1) == ' ' || *(q-1) == '\t' || *(q-1) == ',')) q--;
-        /* now q-1 is last non-space; find start of number */
-        const char *start = q;
-        while (start > out && (*(start-1) >= '0' && *(start-1) <= '9')) start--;
-        if (start < q) {
-            char numbuf[16] = {0};
-            size_t len = q - start;
-            if (len < sizeof(numbuf)) {
-                strncpy(numbuf, start, len);
-                numbuf[len] = '\0';
-                int v = atoi(numbuf);
-                return v;
-            }
+static double meter_scale(float linear)
+{
+    if (linear <= 0) return 0;
+    double db = 20.0 * log10(linear);
+    return CLAMP((db - METER_FLOOR_DB) / -METER_FLOOR_DB, 0.0, 1.0);
+}
+
+static gboolean on_meter_tick(GtkWidget *w, GdkFrameClock *clock, gpointer user_data)
+{
+    LevelMeter *lm = user_data;
+    gint64 now = gdk_frame_clock_get_frame_time(clock);
+    double dt = lm->last_us ? (now - lm->last_us) / 1e6 : 0;
+    lm->last_us = now;
+
+    float peak = 0, rms = 0;
+    pulse_meter_take(lm->meter, &peak, &rms);
+    double fall = dt * METER_FALL_DB_PER_S / -METER_FLOOR_DB;
+    double np = MAX(meter_scale(peak), lm->peak - fall);
+    double nr = MAX(meter_scale(rms), lm->rms - fall);
+    if (fabs(np - lm->peak) > 0.002 || fabs(nr - lm->rms) > 0.002) {
+        lm->peak = np;
+        lm->rms = nr;
+        gtk_widget_queue_draw(w);
+    }
+    return G_SOURCE_CONTINUE;
+}
+
+static void draw_meter(GtkDrawingArea *area, cairo_t *cr, int width, int height, gpointer user_data)
+{
+    LevelMeter *lm = user_data;
+    GdkRGBA fg;
+    gtk_widget_get_color(GTK_WIDGET(area), &fg);
+    cairo_set_source_rgba(cr, fg.red, fg.green, fg.blue, 0.15);
+    cairo_rectangle(cr, 0, 0, width, height);
+    cairo_fill(cr);
+    cairo_set_source_rgba(cr, 0.21, 0.52, 0.89, 0.85);
+    cairo_rectangle(cr, 0, 0, width * lm->rms, height);
+    cairo_fill(cr);
+    if (lm->peak > 0) {
+        gdk_cairo_set_source_rgba(cr, &fg);
+        cairo_rectangle(cr, MAX(0, width * lm->peak - 2), 0, 2, height);
+        cairo_fill(cr);
+    }
+}
+
+static void meter_open(LevelMeter *lm)
+{
+    pulse_meter_free(lm->meter);
+    lm->meter = gtk_widget_get_mapped(lm->area) ? pulse_meter_new(lm->server, lm->source) : NULL;
+}
+
+static void on_meter_map(GtkWidget *w, gpointer user_data)
+{
+    meter_open(user_data);
+}
+
+static void on_meter_unmap(GtkWidget *w, gpointer user_data)
+{
+    LevelMeter *lm = user_data;
+    pulse_meter_free(lm->meter);
+    lm->meter = NULL;
+    lm->peak = lm->rms = 0;
+    lm->last_us = 0;
+}
+
+static LevelMeter *level_meter_new(PulseServer *server)
+{
+    LevelMeter *lm = g_new0(LevelMeter, 1);
+    lm->server = server;
+    lm->area = gtk_drawing_area_new();
+    gtk_drawing_area_set_content_height(GTK_DRAWING_AREA(lm->area), 8);
+    gtk_widget_set_hexpand(lm->area, TRUE);
+    gtk_widget_set_valign(lm->area, GTK_ALIGN_CENTER);
+    gtk_drawing_area_set_draw_func(GTK_DRAWING_AREA(lm->area), draw_meter, lm, NULL);
+    g_signal_connect(lm->area, "map", G_CALLBACK(on_meter_map), lm);
+    g_signal_connect(lm->area, "unmap", G_CALLBACK(on_meter_unmap), lm);
+    /* ticks only run while mapped */
+    gtk_widget_add_tick_callback(lm->area, on_meter_tick, lm, NULL);
+    return lm;
+}
+
+/* Reopen on a new device, and drop or reopen the recording when the
+ * connection goes or comes back */
+static void level_meter_set_source(LevelMeter *lm, const char *source)
+{
+    gboolean connected = pulse_server_is_connected(lm->server);
+    if (g_strcmp0(lm->source, source) == 0 && (lm->meter != NULL) == connected) return;
+    g_free(lm->source);
+    lm->source = g_strdup(source);
+    meter_open(lm);
+}
+
+/* Meters follow the defaults; the output meter records the sink's monitor */
+static void track_meter_sources(AudioUI *ui)
+{
+    const char *sink = pulse_server_get_default_sink(ui->server);
+    char *monitor = sink ? g_strconcat(sink, ".monitor", NULL) : NULL;
+    level_meter_set_source(ui->out_meter, monitor);
+    level_meter_set_source(ui->in_meter, pulse_server_get_default_source(ui->server));
+    g_free(monitor);
+}
+
+static void refresh_info(AudioUI *ui);
+
+static void on_graph_refreshed(GObject *source, GAsyncResult *res, gpointer user_data)
+{
+    AudioUI *ui = (AudioUI *)user_data;
+    GError *err = NULL;
+    if (!pw_graph_refresh_finish(ui->graph, res, &err)) {
+        if (g_error_matches(err, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+            g_error_free(err);
+            return;
         }
-        /* try next percent sign if parsing failed */
-        p = strchr(p+1, '%');
+        gtk_label_set_text(ui->version_label, err->message);
+        g_error_free(err);
+    } else {
+        const char *version = pw_graph_get_version(ui->graph);
+        const char *server = pulse_server_get_info(ui->server);
+        char *text = g_strdup_printf("%s%s%s", version ? version : "", version && server ? " · " : "", server ? server : "");
+        gtk_label_set_text(ui->version_label, text);
+        g_free(text);
+    }
+    ui->refresh_in_progress = FALSE;
+    /* something changed again while we were collecting */
+    if (ui->refresh_again) {
+        ui->refresh_again = FALSE;
+        refresh_info(ui);
     }
-    return -1;
 }
 
-/* Helper: run PipeWire info commands and collect output */
-static gchar *get_pipewire_info(void)
+static void refresh_info(AudioUI *ui)
 {
-    GString *gs = g_string_new(NULL);
-    
-    /* pipewire --version */
-    gchar *out = NULL, *err = NULL;
-    if (g_spawn_command_line_sync("pipewire --version", &out, &err, NULL, NULL)) {
-        g_string_append(gs, "=== PipeWire Version ===\n");
-        g_string_append(gs, out ? out : "N/A");
-        g_string_append(gs, "\n\n");
-    }
-    if (out) g_free(out);
-    if (err) g_free(err);
-    
-    /* pactl info */
-    out = err = NULL;
-    if (g_spawn_command_line_sync("pactl info", &out, &err, NULL, NULL)) {
-        g_string_append(gs, "=== PulseAudio Info ===\n");
-        g_string_append(gs, out ? out : "N/A");
-        g_string_append(gs, "\n\n");
-    }
-    if (out) g_free(out);
-    if (err) g_free(err);
-    
-    /* pactl list short sinks */
-    out = err = NULL;
-    if (g_spawn_command_line_sync("pactl list short sinks", &out, &err, NULL, NULL)) {
-        g_string_append(gs, "=== Sinks (Outputs) ===\n");
-        g_string_append(gs, out ? out : "N/A");
-        g_string_append(gs, "\n\n");
-    }
-    if (out) g_free(out);
-    if (err) g_free(err);
-    
-    /* pactl list short sources */
-    out = err = NULL;
-    if (g_spawn_command_line_sync("pactl list short sources", &out, &err, NULL, NULL)) {
-        g_string_append(gs, "=== Sources (Inputs) ===\n");
-        g_string_append(gs, out ? out : "N/A");
-        g_string_append(gs, "\n\n");
-    }
-    if (out) g_free(out);
-    if (err) g_free(err);
-    
-    /* pactl list sink-inputs */
-    out = err = NULL;
-    if (g_spawn_command_line_sync("pactl list sink-inputs", &out, &err, NULL, NULL)) {
-        g_string_append(gs, "=== Sink Inputs (Apps) ===\n");
-        g_string_append(gs, out ? out : "N/A");
-        g_string_append(gs, "\n\n");
-    }
-    if (out) g_free(out);
-    if (err) g_free(err);
-    
-    /* pactl list source-outputs */
-    out = err = NULL;
-    if (g_spawn_command_line_sync("pactl list source-outputs", &out, &err, NULL, NULL)) {
-        g_string_append(gs, "=== Source Outputs ===\n");
-        g_string_append(gs, out ? out : "N/A");
-    }
-    if (out) g_free(out);
-    if (err) g_free(err);
-    
-    gchar *result = g_string_free(gs, FALSE);
-    return result;
+    if (!ui->graph) return;
+    if (ui->refresh_in_progress) {
+        ui->refresh_again = TRUE;
+        return;
+    }
+    ui->refresh_in_progress = TRUE;
+    pw_graph_refresh_async(ui->graph, ui->graph_cancel, on_graph_refreshed, ui);
 }
 
-typedef struct {
-    GtkTextView *tv;
-    AudioUI *ui;
-} UpdateInfoData;
+/* The graph goes with its view; a refresh still running is cancelled and
+ * never touches it */
+static void on_graph_destroy(GtkWidget *w, gpointer user_data)
+{
+    AudioUI *ui = (AudioUI *)user_data;
+    if (ui->info_id) g_source_remove(ui->info_id);
+    ui->info_id = 0;
+    g_cancellable_cancel(ui->graph_cancel);
+    g_clear_object(&ui->graph_cancel);
+    pw_graph_free(ui->graph);
+    ui->graph = NULL;
+}
+
+/* Graph tree rows: expander with the item's label and a dimmed detail */
+static GListModel *graph_children(gpointer item, gpointer user_data)
+{
+    GListModel *children = pw_graph_item_get_children(PW_GRAPH_ITEM(item));
+    return children ? g_object_ref(children) : NULL;
+}
+
+static void graph_row_setup(GtkSignalListItemFactory *f, GtkListItem *li, gpointer user_data)
+{
+    GtkWidget *expander = gtk_tree_expander_new();
+    GtkWidget *h = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 8);
+    GtkWidget *label = gtk_label_new("");
+    gtk_label_set_xalign(GTK_LABEL(label), 0);
+    GtkWidget *detail = gtk_label_new("");
+    gtk_label_set_xalign(GTK_LABEL(detail), 0);
+    gtk_widget_add_css_class(detail, "dim-label");
+    gtk_box_append(GTK_BOX(h), label);
+    gtk_box_append(GTK_BOX(h), detail);
+    gtk_tree_expander_set_child(GTK_TREE_EXPANDER(expander), h);
+    gtk_list_item_set_child(li, expander);
+    gtk_list_item_set_activatable(li, FALSE);
+}
+
+static void sync_graph_row(GObject *obj, GParamSpec *pspec, gpointer user_data)
+{
+    GtkWidget *label = gtk_widget_get_first_child(user_data);
+    gtk_label_set_text(GTK_LABEL(label), pw_graph_item_get_label(PW_GRAPH_ITEM(obj)));
+    gtk_label_set_text(GTK_LABEL(gtk_widget_get_next_sibling(label)), pw_graph_item_get_detail(PW_GRAPH_ITEM(obj)));
+}
+
+static void graph_row_bind(GtkSignalListItemFactory *f, GtkListItem *li, gpointer user_data)
+{
+    GtkTreeListRow *row = gtk_list_item_get_item(li);
+    GtkWidget *expander = gtk_list_item_get_child(li);
+    GtkWidget *h = gtk_tree_expander_get_child(GTK_TREE_EXPANDER(expander));
+    gtk_tree_expander_set_list_row(GTK_TREE_EXPANDER(expander), row);
+    GObject *item = gtk_tree_list_row_get_item(row);
+    sync_graph_row(item, NULL, h);
+    gulong id = g_signal_connect(item, "notify", G_CALLBACK(sync_graph_row), h);
+    g_object_set_data(G_OBJECT(h), "notify-id", GSIZE_TO_POINTER(id));
+    g_object_unref(item);
+}
 
-static gboolean update_info_ui_cb(gpointer user_data)
+static void graph_row_unbind(GtkSignalListItemFactory *f, GtkListItem *li, gpointer user_data)
 {
-    UpdateInfoData *d = (UpdateInfoData *)user_data;
-    gchar *info = (gchar *)g_object_get_data(G_OBJECT(d->ui->info_tv), "info_text");
-    if (info) {
-        GtkTextBuffer *buf = gtk_text_view_get_buffer(d->tv);
-        gtk_text_buffer_set_text(buf, info, -1);
-        /* Do NOT free info here; it's owned by the object data */
-        g_object_set_data(G_OBJECT(d->ui->info_tv), "info_text", NULL);
+    GtkWidget *expander = gtk_list_item_get_child(li);
+    GtkWidget *h = gtk_tree_expander_get_child(GTK_TREE_EXPANDER(expander));
+    GObject *item = gtk_tree_list_row_get_item(gtk_list_item_get_item(li));
+    gulong id = GPOINTER_TO_SIZE(g_object_get_data(G_OBJECT(h), "notify-id"));
+    if (id && item) g_signal_handler_disconnect(item, id);
+    g_object_set_data(G_OBJECT(h), "notify-id", NULL);
+    g_clear_object(&item);
+    gtk_tree_expander_set_list_row(GTK_TREE_EXPANDER(expander), NULL);
+}
+
+static gboolean on_info_settled(gpointer user_data)
+{
+    AudioUI *ui = (AudioUI *)user_data;
+    ui->info_id = 0;
+    refresh_info(ui);
+    return G_SOURCE_REMOVE;
+}
+
+/* Devices came or went, or the defaults changed; volume changes do not get
+ * here */
+static void schedule_info_refresh(AudioUI *ui)
+{
+    if (ui->info_id) g_source_remove(ui->info_id);
+    ui->info_id = g_timeout_add(AUDIO_INFO_SETTLE_MS, on_info_settled, ui);
+}
+
+static void on_devices_changed(GListModel *list, guint pos, guint removed, guint added, gpointer user_data)
+{
+    ((AudioUI *)user_data)->devices_changing = TRUE;
+    schedule_info_refresh((AudioUI *)user_data);
+}
+
+static void set_volume_label(AudioUI *ui, int vol)
+{
+    char vl[64];
+    g_snprintf(vl, sizeof(vl), "%d%%", vol);
+    gtk_label_set_text(ui->vol_label, vl);
+}
+
+/* Push the sink's state into the controls */
+static void sync_controls(AudioUI *ui)
+{
+    if (!ui->sink) {
+        gtk_widget_set_sensitive(GTK_WIDGET(ui->scale), FALSE);
+        gtk_widget_set_sensitive(GTK_WIDGET(ui->mute_btn), FALSE);
+        gtk_label_set_text(ui->vol_label, "—");
+        return;
     }
-    g_free(d);
-    return FALSE;
+
+    gboolean muted = pulse_device_get_muted(ui->sink);
+    ui->updating = TRUE;
+    gtk_check_button_set_active(ui->mute_btn, muted);
+    ui->updating = FALSE;
+    gtk_widget_set_sensitive(GTK_WIDGET(ui->mute_btn), TRUE);
+    /* Disable slider when mute is on, enable when mute is off */
+    gtk_widget_set_sensitive(GTK_WIDGET(ui->scale), !muted);
+
+    /* while dragging this is our own target, so the slider does not jump */
+    int vol = (int)pulse_device_get_volume(ui->sink);
+    ui->updating = TRUE;
+    gtk_range_set_value(GTK_RANGE(ui->scale), vol);
+    ui->updating = FALSE;
+    set_volume_label(ui, vol);
 }
 
-static gpointer fetch_pipewire_info_thread(gpointer user_data)
+static void on_sink_notify(GObject *obj, GParamSpec *pspec, gpointer user_data)
+{
+    sync_controls((AudioUI *)user_data);
+}
+
+/* Follow the server's default sink; called when it or the sink list changes */
+static void track_default_sink(AudioUI *ui)
+{
+    PulseDevice *sink = pulse_server_find_sink(ui->server, pulse_server_get_default_sink(ui->server));
+    if (sink == ui->sink) return;
+    if (ui->sink) {
+        g_signal_handler_disconnect(ui->sink, ui->volume_id);
+        g_signal_handler_disconnect(ui->sink, ui->muted_id);
+        g_clear_object(&ui->sink);
+    }
+    if (sink) {
+        ui->sink = g_object_ref(sink);
+        ui->volume_id = g_signal_connect(sink, "notify::volume", G_CALLBACK(on_sink_notify), ui);
+        ui->muted_id = g_signal_connect(sink, "notify::muted", G_CALLBACK(on_sink_notify), ui);
+    }
+    sync_controls(ui);
+}
+
+static void on_sinks_changed(GListModel *list, guint pos, guint removed, guint added, gpointer user_data)
+{
+    AudioUI *ui = (AudioUI *)user_data;
+    /* runs before the dropdowns see the change */
+    ui->devices_changing = TRUE;
+    track_default_sink(ui);
+    schedule_info_refresh(ui);
+}
+
+static void sync_default_pickers(AudioUI *ui);
+
+static void on_devices_changed_after(GListModel *list, guint pos, guint removed, guint added, gpointer user_data)
+{
+    AudioUI *ui = (AudioUI *)user_data;
+    ui->devices_changing = FALSE;
+    sync_default_pickers(ui);
+}
+
+static void on_server_notify(GObject *obj, GParamSpec *pspec, gpointer user_data)
+{
+    AudioUI *ui = (AudioUI *)user_data;
+    track_default_sink(ui);
+    track_meter_sources(ui);
+    sync_default_pickers(ui);
+    schedule_info_refresh(ui);
+}
+
+static void set_volume_from_slider(GtkRange *range, gpointer user_data)
+{
+    AudioUI *ui = (AudioUI *)user_data;
+    if (ui->updating || !ui->sink) return;
+    int val = (int)gtk_range_get_value(range);
+
+    if (g_dry_run) {
+        set_status(ui->status, "Dry run: set %s volume to %d%%", pulse_device_get_name(ui->sink), val);
+        return;
+    }
+
+    /* every step goes in; the connection coalesces them */
+    pulse_device_set_volume(ui->sink, (guint)val);
+}
+
+static void on_mute_toggled(GtkCheckButton *btn, gpointer user_data)
+{
+    AudioUI *ui = (AudioUI *)user_data;
+    if (ui->updating || !ui->sink) return;
+    gboolean active = gtk_check_button_get_active(GTK_CHECK_BUTTON(btn));
+
+    if (g_dry_run) {
+        set_status(ui->status, "Dry run: %s %s", active ? "mute" : "unmute", pulse_device_get_name(ui->sink));
+        return;
+    }
+
+    /* the slider follows from the sink's change event */
+    pulse_device_set_muted(ui->sink, active);
+    set_status(ui->status, "%s %s", active ? "Muted" : "Unmuted", pulse_device_get_description(ui->sink));
+}
+
+static void on_refresh_info_clicked(GtkButton *btn, gpointer user_data)
+{
+    refresh_info((AudioUI *)user_data);
+}
+
+static void on_restart_pipewire_clicked(GtkButton *btn, gpointer user_data)
 {
     AudioUI *ui = (AudioUI *)user_data;
-    gchar *info = get_pipewire_info();
     
-    UpdateInfoData *d = g_new0(UpdateInfoData, 1);
-    d->tv = ui->info_tv;
-    d->ui = ui;
-    g_object_set_data_full(G_OBJECT(ui->info_tv), "info_text", info, g_free);
-    g_idle_add(update_info_ui_cb, d);
+    if (g_dry_run) {
+        set_status(ui->status, "Dry run: %s", PIPEWIRE_RESTART_CMD);
+        return;
+    }
     
-    ui->refresh_in_progress = FALSE;
-    return NULL;
+    run_command_and_report(PIPEWIRE_RESTART_CMD, ui->status);
 }
 
-static gboolean update_volume_ui_cb(gpointer user_data)
+/* Latency panel. Forced values go to the running graph as soon as they are
+ * picked; "Keep after restart" mirrors them into a pipewire.conf.d drop-in. */
+static const guint tune_quanta[] = { 0, 32, 64, 128, 256, 512, 1024, 2048 };
+static const guint tune_rates[] = { 0, 44100, 48000, 88200, 96000, 192000 };
+
+static void tune_poll(AudioUI *ui);
+
+static void select_value(AudioUI *ui, GtkDropDown *dd, const guint *values, guint n, guint value)
+{
+    for (guint i = 0; i < n; i++) {
+        if (values[i] == value && gtk_drop_down_get_selected(dd) != i) {
+            ui->tune_syncing = TRUE;
+            gtk_drop_down_set_selected(dd, i);
+            ui->tune_syncing = FALSE;
+        }
+    }
+}
+
+static void show_tune_nodes(AudioUI *ui, GPtrArray *nodes)
+{
+    if (nodes->len == 0) {
+        gtk_label_set_text(ui->nodes_label, "No timing data (is pw-top installed?)");
+        return;
+    }
+    GString *t = g_string_new(NULL);
+    g_string_append_printf(t, "%5s  %-40s %7s %6s %6s %6s", "ID", "Name", "Quantum", "Rate", "Busy", "Xruns");
+    for (guint i = 0; i < nodes->len; i++) {
+        PwTopNode *n = g_ptr_array_index(nodes, i);
+        /* followers indented under their driver, as pw-top shows them */
+        char *name = g_strdup_printf("%s%s", n->follower ? "  " : "", n->name);
+        char *shown = g_utf8_substring(name, 0, MIN(g_utf8_strlen(name, -1), 40));
+        g_string_append_printf(t, "\n%5u  %-40s %7u %6u ", n->id, shown, n->quantum, n->rate);
+        if (n->busy >= 0) g_string_append_printf(t, "%5.0f%%", n->busy * 100);
+        else g_string_append_printf(t, "%6s", "-");
+        g_string_append_printf(t, " %6u", n->errors);
+        g_free(shown);
+        g_free(name);
+    }
+    gtk_label_set_text(ui->nodes_label, t->str);
+    g_string_free(t, TRUE);
+}
+
+static gboolean on_tune_timeout(gpointer user_data)
 {
     AudioUI *ui = (AudioUI *)user_data;
-    /* This function is no longer used for polling; keep returning TRUE if called. */
-    return TRUE;
+    ui->tune_id = 0;
+    tune_poll(ui);
+    return G_SOURCE_REMOVE;
 }
 
-/* one-shot UI update (used via g_idle_add) */
-static gboolean update_volume_ui_once(gpointer user_data)
+static void on_tune_read(GObject *source, GAsyncResult *res, gpointer user_data)
 {
     AudioUI *ui = (AudioUI *)user_data;
-    /* If user changed volume recently, skip overwriting for 2s */
-    gint64 now = g_get_monotonic_time();
-    if (ui->last_set_time_us != 0 && (now - ui->last_set_time_us) < (gint64)2000000) return FALSE;
-
-    gchar *out = NULL, *err = NULL;
-    gint exit_status = 0;
-    GError *error = NULL;
-    if (!g_spawn_command_line_sync("pactl get-sink-volume @DEFAULT_SINK@", &out, &err, &exit_status, &error)) {
-        if (err) g_free(err);
-        if (out) g_free(out);
-        if (error) g_clear_error(&error);
-        return FALSE;
-    }
-
-    int vol = parse_volume_percent(out);
-    if (vol >= 0) {
-        if (GTK_IS_RANGE(ui->scale)) {
-            gtk_range_set_value(GTK_RANGE(ui->scale), vol);
-        } else {
-            set_status(ui->status, "Volume widget not ready");
-        }
-        if (GTK_IS_LABEL(ui->vol_label)) {
-            char vl[64];
-            g_snprintf(vl, sizeof(vl), "%d%%", vol);
-            gtk_label_set_text(ui->vol_label, vl);
-        }
+    PwClockSettings cs;
+    GPtrArray *nodes = NULL;
+    GError *err = NULL;
+    ui->tune_in_progress = FALSE;
+
+    if (pw_tune_read_finish(res, &cs, &nodes, &err)) {
+        GString *c = g_string_new(NULL);
+        g_string_append_printf(c, "Rate %u Hz · quantum %u (min %u, max %u)", cs.rate, cs.quantum, cs.min_quantum, cs.max_quantum);
+        if (cs.rate) g_string_append_printf(c, " · %.1f ms", cs.quantum * 1000.0 / cs.rate);
+        if (cs.force_quantum) g_string_append_printf(c, " · forced quantum %u", cs.force_quantum);
+        if (cs.force_rate) g_string_append_printf(c, " · forced rate %u Hz", cs.force_rate);
+        gtk_label_set_text(ui->clock_label, c->str);
+        g_string_free(c, TRUE);
+        select_value(ui, ui->quantum_dd, tune_quanta, G_N_ELEMENTS(tune_quanta), cs.force_quantum);
+        select_value(ui, ui->rate_dd, tune_rates, G_N_ELEMENTS(tune_rates), cs.force_rate);
+        show_tune_nodes(ui, nodes);
+        g_ptr_array_unref(nodes);
+    } else {
+        gtk_label_set_text(ui->clock_label, err->message);
+        gtk_label_set_text(ui->nodes_label, "");
+        g_error_free(err);
+    }
+
+    /* keep sampling only while the panel is open and on screen */
+    if (gtk_widget_get_mapped(ui->tune_box) && !ui->tune_id) {
+        ui->tune_id = g_timeout_add_seconds(TUNE_POLL_S, on_tune_timeout, ui);
+    }
+}
+
+static void tune_poll(AudioUI *ui)
+{
+    if (ui->tune_in_progress || ui->tune_id || !gtk_widget_get_mapped(ui->tune_box)) return;
+    ui->tune_in_progress = TRUE;
+    pw_tune_read_async(NULL, on_tune_read, ui);
+}
+
+static void on_tune_map(GtkWidget *w, gpointer user_data)
+{
+    tune_poll((AudioUI *)user_data);
+}
+
+static void on_tune_unmap(GtkWidget *w, gpointer user_data)
+{
+    AudioUI *ui = (AudioUI *)user_data;
+    if (ui->tune_id) {
+        g_source_remove(ui->tune_id);
+        ui->tune_id = 0;
     }
+}
 
-    if (out) g_free(out);
-    if (err) g_free(err);
-    if (error) g_clear_error(&error);
-    return FALSE;
+static void report_tuning(AudioUI *ui)
+{
+    guint q = tune_quanta[gtk_drop_down_get_selected(ui->quantum_dd)];
+    guint r = tune_rates[gtk_drop_down_get_selected(ui->rate_dd)];
+    gboolean keep = gtk_check_button_get_active(ui->persist_btn);
+    GString *msg = g_string_new(NULL);
+    if (q) g_string_append_printf(msg, "quantum %u", q);
+    if (r) g_string_append_printf(msg, "%srate %u Hz", q ? ", " : "", r);
+    if (msg->len) set_status(ui->status, "PipeWire clock forced to %s%s", msg->str, keep ? " (kept after restart)" : "");
+    else set_status(ui->status, "PipeWire clock follows the applications again");
+    g_string_free(msg, TRUE);
 }
 
-/* Fetch initial volume and set UI (runs in a thread) */
-static gpointer fetch_initial_volume_thread(gpointer user_data)
+static void set_tuning_live(AudioUI *ui);
+
+static void on_tuning_set(GObject *source, GAsyncResult *res, gpointer user_data)
 {
     AudioUI *ui = (AudioUI *)user_data;
-    gchar *out = NULL, *err = NULL;
-    gint exit_status = 0;
-    GError *error = NULL;
+    GError *err = NULL;
+    ui->tune_setting = FALSE;
+    /* picked again meanwhile: send the latest rather than report this one */
+    if (ui->tune_set_again) {
+        pw_tune_set_live_finish(res, NULL);
+        set_tuning_live(ui);
+        return;
+    }
+    if (!pw_tune_set_live_finish(res, &err)) {
+        set_status(ui->status, "Could not set PipeWire clock: %s", err->message);
+        g_error_free(err);
+        return;
+    }
+    report_tuning(ui);
+    tune_poll(ui);
+}
 
-    if (!g_spawn_command_line_sync("pactl get-sink-volume @DEFAULT_SINK@", &out, &err, &exit_status, &error)) {
-        g_free(out); g_free(err); g_clear_error(&error);
-        ui->refresh_in_progress = FALSE;
-        return NULL;
+/* One write at a time, so an older pick cannot land after a newer one */
+static void set_tuning_live(AudioUI *ui)
+{
+    if (ui->tune_setting) {
+        ui->tune_set_again = TRUE;
+        return;
     }
+    ui->tune_setting = TRUE;
+    ui->tune_set_again = FALSE;
+    pw_tune_set_live_async(tune_quanta[gtk_drop_down_get_selected(ui->quantum_dd)],
+                           tune_rates[gtk_drop_down_get_selected(ui->rate_dd)], NULL, on_tuning_set, ui);
+}
 
-    int vol = parse_volume_percent(out);
-    if (vol >= 0) {
-        /* schedule one-shot UI update on main thread */
-        g_idle_add(update_volume_ui_once, ui);
+static void apply_tuning(AudioUI *ui, gboolean live, gboolean persist)
+{
+    guint q = tune_quanta[gtk_drop_down_get_selected(ui->quantum_dd)];
+    guint r = tune_rates[gtk_drop_down_get_selected(ui->rate_dd)];
+    gboolean keep = gtk_check_button_get_active(ui->persist_btn);
+    GError *err = NULL;
+
+    if (g_dry_run) {
+        if (live) set_status(ui->status, "Dry run: pw-metadata -n settings 0 clock.force-quantum %u; clock.force-rate %u", q, r);
+        if (persist) {
+            char *path = pw_tune_dropin_path();
+            set_status(ui->status, "Dry run: %s %s", keep && (q || r) ? "write" : "remove", path);
+            g_free(path);
+        }
+        return;
     }
 
-    if (out) g_free(out);
-    if (err) g_free(err);
-    if (error) g_clear_error(&error);
-    ui->refresh_in_progress = FALSE;
-    return NULL;
+    if (persist && !pw_tune_persist(keep ? q : 0, keep ? r : 0, &err)) {
+        set_status(ui->status, "Could not save PipeWire clock settings: %s", err->message);
+        g_error_free(err);
+        return;
+    }
+    /* the result is reported once pw-metadata is done */
+    if (live) set_tuning_live(ui);
+    else report_tuning(ui);
 }
 
-static void on_refresh_clicked(GtkButton *btn, gpointer user_data)
+static void on_tune_picked(GObject *obj, GParamSpec *pspec, gpointer user_data)
 {
     AudioUI *ui = (AudioUI *)user_data;
-    if (ui->refresh_in_progress) {
-        set_status(ui->status, "Refresh already in progress");
+    if (ui->tune_syncing) return;
+    apply_tuning(ui, TRUE, gtk_check_button_get_active(ui->persist_btn));
+}
+
+static void on_persist_toggled(GtkCheckButton *btn, gpointer user_data)
+{
+    apply_tuning((AudioUI *)user_data, FALSE, TRUE);
+}
+
+/* Equalizer. Band edits are saved to the drop-in once they settle; gains,
+ * frequencies and Qs also go to the running sink right away, while adding,
+ * removing or retyping bands and switching it on or off need a restart. */
+static void eq_rebuild_rows(AudioUI *ui);
+
+static EqBand *eq_band_of(AudioUI *ui, GtkWidget *w)
+{
+    guint i = GPOINTER_TO_UINT(g_object_get_data(G_OBJECT(w), "band"));
+    return i < ui->eq_bands->len ? &g_array_index(ui->eq_bands, EqBand, i) : NULL;
+}
+
+static void eq_sync_apply(AudioUI *ui)
+{
+    gtk_widget_set_sensitive(ui->eq_apply, ui->eq_restart);
+    gtk_widget_set_sensitive(ui->eq_add, ui->eq_bands->len < EQ_MAX_BANDS);
+}
+
+static gboolean on_eq_settled(gpointer user_data)
+{
+    AudioUI *ui = (AudioUI *)user_data;
+    GError *err = NULL;
+    ui->eq_settle_id = 0;
+
+    if (g_dry_run) {
+        char *path = eq_config_path();
+        set_status(ui->status, "Dry run: write %s", path);
+        g_free(path);
+        return G_SOURCE_REMOVE;
+    }
+    EqBand *bands = (EqBand *)ui->eq_bands->data;
+    if (!eq_save(bands, ui->eq_bands->len, ui->eq_enabled, &err)) {
+        set_status(ui->status, "Could not save equalizer: %s", err->message);
+        g_error_free(err);
+    } else if (ui->eq_enabled && !ui->eq_restart && !eq_set_live(bands, ui->eq_bands->len, &err)) {
+        set_status(ui->status, "Could not update equalizer: %s", err->message);
+        g_error_free(err);
+    }
+    return G_SOURCE_REMOVE;
+}
+
+static void eq_changed(AudioUI *ui, gboolean needs_restart)
+{
+    if (needs_restart) ui->eq_restart = TRUE;
+    eq_sync_apply(ui);
+    gtk_widget_queue_draw(ui->eq_plot);
+    if (ui->eq_settle_id) g_source_remove(ui->eq_settle_id);
+    ui->eq_settle_id = g_timeout_add(EQ_SETTLE_MS, on_eq_settled, ui);
+}
+
+static void on_eq_type_selected(GObject *obj, GParamSpec *pspec, gpointer user_data)
+{
+    AudioUI *ui = (AudioUI *)user_data;
+    EqBand *b = eq_band_of(ui, GTK_WIDGET(obj));
+    guint t = gtk_drop_down_get_selected(GTK_DROP_DOWN(obj));
+    if (!b || t >= EQ_N_TYPES || t == b->type) return;
+    b->type = t;
+    /* pass filters have no gain */
+    gtk_widget_set_sensitive(g_object_get_data(obj, "gain"), t != EQ_LOW_PASS && t != EQ_HIGH_PASS);
+    eq_changed(ui, TRUE);
+}
+
+static void on_eq_value_changed(GtkSpinButton *spin, gpointer user_data)
+{
+    AudioUI *ui = (AudioUI *)user_data;
+    EqBand *b = eq_band_of(ui, GTK_WIDGET(spin));
+    if (!b) return;
+    double *field = (double *)((char *)b + GPOINTER_TO_SIZE(g_object_get_data(G_OBJECT(spin), "field")));
+    *field = gtk_spin_button_get_value(spin);
+    eq_changed(ui, FALSE);
+}
+
+static void on_eq_remove_clicked(GtkButton *btn, gpointer user_data)
+{
+    AudioUI *ui = (AudioUI *)user_data;
+    guint i = GPOINTER_TO_UINT(g_object_get_data(G_OBJECT(btn), "band"));
+    if (i >= ui->eq_bands->len) return;
+    g_array_remove_index(ui->eq_bands, i);
+    eq_rebuild_rows(ui);
+    eq_changed(ui, TRUE);
+}
+
+static void on_eq_add_clicked(GtkButton *btn, gpointer user_data)
+{
+    AudioUI *ui = (AudioUI *)user_data;
+    if (ui->eq_bands->len >= EQ_MAX_BANDS) return;
+    EqBand b = { EQ_PEAKING, 1000, 0, 1.0 };
+    g_array_append_val(ui->eq_bands, b);
+    eq_rebuild_rows(ui);
+    eq_changed(ui, TRUE);
+}
+
+static void on_eq_enable_toggled(GtkCheckButton *btn, gpointer user_data)
+{
+    AudioUI *ui = (AudioUI *)user_data;
+    ui->eq_enabled = gtk_check_button_get_active(btn);
+    eq_changed(ui, TRUE);
+}
+
+static void on_eq_apply_clicked(GtkButton *btn, gpointer user_data)
+{
+    AudioUI *ui = (AudioUI *)user_data;
+    if (ui->eq_settle_id) {
+        g_source_remove(ui->eq_settle_id);
+        on_eq_settled(ui);
+    }
+    if (g_dry_run) {
+        set_status(ui->status, "Dry run: %s", PIPEWIRE_RESTART_CMD);
         return;
     }
-    ui->refresh_in_progress = TRUE;
-    g_thread_new("audio-refresh", fetch_initial_volume_thread, ui);
+    run_command_and_report(PIPEWIRE_RESTART_CMD, ui->status);
+    ui->eq_restart = FALSE;
+    eq_sync_apply(ui);
+}
+
+static GtkWidget *eq_spin(AudioUI *ui, guint band, gsize field, double min, double max, double step, guint digits, double value)
+{
+    GtkWidget *spin = gtk_spin_button_new_with_range(min, max, step);
+    gtk_spin_button_set_digits(GTK_SPIN_BUTTON(spin), digits);
+    gtk_spin_button_set_value(GTK_SPIN_BUTTON(spin), value);
+    g_object_set_data(G_OBJECT(spin), "band", GUINT_TO_POINTER(band));
+    g_object_set_data(G_OBJECT(spin), "field", GSIZE_TO_POINTER(field));
+    g_signal_connect(spin, "value-changed", G_CALLBACK(on_eq_value_changed), ui);
+    return spin;
 }
 
-static gboolean on_periodic_refresh(gpointer user_data)
+static void eq_rebuild_rows(AudioUI *ui)
+{
+    GtkWidget *child;
+    while ((child = gtk_widget_get_first_child(ui->eq_rows))) gtk_box_remove(GTK_BOX(ui->eq_rows), child);
+
+    const char *types[EQ_N_TYPES + 1] = { NULL };
+    for (int t = 0; t < EQ_N_TYPES; t++) types[t] = eq_band_type_label(t);
+
+    for (guint i = 0; i < ui->eq_bands->len; i++) {
+        EqBand *b = &g_array_index(ui->eq_bands, EqBand, i);
+        GtkWidget *row = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 6);
+
+        GtkWidget *type = gtk_drop_down_new_from_strings(types);
+        gtk_drop_down_set_selected(GTK_DROP_DOWN(type), b->type);
+        GtkWidget *freq = eq_spin(ui, i, G_STRUCT_OFFSET(EqBand, freq), 20, 20000, 1, 0, b->freq);
+        GtkWidget *gain = eq_spin(ui, i, G_STRUCT_OFFSET(EqBand, gain), -24, 24, 0.5, 1, b->gain);
+        GtkWidget *q = eq_spin(ui, i, G_STRUCT_OFFSET(EqBand, q), 0.1, 10, 0.05, 2, b->q);
+        gtk_widget_set_sensitive(gain, b->type != EQ_LOW_PASS && b->type != EQ_HIGH_PASS);
+        g_object_set_data(G_OBJECT(type), "band", GUINT_TO_POINTER(i));
+        g_object_set_data(G_OBJECT(type), "gain", gain);
+        g_signal_connect(type, "notify::selected", G_CALLBACK(on_eq_type_selected), ui);
+
+        GtkWidget *remove = gtk_button_new_from_icon_name("list-remove-symbolic");
+        gtk_widget_set_tooltip_text(remove, "Remove band");
+        g_object_set_data(G_OBJECT(remove), "band", GUINT_TO_POINTER(i));
+        g_signal_connect(remove, "clicked", G_CALLBACK(on_eq_remove_clicked), ui);
+
+        gtk_box_append(GTK_BOX(row), type);
+        gtk_box_append(GTK_BOX(row), gtk_label_new("Hz"));
+        gtk_box_append(GTK_BOX(row), freq);
+        gtk_box_append(GTK_BOX(row), gtk_label_new("dB"));
+        gtk_box_append(GTK_BOX(row), gain);
+        gtk_box_append(GTK_BOX(row), gtk_label_new("Q"));
+        gtk_box_append(GTK_BOX(row), q);
+        gtk_box_append(GTK_BOX(row), remove);
+        gtk_box_append(GTK_BOX(ui->eq_rows), row);
+    }
+}
+
+/* Response of the cascade from the band coefficients, 20 Hz - 20 kHz on a
+ * log axis */
+static void draw_eq_plot(GtkDrawingArea *area, cairo_t *cr, int width, int height, gpointer user_data)
 {
     AudioUI *ui = (AudioUI *)user_data;
-    if (ui->refresh_in_progress) return TRUE; /* keep timeout active */
-    ui->refresh_in_progress = TRUE;
-    g_thread_new("audio-periodic-refresh", fetch_initial_volume_thread, ui);
-    return TRUE;
+    const double lo = log10(20.0), hi = log10(20000.0);
+    GdkRGBA fg;
+    gtk_widget_get_color(GTK_WIDGET(area), &fg);
+
+    cairo_set_source_rgba(cr, fg.red, fg.green, fg.blue, 0.15);
+    cairo_set_line_width(cr, 1);
+    for (double f = 100; f < 20000; f *= 10) {
+        double x = (log10(f) - lo) / (hi - lo) * width;
+        cairo_move_to(cr, x + 0.5, 0);
+        cairo_line_to(cr, x + 0.5, height);
+    }
+    cairo_move_to(cr, 0, height / 2 + 0.5);
+    cairo_line_to(cr, width, height / 2 + 0.5);
+    cairo_stroke(cr);
+
+    cairo_set_source_rgba(cr, 0.21, 0.52, 0.89, ui->eq_enabled ? 1.0 : 0.4);
+    cairo_set_line_width(cr, 2);
+    for (int x = 0; x <= width; x++) {
+        double f = pow(10.0, lo + (hi - lo) * x / MAX(width, 1));
+        double db = eq_response_db((EqBand *)ui->eq_bands->data, ui->eq_bands->len, EQ_PLOT_RATE, f);
+        double y = height / 2.0 - CLAMP(db, -EQ_PLOT_RANGE_DB, EQ_PLOT_RANGE_DB) / EQ_PLOT_RANGE_DB * (height / 2.0);
+        if (x == 0) cairo_move_to(cr, x, y);
+        else cairo_line_to(cr, x, y);
+    }
+    cairo_stroke(cr);
 }
 
-static void set_volume_from_slider(GtkRange *range, gpointer user_data)
+/* Per-application mixer rows. Each control compares against the stream's
+ * current state first, so pushing model values into the widgets does not
+ * write them back. */
+static void on_stream_volume_changed(GtkRange *range, gpointer user_data)
 {
     AudioUI *ui = (AudioUI *)user_data;
-    int val = (int)gtk_range_get_value(range);
-    char cmd[256];
-    g_snprintf(cmd, sizeof(cmd), "pactl set-sink-volume @DEFAULT_SINK@ %d%%", val);
+    PulseStream *st = g_object_get_data(G_OBJECT(range), "stream");
+    guint val = (guint)gtk_range_get_value(range);
+    if (!st || val == pulse_stream_get_volume(st)) return;
+    if (g_dry_run) {
+        set_status(ui->status, "Dry run: set %s volume to %u%%", pulse_stream_get_app_name(st), val);
+        return;
+    }
+    pulse_stream_set_volume(st, val);
+}
 
+static void on_stream_mute_toggled(GtkCheckButton *btn, gpointer user_data)
+{
+    AudioUI *ui = (AudioUI *)user_data;
+    PulseStream *st = g_object_get_data(G_OBJECT(btn), "stream");
+    gboolean active = gtk_check_button_get_active(btn);
+    if (!st || active == pulse_stream_get_muted(st)) return;
     if (g_dry_run) {
-        set_status(ui->status, "Dry run: %s", cmd);
+        set_status(ui->status, "Dry run: %s %s", active ? "mute" : "unmute", pulse_stream_get_app_name(st));
         return;
     }
+    pulse_stream_set_muted(st, active);
+}
 
-    run_command_and_report(cmd, ui->status);
-    char vl[64];
-    g_snprintf(vl, sizeof(vl), "%d%%", val);
-    gtk_label_set_text(ui->vol_label, vl);
-    ui->last_set_time_us = g_get_monotonic_time();
+static void on_stream_sink_selected(GObject *obj, GParamSpec *pspec, gpointer user_data)
+{
+    AudioUI *ui = (AudioUI *)user_data;
+    PulseStream *st = g_object_get_data(obj, "stream");
+    PulseDevice *sink = gtk_drop_down_get_selected_item(GTK_DROP_DOWN(obj));
+    /* a removed sink moves the selection; the server moves the stream
+     * itself and we follow its event */
+    if (ui->devices_changing) return;
+    if (!st || !sink || pulse_device_get_index(sink) == pulse_stream_get_sink(st)) return;
+    if (g_dry_run) {
+        set_status(ui->status, "Dry run: move %s to %s", pulse_stream_get_app_name(st), pulse_device_get_name(sink));
+        return;
+    }
+    pulse_stream_move(st, sink);
+    set_status(ui->status, "Moved %s to %s", pulse_stream_get_app_name(st), pulse_device_get_description(sink));
 }
 
-static void on_mute_toggled(GtkCheckButton *btn, gpointer user_data)
+static void stream_row_setup(GtkSignalListItemFactory *f, GtkListItem *li, gpointer user_data)
 {
     AudioUI *ui = (AudioUI *)user_data;
-    gboolean active = gtk_check_button_get_active(GTK_CHECK_BUTTON(btn));
-    char cmd[256];
-    if (active) {
-        g_snprintf(cmd, sizeof(cmd), "pactl set-sink-mute @DEFAULT_SINK@ 1");
-        /* When muting, also set volume to 0% */
-        if (!g_dry_run) {
-            run_command_and_report("pactl set-sink-volume @DEFAULT_SINK@ 0%", ui->status);
+    GtkWidget *h = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 8);
+
+    GtkWidget *icon = gtk_image_new();
+    gtk_image_set_pixel_size(GTK_IMAGE(icon), 32);
+    gtk_box_append(GTK_BOX(h), icon);
+
+    GtkWidget *names = gtk_box_new(GTK_ORIENTATION_VERTICAL, 2);
+    gtk_widget_set_size_request(names, 180, -1);
+    GtkWidget *app = gtk_label_new("");
+    gtk_label_set_xalign(GTK_LABEL(app), 0);
+    gtk_label_set_ellipsize(GTK_LABEL(app), PANGO_ELLIPSIZE_END);
+    GtkWidget *media = gtk_label_new("");
+    gtk_label_set_xalign(GTK_LABEL(media), 0);
+    gtk_label_set_ellipsize(GTK_LABEL(media), PANGO_ELLIPSIZE_END);
+    gtk_widget_add_css_class(media, "dim-label");
+    gtk_box_append(GTK_BOX(names), app);
+    gtk_box_append(GTK_BOX(names), media);
+    gtk_box_append(GTK_BOX(h), names);
+
+    GtkWidget *scale = gtk_scale_new_with_range(GTK_ORIENTATION_HORIZONTAL, 0, 150, 1);
+    gtk_scale_set_draw_value(GTK_SCALE(scale), FALSE);
+    gtk_widget_set_hexpand(scale, TRUE);
+    g_signal_connect(scale, "value-changed", G_CALLBACK(on_stream_volume_changed), ui);
+    gtk_box_append(GTK_BOX(h), scale);
+
+    GtkWidget *vol = gtk_label_new("");
+    gtk_label_set_width_chars(GTK_LABEL(vol), 5);
+    gtk_box_append(GTK_BOX(h), vol);
+
+    GtkWidget *mute = gtk_check_button_new_with_label("Mute");
+    g_signal_connect(mute, "toggled", G_CALLBACK(on_stream_mute_toggled), ui);
+    gtk_box_append(GTK_BOX(h), mute);
+
+    GtkExpression *desc = gtk_property_expression_new(PULSE_TYPE_DEVICE, NULL, "description");
+    GListModel *sinks = g_object_ref(pulse_server_get_sinks(ui->server));
+    GtkWidget *sink = gtk_drop_down_new(sinks, desc);
+    gtk_widget_set_size_request(sink, 180, -1);
+    g_signal_connect(sink, "notify::selected", G_CALLBACK(on_stream_sink_selected), ui);
+    gtk_box_append(GTK_BOX(h), sink);
+
+    g_object_set_data(G_OBJECT(h), "icon", icon);
+    g_object_set_data(G_OBJECT(h), "app", app);
+    g_object_set_data(G_OBJECT(h), "media", media);
+    g_object_set_data(G_OBJECT(h), "scale", scale);
+    g_object_set_data(G_OBJECT(h), "vol", vol);
+    g_object_set_data(G_OBJECT(h), "mute", mute);
+    g_object_set_data(G_OBJECT(h), "sink", sink);
+    gtk_list_item_set_child(li, h);
+    gtk_list_item_set_activatable(li, FALSE);
+}
+
+static void sync_stream_row(GObject *obj, GParamSpec *pspec, gpointer user_data)
+{
+    PulseStream *st = PULSE_STREAM(obj);
+    GtkWidget *h = user_data;
+    const char *icon = pulse_stream_get_icon_name(st);
+    gtk_image_set_from_icon_name(g_object_get_data(G_OBJECT(h), "icon"), icon ? icon : "audio-x-generic");
+    gtk_label_set_text(g_object_get_data(G_OBJECT(h), "app"), pulse_stream_get_app_name(st));
+    gtk_label_set_text(g_object_get_data(G_OBJECT(h), "media"), pulse_stream_get_media_name(st));
+
+    guint vol = pulse_stream_get_volume(st);
+    gboolean muted = pulse_stream_get_muted(st);
+    GtkWidget *scale = g_object_get_data(G_OBJECT(h), "scale");
+    gtk_range_set_value(GTK_RANGE(scale), vol);
+    gtk_widget_set_sensitive(scale, !muted);
+    char vl[16];
+    g_snprintf(vl, sizeof(vl), "%u%%", vol);
+    gtk_label_set_text(g_object_get_data(G_OBJECT(h), "vol"), vl);
+    gtk_check_button_set_active(g_object_get_data(G_OBJECT(h), "mute"), muted);
+
+    GtkDropDown *dd = g_object_get_data(G_OBJECT(h), "sink");
+    GListModel *sinks = gtk_drop_down_get_model(dd);
+    for (guint i = 0; i < g_list_model_get_n_items(sinks); i++) {
+        PulseDevice *d = g_list_model_get_item(sinks, i);
+        gboolean found = pulse_device_get_index(d) == pulse_stream_get_sink(st);
+        g_object_unref(d);
+        if (found) {
+            gtk_drop_down_set_selected(dd, i);
+            break;
         }
-        /* Set slider to 0 and disable it */
-        gtk_range_set_value(GTK_RANGE(ui->scale), 0);
-        gtk_label_set_text(ui->vol_label, "0%");
-    } else {
-        g_snprintf(cmd, sizeof(cmd), "pactl set-sink-mute @DEFAULT_SINK@ 0");
-        /* Re-enable slider when unmuting */
     }
-    if (g_dry_run) {
-        set_status(ui->status, "Dry run: %s", cmd);
-    } else {
-        run_command_and_report(cmd, ui->status);
+}
+
+static void stream_row_bind(GtkSignalListItemFactory *f, GtkListItem *li, gpointer user_data)
+{
+    PulseStream *st = gtk_list_item_get_item(li);
+    GtkWidget *h = gtk_list_item_get_child(li);
+    /* sync first so the controls start from the stream's own values */
+    sync_stream_row(G_OBJECT(st), NULL, h);
+    g_object_set_data(g_object_get_data(G_OBJECT(h), "scale"), "stream", st);
+    g_object_set_data(g_object_get_data(G_OBJECT(h), "mute"), "stream", st);
+    g_object_set_data(g_object_get_data(G_OBJECT(h), "sink"), "stream", st);
+    gulong id = g_signal_connect(st, "notify", G_CALLBACK(sync_stream_row), h);
+    g_object_set_data(G_OBJECT(h), "notify-id", GSIZE_TO_POINTER(id));
+}
+
+static void stream_row_unbind(GtkSignalListItemFactory *f, GtkListItem *li, gpointer user_data)
+{
+    GtkWidget *h = gtk_list_item_get_child(li);
+    gulong id = GPOINTER_TO_SIZE(g_object_get_data(G_OBJECT(h), "notify-id"));
+    if (id) g_signal_handler_disconnect(gtk_list_item_get_item(li), id);
+    g_object_set_data(G_OBJECT(h), "notify-id", NULL);
+    g_object_set_data(g_object_get_data(G_OBJECT(h), "scale"), "stream", NULL);
+    g_object_set_data(g_object_get_data(G_OBJECT(h), "mute"), "stream", NULL);
+    g_object_set_data(g_object_get_data(G_OBJECT(h), "sink"), "stream", NULL);
+}
+
+static void on_streams_changed(GListModel *list, guint pos, guint removed, guint added, gpointer user_data)
+{
+    AudioUI *ui = (AudioUI *)user_data;
+    gtk_widget_set_visible(ui->no_streams, g_list_model_get_n_items(list) == 0);
+    /* new or closed streams add or drop links in the graph */
+    if (ui->graph) schedule_info_refresh(ui);
+}
+
+/* Default output/input pickers */
+static void select_device(GtkDropDown *dd, const char *name)
+{
+    GListModel *model = gtk_drop_down_get_model(dd);
+    guint n = g_list_model_get_n_items(model), sel = GTK_INVALID_LIST_POSITION;
+    for (guint i = 0; i < n && sel == GTK_INVALID_LIST_POSITION; i++) {
+        PulseDevice *d = g_list_model_get_item(model, i);
+        if (g_strcmp0(pulse_device_get_name(d), name) == 0) sel = i;
+        g_object_unref(d);
     }
-    /* Disable slider when mute is on, enable when mute is off */
-    gtk_widget_set_sensitive(GTK_WIDGET(ui->scale), !active);
+    gtk_drop_down_set_selected(dd, sel);
 }
 
-static void on_refresh_info_clicked(GtkButton *btn, gpointer user_data)
+static void sync_default_pickers(AudioUI *ui)
+{
+    if (!ui->out_dd) return;
+    ui->picking = TRUE;
+    select_device(ui->out_dd, pulse_server_get_default_sink(ui->server));
+    select_device(ui->in_dd, pulse_server_get_default_source(ui->server));
+    ui->picking = FALSE;
+}
+
+static void on_default_picked(GObject *obj, GParamSpec *pspec, gpointer user_data)
 {
     AudioUI *ui = (AudioUI *)user_data;
-    if (ui->refresh_in_progress) {
-        set_status(ui->status, "Refresh already in progress");
+    if (ui->picking || ui->devices_changing) return;
+    PulseDevice *d = gtk_drop_down_get_selected_item(GTK_DROP_DOWN(obj));
+    gboolean output = GTK_DROP_DOWN(obj) == ui->out_dd;
+    const char *current = output ? pulse_server_get_default_sink(ui->server) : pulse_server_get_default_source(ui->server);
+    if (!d || g_strcmp0(pulse_device_get_name(d), current) == 0) return;
+
+    if (g_dry_run) {
+        set_status(ui->status, "Dry run: switch %s to %s and move its streams", output ? "output" : "input",
+                   pulse_device_get_name(d));
         return;
     }
-    ui->refresh_in_progress = TRUE;
-    g_thread_new("audio-refresh-info", fetch_pipewire_info_thread, ui);
+    if (output) pulse_server_set_default_sink(ui->server, d);
+    else pulse_server_set_default_source(ui->server, d);
+    set_status(ui->status, "%s: %s", output ? "Output" : "Input", pulse_device_get_description(d));
 }
 
-static void on_restart_pipewire_clicked(GtkButton *btn, gpointer user_data)
+static gboolean not_monitor(gpointer item, gpointer user_data)
+{
+    return !pulse_device_is_monitor(PULSE_DEVICE(item));
+}
+
+static gboolean is_app_stream(gpointer item, gpointer user_data)
+{
+    return !pulse_stream_is_internal(PULSE_STREAM(item));
+}
+
+/* Card profile rows; the dropdown's list is rebuilt only when the card's
+ * cached profile list changes */
+static void sync_card_row(GObject *obj, GParamSpec *pspec, gpointer user_data)
+{
+    PulseCard *card = PULSE_CARD(obj);
+    GtkWidget *dd = user_data;
+    GtkWidget *label = gtk_widget_get_prev_sibling(dd);
+    gtk_label_set_text(GTK_LABEL(label), pulse_card_get_description(card));
+
+    g_object_set_data(G_OBJECT(dd), "syncing", GINT_TO_POINTER(1));
+    if (!pspec || g_strcmp0(pspec->name, "profiles") == 0) {
+        GtkStringList *names = gtk_string_list_new(NULL);
+        for (guint i = 0; i < pulse_card_get_n_profiles(card); i++) {
+            const char *desc = pulse_card_get_profile_description(card, i);
+            char *item = pulse_card_get_profile_available(card, i) ? g_strdup(desc)
+                                                                   : g_strdup_printf("%s (unavailable)", desc);
+            gtk_string_list_append(names, item);
+            g_free(item);
+        }
+        gtk_drop_down_set_model(GTK_DROP_DOWN(dd), G_LIST_MODEL(names));
+        g_object_unref(names);
+    }
+    guint sel = GTK_INVALID_LIST_POSITION;
+    for (guint i = 0; i < pulse_card_get_n_profiles(card); i++) {
+        if (g_strcmp0(pulse_card_get_profile_name(card, i), pulse_card_get_active_profile(card)) == 0) sel = i;
+    }
+    gtk_drop_down_set_selected(GTK_DROP_DOWN(dd), sel);
+    g_object_set_data(G_OBJECT(dd), "syncing", NULL);
+}
+
+static void on_profile_picked(GObject *obj, GParamSpec *pspec, gpointer user_data)
 {
     AudioUI *ui = (AudioUI *)user_data;
-    const char *cmd = "systemctl --user restart pipewire pipewire-pulse pipewire-media-session wireplumber 2>/dev/null && echo 'PipeWire stuff restarted ✅'";
-    
+    PulseCard *card = g_object_get_data(obj, "card");
+    guint sel = gtk_drop_down_get_selected(GTK_DROP_DOWN(obj));
+    if (g_object_get_data(obj, "syncing") || !card || sel >= pulse_card_get_n_profiles(card)) return;
+    const char *profile = pulse_card_get_profile_name(card, sel);
+    if (g_strcmp0(profile, pulse_card_get_active_profile(card)) == 0) return;
+
     if (g_dry_run) {
-        set_status(ui->status, "Dry run: %s", cmd);
+        set_status(ui->status, "Dry run: set %s profile to %s", pulse_card_get_name(card), profile);
         return;
     }
-    
-    run_command_and_report(cmd, ui->status);
+    pulse_card_set_profile(card, profile);
+    set_status(ui->status, "%s: %s", pulse_card_get_description(card), pulse_card_get_profile_description(card, sel));
+}
+
+static GtkWidget *create_card_row(gpointer item, gpointer user_data)
+{
+    GtkWidget *h = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 8);
+    GtkWidget *label = gtk_label_new("");
+    gtk_label_set_xalign(GTK_LABEL(label), 0);
+    gtk_label_set_ellipsize(GTK_LABEL(label), PANGO_ELLIPSIZE_END);
+    gtk_widget_set_hexpand(label, TRUE);
+    GtkWidget *dd = gtk_drop_down_new(NULL, NULL);
+    gtk_widget_set_size_request(dd, 260, -1);
+    gtk_box_append(GTK_BOX(h), label);
+    gtk_box_append(GTK_BOX(h), dd);
+
+    g_object_set_data_full(G_OBJECT(dd), "card", g_object_ref(item), g_object_unref);
+    sync_card_row(G_OBJECT(item), NULL, dd);
+    g_signal_connect(dd, "notify::selected", G_CALLBACK(on_profile_picked), user_data);
+    /* dropped with the row when the card goes away */
+    g_signal_connect_object(item, "notify", G_CALLBACK(sync_card_row), dd, 0);
+    return h;
 }
 
 /* Keep pavucontrol button behavior (launch if found) */
@@ -337,7 +1138,7 @@ GtkWidget *create_audio_page(GtkLabel *status_label)
     gtk_widget_set_halign(title, GTK_ALIGN_START);
     gtk_box_append(GTK_BOX(vbox), title);
 
-    GtkWidget *desc = gtk_label_new("Adjust system volume (PipeWire via pactl). Additional controls below.");
+    GtkWidget *desc = gtk_label_new("Adjust system volume (PipeWire via its PulseAudio server). Additional controls below.");
     gtk_label_set_wrap(GTK_LABEL(desc), TRUE);
     gtk_box_append(GTK_BOX(vbox), desc);
 
@@ -367,30 +1168,126 @@ GtkWidget *create_audio_page(GtkLabel *status_label)
     gtk_box_append(GTK_BOX(vbox), h);
     gtk_box_append(GTK_BOX(vbox), mute);
 
-    /* PipeWire info section */
-    GtkWidget *info_label = gtk_label_new("PipeWire Information");
+    ui->server = pulse_server_get_default();
+    /* connected before any dropdown over these lists exists, so these run
+     * first and the after-handlers last */
+    GListModel *sinks = pulse_server_get_sinks(ui->server);
+    GListModel *sources = pulse_server_get_sources(ui->server);
+    g_signal_connect(sinks, "items-changed", G_CALLBACK(on_sinks_changed), ui);
+    g_signal_connect_after(sinks, "items-changed", G_CALLBACK(on_devices_changed_after), ui);
+    g_signal_connect(sources, "items-changed", G_CALLBACK(on_devices_changed), ui);
+    g_signal_connect_after(sources, "items-changed", G_CALLBACK(on_devices_changed_after), ui);
+
+    /* Default devices and card profiles */
+    GtkWidget *devices = gtk_grid_new();
+    gtk_grid_set_column_spacing(GTK_GRID(devices), 8);
+    gtk_grid_set_row_spacing(GTK_GRID(devices), 4);
+    GtkExpression *desc_expr = gtk_property_expression_new(PULSE_TYPE_DEVICE, NULL, "description");
+    ui->out_dd = GTK_DROP_DOWN(gtk_drop_down_new(g_object_ref(sinks), gtk_expression_ref(desc_expr)));
+    GtkFilter *inputs = GTK_FILTER(gtk_custom_filter_new(not_monitor, NULL, NULL));
+    GtkFilterListModel *in_model = gtk_filter_list_model_new(g_object_ref(sources), inputs);
+    ui->in_dd = GTK_DROP_DOWN(gtk_drop_down_new(G_LIST_MODEL(in_model), desc_expr));
+    gtk_widget_set_hexpand(GTK_WIDGET(ui->out_dd), TRUE);
+    gtk_widget_set_hexpand(GTK_WIDGET(ui->in_dd), TRUE);
+    GtkWidget *out_dd_label = gtk_label_new("Output device");
+    gtk_label_set_xalign(GTK_LABEL(out_dd_label), 0);
+    GtkWidget *in_dd_label = gtk_label_new("Input device");
+    gtk_label_set_xalign(GTK_LABEL(in_dd_label), 0);
+    gtk_grid_attach(GTK_GRID(devices), out_dd_label, 0, 0, 1, 1);
+    gtk_grid_attach(GTK_GRID(devices), GTK_WIDGET(ui->out_dd), 1, 0, 1, 1);
+    gtk_grid_attach(GTK_GRID(devices), in_dd_label, 0, 1, 1, 1);
+    gtk_grid_attach(GTK_GRID(devices), GTK_WIDGET(ui->in_dd), 1, 1, 1, 1);
+    gtk_box_append(GTK_BOX(vbox), devices);
+    sync_default_pickers(ui);
+    g_signal_connect(ui->out_dd, "notify::selected", G_CALLBACK(on_default_picked), ui);
+    g_signal_connect(ui->in_dd, "notify::selected", G_CALLBACK(on_default_picked), ui);
+
+    GtkWidget *cards = gtk_list_box_new();
+    gtk_list_box_set_selection_mode(GTK_LIST_BOX(cards), GTK_SELECTION_NONE);
+    gtk_list_box_bind_model(GTK_LIST_BOX(cards), pulse_server_get_cards(ui->server), create_card_row, ui, NULL);
+    gtk_box_append(GTK_BOX(vbox), cards);
+
+    /* Level meters */
+    GtkWidget *meters = gtk_grid_new();
+    gtk_grid_set_column_spacing(GTK_GRID(meters), 8);
+    gtk_grid_set_row_spacing(GTK_GRID(meters), 4);
+    ui->out_meter = level_meter_new(ui->server);
+    ui->in_meter = level_meter_new(ui->server);
+    GtkWidget *out_label = gtk_label_new("Output");
+    gtk_label_set_xalign(GTK_LABEL(out_label), 0);
+    GtkWidget *in_label = gtk_label_new("Input");
+    gtk_label_set_xalign(GTK_LABEL(in_label), 0);
+    gtk_grid_attach(GTK_GRID(meters), out_label, 0, 0, 1, 1);
+    gtk_grid_attach(GTK_GRID(meters), ui->out_meter->area, 1, 0, 1, 1);
+    gtk_grid_attach(GTK_GRID(meters), in_label, 0, 1, 1, 1);
+    gtk_grid_attach(GTK_GRID(meters), ui->in_meter->area, 1, 1, 1, 1);
+    gtk_box_append(GTK_BOX(vbox), meters);
+
+    /* Applications section */
+    GtkWidget *apps_label = gtk_label_new("Applications");
+    gtk_widget_set_halign(apps_label, GTK_ALIGN_START);
+    gtk_box_append(GTK_BOX(vbox), apps_label);
+
+    ui->no_streams = gtk_label_new("No applications are playing audio.");
+    gtk_widget_set_halign(ui->no_streams, GTK_ALIGN_START);
+    gtk_widget_add_css_class(ui->no_streams, "dim-label");
+    gtk_box_append(GTK_BOX(vbox), ui->no_streams);
+
+    /* applications only; the equalizer's own output is not one */
+    GtkFilter *apps = GTK_FILTER(gtk_custom_filter_new(is_app_stream, NULL, NULL));
+    GListModel *streams = G_LIST_MODEL(gtk_filter_list_model_new(g_object_ref(pulse_server_get_streams(ui->server)), apps));
+    GtkListItemFactory *factory = gtk_signal_list_item_factory_new();
+    g_signal_connect(factory, "setup", G_CALLBACK(stream_row_setup), ui);
+    g_signal_connect(factory, "bind", G_CALLBACK(stream_row_bind), ui);
+    g_signal_connect(factory, "unbind", G_CALLBACK(stream_row_unbind), ui);
+    GtkNoSelection *sel = gtk_no_selection_new(g_object_ref(streams));
+    GtkWidget *mixer = gtk_list_view_new(GTK_SELECTION_MODEL(sel), factory);
+
+    GtkWidget *mixer_sc = gtk_scrolled_window_new();
+    gtk_scrolled_window_set_policy(GTK_SCROLLED_WINDOW(mixer_sc), GTK_POLICY_NEVER, GTK_POLICY_AUTOMATIC);
+    gtk_widget_set_vexpand(mixer_sc, TRUE);
+    gtk_widget_set_size_request(mixer_sc, -1, 160);
+    gtk_scrolled_window_set_child(GTK_SCROLLED_WINDOW(mixer_sc), mixer);
+    gtk_box_append(GTK_BOX(vbox), mixer_sc);
+    g_signal_connect(streams, "items-changed", G_CALLBACK(on_streams_changed), ui);
+    on_streams_changed(streams, 0, 0, 0, ui);
+
+    /* PipeWire graph section */
+    GtkWidget *info_label = gtk_label_new("PipeWire Graph");
     gtk_widget_set_halign(info_label, GTK_ALIGN_START);
     gtk_box_append(GTK_BOX(vbox), info_label);
 
+    GtkWidget *version_label = gtk_label_new("");
+    gtk_widget_set_halign(version_label, GTK_ALIGN_START);
+    gtk_label_set_wrap(GTK_LABEL(version_label), TRUE);
+    gtk_widget_add_css_class(version_label, "dim-label");
+    ui->version_label = GTK_LABEL(version_label);
+    gtk_box_append(GTK_BOX(vbox), version_label);
+
     GtkWidget *sc = gtk_scrolled_window_new();
     gtk_scrolled_window_set_policy(GTK_SCROLLED_WINDOW(sc), GTK_POLICY_AUTOMATIC, GTK_POLICY_AUTOMATIC);
     gtk_widget_set_hexpand(sc, TRUE);
     gtk_widget_set_vexpand(sc, TRUE);
-    gtk_widget_set_size_request(sc, -1, 200);
+    gtk_widget_set_size_request(sc, -1, 160);
 
-    GtkWidget *info_tv = gtk_text_view_new();
-    gtk_text_view_set_editable(GTK_TEXT_VIEW(info_tv), FALSE);
-    gtk_text_view_set_wrap_mode(GTK_TEXT_VIEW(info_tv), GTK_WRAP_WORD_CHAR);
-    ui->info_tv = GTK_TEXT_VIEW(info_tv);
-
-    gtk_scrolled_window_set_child(GTK_SCROLLED_WINDOW(sc), info_tv);
+    ui->graph = pw_graph_new();
+    ui->graph_cancel = g_cancellable_new();
+    g_signal_connect(sc, "destroy", G_CALLBACK(on_graph_destroy), ui);
+    GtkTreeListModel *tree = gtk_tree_list_model_new(g_object_ref(pw_graph_get_nodes(ui->graph)), FALSE, FALSE,
+                                                     graph_children, NULL, NULL);
+    GtkListItemFactory *graph_factory = gtk_signal_list_item_factory_new();
+    g_signal_connect(graph_factory, "setup", G_CALLBACK(graph_row_setup), ui);
+    g_signal_connect(graph_factory, "bind", G_CALLBACK(graph_row_bind), ui);
+    g_signal_connect(graph_factory, "unbind", G_CALLBACK(graph_row_unbind), ui);
+    GtkWidget *graph_view = gtk_list_view_new(GTK_SELECTION_MODEL(gtk_no_selection_new(G_LIST_MODEL(tree))), graph_factory);
+    gtk_scrolled_window_set_child(GTK_SCROLLED_WINDOW(sc), graph_view);
     gtk_box_append(GTK_BOX(vbox), sc);
 
-    /* Buttons: Refresh Info, Restart PipeWire, and Open pavucontrol */
+    /* Buttons: Refresh Graph, Restart PipeWire, and Open pavucontrol */
     GtkWidget *button_box = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 6);
     gtk_widget_set_halign(button_box, GTK_ALIGN_END);
 
-    GtkWidget *btn_refresh = gtk_button_new_with_label("Refresh Info");
+    GtkWidget *btn_refresh = gtk_button_new_with_label("Refresh Graph");
     GtkWidget *btn_restart = gtk_button_new_with_label("Restart PipeWire");
     GtkWidget *btn_pavu = gtk_button_new_with_label("Open Volume Control (pavucontrol)");
 
@@ -399,6 +1296,90 @@ GtkWidget *create_audio_page(GtkLabel *status_label)
     gtk_box_append(GTK_BOX(button_box), btn_pavu);
     gtk_box_append(GTK_BOX(vbox), button_box);
 
+    /* Latency: clock settings, forcing them, and pw-top timings */
+    GtkWidget *tune = gtk_expander_new("Latency and xruns");
+    ui->tune_box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 6);
+    GtkWidget *clock_label = gtk_label_new("Reading PipeWire clock…");
+    gtk_widget_set_halign(clock_label, GTK_ALIGN_START);
+    gtk_label_set_wrap(GTK_LABEL(clock_label), TRUE);
+    ui->clock_label = GTK_LABEL(clock_label);
+    gtk_box_append(GTK_BOX(ui->tune_box), clock_label);
+
+    GtkWidget *force = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 8);
+    const char *quanta[G_N_ELEMENTS(tune_quanta) + 1] = { "Off" };
+    const char *rates[G_N_ELEMENTS(tune_rates) + 1] = { "Off" };
+    char *names[G_N_ELEMENTS(tune_quanta) + G_N_ELEMENTS(tune_rates)];
+    guint nn = 0;
+    for (guint i = 1; i < G_N_ELEMENTS(tune_quanta); i++) quanta[i] = names[nn++] = g_strdup_printf("%u", tune_quanta[i]);
+    for (guint i = 1; i < G_N_ELEMENTS(tune_rates); i++) rates[i] = names[nn++] = g_strdup_printf("%u Hz", tune_rates[i]);
+    ui->quantum_dd = GTK_DROP_DOWN(gtk_drop_down_new_from_strings(quanta));
+    ui->rate_dd = GTK_DROP_DOWN(gtk_drop_down_new_from_strings(rates));
+    for (guint i = 0; i < nn; i++) g_free(names[i]);
+    gtk_box_append(GTK_BOX(force), gtk_label_new("Force quantum"));
+    gtk_box_append(GTK_BOX(force), GTK_WIDGET(ui->quantum_dd));
+    gtk_box_append(GTK_BOX(force), gtk_label_new("Force rate"));
+    gtk_box_append(GTK_BOX(force), GTK_WIDGET(ui->rate_dd));
+    char *dropin = pw_tune_dropin_path();
+    GtkWidget *persist = gtk_check_button_new_with_label("Keep after restart");
+    gtk_check_button_set_active(GTK_CHECK_BUTTON(persist), g_file_test(dropin, G_FILE_TEST_EXISTS));
+    gtk_widget_set_tooltip_text(persist, dropin);
+    g_free(dropin);
+    ui->persist_btn = GTK_CHECK_BUTTON(persist);
+    gtk_box_append(GTK_BOX(force), persist);
+    gtk_box_append(GTK_BOX(ui->tune_box), force);
+
+    GtkWidget *nodes_label = gtk_label_new("");
+    gtk_widget_set_halign(nodes_label, GTK_ALIGN_START);
+    gtk_label_set_selectable(GTK_LABEL(nodes_label), TRUE);
+    gtk_widget_add_css_class(nodes_label, "monospace");
+    ui->nodes_label = GTK_LABEL(nodes_label);
+    GtkWidget *nodes_sc = gtk_scrolled_window_new();
+    gtk_scrolled_window_set_policy(GTK_SCROLLED_WINDOW(nodes_sc), GTK_POLICY_AUTOMATIC, GTK_POLICY_AUTOMATIC);
+    gtk_widget_set_size_request(nodes_sc, -1, 160);
+    gtk_scrolled_window_set_child(GTK_SCROLLED_WINDOW(nodes_sc), nodes_label);
+    gtk_box_append(GTK_BOX(ui->tune_box), nodes_sc);
+    gtk_expander_set_child(GTK_EXPANDER(tune), ui->tune_box);
+    gtk_box_append(GTK_BOX(vbox), tune);
+
+    g_signal_connect(ui->tune_box, "map", G_CALLBACK(on_tune_map), ui);
+    g_signal_connect(ui->tune_box, "unmap", G_CALLBACK(on_tune_unmap), ui);
+    g_signal_connect(ui->quantum_dd, "notify::selected", G_CALLBACK(on_tune_picked), ui);
+    g_signal_connect(ui->rate_dd, "notify::selected", G_CALLBACK(on_tune_picked), ui);
+    g_signal_connect(persist, "toggled", G_CALLBACK(on_persist_toggled), ui);
+
+    /* Equalizer: bands, their combined response, and the sink they form */
+    GtkWidget *eq = gtk_expander_new("Equalizer");
+    GtkWidget *eq_box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 6);
+    ui->eq_bands = eq_load(&ui->eq_enabled);
+    GtkWidget *eq_enable = gtk_check_button_new_with_label("Play everything through the equalizer");
+    gtk_check_button_set_active(GTK_CHECK_BUTTON(eq_enable), ui->eq_enabled);
+    gtk_box_append(GTK_BOX(eq_box), eq_enable);
+
+    ui->eq_plot = gtk_drawing_area_new();
+    gtk_widget_set_hexpand(ui->eq_plot, TRUE);
+    gtk_drawing_area_set_content_height(GTK_DRAWING_AREA(ui->eq_plot), 120);
+    gtk_drawing_area_set_draw_func(GTK_DRAWING_AREA(ui->eq_plot), draw_eq_plot, ui, NULL);
+    gtk_box_append(GTK_BOX(eq_box), ui->eq_plot);
+
+    ui->eq_rows = gtk_box_new(GTK_ORIENTATION_VERTICAL, 4);
+    eq_rebuild_rows(ui);
+    gtk_box_append(GTK_BOX(eq_box), ui->eq_rows);
+
+    GtkWidget *eq_buttons = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 6);
+    gtk_widget_set_halign(eq_buttons, GTK_ALIGN_END);
+    ui->eq_add = gtk_button_new_with_label("Add Band");
+    ui->eq_apply = gtk_button_new_with_label("Apply (restarts PipeWire)");
+    gtk_box_append(GTK_BOX(eq_buttons), ui->eq_add);
+    gtk_box_append(GTK_BOX(eq_buttons), ui->eq_apply);
+    gtk_box_append(GTK_BOX(eq_box), eq_buttons);
+    eq_sync_apply(ui);
+    gtk_expander_set_child(GTK_EXPANDER(eq), eq_box);
+    gtk_box_append(GTK_BOX(vbox), eq);
+
+    g_signal_connect(eq_enable, "toggled", G_CALLBACK(on_eq_enable_toggled), ui);
+    g_signal_connect(ui->eq_add, "clicked", G_CALLBACK(on_eq_add_clicked), ui);
+    g_signal_connect(ui->eq_apply, "clicked", G_CALLBACK(on_eq_apply_clicked), ui);
+
     /* Connect signals */
     g_signal_connect(scale, "value-changed", G_CALLBACK(set_volume_from_slider), ui);
     g_signal_connect(mute, "toggled", G_CALLBACK(on_mute_toggled), ui);
@@ -406,16 +1387,17 @@ GtkWidget *create_audio_page(GtkLabel *status_label)
     g_signal_connect(btn_refresh, "clicked", G_CALLBACK(on_refresh_info_clicked), ui);
     g_signal_connect(btn_restart, "clicked", G_CALLBACK(on_restart_pipewire_clicked), ui);
 
-    /* Start periodic refresh every 3000ms (runs in background thread) */
-    g_timeout_add_seconds(3, on_periodic_refresh, ui);
-
-    /* Fetch initial volume async (one-shot) */
-    ui->refresh_in_progress = TRUE;
-    g_thread_new("audio-init", fetch_initial_volume_thread, ui);
+    /* Bind controls to the default sink; state arrives from events */
+    g_signal_connect(ui->server, "notify::default-sink", G_CALLBACK(on_server_notify), ui);
+    g_signal_connect(ui->server, "notify::default-source", G_CALLBACK(on_server_notify), ui);
+    g_signal_connect(ui->server, "notify::server-info", G_CALLBACK(on_server_notify), ui);
+    g_signal_connect(ui->server, "notify::connected", G_CALLBACK(on_server_notify), ui);
+    track_default_sink(ui);
+    track_meter_sources(ui);
+    sync_controls(ui);
 
     /* Fetch initial PipeWire info async */
-    ui->refresh_in_progress = TRUE;
-    g_thread_new("audio-init-info", fetch_pipewire_info_thread, ui);
+    refresh_info(ui);
 
     return vbox;
 }
@@ -1,296 +1,1062 @@
 #include "../common.h"
+#include "../hyprwatch.h"
+#include "../edithistory.h"
+#include "../hyprbinds.h"
+#include "../hyprconf.h"
+#include "../hypripc.h"
 #include <gtk/gtk.h>
+#include <json-glib/json-glib.h>
+#include <stdlib.h>
 
+/* One bind (or comment) line; the list view binds recycled row widgets to these */
+#define BIND_TYPE_ROW (bind_row_get_type())
+G_DECLARE_FINAL_TYPE(BindRow, bind_row, BIND, ROW, GObject)
+
+typedef enum {
+    BIND_NOTE_NONE,
+    BIND_NOTE_ERROR,
+    BIND_NOTE_DUPLICATE,   /* same trigger and action as another bind */
+    BIND_NOTE_CONFLICT     /* same trigger, different action */
+} BindNote;
+
+struct _BindRow {
+    GObject parent_instance;
+    char *text;
+    int line;              /* file line this row came from, -1 for rows added in the UI */
+    gboolean invalid;      /* rejected by the last Save */
+    const char *submap;    /* interned, "" for the global map */
+    gboolean is_bind;
+    HyprBind bind;
+    char *trigger;         /* key into the conflict index, NULL when not indexed */
+    char *search;          /* casefolded "MODS key dispatcher" for the filter */
+    BindNote note;
+    char *detail;          /* tooltip for the note */
+    char *reported;        /* error Hyprland gave for this line on the last reload */
+};
+
+enum {
+    PROP_0,
+    PROP_INVALID,
+    PROP_NOTE,
+    N_PROPS
+};
+
+static GParamSpec *props[N_PROPS];
+
+G_DEFINE_FINAL_TYPE(BindRow, bind_row, G_TYPE_OBJECT)
+
+static void bind_row_finalize(GObject *obj)
+{
+    BindRow *r = BIND_ROW(obj);
+    g_free(r->text);
+    hypr_bind_clear(&r->bind);
+    g_free(r->trigger);
+    g_free(r->search);
+    g_free(r->detail);
+    g_free(r->reported);
+    G_OBJECT_CLASS(bind_row_parent_class)->finalize(obj);
+}
+
+static void bind_row_get_property(GObject *obj, guint id, GValue *value, GParamSpec *pspec)
+{
+    BindRow *r = BIND_ROW(obj);
+    switch (id) {
+    case PROP_INVALID: g_value_set_boolean(value, r->invalid); break;
+    case PROP_NOTE: g_value_set_int(value, r->note); break;
+    default: G_OBJECT_WARN_INVALID_PROPERTY_ID(obj, id, pspec);
+    }
+}
+
+static void bind_row_class_init(BindRowClass *klass)
+{
+    GObjectClass *oc = G_OBJECT_CLASS(klass);
+    oc->finalize = bind_row_finalize;
+    oc->get_property = bind_row_get_property;
+    props[PROP_INVALID] = g_param_spec_boolean("invalid", NULL, NULL, FALSE, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
+    props[PROP_NOTE] = g_param_spec_int("note", NULL, NULL, BIND_NOTE_NONE, BIND_NOTE_CONFLICT, BIND_NOTE_NONE,
+                                        G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
+    g_object_class_install_properties(oc, N_PROPS, props);
+}
+
+static void bind_row_init(BindRow *r)
+{
+    r->line = -1;
+    r->submap = g_intern_static_string("");
+}
+
+/* `len` may be -1 */
+static BindRow *bind_row_new(const char *text, gssize len, int line)
+{
+    BindRow *r = g_object_new(BIND_TYPE_ROW, NULL);
+    r->text = len < 0 ? g_strdup(text) : g_strndup(text, (gsize)len);
+    r->line = line;
+    return r;
+}
+
+static void bind_row_set_invalid(BindRow *r, gboolean invalid)
+{
+    if (r->invalid == invalid) return;
+    r->invalid = invalid;
+    g_object_notify_by_pspec(G_OBJECT(r), props[PROP_INVALID]);
+}
+
+/* `msg` is copied; NULL clears the note */
+static void bind_row_set_reported(BindRow *r, const char *msg)
+{
+    if (g_strcmp0(r->reported, msg) == 0) return;
+    g_free(r->reported);
+    r->reported = g_strdup(msg);
+    g_object_notify_by_pspec(G_OBJECT(r), props[PROP_NOTE]);
+}
+
+static void bind_row_set_note(BindRow *r, BindNote note, char *detail)
+{
+    if (r->note == note && g_strcmp0(r->detail, detail) == 0) {
+        g_free(detail);
+        return;
+    }
+    r->note = note;
+    g_free(r->detail);
+    r->detail = detail;
+    g_object_notify_by_pspec(G_OBJECT(r), props[PROP_NOTE]);
+}
+
+/* One line of the loaded file. Rows refer to these by index; the text of
+ * lines without a row (comments, blanks, other keywords) is never copied. */
 typedef struct {
-    GtkWidget  *container; /* GtkBox holding bind rows */
+    gsize start;           /* offset into doc */
+    gsize len;             /* without the newline */
+    const char *submap;    /* interned submap in effect at this line */
+    gboolean row;          /* shown as a row in the list */
+} DocLine;
+
+typedef struct {
+    GListStore *rows;      /* BindRow*, in display order */
+    GtkFilterListModel *shown; /* rows passing the filter */
+    GtkCustomFilter *filter;
+    char      **query;     /* casefolded filter words, NULL when empty */
+    GtkWidget  *list;      /* GtkListView over shown */
+    GHashTable *index;     /* trigger -> GPtrArray of BindRow* sharing it */
+    GHashTable *vars;      /* $variables of hyprland.conf and binds.conf */
+    GHashTable *conf_vars; /* those of hyprland.conf alone, as last loaded */
     GtkLabel   *status;    /* status label to report messages */
     char       *path;      /* path to binds.conf */
-    GPtrArray  *rows;      /* array of GtkWidget* rows */
-    GPtrArray  *original_lines; /* original file lines (preserve comments/blanks) */
+    char       *doc;       /* binds.conf as loaded; Save copies unchanged lines from here */
+    gsize       doc_len;
+    GArray     *lines;     /* DocLine for each line of doc */
+    FileStamp   stamp;     /* on-disk identity of binds.conf when loaded/saved */
+    gboolean    force_save; /* set after a conflict: next Save overwrites */
+    gboolean    dirty;     /* rows edited since load/save */
+    HyprWatch  *watch;
+    EditHistory *history;  /* row-level undo: positions are indexes into rows */
+    GtkWidget  *undo_btn;
+    GtkWidget  *redo_btn;
+    GCancellable *reload_cancel; /* reload and error query after a save */
+    GCancellable *load_cancel;   /* file read in flight */
+    gboolean    loaded;    /* the first read has finished */
 } BindsPageData;
 
-static void on_remove_bind_clicked(GtkButton *btn, gpointer user_data);
-static void on_add_bind_clicked(GtkButton *btn, gpointer user_data);
 static void on_save_binds_clicked(GtkButton *btn, gpointer user_data);
 
-static GtkWidget *create_bind_row(BindsPageData *pd, const char *line)
+static BindRow *get_row(BindsPageData *pd, guint pos)
+{
+    /* the store holds a reference; callers only borrow */
+    BindRow *r = g_list_model_get_item(G_LIST_MODEL(pd->rows), pos);
+    g_object_unref(r);
+    return r;
+}
+
+/* Conflict index. Each bind sits in the bucket of its trigger (submap, mods,
+ * key); only the buckets an edit touches are re-examined, so loading and
+ * typing stay linear in the number of binds. */
+
+static void bucket_update(GPtrArray *bucket)
+{
+    if (bucket->len == 1) {
+        bind_row_set_note(g_ptr_array_index(bucket, 0), BIND_NOTE_NONE, NULL);
+        return;
+    }
+    /* a bucket holds the binds of one trigger, rarely more than a few, so
+     * pairwise is cheaper than hashing the actions */
+    for (guint i = 0; i < bucket->len; i++) {
+        BindRow *r = g_ptr_array_index(bucket, i), *dup = NULL;
+        for (guint j = 0; j < bucket->len && !dup; j++) {
+            BindRow *o = g_ptr_array_index(bucket, j);
+            if (j != i && hypr_bind_same_action(&r->bind, &o->bind)) dup = o;
+        }
+        if (dup) {
+            bind_row_set_note(r, BIND_NOTE_DUPLICATE, g_strdup_printf("Same keys and action as: %s", dup->text));
+        } else {
+            BindRow *other = g_ptr_array_index(bucket, i == 0 ? 1 : 0);
+            bind_row_set_note(r, BIND_NOTE_CONFLICT, g_strdup_printf("Same keys as: %s", other->text));
+        }
+    }
+}
+
+static void index_remove(BindsPageData *pd, BindRow *r)
+{
+    if (!r->trigger) return;
+    GPtrArray *bucket = g_hash_table_lookup(pd->index, r->trigger);
+    if (bucket) {
+        g_ptr_array_remove(bucket, r);
+        if (bucket->len == 0) g_hash_table_remove(pd->index, r->trigger);
+        else bucket_update(bucket);
+    }
+    g_clear_pointer(&r->trigger, g_free);
+}
+
+/* Re-read the row's text and file it under its new trigger. `update` is
+ * FALSE during bulk loads, which update every bucket once at the end. */
+static void index_add(BindsPageData *pd, BindRow *r, gboolean update)
+{
+    hypr_bind_clear(&r->bind);
+    g_free(r->search);
+    r->is_bind = hypr_bind_parse(r->text, pd->vars, &r->bind);
+    r->trigger = r->is_bind ? hypr_bind_trigger(&r->bind, r->submap) : NULL;
+    if (r->is_bind && !r->bind.error) {
+        char *mods = hypr_bind_mods_to_string(r->bind.mods);
+        char *joined = g_strdup_printf("%s %s %s", mods, r->bind.key, r->bind.dispatcher);
+        r->search = g_utf8_casefold(joined, -1);
+        g_free(joined);
+        g_free(mods);
+    } else {
+        r->search = g_utf8_casefold(r->text, -1);
+    }
+
+    if (!r->trigger) {
+        bind_row_set_note(r, r->bind.error ? BIND_NOTE_ERROR : BIND_NOTE_NONE, g_strdup(r->bind.error));
+        return;
+    }
+    GPtrArray *bucket = g_hash_table_lookup(pd->index, r->trigger);
+    if (!bucket) {
+        bucket = g_ptr_array_new();
+        g_hash_table_insert(pd->index, g_strdup(r->trigger), bucket);
+    }
+    g_ptr_array_add(bucket, r);
+    if (update) bucket_update(bucket);
+}
+
+static const char *submap_for_line(BindsPageData *pd, int line)
+{
+    if (!pd->lines || pd->lines->len == 0) return g_intern_static_string("");
+    /* rows added in the UI are written at the end of the file */
+    if (line < 0 || (guint)line >= pd->lines->len) line = (int)pd->lines->len - 1;
+    return g_array_index(pd->lines, DocLine, line).submap;
+}
+
+/* Rebuild the whole index, e.g. after the submap layout or variables changed */
+static void reindex_all(BindsPageData *pd)
+{
+    g_hash_table_remove_all(pd->index);
+    guint n = g_list_model_get_n_items(G_LIST_MODEL(pd->rows));
+    for (guint i = 0; i < n; i++) {
+        BindRow *r = get_row(pd, i);
+        g_clear_pointer(&r->trigger, g_free);
+        r->submap = submap_for_line(pd, r->line);
+        index_add(pd, r, FALSE);
+    }
+    GHashTableIter it;
+    gpointer bucket;
+    g_hash_table_iter_init(&it, pd->index);
+    while (g_hash_table_iter_next(&it, NULL, &bucket)) bucket_update(bucket);
+}
+
+/* Every word of the query must occur in the row's mods, key or dispatcher */
+static gboolean filter_row(gpointer item, gpointer user_data)
 {
+    BindsPageData *pd = user_data;
+    BindRow *r = item;
+    if (!r->search) return TRUE; /* not parsed yet */
+    for (char **w = pd->query; w && *w; w++) {
+        if (!strstr(r->search, *w)) return FALSE;
+    }
+    return TRUE;
+}
+
+static void on_filter_changed(GtkSearchEntry *e, gpointer user_data)
+{
+    BindsPageData *pd = user_data;
+    char *folded = g_utf8_casefold(gtk_editable_get_text(GTK_EDITABLE(e)), -1);
+    g_strfreev(pd->query);
+    pd->query = g_strsplit_set(g_strstrip(folded), " \t", -1);
+    g_free(folded);
+    if (!pd->query[0]) g_clear_pointer(&pd->query, g_strfreev);
+    gtk_filter_changed(GTK_FILTER(pd->filter), GTK_FILTER_CHANGE_DIFFERENT);
+}
+
+/* Position of `row` in the filtered view, or -1 when the filter hides it */
+static gint view_position(BindsPageData *pd, BindRow *row)
+{
+    guint n = g_list_model_get_n_items(G_LIST_MODEL(pd->shown));
+    for (guint i = 0; i < n; i++) {
+        BindRow *r = g_list_model_get_item(G_LIST_MODEL(pd->shown), i);
+        g_object_unref(r);
+        if (r == row) return (gint)i;
+    }
+    return -1;
+}
+
+static void scroll_to_row(BindsPageData *pd, BindRow *row)
+{
+    gint pos = view_position(pd, row);
+    if (pos >= 0) gtk_list_view_scroll_to(GTK_LIST_VIEW(pd->list), (guint)pos, GTK_LIST_SCROLL_FOCUS, NULL);
+}
+
+static void update_undo_buttons(BindsPageData *pd)
+{
+    if (!pd->undo_btn) return;
+    gtk_widget_set_sensitive(pd->undo_btn, edit_history_can_undo(pd->history));
+    gtk_widget_set_sensitive(pd->redo_btn, edit_history_can_redo(pd->history));
+}
+
+/* History payload for a row: "<line-index>\n<text>". Entries are single
+ * lines, so the first newline always ends the index. */
+static void record_row(BindsPageData *pd, EditKind kind, BindRow *row, const char *text)
+{
+    guint pos = 0;
+    if (!g_list_store_find(pd->rows, row, &pos)) return;
+    char *payload = g_strdup_printf("%d\n%s", row->line, text ? text : "");
+    edit_history_record(pd->history, kind, pos, payload, strlen(payload));
+    g_free(payload);
+    update_undo_buttons(pd);
+}
+
+static void on_bind_entry_changed(GtkEditable *editable, gpointer user_data)
+{
+    BindsPageData *pd = user_data;
+    BindRow *row = g_object_get_data(G_OBJECT(editable), "bind-row");
+    if (!row) return; /* being bound */
+    g_free(row->text);
+    row->text = g_strdup(gtk_editable_get_text(editable));
+    bind_row_set_reported(row, NULL);
+    index_remove(pd, row);
+    index_add(pd, row, TRUE);
+    pd->dirty = TRUE;
+}
+
+/* Entry edits become one undo step each, committed when the entry loses
+ * focus, rather than one step per keystroke. */
+static void on_bind_entry_focus_enter(GtkEventControllerFocus *focus, gpointer user_data)
+{
+    GtkWidget *entry = gtk_event_controller_get_widget(GTK_EVENT_CONTROLLER(focus));
+    g_object_set_data_full(G_OBJECT(entry), "history-text",
+                           g_strdup(gtk_editable_get_text(GTK_EDITABLE(entry))), g_free);
+}
+
+static void on_bind_entry_focus_leave(GtkEventControllerFocus *focus, gpointer user_data)
+{
+    BindsPageData *pd = user_data;
+    GtkWidget *entry = gtk_event_controller_get_widget(GTK_EVENT_CONTROLLER(focus));
+    BindRow *row = g_object_get_data(G_OBJECT(entry), "bind-row");
+    const char *before = g_object_get_data(G_OBJECT(entry), "history-text");
+    const char *now = gtk_editable_get_text(GTK_EDITABLE(entry));
+    if (!row || !before || g_strcmp0(before, now) == 0) return;
+
+    edit_history_begin_group(pd->history);
+    record_row(pd, EDIT_DELETE, row, before);
+    record_row(pd, EDIT_INSERT, row, now);
+    edit_history_end_group(pd->history);
+    g_object_set_data_full(G_OBJECT(entry), "history-text", g_strdup(now), g_free);
+}
+
+static void on_remove_bind_clicked(GtkButton *btn, gpointer user_data)
+{
+    BindsPageData *pd = user_data;
+    BindRow *row = g_object_get_data(G_OBJECT(btn), "bind-row");
+    guint pos = 0;
+    if (!row || !g_list_store_find(pd->rows, row, &pos)) return;
+    record_row(pd, EDIT_DELETE, row, row->text);
+    index_remove(pd, row);
+    g_list_store_remove(pd->rows, pos);
+    pd->dirty = TRUE;
+}
+
+/* Row widgets are created once per visible slot and rebound while scrolling */
+static void row_setup(GtkSignalListItemFactory *f, GtkListItem *li, gpointer user_data)
+{
+    BindsPageData *pd = user_data;
     GtkWidget *h = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 6);
     gtk_widget_set_hexpand(h, TRUE);
 
     GtkWidget *entry = gtk_entry_new();
-    if (line) gtk_editable_set_text(GTK_EDITABLE(entry), line);
+    g_signal_connect(entry, "changed", G_CALLBACK(on_bind_entry_changed), pd);
+    GtkEventController *focus = gtk_event_controller_focus_new();
+    g_signal_connect(focus, "enter", G_CALLBACK(on_bind_entry_focus_enter), pd);
+    g_signal_connect(focus, "leave", G_CALLBACK(on_bind_entry_focus_leave), pd);
+    gtk_widget_add_controller(entry, focus);
     gtk_widget_set_hexpand(entry, TRUE);
     gtk_box_append(GTK_BOX(h), entry);
 
+    GtkWidget *note = gtk_label_new("");
+    gtk_widget_set_size_request(note, 80, -1);
+    gtk_label_set_xalign(GTK_LABEL(note), 0);
+    gtk_box_append(GTK_BOX(h), note);
+
     GtkWidget *btn_rm = gtk_button_new_with_label("Remove");
-    g_object_set_data(G_OBJECT(btn_rm), "row", h);
-    g_signal_connect(btn_rm, "clicked", G_CALLBACK(on_remove_bind_clicked), h);
+    g_signal_connect(btn_rm, "clicked", G_CALLBACK(on_remove_bind_clicked), pd);
     gtk_box_append(GTK_BOX(h), btn_rm);
 
-    g_object_set_data(G_OBJECT(h), "binds-pd", pd);
+    gtk_list_item_set_child(li, h);
+    gtk_list_item_set_activatable(li, FALSE);
+}
+
+static void sync_invalid(GObject *obj, GParamSpec *pspec, gpointer user_data)
+{
+    GtkWidget *entry = user_data;
+    if (BIND_ROW(obj)->invalid) gtk_widget_add_css_class(entry, "invalid-entry");
+    else gtk_widget_remove_css_class(entry, "invalid-entry");
+}
+
+static void sync_note(GObject *obj, GParamSpec *pspec, gpointer user_data)
+{
+    static const char *names[] = { "", "error", "duplicate", "conflict" };
+    BindRow *r = BIND_ROW(obj);
+    GtkWidget *label = user_data;
+    gtk_label_set_text(GTK_LABEL(label), r->note == BIND_NOTE_NONE && r->reported ? "rejected" : names[r->note]);
+    if (r->detail && r->reported) {
+        char *tip = g_strdup_printf("%s\nHyprland: %s", r->detail, r->reported);
+        gtk_widget_set_tooltip_text(label, tip);
+        g_free(tip);
+    } else if (r->reported) {
+        char *tip = g_strdup_printf("Hyprland: %s", r->reported);
+        gtk_widget_set_tooltip_text(label, tip);
+        g_free(tip);
+    } else {
+        gtk_widget_set_tooltip_text(label, r->detail);
+    }
+    if (r->note == BIND_NOTE_DUPLICATE && !r->reported) gtk_widget_remove_css_class(label, "error");
+    else gtk_widget_add_css_class(label, "error");
+}
+
+static void row_bind(GtkSignalListItemFactory *f, GtkListItem *li, gpointer user_data)
+{
+    BindRow *row = gtk_list_item_get_item(li);
+    GtkWidget *h = gtk_list_item_get_child(li);
+    GtkWidget *entry = gtk_widget_get_first_child(h);
+    GtkWidget *note = gtk_widget_get_next_sibling(entry);
+    GtkWidget *btn_rm = gtk_widget_get_last_child(h);
+
+    gtk_editable_set_text(GTK_EDITABLE(entry), row->text);
+    g_object_set_data(G_OBJECT(entry), "bind-row", row);
+    g_object_set_data(G_OBJECT(btn_rm), "bind-row", row);
+    sync_invalid(G_OBJECT(row), NULL, entry);
+    gulong id = g_signal_connect(row, "notify::invalid", G_CALLBACK(sync_invalid), entry);
+    g_object_set_data(G_OBJECT(entry), "notify-id", GSIZE_TO_POINTER(id));
+    sync_note(G_OBJECT(row), NULL, note);
+    id = g_signal_connect(row, "notify::note", G_CALLBACK(sync_note), note);
+    g_object_set_data(G_OBJECT(note), "notify-id", GSIZE_TO_POINTER(id));
+}
 
-    return h;
+static void row_unbind(GtkSignalListItemFactory *f, GtkListItem *li, gpointer user_data)
+{
+    GtkWidget *h = gtk_list_item_get_child(li);
+    GtkWidget *entry = gtk_widget_get_first_child(h);
+    GtkWidget *note = gtk_widget_get_next_sibling(entry);
+    gpointer row = gtk_list_item_get_item(li);
+    gulong id = GPOINTER_TO_SIZE(g_object_get_data(G_OBJECT(entry), "notify-id"));
+    if (id) g_signal_handler_disconnect(row, id);
+    id = GPOINTER_TO_SIZE(g_object_get_data(G_OBJECT(note), "notify-id"));
+    if (id) g_signal_handler_disconnect(row, id);
+    g_object_set_data(G_OBJECT(entry), "notify-id", NULL);
+    g_object_set_data(G_OBJECT(note), "notify-id", NULL);
+    g_object_set_data(G_OBJECT(entry), "bind-row", NULL);
+    g_object_set_data(G_OBJECT(entry), "history-text", NULL);
+    g_object_set_data(G_OBJECT(gtk_widget_get_last_child(h)), "bind-row", NULL);
 }
 
-static char *sanitize_bind_for_display(const char *s)
+static gboolean line_is_bind(const char *line, gsize len)
 {
-    if (!s) return NULL;
-    return g_strdup(s);
+    while (len > 0 && g_ascii_isspace(*line)) { line++; len--; }
+    return len >= 4 && g_ascii_strncasecmp(line, "bind", 4) == 0;
 }
 
-static void connect_bind_row_remove_button(GtkWidget *row)
+/* Line spans of `text`; a trailing newline leaves an empty last line, as
+ * g_strsplit() would */
+static GArray *doc_split(const char *text, gsize len)
 {
-    GtkWidget *btn = gtk_widget_get_last_child(row);
-    if (btn && GTK_IS_BUTTON(btn)) {
-        g_signal_handlers_disconnect_by_func(btn, G_CALLBACK(on_remove_bind_clicked), row);
-        g_signal_connect(btn, "clicked", G_CALLBACK(on_remove_bind_clicked), row);
+    GArray *lines = g_array_new(FALSE, TRUE, sizeof(DocLine));
+    gsize off = 0;
+    for (;;) {
+        const char *nl = memchr(text + off, '\n', len - off);
+        DocLine dl = { off, nl ? (gsize)(nl - text) - off : len - off, NULL, FALSE };
+        g_array_append_val(lines, dl);
+        if (!nl) break;
+        off = (gsize)(nl - text) + 1;
     }
+    return lines;
+}
+
+static const char *doc_line(BindsPageData *pd, guint i, gsize *len)
+{
+    DocLine *dl = &g_array_index(pd->lines, DocLine, i);
+    *len = dl->len;
+    return pd->doc + dl->start;
 }
 
-static void load_binds_file(BindsPageData *pd)
+/* Take `text` as the document: index its lines, the submap in effect at
+ * each and the variables bind lines may use (hyprland.conf's, then
+ * binds.conf's own) */
+static void load_doc(BindsPageData *pd, char *text, gsize len)
 {
-    if (pd->rows) {
-        for (guint i = 0; i < pd->rows->len; ++i) {
-            GtkWidget *r = g_ptr_array_index(pd->rows, i);
-            gtk_box_remove(GTK_BOX(pd->container), r);
+    g_free(pd->doc);
+    pd->doc = text;
+    pd->doc_len = len;
+    if (pd->lines) g_array_unref(pd->lines);
+    pd->lines = doc_split(text, len);
+    if (pd->vars) g_hash_table_destroy(pd->vars);
+    pd->vars = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+    if (pd->conf_vars) {
+        GHashTableIter it;
+        gpointer key, value;
+        g_hash_table_iter_init(&it, pd->conf_vars);
+        while (g_hash_table_iter_next(&it, &key, &value)) g_hash_table_insert(pd->vars, g_strdup(key), g_strdup(value));
+    }
+
+    const char *submap = g_intern_static_string("");
+    for (guint i = 0; i < pd->lines->len; i++) {
+        DocLine *dl = &g_array_index(pd->lines, DocLine, i);
+        const char *line = text + dl->start;
+        submap = hypr_bind_submap_after(line, (gssize)dl->len, submap);
+        dl->submap = submap;
+        dl->row = line_is_bind(line, dl->len);
+        HyprLine hl;
+        hypr_conf_scan_line(line, (gssize)dl->len, &hl);
+        if (hl.kind == HYPR_LINE_VARIABLE) {
+            g_hash_table_replace(pd->vars, g_strndup(hl.key, hl.key_len), g_strndup(hl.value, hl.value_len));
         }
-        g_ptr_array_free(pd->rows, TRUE);
-        pd->rows = NULL;
     }
+}
+
+/* Rebuild every row from `content` (taken; NULL when binds.conf is
+ * missing) */
+static void load_binds_text(BindsPageData *pd, char *content, gsize len)
+{
+    /* dropping focused rows must not record edits */
+    if (pd->history) edit_history_set_enabled(pd->history, FALSE);
+    guint old = g_list_model_get_n_items(G_LIST_MODEL(pd->rows));
 
-    gchar *content = NULL;
-    if (!g_file_get_contents(pd->path, &content, NULL, NULL)) {
+    if (!content) {
+        load_doc(pd, g_strdup(""), 0);
+        g_hash_table_remove_all(pd->index);
+        g_list_store_remove_all(pd->rows);
         set_status(pd->status, "No binds.conf found at %s — starting empty", pd->path);
+        if (pd->history) edit_history_set_enabled(pd->history, TRUE);
         return;
     }
 
-    gchar **lines = g_strsplit(content, "\n", -1);
-    pd->original_lines = g_ptr_array_new_with_free_func(g_free);
-    pd->rows = g_ptr_array_new();
-    for (gint i = 0; lines[i] != NULL; ++i) {
-        g_ptr_array_add(pd->original_lines, g_strdup(lines[i]));
-
-        char *trim = g_strdup(lines[i]);
-        g_strstrip(trim);
-        if (strlen(trim) == 0) { g_free(trim); continue; }
-        if (trim[0] == '#') { g_free(trim); continue; }
-
-        char *lower = g_ascii_strdown(trim, -1);
-        gboolean is_bind = g_str_has_prefix(lower, "bind");
-        g_free(lower);
-        g_free(trim);
-        if (!is_bind) continue;
-
-        char *disp = sanitize_bind_for_display(lines[i]);
-        GtkWidget *row = create_bind_row(pd, disp ? disp : lines[i]);
-        g_free(disp);
-        gtk_box_append(GTK_BOX(pd->container), row);
-        g_ptr_array_add(pd->rows, row);
-        connect_bind_row_remove_button(row);
+    load_doc(pd, content, len);
+    GPtrArray *rows = g_ptr_array_new_with_free_func(g_object_unref);
+    for (guint i = 0; i < pd->lines->len; ++i) {
+        DocLine *dl = &g_array_index(pd->lines, DocLine, i);
+        if (dl->row) g_ptr_array_add(rows, bind_row_new(pd->doc + dl->start, (gssize)dl->len, (int)i));
     }
-    g_strfreev(lines);
-    g_free(content);
+    /* one items-changed for the whole file */
+    g_hash_table_remove_all(pd->index);
+    g_list_store_splice(pd->rows, 0, old, rows->pdata, rows->len);
+    g_ptr_array_free(rows, TRUE);
+    reindex_all(pd);
+    pd->dirty = FALSE;
+    if (pd->history) edit_history_set_enabled(pd->history, TRUE);
 
     set_status(pd->status, "Loaded %s", pd->path);
 }
 
-static void on_remove_bind_clicked(GtkButton *btn, gpointer user_data)
+static void append_row(BindsPageData *pd, const char *text)
 {
-    GtkWidget *row = GTK_WIDGET(user_data);
-    GtkWidget *parent = gtk_widget_get_parent(row);
-    if (parent && GTK_IS_BOX(parent)) {
-        gtk_box_remove(GTK_BOX(parent), row);
-        BindsPageData *pd = g_object_get_data(G_OBJECT(row), "binds-pd");
-        if (pd && pd->rows) {
-            g_ptr_array_remove(pd->rows, row);
-        }
-    }
+    BindRow *row = bind_row_new(text, -1, -1);
+    row->submap = submap_for_line(pd, -1);
+    index_add(pd, row, TRUE);
+    g_list_store_append(pd->rows, row);
+    pd->dirty = TRUE;
+    record_row(pd, EDIT_INSERT, row, text);
+    scroll_to_row(pd, row);
+    g_object_unref(row);
 }
 
 static void on_add_bind_clicked(GtkButton *btn, gpointer user_data)
 {
     BindsPageData *pd = user_data;
-    GtkWidget *row = create_bind_row(pd, "");
-    connect_bind_row_remove_button(row);
-    gtk_box_append(GTK_BOX(pd->container), row);
-    if (!pd->rows) pd->rows = g_ptr_array_new();
-    g_ptr_array_add(pd->rows, row);
+    append_row(pd, "");
     set_status(pd->status, "Added new bind entry (edit and Save)");
 }
 
 static void on_add_comment_clicked(GtkButton *btn, gpointer user_data)
 {
     BindsPageData *pd = user_data;
-    GtkWidget *row = create_bind_row(pd, "# ");
-    connect_bind_row_remove_button(row);
-    gtk_box_append(GTK_BOX(pd->container), row);
-    if (!pd->rows) pd->rows = g_ptr_array_new();
-    g_ptr_array_add(pd->rows, row);
+    append_row(pd, "# ");
     set_status(pd->status, "Added new comment (edit and Save)");
 }
 
-static void on_save_binds_clicked(GtkButton *btn, gpointer user_data)
+static void binds_history_apply(EditKind kind, gint64 pos, const char *text, gsize len, gpointer user_data)
 {
     BindsPageData *pd = user_data;
-    GString *out = g_string_new(NULL);
-    GtkWidget *first_invalid = NULL;
-    GPtrArray *visible_bind_lines = g_ptr_array_new_with_free_func(g_free);
-    GPtrArray *visible_comment_lines = g_ptr_array_new_with_free_func(g_free);
-    if (pd->rows) {
-        for (guint i = 0; i < pd->rows->len; ++i) {
-            GtkWidget *row = g_ptr_array_index(pd->rows, i);
-            GtkWidget *entry = gtk_widget_get_first_child(row);
-            if (entry && GTK_IS_ENTRY(entry)) {
-                GtkStyleContext *ctx = gtk_widget_get_style_context(entry);
-                gtk_style_context_remove_class(ctx, "invalid-entry");
-
-                const char *txt = gtk_editable_get_text(GTK_EDITABLE(entry));
-                const char *use_txt = txt ? txt : "";
-
-                char *trim = g_strdup(use_txt);
-                g_strstrip(trim);
-
-                if (strlen(trim) == 0) {
-                    g_ptr_array_add(visible_bind_lines, g_strdup(""));
-                    g_free(trim);
-                    continue;
-                }
-
-                if (trim[0] == '#') {
-                    g_ptr_array_add(visible_comment_lines, g_strdup(use_txt));
-                    g_free(trim);
-                    continue;
-                }
-
-                char *lower = g_ascii_strdown(trim, -1);
-                if (!g_str_has_prefix(lower, "bind")) {
-                    gtk_style_context_add_class(ctx, "invalid-entry");
-                    if (!first_invalid) first_invalid = entry;
-                    g_free(lower);
-                    g_free(trim);
-                    continue;
-                }
-                g_free(lower);
-                g_free(trim);
-
-                g_ptr_array_add(visible_bind_lines, g_strdup(use_txt));
-            }
-        }
+    guint n = g_list_model_get_n_items(G_LIST_MODEL(pd->rows));
+    if (kind == EDIT_DELETE) {
+        if ((guint)pos >= n) return;
+        index_remove(pd, get_row(pd, (guint)pos));
+        g_list_store_remove(pd->rows, (guint)pos);
+    } else {
+        char *copy = g_strndup(text, len);
+        char *nl = strchr(copy, '\n');
+        const char *line = "";
+        if (nl) { *nl = '\0'; line = nl + 1; }
+        BindRow *row = bind_row_new(line, -1, atoi(copy));
+        row->submap = submap_for_line(pd, row->line);
+        index_add(pd, row, TRUE);
+        g_list_store_insert(pd->rows, MIN((guint)pos, n), row);
+        g_object_unref(row);
+        g_free(copy);
     }
+    pd->dirty = TRUE;
+}
 
-    if (first_invalid) {
-        g_ptr_array_free(visible_bind_lines, TRUE);
-        g_ptr_array_free(visible_comment_lines, TRUE);
-        set_status(pd->status, "Validation failed: some lines must start with 'bind'");
-        gtk_widget_grab_focus(first_invalid);
-        return;
+static void on_binds_undo_clicked(GtkButton *btn, gpointer user_data)
+{
+    BindsPageData *pd = user_data;
+    if (edit_history_undo(pd->history)) set_status(pd->status, "Undid last change (Save to write it)");
+    update_undo_buttons(pd);
+}
+
+static void on_binds_redo_clicked(GtkButton *btn, gpointer user_data)
+{
+    BindsPageData *pd = user_data;
+    if (edit_history_redo(pd->history)) set_status(pd->status, "Redid change (Save to write it)");
+    update_undo_buttons(pd);
+}
+
+static gboolean on_binds_undo_shortcut(GtkWidget *widget, GVariant *args, gpointer user_data)
+{
+    if (g_variant_get_boolean(args)) on_binds_redo_clicked(NULL, user_data);
+    else on_binds_undo_clicked(NULL, user_data);
+    return TRUE;
+}
+
+/* Row texts in display order, used to tell whether history positions still
+ * line up with the rows after a reload. */
+static GPtrArray *snapshot_rows(BindsPageData *pd)
+{
+    GPtrArray *snap = g_ptr_array_new_with_free_func(g_free);
+    guint n = g_list_model_get_n_items(G_LIST_MODEL(pd->rows));
+    for (guint i = 0; i < n; i++) g_ptr_array_add(snap, g_strdup(get_row(pd, i)->text));
+    return snap;
+}
+
+static gboolean snapshots_equal(GPtrArray *a, GPtrArray *b)
+{
+    if (a->len != b->len) return FALSE;
+    for (guint i = 0; i < a->len; i++) {
+        if (g_strcmp0(g_ptr_array_index(a, i), g_ptr_array_index(b, i)) != 0) return FALSE;
     }
+    return TRUE;
+}
+
+/* After a save: ask Hyprland to reload, then fetch j/configerrors and hang
+ * each error about binds.conf on the row for its line. Both requests run
+ * on the IPC worker with a timeout; a newer save cancels them. */
 
-    GPtrArray *out_lines = g_ptr_array_new_with_free_func(g_free);
-    if (pd->original_lines && pd->original_lines->len > 0) {
-        for (guint i = 0; i < pd->original_lines->len; ++i) {
-            g_ptr_array_add(out_lines, g_strdup(g_ptr_array_index(pd->original_lines, i)));
+static void on_config_errors(GObject *source, GAsyncResult *res, gpointer user_data)
+{
+    GError *err = NULL;
+    gchar *reply = hypr_ipc_request_finish(res, &err);
+    if (!reply) {
+        if (!g_error_matches(err, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+            BindsPageData *pd = user_data;
+            set_status(pd->status, "Saved and reloaded binds; could not read config errors: %s", err->message);
         }
+        g_clear_error(&err);
+        return;
+    }
+    BindsPageData *pd = user_data;
+    JsonParser *parser = json_parser_new();
+    JsonNode *root = json_parser_load_from_data(parser, reply, -1, NULL) ? json_parser_get_root(parser) : NULL;
+    g_free(reply);
+    if (!root || !JSON_NODE_HOLDS_ARRAY(root)) {
+        set_status(pd->status, "Saved and reloaded binds");
+        g_object_unref(parser);
+        return;
     }
 
-    guint bind_index = 0;
-    for (guint i = 0; i < out_lines->len; ++i) {
-        char *oline = g_strdup(g_ptr_array_index(out_lines, i));
-        char *trim = g_strdup(oline);
-        g_strstrip(trim);
-        if (strlen(trim) == 0 || trim[0] == '#') {
-            g_free(oline);
-            g_free(trim);
-            continue;
-        }
+    /* rows were re-read after the save, so their lines are the file's */
+    guint n_rows = g_list_model_get_n_items(G_LIST_MODEL(pd->rows));
+    GHashTable *by_line = g_hash_table_new(g_direct_hash, g_direct_equal);
+    for (guint i = 0; i < n_rows; i++) {
+        BindRow *r = get_row(pd, i);
+        if (r->line >= 0) g_hash_table_insert(by_line, GINT_TO_POINTER(r->line + 1), r);
+    }
 
-        char *lower = g_ascii_strdown(trim, -1);
-        gboolean orig_is_bind = g_str_has_prefix(lower, "bind");
-        g_free(lower);
-        if (!orig_is_bind) {
-            g_free(oline);
-            g_free(trim);
-            continue;
+    static GRegex *re = NULL;
+    if (!re) re = g_regex_new("^Config error in file (.+) at line (\\d+): (.*)$", G_REGEX_DOTALL, 0, NULL);
+    JsonArray *arr = json_node_get_array(root);
+    guint total = 0, attached = 0;
+    const char *other = NULL;
+    for (guint i = 0; i < json_array_get_length(arr); i++) {
+        const char *msg = json_array_get_string_element(arr, i);
+        if (!msg || !*msg) continue;
+        total++;
+        GMatchInfo *mi = NULL;
+        BindRow *row = NULL;
+        char *text = NULL;
+        if (g_regex_match(re, msg, 0, &mi)) {
+            char *file = g_match_info_fetch(mi, 1);
+            char *line = g_match_info_fetch(mi, 2);
+            if (g_strcmp0(file, pd->path) == 0) row = g_hash_table_lookup(by_line, GINT_TO_POINTER(atoi(line)));
+            text = g_match_info_fetch(mi, 3);
+            g_free(file);
+            g_free(line);
+        }
+        g_match_info_free(mi);
+        if (row) {
+            bind_row_set_reported(row, text);
+            attached++;
+        } else if (!other) {
+            other = msg;
         }
+        g_free(text);
+    }
+    g_hash_table_destroy(by_line);
 
-        g_free(g_ptr_array_index(out_lines, i));
-        if (bind_index < visible_bind_lines->len) {
-            g_ptr_array_index(out_lines, i) = g_strdup(g_ptr_array_index(visible_bind_lines, bind_index));
-            bind_index++;
-        } else {
-            g_ptr_array_index(out_lines, i) = g_strdup("");
+    if (total == 0) set_status(pd->status, "Saved and reloaded binds");
+    else if (other) set_status(pd->status, "Reloaded with %u config error(s), %u on bind rows; first other: %s", total, attached, other);
+    else set_status(pd->status, "Reloaded with %u config error(s) in binds.conf; see the rejected rows", total);
+    g_object_unref(parser);
+}
+
+static void on_binds_reloaded(GObject *source, GAsyncResult *res, gpointer user_data)
+{
+    GError *err = NULL;
+    gchar *reply = hypr_ipc_request_finish(res, &err);
+    if (!reply) {
+        if (!g_error_matches(err, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+            BindsPageData *pd = user_data;
+            set_status(pd->status, "Saved binds to %s; Hyprland did not reload: %s", pd->path, err->message);
         }
-        g_free(oline);
-        g_free(trim);
+        g_clear_error(&err);
+        return;
+    }
+    BindsPageData *pd = user_data;
+    char *p = g_strstrip(reply);
+    if (!g_str_has_prefix(p, "ok")) {
+        set_status(pd->status, "Saved binds to %s; Hyprland reported: %s", pd->path, p);
+        g_free(reply);
+        return;
     }
+    g_free(reply);
+    hypr_ipc_request_async("j/configerrors", 3000, pd->reload_cancel, on_config_errors, pd);
+}
 
-    while (bind_index < visible_bind_lines->len) {
-        g_ptr_array_add(out_lines, g_strdup(g_ptr_array_index(visible_bind_lines, bind_index)));
-        bind_index++;
+static void binds_reload(BindsPageData *pd)
+{
+    guint n_rows = g_list_model_get_n_items(G_LIST_MODEL(pd->rows));
+    for (guint i = 0; i < n_rows; i++) bind_row_set_reported(get_row(pd, i), NULL);
+    if (pd->reload_cancel) {
+        g_cancellable_cancel(pd->reload_cancel);
+        g_object_unref(pd->reload_cancel);
+    }
+    pd->reload_cancel = g_cancellable_new();
+    if (g_dry_run) {
+        set_status(pd->status, "Saved binds to %s; Dry run: not reloading Hyprland", pd->path);
+        return;
     }
+    set_status(pd->status, "Saved binds to %s; reloading Hyprland…", pd->path);
+    hypr_ipc_request_async("reload", 5000, pd->reload_cancel, on_binds_reloaded, pd);
+}
+
+static gboolean row_text_valid(const char *text)
+{
+    while (g_ascii_isspace(*text)) text++;
+    return *text == '\0' || *text == '#' || line_is_bind(text, strlen(text));
+}
+
+static void insert_before(GPtrArray **before, guint line, BindRow *row)
+{
+    if (!before[line]) before[line] = g_ptr_array_new();
+    g_ptr_array_add(before[line], row);
+}
 
-    for (guint i = 0; i < visible_comment_lines->len; ++i) {
-        g_ptr_array_add(out_lines, g_strdup(g_ptr_array_index(visible_comment_lines, i)));
+/* The file as it should be written: in one pass over the document, runs of
+ * untouched lines are copied byte for byte, edited rows replace their line,
+ * removed rows drop theirs and rows added in the UI go after the row they
+ * follow in the list. */
+static GString *build_binds_doc(BindsPageData *pd)
+{
+    guint n_lines = pd->lines->len;
+    BindRow **at_line = g_new0(BindRow *, n_lines);
+    GPtrArray **before = g_new0(GPtrArray *, n_lines + 1);
+    GPtrArray *leading = g_ptr_array_new(); /* new rows above every file row */
+    gint anchor = -1;
+
+    guint n_rows = g_list_model_get_n_items(G_LIST_MODEL(pd->rows));
+    for (guint i = 0; i < n_rows; i++) {
+        BindRow *row = get_row(pd, i);
+        gint l = row->line;
+        if (l >= 0 && (guint)l < n_lines && g_array_index(pd->lines, DocLine, l).row && !at_line[l]) {
+            at_line[l] = row;
+            if (anchor < 0) {
+                for (guint k = 0; k < leading->len; k++) insert_before(before, (guint)l, g_ptr_array_index(leading, k));
+            }
+            anchor = l;
+        } else if (anchor >= 0) {
+            insert_before(before, (guint)anchor + 1, row);
+        } else {
+            g_ptr_array_add(leading, row);
+        }
+    }
+    if (anchor < 0) {
+        /* no file rows left: new rows go at the end, above a final newline */
+        guint end = n_lines > 0 && g_array_index(pd->lines, DocLine, n_lines - 1).len == 0 ? n_lines - 1 : n_lines;
+        for (guint k = 0; k < leading->len; k++) insert_before(before, end, g_ptr_array_index(leading, k));
     }
+    g_ptr_array_free(leading, TRUE);
 
-    GString *final = g_string_new(NULL);
-    for (guint i = 0; i < out_lines->len; ++i) {
-        char *s = g_ptr_array_index(out_lines, i);
-        g_string_append(final, s ? s : "");
-        if (i + 1 < out_lines->len) g_string_append_c(final, '\n');
+    GString *out = g_string_sized_new(pd->doc_len + 64);
+    gsize run = 0; /* start of the bytes still to copy verbatim */
+    for (guint i = 0; i <= n_lines; i++) {
+        DocLine *dl = i < n_lines ? &g_array_index(pd->lines, DocLine, i) : NULL;
+        BindRow *row = dl ? at_line[i] : NULL;
+        gboolean same = dl && (!dl->row || (row && strlen(row->text) == dl->len &&
+                                            memcmp(row->text, pd->doc + dl->start, dl->len) == 0));
+        if (same && !before[i]) continue;
+
+        gsize at = dl ? dl->start : pd->doc_len;
+        g_string_append_len(out, pd->doc + run, (gssize)(at - run));
+        run = at;
+        if (before[i]) {
+            if (!dl && out->len > 0 && out->str[out->len - 1] != '\n') g_string_append_c(out, '\n');
+            for (guint k = 0; k < before[i]->len; k++) {
+                BindRow *added = g_ptr_array_index(before[i], k);
+                g_string_append(out, added->text);
+                if (dl || k + 1 < before[i]->len) g_string_append_c(out, '\n');
+            }
+            g_ptr_array_free(before[i], TRUE);
+        }
+        if (!dl || same) continue;
+
+        gboolean last = i + 1 == n_lines;
+        if (row) {
+            g_string_append(out, row->text);
+            if (!last) g_string_append_c(out, '\n');
+        }
+        run = last ? pd->doc_len : g_array_index(pd->lines, DocLine, i + 1).start;
     }
+    g_string_append_len(out, pd->doc + run, (gssize)(pd->doc_len - run));
 
-    g_ptr_array_free(visible_bind_lines, TRUE);
-    g_ptr_array_free(visible_comment_lines, TRUE);
-    g_ptr_array_free(out_lines, TRUE);
-    g_string_free(out, TRUE);
-    out = final;
+    g_free(before);
+    g_free(at_line);
+    return out;
+}
 
+static void on_save_binds_clicked(GtkButton *btn, gpointer user_data)
+{
+    BindsPageData *pd = user_data;
+    if (!pd->loaded) {
+        set_status(pd->status, "Still loading %s", pd->path);
+        return;
+    }
+    BindRow *first_invalid = NULL;
+    guint n_rows = g_list_model_get_n_items(G_LIST_MODEL(pd->rows));
+    for (guint i = 0; i < n_rows; ++i) {
+        BindRow *row = get_row(pd, i);
+        gboolean valid = row_text_valid(row->text);
+        bind_row_set_invalid(row, !valid);
+        if (!valid && !first_invalid) first_invalid = row;
+    }
     if (first_invalid) {
         set_status(pd->status, "Validation failed: some lines must start with 'bind'");
-        gtk_widget_grab_focus(first_invalid);
-        g_string_free(out, TRUE);
+        scroll_to_row(pd, first_invalid);
         return;
     }
 
+    GString *out = build_binds_doc(pd);
+    gsize out_len = out->len;
+    char *text = g_string_free(out, FALSE);
     GError *error = NULL;
-    if (!g_file_set_contents(pd->path, out->str, -1, &error)) {
-        set_status(pd->status, "Failed to write %s: %s", pd->path, error->message);
+    ConfigSaveResult r = save_config_file(pd->path, text, (gssize)out_len, &pd->stamp, pd->force_save, &error);
+    pd->force_save = FALSE;
+    if (r == CONFIG_SAVE_FAILED) {
+        set_status(pd->status, "Failed to write %s: %s", pd->path, error ? error->message : "unknown");
+        g_clear_error(&error);
+        g_free(text);
+        return;
+    }
+    if (r == CONFIG_SAVE_CONFLICT) {
+        /* the next Save is a deliberate overwrite */
+        pd->force_save = TRUE;
+        set_status(pd->status, "%s changed on disk since it was loaded; press Save again to overwrite it", pd->path);
         g_clear_error(&error);
-        g_string_free(out, TRUE);
+        g_free(text);
+        return;
+    }
+    if (r == CONFIG_SAVE_UNCHANGED) {
+        pd->dirty = FALSE;
+        set_status(pd->status, "No changes to save in %s", pd->path);
+        g_free(text);
+        return;
+    }
+    /* rows now mirror the file; rebuild them from what was written so line
+     * identities match it. Undo history survives the save unless that
+     * changed the row layout (e.g. comments are not shown as rows once
+     * written). */
+    GPtrArray *before = snapshot_rows(pd);
+    load_binds_text(pd, text, out_len);
+    GPtrArray *after = snapshot_rows(pd);
+    if (!snapshots_equal(before, after)) edit_history_clear(pd->history);
+    g_ptr_array_free(before, TRUE);
+    g_ptr_array_free(after, TRUE);
+    update_undo_buttons(pd);
+
+    binds_reload(pd);
+}
+
+static gboolean same_line(BindsPageData *pd, guint i, const char *text, const DocLine *other)
+{
+    gsize len;
+    const char *line = doc_line(pd, i, &len);
+    return len == other->len && memcmp(line, text + other->start, len) == 0;
+}
+
+/* binds.conf changed on disk and there are no local edits: keep the rows of
+ * the unchanged leading and trailing lines and rebuild only the rows for the
+ * lines in between. `content` is taken; NULL when the file is gone. */
+static void merge_binds_file(BindsPageData *pd, char *content, gsize len)
+{
+    if (!content) {
+        set_status(pd->status, "%s was removed on disk", pd->path);
         return;
     }
-    g_string_free(out, TRUE);
-
-    set_status(pd->status, "Saved binds to %s", pd->path);
-    char *hyprctl = g_find_program_in_path("hyprctl");
-    if (hyprctl) {
-        char *cmd = g_strdup_printf("%s reload", hyprctl);
-        GError *err = NULL;
-        gchar *outbuf = NULL;
-        gchar *errbuf = NULL;
-        gint exit_status = 0;
-        gboolean ok = g_spawn_command_line_sync(cmd, &outbuf, &errbuf, &exit_status, &err);
-        if (ok && outbuf && *outbuf) {
-            GtkWindow *parent = GTK_WINDOW(gtk_widget_get_ancestor(GTK_WIDGET(btn), GTK_TYPE_WINDOW));
-            GtkWindow *dialog = create_modal_window(parent, "hyprctl output");
-            GtkWidget *v = gtk_box_new(GTK_ORIENTATION_VERTICAL, 6);
-            gtk_window_set_child(dialog, v);
-            GtkWidget *lab = gtk_label_new(outbuf);
-            gtk_label_set_selectable(GTK_LABEL(lab), TRUE);
-            gtk_box_append(GTK_BOX(v), lab);
-            GtkWidget *b = gtk_button_new_with_label("OK");
-            g_signal_connect_swapped(b, "clicked", G_CALLBACK(gtk_window_destroy), dialog);
-            gtk_box_append(GTK_BOX(v), b);
-            gtk_window_present(dialog);
+    GArray *nl = doc_split(content, len);
+    guint n_new = nl->len;
+    guint n_old = pd->lines ? pd->lines->len : 0;
+
+    guint pre = 0;
+    while (pre < n_old && pre < n_new && same_line(pd, pre, content, &g_array_index(nl, DocLine, pre))) pre++;
+    guint suf = 0;
+    while (suf < n_old - pre && suf < n_new - pre &&
+           same_line(pd, n_old - 1 - suf, content, &g_array_index(nl, DocLine, n_new - 1 - suf))) suf++;
+
+    if (pre == n_old && pre == n_new) {
+        g_array_unref(nl);
+        g_free(content);
+        return;
+    }
+
+    guint old_end = n_old - suf;
+    guint new_end = n_new - suf;
+    gint delta = (gint)n_new - (gint)n_old;
+    edit_history_set_enabled(pd->history, FALSE);
+
+    /* without local edits the rows follow file order, so the rows of the
+     * changed lines form one contiguous run [first, last) */
+    guint n_rows = g_list_model_get_n_items(G_LIST_MODEL(pd->rows));
+    guint first = 0;
+    while (first < n_rows && get_row(pd, first)->line >= 0 && (guint)get_row(pd, first)->line < pre) first++;
+    guint last = first;
+    while (last < n_rows && (get_row(pd, last)->line < 0 || (guint)get_row(pd, last)->line < old_end)) last++;
+    for (guint i = last; i < n_rows; i++) get_row(pd, i)->line += delta;
+
+    GPtrArray *added = g_ptr_array_new_with_free_func(g_object_unref);
+    for (guint i = pre; i < new_end; i++) {
+        DocLine *dl = &g_array_index(nl, DocLine, i);
+        if (line_is_bind(content + dl->start, dl->len)) {
+            g_ptr_array_add(added, bind_row_new(content + dl->start, (gssize)dl->len, (int)i));
         }
-        g_free(cmd);
-        g_free(hyprctl);
-        g_free(outbuf);
-        g_free(errbuf);
-        if (err) g_clear_error(&err);
     }
+    g_array_unref(nl);
+    g_hash_table_remove_all(pd->index);
+    g_list_store_splice(pd->rows, first, last - first, added->pdata, added->len);
+    g_ptr_array_free(added, TRUE);
+
+    /* a changed submap or variable line can move binds outside the range */
+    load_doc(pd, content, len);
+    reindex_all(pd);
+
+    pd->dirty = FALSE;
+    /* row positions in the history no longer describe these rows */
+    edit_history_clear(pd->history);
+    edit_history_set_enabled(pd->history, TRUE);
+    update_undo_buttons(pd);
+    set_status(pd->status, "Reloaded %u changed line(s) of %s from disk", new_end - pre, pd->path);
+}
+
+/* Loading: binds.conf and the variables of hyprland.conf (with everything
+ * it sources) are read on a worker thread */
+
+typedef struct {
+    char *content;         /* NULL when binds.conf could not be read */
+    gsize len;
+    FileStamp stamp;
+    GHashTable *conf_vars;
+} BindsDoc;
+
+static void binds_doc_free(BindsDoc *doc)
+{
+    if (!doc) return;
+    g_free(doc->content);
+    if (doc->conf_vars) g_hash_table_destroy(doc->conf_vars);
+    g_free(doc);
+}
+
+static void load_binds_thread(GTask *task, gpointer source, gpointer task_data, GCancellable *cancellable)
+{
+    const char *path = task_data;
+    BindsDoc *doc = g_new0(BindsDoc, 1);
+    file_stamp_take(path, &doc->stamp);
+    if (!g_file_get_contents(path, &doc->content, &doc->len, NULL)) doc->content = NULL;
+    char *conf = g_build_filename(g_get_home_dir(), ".config", "hypr", "hyprland.conf", NULL);
+    doc->conf_vars = hypr_bind_vars_load(conf);
+    g_free(conf);
+    g_task_return_pointer(task, doc, (GDestroyNotify)binds_doc_free);
+}
+
+static void on_binds_loaded(GObject *source, GAsyncResult *res, gpointer user_data)
+{
+    BindsPageData *pd = user_data;
+    BindsDoc *doc = g_task_propagate_pointer(G_TASK(res), NULL);
+    if (!doc) return; /* superseded by a newer read */
+
+    if (pd->conf_vars) g_hash_table_destroy(pd->conf_vars);
+    pd->conf_vars = g_steal_pointer(&doc->conf_vars);
+    char *content = g_steal_pointer(&doc->content);
+    if (!pd->loaded) {
+        pd->loaded = TRUE;
+        pd->stamp = doc->stamp;
+        load_binds_text(pd, content, doc->len);
+        update_undo_buttons(pd);
+    } else if (pd->dirty) {
+        /* edited while the read was in flight */
+        g_free(content);
+        set_status(pd->status, "%s changed on disk while you have unsaved edits; Save will ask before overwriting", pd->path);
+    } else {
+        merge_binds_file(pd, content, doc->len);
+        pd->stamp = doc->stamp;
+    }
+    binds_doc_free(doc);
+}
+
+static void binds_start_load(BindsPageData *pd)
+{
+    if (pd->load_cancel) {
+        g_cancellable_cancel(pd->load_cancel);
+        g_object_unref(pd->load_cancel);
+    }
+    pd->load_cancel = g_cancellable_new();
+    GTask *task = g_task_new(NULL, pd->load_cancel, on_binds_loaded, pd);
+    g_task_set_task_data(task, g_strdup(pd->path), g_free);
+    g_task_run_in_thread(task, load_binds_thread);
+    g_object_unref(task);
+}
+
+static void on_binds_file_changed(const char *path, gpointer user_data)
+{
+    BindsPageData *pd = user_data;
+    FileStamp now;
+    file_stamp_take(pd->path, &now);
+    if (file_stamp_equal(&now, &pd->stamp)) return; /* our own save */
+
+    if (pd->dirty) {
+        set_status(pd->status, "%s changed on disk while you have unsaved edits; Save will ask before overwriting", pd->path);
+        return;
+    }
+    binds_start_load(pd);
 }
 
 GtkWidget *create_binds_page(GtkLabel *status_label)
@@ -326,18 +1092,50 @@ GtkWidget *create_binds_page(GtkLabel *status_label)
     gtk_widget_set_hexpand(scroller, TRUE);
     gtk_box_append(GTK_BOX(vbox), scroller);
 
-    GtkWidget *container = gtk_box_new(GTK_ORIENTATION_VERTICAL, 6);
-    gtk_widget_set_margin_top(container, 6);
-    gtk_widget_set_margin_bottom(container, 6);
-    gtk_widget_set_hexpand(container, TRUE);
-    gtk_scrolled_window_set_child(GTK_SCROLLED_WINDOW(scroller), container);
-
     BindsPageData *pd = g_new0(BindsPageData, 1);
-    pd->container = container;
+    pd->rows = g_list_store_new(BIND_TYPE_ROW);
+    pd->index = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, (GDestroyNotify)g_ptr_array_unref);
+    pd->filter = gtk_custom_filter_new(filter_row, pd, NULL);
+    pd->shown = gtk_filter_list_model_new(G_LIST_MODEL(g_object_ref(pd->rows)), GTK_FILTER(g_object_ref(pd->filter)));
+    GtkListItemFactory *f = gtk_signal_list_item_factory_new();
+    g_signal_connect(f, "setup", G_CALLBACK(row_setup), pd);
+    g_signal_connect(f, "bind", G_CALLBACK(row_bind), pd);
+    g_signal_connect(f, "unbind", G_CALLBACK(row_unbind), pd);
+    pd->list = gtk_list_view_new(GTK_SELECTION_MODEL(gtk_no_selection_new(G_LIST_MODEL(pd->shown))), f);
+    gtk_widget_set_margin_top(pd->list, 6);
+    gtk_widget_set_margin_bottom(pd->list, 6);
+    gtk_scrolled_window_set_child(GTK_SCROLLED_WINDOW(scroller), pd->list);
+
+    GtkWidget *search = gtk_search_entry_new();
+    gtk_search_entry_set_placeholder_text(GTK_SEARCH_ENTRY(search), "Filter by key, modifier or dispatcher");
+    g_signal_connect(search, "search-changed", G_CALLBACK(on_filter_changed), pd);
+    gtk_box_insert_child_after(GTK_BOX(vbox), search, desc);
+
     pd->status = GTK_LABEL(status_label);
     pd->path = g_build_filename(g_get_home_dir(), ".config", "hypr", "binds.conf", NULL);
+    pd->history = edit_history_new(binds_history_apply, pd, FALSE);
+
+    /* page-wide Ctrl+Z / Ctrl+Shift+Z; a focused entry handles its own first */
+    GtkEventController *keys = gtk_shortcut_controller_new();
+    GtkShortcut *sc = gtk_shortcut_new(gtk_shortcut_trigger_parse_string("<Control>z"),
+                                       gtk_callback_action_new(on_binds_undo_shortcut, pd, NULL));
+    gtk_shortcut_set_arguments(sc, g_variant_new_boolean(FALSE));
+    gtk_shortcut_controller_add_shortcut(GTK_SHORTCUT_CONTROLLER(keys), sc);
+    sc = gtk_shortcut_new(gtk_alternative_trigger_new(gtk_shortcut_trigger_parse_string("<Control><Shift>z"),
+                                                      gtk_shortcut_trigger_parse_string("<Control>y")),
+                          gtk_callback_action_new(on_binds_undo_shortcut, pd, NULL));
+    gtk_shortcut_set_arguments(sc, g_variant_new_boolean(TRUE));
+    gtk_shortcut_controller_add_shortcut(GTK_SHORTCUT_CONTROLLER(keys), sc);
+    gtk_widget_add_controller(vbox, keys);
 
     GtkWidget *h = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 8);
+    pd->undo_btn = gtk_button_new_with_label("Undo");
+    g_signal_connect(pd->undo_btn, "clicked", G_CALLBACK(on_binds_undo_clicked), pd);
+    gtk_box_append(GTK_BOX(h), pd->undo_btn);
+    pd->redo_btn = gtk_button_new_with_label("Redo");
+    g_signal_connect(pd->redo_btn, "clicked", G_CALLBACK(on_binds_redo_clicked), pd);
+    gtk_box_append(GTK_BOX(h), pd->redo_btn);
+
     GtkWidget *btn_add = gtk_button_new_with_label("Add bind");
     g_signal_connect(btn_add, "clicked", G_CALLBACK(on_add_bind_clicked), pd);
     gtk_box_append(GTK_BOX(h), btn_add);
@@ -353,7 +1151,10 @@ GtkWidget *create_binds_page(GtkLabel *status_label)
     gtk_widget_set_halign(h, GTK_ALIGN_END);
     gtk_box_append(GTK_BOX(vbox), h);
 
-    load_binds_file(pd);
+    update_undo_buttons(pd);
+    set_status(pd->status, "Loading %s…", pd->path);
+    binds_start_load(pd);
+    pd->watch = hypr_watch_new(pd->path, FALSE, on_binds_file_changed, pd);
 
     return vbox;
 }
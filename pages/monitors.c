@@ -0,0 +1,973 @@
+/* monitors.c - monitor layout page driven by Hyprland's IPC monitors JSON */
+#include "../common.h"
+#include "../hypr.h"
+#include "../hypripc.h"
+#include "../hyprconf.h"
+#include <gtk/gtk.h>
+#include <pango/pangocairo.h>
+#include <json-glib/json-glib.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+/* Seconds before an applied layout is rolled back unless kept */
+#define MONITOR_REVERT_SECS 15
+/* Snap distance for dragged edges, in preview pixels */
+#define MONITOR_SNAP_PX     10
+#define MONITOR_PREVIEW_PAD 16
+
+static const char *transform_names[] = {
+    "Normal", "90°", "180°", "270°", "Flipped", "Flipped 90°", "Flipped 180°", "Flipped 270°", NULL
+};
+
+typedef struct {
+    char *name;
+    char *description;
+    char **modes;          /* "WxH@R" (Hz suffix dropped), as keyword monitor takes it */
+    /* state reported by Hyprland; Revert goes back to this */
+    char *cur_mode;
+    int x, y;
+    double scale;
+    int transform;
+    gboolean disabled;
+    /* pending edit */
+    char *mode;
+    double px, py;
+    double new_scale;
+    int new_transform;
+    gboolean new_disabled;
+} MonitorInfo;
+
+typedef struct {
+    GtkLabel *status;
+    GtkWidget *area;
+    GtkWidget *mon_dd;
+    GtkWidget *mode_dd;
+    GtkWidget *scale_spin;
+    GtkWidget *transform_dd;
+    GtkWidget *x_spin;
+    GtkWidget *y_spin;
+    GtkWidget *enabled_btn;
+    GtkWidget *apply_btn;
+    GtkWidget *save_btn;
+    GtkWidget *confirm_bar;
+    GtkWidget *confirm_label;
+    GPtrArray *mons;       /* MonitorInfo* */
+    int selected;
+    gboolean updating;     /* editors are being filled from code */
+    /* preview mapping: screen = (layout - origin) * view_scale + pad */
+    double view_scale, origin_x, origin_y;
+    gboolean dragging;
+    double drag_x0, drag_y0;
+    char *revert_batch;
+    guint revert_id;
+    int revert_left;
+    char *root;            /* hyprland.conf */
+} MonitorsPageData;
+
+static void monitor_free(gpointer p)
+{
+    MonitorInfo *m = p;
+    g_free(m->name);
+    g_free(m->description);
+    g_strfreev(m->modes);
+    g_free(m->cur_mode);
+    g_free(m->mode);
+    g_free(m);
+}
+
+/* Size in layout coordinates: mode size divided by scale, swapped when the
+ * output is rotated by 90/270 degrees */
+static void monitor_layout_size(const MonitorInfo *m, double *w, double *h)
+{
+    int mw = 0, mh = 0;
+    if (!m->mode || sscanf(m->mode, "%dx%d", &mw, &mh) != 2) mw = 1920, mh = 1080;
+    double s = m->new_scale > 0 ? m->new_scale : 1.0;
+    *w = mw / s;
+    *h = mh / s;
+    if (m->new_transform % 2 == 1) {
+        double t = *w;
+        *w = *h;
+        *h = t;
+    }
+}
+
+static char *format_scale(double scale)
+{
+    char buf[G_ASCII_DTOSTR_BUF_SIZE];
+    g_ascii_formatd(buf, sizeof(buf), "%.2f", scale);
+    return g_strdup(buf);
+}
+
+/* Everything after the name field of a monitor rule */
+static char *monitor_rule_tail(const MonitorInfo *m, gboolean pending)
+{
+    if (pending ? m->new_disabled : m->disabled) return g_strdup("disable");
+    char *scale = format_scale(pending ? m->new_scale : m->scale);
+    int t = pending ? m->new_transform : m->transform;
+    char transform[16] = "";
+    if (t) g_snprintf(transform, sizeof(transform), ",transform,%d", t);
+    char *tail = g_strdup_printf("%s,%dx%d,%s%s", pending ? m->mode : m->cur_mode,
+                                 pending ? (int)lround(m->px) : m->x,
+                                 pending ? (int)lround(m->py) : m->y, scale, transform);
+    g_free(scale);
+    return tail;
+}
+
+static gboolean monitor_is_changed(const MonitorInfo *m)
+{
+    char *a = monitor_rule_tail(m, FALSE);
+    char *b = monitor_rule_tail(m, TRUE);
+    gboolean changed = g_strcmp0(a, b) != 0;
+    g_free(a);
+    g_free(b);
+    return changed;
+}
+
+static GPtrArray *parse_monitors(const char *json, GError **error)
+{
+    JsonParser *parser = json_parser_new();
+    if (!json_parser_load_from_data(parser, json, -1, error)) {
+        g_object_unref(parser);
+        return NULL;
+    }
+    JsonNode *root = json_parser_get_root(parser);
+    if (!JSON_NODE_HOLDS_ARRAY(root)) {
+        g_set_error(error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA, "Unexpected monitors reply");
+        g_object_unref(parser);
+        return NULL;
+    }
+
+    GPtrArray *mons = g_ptr_array_new_with_free_func(monitor_free);
+    JsonArray *arr = json_node_get_array(root);
+    for (guint i = 0; i < json_array_get_length(arr); i++) {
+        JsonObject *o = json_array_get_object_element(arr, i);
+        if (!o) continue;
+        MonitorInfo *m = g_new0(MonitorInfo, 1);
+        m->name = g_strdup(json_object_get_string_member_with_default(o, "name", ""));
+        m->description = g_strdup(json_object_get_string_member_with_default(o, "description", ""));
+        int w = (int)json_object_get_int_member_with_default(o, "width", 0);
+        int h = (int)json_object_get_int_member_with_default(o, "height", 0);
+        double rate = json_object_get_double_member_with_default(o, "refreshRate", 60.0);
+        char rbuf[G_ASCII_DTOSTR_BUF_SIZE];
+        g_ascii_formatd(rbuf, sizeof(rbuf), "%.2f", rate);
+        m->cur_mode = g_strdup_printf("%dx%d@%s", w, h, rbuf);
+        m->x = (int)json_object_get_int_member_with_default(o, "x", 0);
+        m->y = (int)json_object_get_int_member_with_default(o, "y", 0);
+        m->scale = json_object_get_double_member_with_default(o, "scale", 1.0);
+        m->transform = (int)json_object_get_int_member_with_default(o, "transform", 0) & 7;
+        m->disabled = json_object_get_boolean_member_with_default(o, "disabled", FALSE);
+
+        GStrvBuilder *sb = g_strv_builder_new();
+        gboolean have_cur = FALSE;
+        JsonArray *modes = json_object_has_member(o, "availableModes") ? json_object_get_array_member(o, "availableModes") : NULL;
+        for (guint k = 0; modes && k < json_array_get_length(modes); k++) {
+            const char *s = json_array_get_string_element(modes, k);
+            if (!s) continue;
+            char *mode = g_strdup(s);
+            if (g_str_has_suffix(mode, "Hz")) mode[strlen(mode) - 2] = '\0';
+            if (g_strcmp0(mode, m->cur_mode) == 0) have_cur = TRUE;
+            g_strv_builder_add(sb, mode);
+            g_free(mode);
+        }
+        if (!have_cur) g_strv_builder_add(sb, m->cur_mode);
+        m->modes = g_strv_builder_end(sb);
+        g_strv_builder_unref(sb);
+
+        m->mode = g_strdup(m->cur_mode);
+        m->px = m->x;
+        m->py = m->y;
+        m->new_scale = m->scale;
+        m->new_transform = m->transform;
+        m->new_disabled = m->disabled;
+        g_ptr_array_add(mons, m);
+    }
+    g_object_unref(parser);
+    return mons;
+}
+
+static MonitorInfo *selected_monitor(MonitorsPageData *pd)
+{
+    if (!pd->mons || pd->selected < 0 || (guint)pd->selected >= pd->mons->len) return NULL;
+    return g_ptr_array_index(pd->mons, pd->selected);
+}
+
+static void update_buttons(MonitorsPageData *pd)
+{
+    gboolean changed = FALSE;
+    for (guint i = 0; pd->mons && i < pd->mons->len; i++) changed |= monitor_is_changed(g_ptr_array_index(pd->mons, i));
+    gboolean confirming = pd->revert_id != 0;
+    gtk_widget_set_sensitive(pd->apply_btn, changed && !confirming);
+    gtk_widget_set_sensitive(pd->save_btn, pd->mons && pd->mons->len > 0 && !confirming);
+}
+
+/* Fit all enabled monitors into the preview; not recomputed mid-drag so the
+ * view does not shift under the pointer */
+static void compute_view(MonitorsPageData *pd, int width, int height)
+{
+    double minx = G_MAXDOUBLE, miny = G_MAXDOUBLE, maxx = -G_MAXDOUBLE, maxy = -G_MAXDOUBLE;
+    for (guint i = 0; pd->mons && i < pd->mons->len; i++) {
+        MonitorInfo *m = g_ptr_array_index(pd->mons, i);
+        if (m->new_disabled) continue;
+        double w, h;
+        monitor_layout_size(m, &w, &h);
+        minx = MIN(minx, m->px);
+        miny = MIN(miny, m->py);
+        maxx = MAX(maxx, m->px + w);
+        maxy = MAX(maxy, m->py + h);
+    }
+    if (minx > maxx) {
+        pd->view_scale = 0.1;
+        pd->origin_x = pd->origin_y = 0;
+        return;
+    }
+    double avail_w = MAX(1, width - 2 * MONITOR_PREVIEW_PAD);
+    double avail_h = MAX(1, height - 2 * MONITOR_PREVIEW_PAD);
+    pd->view_scale = MIN(avail_w / (maxx - minx), avail_h / (maxy - miny));
+    pd->origin_x = minx - (avail_w / pd->view_scale - (maxx - minx)) / 2;
+    pd->origin_y = miny - (avail_h / pd->view_scale - (maxy - miny)) / 2;
+}
+
+static void draw_layout(GtkDrawingArea *area, cairo_t *cr, int width, int height, gpointer user_data)
+{
+    MonitorsPageData *pd = user_data;
+    if (!pd->dragging) compute_view(pd, width, height);
+
+    GdkRGBA fg;
+    gtk_widget_get_color(GTK_WIDGET(area), &fg);
+    PangoLayout *layout = gtk_widget_create_pango_layout(GTK_WIDGET(area), NULL);
+
+    for (guint i = 0; pd->mons && i < pd->mons->len; i++) {
+        MonitorInfo *m = g_ptr_array_index(pd->mons, i);
+        if (m->new_disabled) continue;
+        double w, h;
+        monitor_layout_size(m, &w, &h);
+        double sx = (m->px - pd->origin_x) * pd->view_scale + MONITOR_PREVIEW_PAD;
+        double sy = (m->py - pd->origin_y) * pd->view_scale + MONITOR_PREVIEW_PAD;
+        double sw = w * pd->view_scale, sh = h * pd->view_scale;
+
+        if ((int)i == pd->selected) cairo_set_source_rgba(cr, 0.21, 0.52, 0.89, 0.55);
+        else cairo_set_source_rgba(cr, fg.red, fg.green, fg.blue, 0.15);
+        cairo_rectangle(cr, sx + 1, sy + 1, sw - 2, sh - 2);
+        cairo_fill_preserve(cr);
+        gdk_cairo_set_source_rgba(cr, &fg);
+        cairo_set_line_width(cr, 1.0);
+        cairo_stroke(cr);
+
+        char *text = g_strdup_printf("%s\n%d,%d", m->name, (int)lround(m->px), (int)lround(m->py));
+        pango_layout_set_text(layout, text, -1);
+        g_free(text);
+        int tw = 0, th = 0;
+        pango_layout_get_pixel_size(layout, &tw, &th);
+        cairo_move_to(cr, sx + (sw - tw) / 2, sy + (sh - th) / 2);
+        pango_cairo_show_layout(cr, layout);
+    }
+    g_object_unref(layout);
+}
+
+static int hit_test(MonitorsPageData *pd, double x, double y)
+{
+    for (guint i = pd->mons ? pd->mons->len : 0; i-- > 0;) {
+        MonitorInfo *m = g_ptr_array_index(pd->mons, i);
+        if (m->new_disabled) continue;
+        double w, h;
+        monitor_layout_size(m, &w, &h);
+        double sx = (m->px - pd->origin_x) * pd->view_scale + MONITOR_PREVIEW_PAD;
+        double sy = (m->py - pd->origin_y) * pd->view_scale + MONITOR_PREVIEW_PAD;
+        if (x >= sx && y >= sy && x < sx + w * pd->view_scale && y < sy + h * pd->view_scale) return (int)i;
+    }
+    return -1;
+}
+
+static void fill_editors(MonitorsPageData *pd)
+{
+    MonitorInfo *m = selected_monitor(pd);
+    pd->updating = TRUE;
+    gtk_widget_set_sensitive(pd->mode_dd, m != NULL);
+    gtk_widget_set_sensitive(pd->scale_spin, m != NULL);
+    gtk_widget_set_sensitive(pd->transform_dd, m != NULL);
+    gtk_widget_set_sensitive(pd->x_spin, m != NULL);
+    gtk_widget_set_sensitive(pd->y_spin, m != NULL);
+    gtk_widget_set_sensitive(pd->enabled_btn, m != NULL);
+    if (m) {
+        gtk_drop_down_set_selected(GTK_DROP_DOWN(pd->mon_dd), (guint)pd->selected);
+        GtkStringList *modes = gtk_string_list_new((const char * const *)m->modes);
+        gtk_drop_down_set_model(GTK_DROP_DOWN(pd->mode_dd), G_LIST_MODEL(modes));
+        g_object_unref(modes);
+        guint sel = 0;
+        for (guint i = 0; m->modes[i]; i++) if (g_strcmp0(m->modes[i], m->mode) == 0) sel = i;
+        gtk_drop_down_set_selected(GTK_DROP_DOWN(pd->mode_dd), sel);
+        gtk_spin_button_set_value(GTK_SPIN_BUTTON(pd->scale_spin), m->new_scale);
+        gtk_drop_down_set_selected(GTK_DROP_DOWN(pd->transform_dd), (guint)m->new_transform);
+        gtk_spin_button_set_value(GTK_SPIN_BUTTON(pd->x_spin), lround(m->px));
+        gtk_spin_button_set_value(GTK_SPIN_BUTTON(pd->y_spin), lround(m->py));
+        gtk_check_button_set_active(GTK_CHECK_BUTTON(pd->enabled_btn), !m->new_disabled);
+    }
+    pd->updating = FALSE;
+}
+
+static void on_monitor_edited(MonitorsPageData *pd)
+{
+    gtk_widget_queue_draw(pd->area);
+    update_buttons(pd);
+}
+
+static void on_mon_selected(GObject *dd, GParamSpec *pspec, gpointer user_data)
+{
+    MonitorsPageData *pd = user_data;
+    if (pd->updating) return;
+    guint sel = gtk_drop_down_get_selected(GTK_DROP_DOWN(dd));
+    if (sel == GTK_INVALID_LIST_POSITION) return;
+    pd->selected = (int)sel;
+    fill_editors(pd);
+    gtk_widget_queue_draw(pd->area);
+}
+
+static void on_mode_selected(GObject *dd, GParamSpec *pspec, gpointer user_data)
+{
+    MonitorsPageData *pd = user_data;
+    MonitorInfo *m = selected_monitor(pd);
+    if (pd->updating || !m) return;
+    guint sel = gtk_drop_down_get_selected(GTK_DROP_DOWN(dd));
+    if (sel == GTK_INVALID_LIST_POSITION || sel >= g_strv_length(m->modes)) return;
+    g_free(m->mode);
+    m->mode = g_strdup(m->modes[sel]);
+    on_monitor_edited(pd);
+}
+
+static void on_transform_selected(GObject *dd, GParamSpec *pspec, gpointer user_data)
+{
+    MonitorsPageData *pd = user_data;
+    MonitorInfo *m = selected_monitor(pd);
+    if (pd->updating || !m) return;
+    guint sel = gtk_drop_down_get_selected(GTK_DROP_DOWN(dd));
+    if (sel == GTK_INVALID_LIST_POSITION) return;
+    m->new_transform = (int)sel;
+    on_monitor_edited(pd);
+}
+
+static void on_spin_changed(GtkSpinButton *spin, gpointer user_data)
+{
+    MonitorsPageData *pd = user_data;
+    MonitorInfo *m = selected_monitor(pd);
+    if (pd->updating || !m) return;
+    double v = gtk_spin_button_get_value(spin);
+    if (GTK_WIDGET(spin) == pd->scale_spin) m->new_scale = v;
+    else if (GTK_WIDGET(spin) == pd->x_spin) m->px = v;
+    else m->py = v;
+    on_monitor_edited(pd);
+}
+
+static void on_enabled_toggled(GtkCheckButton *btn, gpointer user_data)
+{
+    MonitorsPageData *pd = user_data;
+    MonitorInfo *m = selected_monitor(pd);
+    if (pd->updating || !m) return;
+    m->new_disabled = !gtk_check_button_get_active(btn);
+    on_monitor_edited(pd);
+}
+
+static void on_drag_begin(GtkGestureDrag *g, double x, double y, gpointer user_data)
+{
+    MonitorsPageData *pd = user_data;
+    int hit = hit_test(pd, x, y);
+    if (hit < 0) {
+        gtk_gesture_set_state(GTK_GESTURE(g), GTK_EVENT_SEQUENCE_DENIED);
+        return;
+    }
+    pd->selected = hit;
+    MonitorInfo *m = selected_monitor(pd);
+    pd->drag_x0 = m->px;
+    pd->drag_y0 = m->py;
+    pd->dragging = TRUE;
+    fill_editors(pd);
+    gtk_widget_queue_draw(pd->area);
+}
+
+/* Pull `*v` (an edge-aligned position) to the nearest candidate in range */
+static void snap_axis(double *v, const double *cands, int n, double range)
+{
+    double best = range;
+    double out = *v;
+    for (int i = 0; i < n; i++) {
+        double d = fabs(cands[i] - *v);
+        if (d < best) {
+            best = d;
+            out = cands[i];
+        }
+    }
+    *v = out;
+}
+
+static void on_drag_update(GtkGestureDrag *g, double dx, double dy, gpointer user_data)
+{
+    MonitorsPageData *pd = user_data;
+    MonitorInfo *m = selected_monitor(pd);
+    if (!pd->dragging || !m) return;
+
+    double w, h;
+    monitor_layout_size(m, &w, &h);
+    double nx = pd->drag_x0 + dx / pd->view_scale;
+    double ny = pd->drag_y0 + dy / pd->view_scale;
+
+    /* snap our edges to the other monitors' edges */
+    GArray *cx = g_array_new(FALSE, FALSE, sizeof(double));
+    GArray *cy = g_array_new(FALSE, FALSE, sizeof(double));
+    for (guint i = 0; i < pd->mons->len; i++) {
+        MonitorInfo *o = g_ptr_array_index(pd->mons, i);
+        if ((int)i == pd->selected || o->new_disabled) continue;
+        double ow, oh;
+        monitor_layout_size(o, &ow, &oh);
+        double xs[] = { o->px, o->px + ow, o->px - w, o->px + ow - w };
+        double ys[] = { o->py, o->py + oh, o->py - h, o->py + oh - h };
+        g_array_append_vals(cx, xs, 4);
+        g_array_append_vals(cy, ys, 4);
+    }
+    double range = MONITOR_SNAP_PX / pd->view_scale;
+    snap_axis(&nx, (double *)cx->data, (int)cx->len, range);
+    snap_axis(&ny, (double *)cy->data, (int)cy->len, range);
+    g_array_free(cx, TRUE);
+    g_array_free(cy, TRUE);
+
+    m->px = round(nx);
+    m->py = round(ny);
+    pd->updating = TRUE;
+    gtk_spin_button_set_value(GTK_SPIN_BUTTON(pd->x_spin), m->px);
+    gtk_spin_button_set_value(GTK_SPIN_BUTTON(pd->y_spin), m->py);
+    pd->updating = FALSE;
+    on_monitor_edited(pd);
+}
+
+static void on_drag_end(GtkGestureDrag *g, double dx, double dy, gpointer user_data)
+{
+    MonitorsPageData *pd = user_data;
+    pd->dragging = FALSE;
+    gtk_widget_queue_draw(pd->area);
+}
+
+static void set_monitors(MonitorsPageData *pd, GPtrArray *mons)
+{
+    if (pd->mons) g_ptr_array_unref(pd->mons);
+    pd->mons = mons;
+    if (pd->selected >= (int)mons->len) pd->selected = 0;
+    if (mons->len == 0) pd->selected = -1;
+    else if (pd->selected < 0) pd->selected = 0;
+
+    GStrvBuilder *sb = g_strv_builder_new();
+    for (guint i = 0; i < mons->len; i++) {
+        MonitorInfo *m = g_ptr_array_index(mons, i);
+        char *label = g_strdup_printf("%s — %s", m->name, m->description);
+        g_strv_builder_add(sb, label);
+        g_free(label);
+    }
+    char **names = g_strv_builder_end(sb);
+    g_strv_builder_unref(sb);
+    pd->updating = TRUE;
+    GtkStringList *model = gtk_string_list_new((const char * const *)names);
+    gtk_drop_down_set_model(GTK_DROP_DOWN(pd->mon_dd), G_LIST_MODEL(model));
+    g_object_unref(model);
+    pd->updating = FALSE;
+    g_strfreev(names);
+
+    fill_editors(pd);
+    update_buttons(pd);
+    gtk_widget_queue_draw(pd->area);
+}
+
+static void on_monitors_loaded(GObject *source, GAsyncResult *res, gpointer user_data)
+{
+    MonitorsPageData *pd = user_data;
+    GError *err = NULL;
+    gchar *reply = hypr_ipc_request_finish(res, &err);
+    GPtrArray *mons = reply ? parse_monitors(reply, &err) : NULL;
+    g_free(reply);
+    if (!mons) {
+        set_status(pd->status, "Could not read monitors from Hyprland: %s", err ? err->message : "unknown error");
+        g_clear_error(&err);
+        return;
+    }
+    set_monitors(pd, mons);
+}
+
+static void monitors_refresh(MonitorsPageData *pd)
+{
+    char *sock = hypr_ipc_socket_path(".socket.sock");
+    if (!sock) {
+        set_status(pd->status, "Hyprland is not running; monitor settings are unavailable");
+        return;
+    }
+    g_free(sock);
+    /* "all" includes disabled outputs so they can be turned back on */
+    hypr_ipc_request_async("j/monitors all", 3000, NULL, on_monitors_loaded, pd);
+}
+
+static void on_refresh_clicked(GtkButton *btn, gpointer user_data)
+{
+    monitors_refresh((MonitorsPageData *)user_data);
+}
+
+/* One IPC round trip for every output: applying monitors one at a time
+ * reflows the windows once per request. */
+static char *build_batch(MonitorsPageData *pd, gboolean pending)
+{
+    GString *b = g_string_new("[[BATCH]]");
+    gboolean any = FALSE;
+    for (guint i = 0; i < pd->mons->len; i++) {
+        MonitorInfo *m = g_ptr_array_index(pd->mons, i);
+        if (!monitor_is_changed(m)) continue;
+        char *tail = monitor_rule_tail(m, pending);
+        g_string_append_printf(b, "%skeyword monitor %s,%s", any ? ";" : "", m->name, tail);
+        g_free(tail);
+        any = TRUE;
+    }
+    if (!any) {
+        g_string_free(b, TRUE);
+        return NULL;
+    }
+    return g_string_free(b, FALSE);
+}
+
+static void confirm_finish(MonitorsPageData *pd)
+{
+    if (pd->revert_id) g_source_remove(pd->revert_id);
+    pd->revert_id = 0;
+    g_clear_pointer(&pd->revert_batch, g_free);
+    gtk_widget_set_visible(pd->confirm_bar, FALSE);
+    update_buttons(pd);
+}
+
+static void on_reverted(GObject *source, GAsyncResult *res, gpointer user_data)
+{
+    MonitorsPageData *pd = user_data;
+    GError *err = NULL;
+    gchar *reply = hypr_ipc_request_finish(res, &err);
+    if (!reply) set_status(pd->status, "Reverting the monitor layout failed: %s", err ? err->message : "unknown error");
+    else set_status(pd->status, "Monitor layout reverted");
+    g_free(reply);
+    g_clear_error(&err);
+    monitors_refresh(pd);
+}
+
+static void monitors_revert(MonitorsPageData *pd)
+{
+    char *batch = g_steal_pointer(&pd->revert_batch);
+    confirm_finish(pd);
+    if (batch) hypr_ipc_request_async(batch, 3000, NULL, on_reverted, pd);
+    g_free(batch);
+}
+
+static gboolean on_revert_tick(gpointer user_data)
+{
+    MonitorsPageData *pd = user_data;
+    if (--pd->revert_left <= 0) {
+        pd->revert_id = 0;
+        monitors_revert(pd);
+        return G_SOURCE_REMOVE;
+    }
+    char *text = g_strdup_printf("Keep this monitor layout? Reverting in %d s.", pd->revert_left);
+    gtk_label_set_text(GTK_LABEL(pd->confirm_label), text);
+    g_free(text);
+    return G_SOURCE_CONTINUE;
+}
+
+static void on_keep_clicked(GtkButton *btn, gpointer user_data)
+{
+    MonitorsPageData *pd = user_data;
+    confirm_finish(pd);
+    set_status(pd->status, "Monitor layout kept (use Save to make it permanent)");
+    monitors_refresh(pd);
+}
+
+static void on_revert_clicked(GtkButton *btn, gpointer user_data)
+{
+    monitors_revert((MonitorsPageData *)user_data);
+}
+
+static void on_applied(GObject *source, GAsyncResult *res, gpointer user_data)
+{
+    MonitorsPageData *pd = user_data;
+    GError *err = NULL;
+    gchar *reply = hypr_ipc_request_finish(res, &err);
+    if (!reply) {
+        set_status(pd->status, "Applying the monitor layout failed: %s", err ? err->message : "unknown error");
+        g_clear_error(&err);
+        g_clear_pointer(&pd->revert_batch, g_free);
+        update_buttons(pd);
+        return;
+    }
+    /* a batch answers "ok" per command; anything else is an error text */
+    char *rest = g_strdup(reply);
+    char *p = rest;
+    while (g_str_has_prefix(p, "ok")) {
+        p += 2;
+        while (*p && g_ascii_isspace(*p)) p++;
+    }
+    if (*p) set_status(pd->status, "Hyprland reported: %s", g_strstrip(p));
+    g_free(rest);
+    g_free(reply);
+
+    pd->revert_left = MONITOR_REVERT_SECS + 1;
+    on_revert_tick(pd);
+    pd->revert_id = g_timeout_add_seconds(1, on_revert_tick, pd);
+    gtk_widget_set_visible(pd->confirm_bar, TRUE);
+    update_buttons(pd);
+}
+
+static void on_apply_clicked(GtkButton *btn, gpointer user_data)
+{
+    MonitorsPageData *pd = user_data;
+    if (!pd->mons || pd->revert_id) return;
+    char *batch = build_batch(pd, TRUE);
+    if (!batch) return;
+    if (g_dry_run) {
+        set_status(pd->status, "Dry run: would send %s", batch);
+        g_free(batch);
+        return;
+    }
+    g_free(pd->revert_batch);
+    pd->revert_batch = build_batch(pd, FALSE);
+    gtk_widget_set_sensitive(pd->apply_btn, FALSE);
+    hypr_ipc_request_async(batch, 3000, NULL, on_applied, pd);
+    g_free(batch);
+}
+
+/* Persisting: each output's rule replaces the value of the last top-level
+ * `monitor =` line naming it (by name or desc: prefix) anywhere in the
+ * include graph, keeping indentation and trailing comments; outputs without
+ * a rule get a new line after the root file's last monitor line. */
+typedef struct {
+    char *name;
+    char *description;
+    char *tail;
+    gint file, line;       /* last matching rule, -1 when none */
+    gsize val_off, val_len, field_len;
+} RuleEdit;
+
+typedef struct {
+    char *root;
+    GPtrArray *edits;      /* RuleEdit* */
+} SaveJob;
+
+static void rule_edit_free(gpointer p)
+{
+    RuleEdit *e = p;
+    g_free(e->name);
+    g_free(e->description);
+    g_free(e->tail);
+    g_free(e);
+}
+
+static void save_job_free(gpointer p)
+{
+    SaveJob *job = p;
+    g_free(job->root);
+    g_ptr_array_unref(job->edits);
+    g_free(job);
+}
+
+static gboolean rule_names_monitor(const RuleEdit *e, const char *field, gsize len)
+{
+    if (len > 5 && strncmp(field, "desc:", 5) == 0) {
+        char *want = g_strstrip(g_strndup(field + 5, len - 5));
+        gboolean ok = *want && g_str_has_prefix(e->description, want);
+        g_free(want);
+        return ok;
+    }
+    return strlen(e->name) == len && strncmp(e->name, field, len) == 0;
+}
+
+/* New value for an existing rule: the name field, then `tail` in place of
+ * mode, position and scale. Later key/value pairs (vrr, bitdepth, mirror,
+ * cm, ...) are kept; transform takes the page's value, or is dropped when
+ * that is 0. A disabled output or a rule of another form is replaced. */
+static char *merge_rule_value(const char *value, gsize len, gsize field_len, const char *tail)
+{
+    char *rest = g_strndup(value + field_len, len - field_len);
+    char **have = g_strsplit(rest, ",", -1);  /* have[0] is what precedes the first comma */
+    char **want = g_strsplit(tail, ",", -1);
+    GString *out = g_string_new_len(value, field_len);
+    guint nhave = g_strv_length(have), nwant = g_strv_length(want);
+    const char *transform = nwant >= 5 ? want[4] : NULL;
+    gboolean keep = nwant >= 3 && nhave >= 4;
+    if (keep) {
+        char *mode = g_strstrip(g_strdup(have[1]));
+        keep = strcmp(mode, "disable") != 0 && strcmp(mode, "addreserved") != 0;
+        g_free(mode);
+    }
+
+    if (nwant >= 3) g_string_append_printf(out, ",%s,%s,%s", want[0], want[1], want[2]);
+    else g_string_append_printf(out, ",%s", tail);
+    gboolean have_transform = FALSE;
+    for (guint i = 4; keep && i < nhave; i += 2) {
+        char *key = g_strstrip(g_strdup(have[i]));
+        if (strcmp(key, "transform") == 0) {
+            if (transform) g_string_append_printf(out, ",%s,%s", have[i], transform);
+            have_transform = TRUE;
+        } else {
+            g_string_append_printf(out, ",%s", have[i]);
+            if (i + 1 < nhave) g_string_append_printf(out, ",%s", have[i + 1]);
+        }
+        g_free(key);
+    }
+    if (transform && !have_transform) g_string_append_printf(out, ",transform,%s", transform);
+
+    g_strfreev(have);
+    g_strfreev(want);
+    g_free(rest);
+    return g_string_free(out, FALSE);
+}
+
+static void save_rules_thread(GTask *task, gpointer source, gpointer task_data, GCancellable *cancellable)
+{
+    SaveJob *job = task_data;
+    GPtrArray *graph = hypr_conf_include_graph(job->root);
+    guint nf = graph->len;
+    gchar ***lines = g_new0(gchar **, nf);
+    FileStamp *stamps = g_new0(FileStamp, nf);
+    gboolean *dirty = g_new0(gboolean, nf);
+    gint root_last_rule = -1;
+
+    for (guint f = 0; f < nf; f++) {
+        const char *path = g_ptr_array_index(graph, f);
+        file_stamp_take(path, &stamps[f]);
+        gchar *content = NULL;
+        if (!g_file_get_contents(path, &content, NULL, NULL)) content = g_strdup("");
+        lines[f] = g_strsplit(content, "\n", -1);
+        g_free(content);
+
+        int depth = 0;
+        for (gint l = 0; lines[f][l]; l++) {
+            HyprLine hl;
+            hypr_conf_scan_line(lines[f][l], -1, &hl);
+            if (depth == 0 && hl.kind == HYPR_LINE_ASSIGN && hl.key_len == 7 && strncmp(hl.key, "monitor", 7) == 0) {
+                const char *comma = memchr(hl.value, ',', hl.value_len);
+                gsize flen = comma ? (gsize)(comma - hl.value) : hl.value_len;
+                while (flen > 0 && g_ascii_isspace(hl.value[flen - 1])) flen--;
+                for (guint e = 0; e < job->edits->len; e++) {
+                    RuleEdit *re = g_ptr_array_index(job->edits, e);
+                    if (!rule_names_monitor(re, hl.value, flen)) continue;
+                    re->file = (gint)f;
+                    re->line = l;
+                    re->val_off = (gsize)(hl.value - lines[f][l]);
+                    re->val_len = hl.value_len;
+                    re->field_len = flen;
+                }
+                if (f == 0) root_last_rule = l;
+            }
+            depth = MAX(0, depth + hl.opens - hl.closes);
+        }
+    }
+
+    for (guint e = 0; e < job->edits->len; e++) {
+        RuleEdit *re = g_ptr_array_index(job->edits, e);
+        if (re->file < 0) continue;
+        char *old = lines[re->file][re->line];
+        char *value = merge_rule_value(old + re->val_off, re->val_len, re->field_len, re->tail);
+        char *line = g_strdup_printf("%.*s%s%s", (int)re->val_off, old, value, old + re->val_off + re->val_len);
+        g_free(value);
+        if (g_strcmp0(line, old) != 0) {
+            lines[re->file][re->line] = line;
+            g_free(old);
+            dirty[re->file] = TRUE;
+        } else {
+            g_free(line);
+        }
+    }
+
+    /* outputs without a rule yet */
+    GPtrArray *added = g_ptr_array_new();
+    for (guint e = 0; e < job->edits->len; e++) {
+        RuleEdit *re = g_ptr_array_index(job->edits, e);
+        if (re->file < 0) g_ptr_array_add(added, g_strdup_printf("monitor = %s,%s", re->name, re->tail));
+    }
+    if (added->len > 0 && nf > 0) {
+        guint n = g_strv_length(lines[0]);
+        guint at = root_last_rule >= 0 ? (guint)root_last_rule + 1 : (n > 0 && *lines[0][n - 1] == '\0' ? n - 1 : n);
+        gchar **merged = g_new0(gchar *, n + added->len + 1);
+        guint k = 0;
+        for (guint l = 0; l < at; l++) merged[k++] = lines[0][l];
+        for (guint a = 0; a < added->len; a++) merged[k++] = g_ptr_array_index(added, a);
+        for (guint l = at; l < n; l++) merged[k++] = lines[0][l];
+        g_free(lines[0]);
+        lines[0] = merged;
+        dirty[0] = TRUE;
+    }
+    g_ptr_array_free(added, TRUE);
+
+    GArray *writes = g_array_new(FALSE, TRUE, sizeof(ConfigWrite));
+    GPtrArray *texts = g_ptr_array_new_with_free_func(g_free);
+    for (guint f = 0; f < nf; f++) {
+        if (!dirty[f]) continue;
+        char *text = g_strjoinv("\n", lines[f]);
+        g_ptr_array_add(texts, text);
+        ConfigWrite w = { g_ptr_array_index(graph, f), text, -1, &stamps[f] };
+        g_array_append_val(writes, w);
+    }
+
+    GError *err = NULL;
+    ConfigSaveResult r = writes->len > 0
+        ? save_config_files((ConfigWrite *)writes->data, writes->len, FALSE, &err)
+        : CONFIG_SAVE_UNCHANGED;
+    if (r == CONFIG_SAVE_FAILED || r == CONFIG_SAVE_CONFLICT) g_task_return_error(task, err);
+    else g_task_return_int(task, r);
+
+    g_array_free(writes, TRUE);
+    g_ptr_array_unref(texts);
+    for (guint f = 0; f < nf; f++) g_strfreev(lines[f]);
+    g_free(lines);
+    g_free(stamps);
+    g_free(dirty);
+    g_ptr_array_unref(graph);
+}
+
+static void on_rules_saved(GObject *source, GAsyncResult *res, gpointer user_data)
+{
+    MonitorsPageData *pd = user_data;
+    GError *err = NULL;
+    gssize r = g_task_propagate_int(G_TASK(res), &err);
+    gtk_widget_set_sensitive(pd->save_btn, TRUE);
+    if (err) {
+        char *msg = g_strdup_printf("Failed to save monitor rules:\n%s", err->message);
+        show_big_message_dialog("Error saving monitor layout", msg);
+        g_free(msg);
+        g_error_free(err);
+        return;
+    }
+    set_status(pd->status, r == CONFIG_SAVE_WRITTEN ? "Monitor rules saved to %s" : "Monitor rules in %s are already up to date", pd->root);
+}
+
+static void on_save_clicked(GtkButton *btn, gpointer user_data)
+{
+    MonitorsPageData *pd = user_data;
+    if (!pd->mons || pd->mons->len == 0) return;
+
+    SaveJob *job = g_new0(SaveJob, 1);
+    job->root = g_strdup(pd->root);
+    job->edits = g_ptr_array_new_with_free_func(rule_edit_free);
+    for (guint i = 0; i < pd->mons->len; i++) {
+        MonitorInfo *m = g_ptr_array_index(pd->mons, i);
+        RuleEdit *e = g_new0(RuleEdit, 1);
+        e->name = g_strdup(m->name);
+        e->description = g_strdup(m->description);
+        e->tail = monitor_rule_tail(m, TRUE);
+        e->file = e->line = -1;
+        g_ptr_array_add(job->edits, e);
+    }
+    gtk_widget_set_sensitive(pd->save_btn, FALSE);
+    GTask *task = g_task_new(NULL, NULL, on_rules_saved, pd);
+    g_task_set_task_data(task, job, save_job_free);
+    g_task_run_in_thread(task, save_rules_thread);
+    g_object_unref(task);
+}
+
+static GtkWidget *labeled(const char *text, GtkWidget *w)
+{
+    GtkWidget *h = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 6);
+    gtk_box_append(GTK_BOX(h), gtk_label_new(text));
+    gtk_box_append(GTK_BOX(h), w);
+    return h;
+}
+
+GtkWidget *create_monitors_page(GtkLabel *status_label)
+{
+    DBG("create_monitors_page called");
+    GtkWidget *vbox = gtk_box_new(GTK_ORIENTATION_VERTICAL, 8);
+    gtk_widget_set_margin_top(vbox, 12);
+    gtk_widget_set_margin_bottom(vbox, 12);
+    gtk_widget_set_margin_start(vbox, 12);
+    gtk_widget_set_margin_end(vbox, 12);
+
+    GtkWidget *label = gtk_label_new("Monitors");
+    gtk_widget_set_halign(label, GTK_ALIGN_START);
+    gtk_box_append(GTK_BOX(vbox), label);
+
+    GtkWidget *desc = gtk_label_new("Drag outputs to arrange them and adjust mode, scale and rotation. Apply changes everything in one step and reverts automatically unless you keep it; Save writes the monitor rules to your Hyprland config.");
+    gtk_label_set_wrap(GTK_LABEL(desc), TRUE);
+    gtk_box_append(GTK_BOX(vbox), desc);
+
+    MonitorsPageData *pd = g_new0(MonitorsPageData, 1);
+    pd->status = status_label;
+    pd->selected = -1;
+    pd->root = g_build_filename(g_get_home_dir(), ".config", "hypr", "hyprland.conf", NULL);
+
+    pd->area = gtk_drawing_area_new();
+    gtk_widget_set_vexpand(pd->area, TRUE);
+    gtk_widget_set_size_request(pd->area, -1, 220);
+    gtk_drawing_area_set_draw_func(GTK_DRAWING_AREA(pd->area), draw_layout, pd, NULL);
+    GtkGesture *drag = gtk_gesture_drag_new();
+    g_signal_connect(drag, "drag-begin", G_CALLBACK(on_drag_begin), pd);
+    g_signal_connect(drag, "drag-update", G_CALLBACK(on_drag_update), pd);
+    g_signal_connect(drag, "drag-end", G_CALLBACK(on_drag_end), pd);
+    gtk_widget_add_controller(pd->area, GTK_EVENT_CONTROLLER(drag));
+    GtkWidget *frame = gtk_frame_new(NULL);
+    gtk_frame_set_child(GTK_FRAME(frame), pd->area);
+    gtk_box_append(GTK_BOX(vbox), frame);
+
+    /* editors for the selected output */
+    GtkWidget *grid = gtk_flow_box_new();
+    gtk_flow_box_set_selection_mode(GTK_FLOW_BOX(grid), GTK_SELECTION_NONE);
+    gtk_flow_box_set_max_children_per_line(GTK_FLOW_BOX(grid), 4);
+
+    pd->mon_dd = gtk_drop_down_new(NULL, NULL);
+    g_signal_connect(pd->mon_dd, "notify::selected", G_CALLBACK(on_mon_selected), pd);
+    gtk_flow_box_append(GTK_FLOW_BOX(grid), labeled("Output", pd->mon_dd));
+
+    pd->mode_dd = gtk_drop_down_new(NULL, NULL);
+    g_signal_connect(pd->mode_dd, "notify::selected", G_CALLBACK(on_mode_selected), pd);
+    gtk_flow_box_append(GTK_FLOW_BOX(grid), labeled("Mode", pd->mode_dd));
+
+    pd->scale_spin = gtk_spin_button_new_with_range(0.25, 4.0, 0.05);
+    gtk_spin_button_set_digits(GTK_SPIN_BUTTON(pd->scale_spin), 2);
+    g_signal_connect(pd->scale_spin, "value-changed", G_CALLBACK(on_spin_changed), pd);
+    gtk_flow_box_append(GTK_FLOW_BOX(grid), labeled("Scale", pd->scale_spin));
+
+    pd->transform_dd = gtk_drop_down_new_from_strings(transform_names);
+    g_signal_connect(pd->transform_dd, "notify::selected", G_CALLBACK(on_transform_selected), pd);
+    gtk_flow_box_append(GTK_FLOW_BOX(grid), labeled("Rotation", pd->transform_dd));
+
+    pd->x_spin = gtk_spin_button_new_with_range(-32768, 32768, 1);
+    g_signal_connect(pd->x_spin, "value-changed", G_CALLBACK(on_spin_changed), pd);
+    gtk_flow_box_append(GTK_FLOW_BOX(grid), labeled("X", pd->x_spin));
+
+    pd->y_spin = gtk_spin_button_new_with_range(-32768, 32768, 1);
+    g_signal_connect(pd->y_spin, "value-changed", G_CALLBACK(on_spin_changed), pd);
+    gtk_flow_box_append(GTK_FLOW_BOX(grid), labeled("Y", pd->y_spin));
+
+    pd->enabled_btn = gtk_check_button_new_with_label("Enabled");
+    g_signal_connect(pd->enabled_btn, "toggled", G_CALLBACK(on_enabled_toggled), pd);
+    gtk_flow_box_append(GTK_FLOW_BOX(grid), pd->enabled_btn);
+    gtk_box_append(GTK_BOX(vbox), grid);
+
+    /* keep/revert prompt shown after Apply */
+    pd->confirm_bar = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 8);
+    pd->confirm_label = gtk_label_new("");
+    gtk_widget_set_hexpand(pd->confirm_label, TRUE);
+    gtk_widget_set_halign(pd->confirm_label, GTK_ALIGN_START);
+    gtk_box_append(GTK_BOX(pd->confirm_bar), pd->confirm_label);
+    GtkWidget *keep = gtk_button_new_with_label("Keep");
+    g_signal_connect(keep, "clicked", G_CALLBACK(on_keep_clicked), pd);
+    gtk_box_append(GTK_BOX(pd->confirm_bar), keep);
+    GtkWidget *revert = gtk_button_new_with_label("Revert");
+    g_signal_connect(revert, "clicked", G_CALLBACK(on_revert_clicked), pd);
+    gtk_box_append(GTK_BOX(pd->confirm_bar), revert);
+    gtk_widget_set_visible(pd->confirm_bar, FALSE);
+    gtk_box_append(GTK_BOX(vbox), pd->confirm_bar);
+
+    GtkWidget *h = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 8);
+    GtkWidget *btn_refresh = gtk_button_new_with_label("Refresh");
+    g_signal_connect(btn_refresh, "clicked", G_CALLBACK(on_refresh_clicked), pd);
+    gtk_box_append(GTK_BOX(h), btn_refresh);
+    pd->apply_btn = gtk_button_new_with_label("Apply");
+    g_signal_connect(pd->apply_btn, "clicked", G_CALLBACK(on_apply_clicked), pd);
+    gtk_box_append(GTK_BOX(h), pd->apply_btn);
+    pd->save_btn = gtk_button_new_with_label("Save to config");
+    g_signal_connect(pd->save_btn, "clicked", G_CALLBACK(on_save_clicked), pd);
+    gtk_box_append(GTK_BOX(h), pd->save_btn);
+    gtk_widget_set_halign(h, GTK_ALIGN_END);
+    gtk_box_append(GTK_BOX(vbox), h);
+
+    fill_editors(pd);
+    update_buttons(pd);
+    monitors_refresh(pd);
+    return vbox;
+}
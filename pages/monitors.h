@@ -0,0 +1,9 @@
+/* Monitors page header */
+#ifndef PAGES_MONITORS_H
+#define PAGES_MONITORS_H
+
+#include <gtk/gtk.h>
+
+GtkWidget *create_monitors_page(GtkLabel *status_label);
+
+#endif /* PAGES_MONITORS_H */
@@ -1,4 +1,5 @@
 #include "../common.h"
+#include "../pacdb.h"
 #include <gtk/gtk.h>
 #include <unistd.h>
 #include <string.h>
@@ -265,48 +266,49 @@ typedef struct {
     GtkTextView *tv;
     GtkLabel    *status;
     gchar       *text;
+    gboolean     append;   /* add below the list instead of replacing it */
 } UISetData;
 
 static gboolean ui_set_text_cb(gpointer user_data)
 {
     UISetData *d = (UISetData *)user_data;
     GtkTextBuffer *buf = gtk_text_view_get_buffer(d->tv);
-    gtk_text_buffer_set_text(buf, d->text ? d->text : "", -1);
-    set_status(d->status, "Updated list");
+    if (d->append) {
+        GtkTextIter end;
+        gtk_text_buffer_get_end_iter(buf, &end);
+        gtk_text_buffer_insert(buf, &end, d->text ? d->text : "", -1);
+        set_status(d->status, "Checked AUR");
+    } else {
+        gtk_text_buffer_set_text(buf, d->text ? d->text : "", -1);
+        set_status(d->status, "Updated list");
+    }
     g_free(d->text);
     g_free(d);
     return G_SOURCE_REMOVE;
 }
 
-/* Thread: run `yay -Qu` and post results to UI */
+/* Thread: compute pending repository updates from the pacman databases
+ * (read-only, no helper spawned) and post them to the UI in `pacman -Qu`
+ * format */
 static gpointer refresh_list_thread(gpointer user_data)
 {
     UpdatesRefreshData *d = (UpdatesRefreshData *)user_data;
-
-    if (g_dry_run) {
-        UISetData *ud = g_new0(UISetData, 1);
-        ud->tv = d->tv;
-        ud->status = d->status;
-        ud->text = g_strdup("Dry run: not executing 'yay -Qu'\n");
-        g_idle_add(ui_set_text_cb, ud);
-        g_free(d);
-        return NULL;
-    }
-
-    gchar *out = NULL, *err = NULL;
-    gint exit_status = 0;
     GError *error = NULL;
-
-    gboolean ok = g_spawn_command_line_sync("yay -Qu", &out, &err, &exit_status, &error);
+    GPtrArray *updates = pac_db_pending_updates(NULL, &error);
     gchar *text = NULL;
-    if (!ok) {
-        text = g_strdup_printf("Failed to run 'yay -Qu': %s\n", error ? error->message : "unknown");
+
+    if (!updates) {
+        text = g_strdup_printf("Failed to read the pacman databases: %s\n", error ? error->message : "unknown");
+    } else if (updates->len == 0) {
+        text = g_strdup("No updates available\n");
     } else {
-        if (out && *out) {
-            text = g_strdup(out);
-        } else {
-            text = g_strdup("No updates available\n");
+        GString *out = g_string_new(NULL);
+        for (guint i = 0; i < updates->len; i++) {
+            PacUpdate *u = g_ptr_array_index(updates, i);
+            g_string_append_printf(out, "%s %s -> %s%s\n", u->name, u->local_version, u->new_version,
+                                   u->ignored ? " [ignored]" : "");
         }
+        text = g_string_free(out, FALSE);
     }
 
     UISetData *ud = g_new0(UISetData, 1);
@@ -315,8 +317,54 @@ static gpointer refresh_list_thread(gpointer user_data)
     ud->text = text;
     g_idle_add(ui_set_text_cb, ud);
 
-    if (out) g_free(out);
-    if (err) g_free(err);
+    if (updates) g_ptr_array_unref(updates);
+    if (error) g_clear_error(&error);
+    g_free(d);
+    return NULL;
+}
+
+/* Full path of the AUR helper, yay before paru; NULL when neither is
+ * installed */
+static gchar *find_aur_helper(void)
+{
+    gchar *helper = g_find_program_in_path("yay");
+    if (!helper) helper = g_find_program_in_path("paru");
+    return helper;
+}
+
+/* Thread: ask the AUR helper for foreign package updates (network) and
+ * append them to the list */
+static gpointer aur_check_thread(gpointer user_data)
+{
+    UpdatesRefreshData *d = (UpdatesRefreshData *)user_data;
+    UISetData *ud = g_new0(UISetData, 1);
+    ud->tv = d->tv;
+    ud->status = d->status;
+    ud->append = TRUE;
+
+    gchar *helper = find_aur_helper();
+    if (!helper) {
+        ud->text = g_strdup("\nAUR: neither yay nor paru is installed\n");
+        g_idle_add(ui_set_text_cb, ud);
+        g_free(d);
+        return NULL;
+    }
+
+    gchar *out = NULL;
+    gint exit_status = 0;
+    GError *error = NULL;
+    gchar *argv[] = { helper, "-Qua", NULL };
+    if (!g_spawn_sync(NULL, argv, NULL, G_SPAWN_STDERR_TO_DEV_NULL, NULL, NULL, &out, NULL, &exit_status, &error)) {
+        ud->text = g_strdup_printf("\nAUR: failed to run %s -Qua: %s\n", helper, error ? error->message : "unknown");
+    } else if (out && *out) {
+        ud->text = g_strdup_printf("\nAUR:\n%s", out);
+    } else {
+        ud->text = g_strdup("\nAUR: no updates available\n");
+    }
+    g_idle_add(ui_set_text_cb, ud);
+
+    g_free(out);
+    g_free(helper);
     if (error) g_clear_error(&error);
     g_free(d);
     return NULL;
@@ -330,6 +378,28 @@ static void start_refresh_list(GtkTextView *tv, GtkLabel *status)
     g_thread_new("updates-refresh", refresh_list_thread, d);
 }
 
+static void on_check_aur_clicked(GtkButton *btn, gpointer user_data)
+{
+    UpdatesRefreshData *d = (UpdatesRefreshData *)user_data;
+    if (g_dry_run) {
+        gchar *helper = find_aur_helper();
+        if (helper) {
+            gchar *name = g_path_get_basename(helper);
+            set_status(d->status, "Dry run: not executing '%s -Qua'", name);
+            g_free(name);
+        } else {
+            set_status(d->status, "Dry run: neither yay nor paru is installed");
+        }
+        g_free(helper);
+        return;
+    }
+    UpdatesRefreshData *copy = g_new0(UpdatesRefreshData, 1);
+    copy->tv = d->tv;
+    copy->status = d->status;
+    set_status(d->status, "Checking AUR...");
+    g_thread_new("aur-check", aur_check_thread, copy);
+}
+
 /* Thread: run the long update command then refresh the list */
 static gpointer run_update_then_refresh_thread(gpointer user_data)
 {
@@ -571,6 +641,10 @@ GtkWidget *create_packages_page(GtkWindow *parent, GtkLabel *status_label)
     d->tv = GTK_TEXT_VIEW(tv);
     d->status = status_label;
 
+    GtkWidget *btn_check_aur = gtk_button_new_with_label("Check AUR");
+    g_signal_connect(btn_check_aur, "clicked", G_CALLBACK(on_check_aur_clicked), d);
+    gtk_box_append(GTK_BOX(hbox), btn_check_aur);
+
     GtkWidget *btn_update_system = gtk_button_new_with_label("Update System");
     g_signal_connect(btn_update_system, "clicked", G_CALLBACK(on_update_system_clicked), d);
     gtk_box_append(GTK_BOX(hbox), btn_update_system);
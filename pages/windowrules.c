@@ -0,0 +1,575 @@
+/* windowrules.c - structured windowrulev2 editor checked against live windows */
+#include "../common.h"
+#include "../hypr.h"
+#include "../hyprconf.h"
+#include "../hyprclients.h"
+#include "../hyprrules.h"
+#include <gtk/gtk.h>
+#include <string.h>
+
+/* Placeholder for a rule added from the editor */
+#define NEW_RULE_TEXT "float, class:^(app-id)$"
+
+typedef struct {
+    int file, line;
+} RuleOrigin;
+
+/* Config files as last read; rule origins index into these */
+typedef struct {
+    GPtrArray *paths;      /* include graph, root first */
+    GPtrArray *lines;      /* gchar** per file */
+    FileStamp *stamps;
+    GArray *found;         /* RuleOrigin of every windowrulev2 line */
+    GPtrArray *values;     /* rule value per found entry */
+} RulesDoc;
+
+typedef struct {
+    GtkLabel *status;
+    char *root;
+    HyprRuleSet *set;
+    RulesDoc *doc;
+    GArray *removed;       /* RuleOrigin of rules deleted in the editor */
+    GtkSingleSelection *sel;
+    GtkWidget *entry;
+    GtkWidget *error_label;
+    GtkStringList *matched;
+    GtkWidget *matched_label;
+    GtkWidget *remove_btn;
+    GtkWidget *save_btn;
+    HyprRule *current;
+    gulong current_id;
+    gboolean updating;
+    gboolean dirty;
+} WindowRulesPageData;
+
+static void rules_doc_free(RulesDoc *doc)
+{
+    if (!doc) return;
+    g_ptr_array_unref(doc->paths);
+    g_ptr_array_unref(doc->lines);
+    g_free(doc->stamps);
+    g_array_unref(doc->found);
+    g_ptr_array_unref(doc->values);
+    g_free(doc);
+}
+
+static gboolean is_rule_line(const HyprLine *hl)
+{
+    return hl->kind == HYPR_LINE_ASSIGN && hl->key_len == 12 && strncmp(hl->key, "windowrulev2", 12) == 0;
+}
+
+static void load_rules_thread(GTask *task, gpointer source, gpointer task_data, GCancellable *cancellable)
+{
+    const char *root = task_data;
+    RulesDoc *doc = g_new0(RulesDoc, 1);
+    doc->paths = hypr_conf_include_graph(root);
+    doc->lines = g_ptr_array_new_with_free_func((GDestroyNotify)g_strfreev);
+    doc->stamps = g_new0(FileStamp, doc->paths->len);
+    doc->found = g_array_new(FALSE, FALSE, sizeof(RuleOrigin));
+    doc->values = g_ptr_array_new_with_free_func(g_free);
+
+    for (guint f = 0; f < doc->paths->len; f++) {
+        const char *path = g_ptr_array_index(doc->paths, f);
+        file_stamp_take(path, &doc->stamps[f]);
+        gchar *content = NULL;
+        if (!g_file_get_contents(path, &content, NULL, NULL)) content = g_strdup("");
+        gchar **lines = g_strsplit(content, "\n", -1);
+        g_free(content);
+        g_ptr_array_add(doc->lines, lines);
+
+        int depth = 0;
+        for (gint l = 0; lines[l]; l++) {
+            HyprLine hl;
+            hypr_conf_scan_line(lines[l], -1, &hl);
+            if (depth == 0 && is_rule_line(&hl)) {
+                RuleOrigin o = { (int)f, l };
+                g_array_append_val(doc->found, o);
+                g_ptr_array_add(doc->values, g_strndup(hl.value, hl.value_len));
+            }
+            depth = MAX(0, depth + hl.opens - hl.closes);
+        }
+    }
+    g_task_return_pointer(task, doc, (GDestroyNotify)rules_doc_free);
+}
+
+static void update_buttons(WindowRulesPageData *pd)
+{
+    gtk_widget_set_sensitive(pd->save_btn, pd->dirty && pd->doc);
+    gtk_widget_set_sensitive(pd->remove_btn, pd->current != NULL);
+    gtk_widget_set_sensitive(pd->entry, pd->current != NULL);
+}
+
+static void on_rules_loaded(GObject *source, GAsyncResult *res, gpointer user_data)
+{
+    WindowRulesPageData *pd = user_data;
+    RulesDoc *doc = g_task_propagate_pointer(G_TASK(res), NULL);
+    if (!doc) return;
+    rules_doc_free(pd->doc);
+    pd->doc = doc;
+    g_array_set_size(pd->removed, 0);
+    hypr_rule_set_clear(pd->set);
+    for (guint i = 0; i < doc->found->len; i++) {
+        RuleOrigin *o = &g_array_index(doc->found, RuleOrigin, i);
+        hypr_rule_set_append(pd->set, g_ptr_array_index(doc->values, i), o->file, o->line);
+    }
+    pd->dirty = FALSE;
+    update_buttons(pd);
+    set_status(pd->status, "Loaded %u window rules from %u config files", doc->found->len, doc->paths->len);
+}
+
+static void rules_reload(WindowRulesPageData *pd)
+{
+    GTask *task = g_task_new(NULL, NULL, on_rules_loaded, pd);
+    g_task_set_task_data(task, g_strdup(pd->root), g_free);
+    g_task_run_in_thread(task, load_rules_thread);
+    g_object_unref(task);
+}
+
+/* Saving */
+
+typedef struct {
+    GPtrArray *paths;
+    GPtrArray *lines;      /* GPtrArray of line strings per file */
+    FileStamp *stamps;
+    GArray *edits;         /* RuleOrigin of kept rules, parallel to texts */
+    GPtrArray *texts;
+    GArray *removed;
+    GPtrArray *added;      /* rule values without an origin */
+    int insert_at;         /* root line after the last rule, or -1 for the end */
+} SaveJob;
+
+static void save_job_free(gpointer p)
+{
+    SaveJob *job = p;
+    g_ptr_array_unref(job->paths);
+    g_ptr_array_unref(job->lines);
+    g_free(job->stamps);
+    g_array_unref(job->edits);
+    g_ptr_array_unref(job->texts);
+    g_array_unref(job->removed);
+    g_ptr_array_unref(job->added);
+    g_free(job);
+}
+
+static void save_rules_thread(GTask *task, gpointer source, gpointer task_data, GCancellable *cancellable)
+{
+    SaveJob *job = task_data;
+    guint nf = job->paths->len;
+    gboolean *dirty = g_new0(gboolean, nf);
+
+    /* line indices refer to the files as read, so rewrite and drop in place
+     * (dropped lines become NULL) before inserting anything */
+    for (guint i = 0; i < job->edits->len; i++) {
+        RuleOrigin *o = &g_array_index(job->edits, RuleOrigin, i);
+        GPtrArray *lines = g_ptr_array_index(job->lines, o->file);
+        char *old = g_ptr_array_index(lines, o->line);
+        HyprLine hl;
+        hypr_conf_scan_line(old, -1, &hl);
+        const char *text = g_ptr_array_index(job->texts, i);
+        if (hl.value_len == strlen(text) && strncmp(hl.value, text, hl.value_len) == 0) continue;
+        gsize off;
+        if (hl.value_len > 0) {
+            off = hl.value - old;
+        } else {
+            /* "windowrulev2 =" with nothing after it */
+            const char *eq = strchr(old, '=');
+            off = eq ? (gsize)(eq - old) + 1 : strlen(old);
+        }
+        g_ptr_array_index(lines, o->line) = g_strdup_printf("%.*s%s%s%s", (int)off, old,
+                                                           hl.value_len == 0 ? " " : "", text,
+                                                           old + off + hl.value_len);
+        g_free(old);
+        dirty[o->file] = TRUE;
+    }
+    for (guint i = 0; i < job->removed->len; i++) {
+        RuleOrigin *o = &g_array_index(job->removed, RuleOrigin, i);
+        GPtrArray *lines = g_ptr_array_index(job->lines, o->file);
+        g_clear_pointer(&g_ptr_array_index(lines, o->line), g_free);
+        dirty[o->file] = TRUE;
+    }
+    if (job->added->len > 0 && nf > 0) {
+        GPtrArray *lines = g_ptr_array_index(job->lines, 0);
+        guint at;
+        if (job->insert_at >= 0) {
+            at = (guint)job->insert_at;
+        } else {
+            /* before the empty string a trailing newline leaves */
+            at = lines->len;
+            if (at > 0 && g_ptr_array_index(lines, at - 1) && !*(char *)g_ptr_array_index(lines, at - 1)) at--;
+        }
+        for (guint a = 0; a < job->added->len; a++) {
+            g_ptr_array_insert(lines, at + a, g_strdup_printf("windowrulev2 = %s", (char *)g_ptr_array_index(job->added, a)));
+        }
+        dirty[0] = TRUE;
+    }
+
+    GArray *writes = g_array_new(FALSE, TRUE, sizeof(ConfigWrite));
+    GPtrArray *contents = g_ptr_array_new_with_free_func(g_free);
+    for (guint f = 0; f < nf; f++) {
+        if (!dirty[f]) continue;
+        GPtrArray *lines = g_ptr_array_index(job->lines, f);
+        GString *s = g_string_new(NULL);
+        gboolean first = TRUE;
+        for (guint l = 0; l < lines->len; l++) {
+            const char *line = g_ptr_array_index(lines, l);
+            if (!line) continue;
+            if (!first) g_string_append_c(s, '\n');
+            g_string_append(s, line);
+            first = FALSE;
+        }
+        char *text = g_string_free(s, FALSE);
+        g_ptr_array_add(contents, text);
+        ConfigWrite w = { g_ptr_array_index(job->paths, f), text, -1, &job->stamps[f] };
+        g_array_append_val(writes, w);
+    }
+
+    GError *err = NULL;
+    ConfigSaveResult r = writes->len > 0
+        ? save_config_files((ConfigWrite *)writes->data, writes->len, FALSE, &err)
+        : CONFIG_SAVE_UNCHANGED;
+    if (r == CONFIG_SAVE_FAILED || r == CONFIG_SAVE_CONFLICT) g_task_return_error(task, err);
+    else g_task_return_int(task, r);
+
+    g_array_free(writes, TRUE);
+    g_ptr_array_unref(contents);
+    g_free(dirty);
+}
+
+static void on_rules_saved(GObject *source, GAsyncResult *res, gpointer user_data)
+{
+    WindowRulesPageData *pd = user_data;
+    GError *err = NULL;
+    g_task_propagate_int(G_TASK(res), &err);
+    if (err) {
+        char *msg = g_strdup_printf("Failed to save window rules:\n%s", err->message);
+        show_big_message_dialog("Error saving window rules", msg);
+        g_free(msg);
+        g_error_free(err);
+        update_buttons(pd);
+        return;
+    }
+    set_status(pd->status, "Window rules saved");
+    /* re-read so origins and stamps match what is on disk now */
+    rules_reload(pd);
+}
+
+static void on_save_clicked(GtkButton *btn, gpointer user_data)
+{
+    WindowRulesPageData *pd = user_data;
+    RulesDoc *doc = pd->doc;
+    if (!doc) return;
+
+    SaveJob *job = g_new0(SaveJob, 1);
+    job->paths = g_ptr_array_new_with_free_func(g_free);
+    job->lines = g_ptr_array_new_with_free_func((GDestroyNotify)g_ptr_array_unref);
+    job->stamps = g_memdup2(doc->stamps, sizeof(FileStamp) * doc->paths->len);
+    for (guint f = 0; f < doc->paths->len; f++) {
+        g_ptr_array_add(job->paths, g_strdup(g_ptr_array_index(doc->paths, f)));
+        gchar **src = g_ptr_array_index(doc->lines, f);
+        GPtrArray *lines = g_ptr_array_new_with_free_func(g_free);
+        for (guint l = 0; src[l]; l++) g_ptr_array_add(lines, g_strdup(src[l]));
+        g_ptr_array_add(job->lines, lines);
+    }
+    job->edits = g_array_new(FALSE, FALSE, sizeof(RuleOrigin));
+    job->texts = g_ptr_array_new_with_free_func(g_free);
+    job->added = g_ptr_array_new_with_free_func(g_free);
+    job->removed = g_array_copy(pd->removed);
+    job->insert_at = -1;
+    for (guint i = 0; i < doc->found->len; i++) {
+        RuleOrigin *o = &g_array_index(doc->found, RuleOrigin, i);
+        if (o->file == 0) job->insert_at = o->line + 1;
+    }
+
+    GListModel *rules = hypr_rule_set_get_model(pd->set);
+    for (guint i = 0; i < g_list_model_get_n_items(rules); i++) {
+        HyprRule *r = g_list_model_get_item(rules, i);
+        RuleOrigin o;
+        hypr_rule_get_origin(r, &o.file, &o.line);
+        if (o.file >= 0) {
+            g_array_append_val(job->edits, o);
+            g_ptr_array_add(job->texts, g_strdup(hypr_rule_get_text(r)));
+        } else {
+            g_ptr_array_add(job->added, g_strdup(hypr_rule_get_text(r)));
+        }
+        g_object_unref(r);
+    }
+
+    gtk_widget_set_sensitive(pd->save_btn, FALSE);
+    GTask *task = g_task_new(NULL, NULL, on_rules_saved, pd);
+    g_task_set_task_data(task, job, save_job_free);
+    g_task_run_in_thread(task, save_rules_thread);
+    g_object_unref(task);
+}
+
+/* Rule list */
+
+typedef struct {
+    const char *title;
+    const char *prop;      /* notify that refreshes the cell; NULL for any */
+    char *(*text)(HyprRule *r);
+    gboolean expand;
+} ColumnDef;
+
+static char *col_rule(HyprRule *r) { return g_strdup(hypr_rule_get_text(r)); }
+
+static char *col_matches(HyprRule *r)
+{
+    return g_strdup_printf("%u", hypr_rule_get_matches(r)->len);
+}
+
+static char *col_notes(HyprRule *r)
+{
+    if (hypr_rule_get_error(r)) return g_strdup_printf("Error: %s", hypr_rule_get_error(r));
+    HyprRule *by = hypr_rule_get_shadowed_by(r);
+    if (by) return g_strdup_printf("Overridden by \"%s\"", hypr_rule_get_text(by));
+    if (hypr_rule_get_unchecked(r)) return g_strdup_printf("Not checked: %s", hypr_rule_get_unchecked(r));
+    return g_strdup("");
+}
+
+static const ColumnDef columns[] = {
+    { "Rule", "text", col_rule, TRUE },
+    { "Windows", "matches", col_matches, FALSE },
+    { "Notes", NULL, col_notes, TRUE },
+};
+
+static void cell_update(GtkLabel *label, HyprRule *r)
+{
+    const ColumnDef *col = g_object_get_data(G_OBJECT(label), "column");
+    char *text = col->text(r);
+    gtk_label_set_text(label, text);
+    gtk_widget_set_tooltip_text(GTK_WIDGET(label), *text ? text : NULL);
+    g_free(text);
+}
+
+static void on_rule_notify(GObject *item, GParamSpec *pspec, gpointer user_data)
+{
+    cell_update(GTK_LABEL(user_data), HYPR_RULE(item));
+}
+
+static void cell_setup(GtkSignalListItemFactory *f, GtkListItem *li, gpointer user_data)
+{
+    GtkWidget *label = gtk_label_new("");
+    gtk_label_set_xalign(GTK_LABEL(label), 0);
+    gtk_label_set_ellipsize(GTK_LABEL(label), PANGO_ELLIPSIZE_END);
+    g_object_set_data(G_OBJECT(label), "column", user_data);
+    gtk_list_item_set_child(li, label);
+}
+
+static void cell_bind(GtkSignalListItemFactory *f, GtkListItem *li, gpointer user_data)
+{
+    const ColumnDef *col = user_data;
+    GtkWidget *label = gtk_list_item_get_child(li);
+    HyprRule *r = gtk_list_item_get_item(li);
+    cell_update(GTK_LABEL(label), r);
+    char *signal = col->prop ? g_strconcat("notify::", col->prop, NULL) : g_strdup("notify");
+    gulong id = g_signal_connect(r, signal, G_CALLBACK(on_rule_notify), label);
+    g_free(signal);
+    g_object_set_data(G_OBJECT(label), "notify-id", GSIZE_TO_POINTER(id));
+}
+
+static void cell_unbind(GtkSignalListItemFactory *f, GtkListItem *li, gpointer user_data)
+{
+    GtkWidget *label = gtk_list_item_get_child(li);
+    gulong id = GPOINTER_TO_SIZE(g_object_get_data(G_OBJECT(label), "notify-id"));
+    GObject *item = gtk_list_item_get_item(li);
+    if (id && item) g_signal_handler_disconnect(item, id);
+    g_object_set_data(G_OBJECT(label), "notify-id", NULL);
+}
+
+static void matched_bind(GtkSignalListItemFactory *f, GtkListItem *li, gpointer user_data)
+{
+    GtkStringObject *so = gtk_list_item_get_item(li);
+    gtk_label_set_text(GTK_LABEL(gtk_list_item_get_child(li)), gtk_string_object_get_string(so));
+}
+
+/* Selected rule */
+
+static void fill_matched(WindowRulesPageData *pd)
+{
+    GPtrArray *matches = pd->current ? hypr_rule_get_matches(pd->current) : NULL;
+    guint n = matches ? matches->len : 0;
+    const char **items = g_new0(const char *, n + 1);
+    for (guint i = 0; i < n; i++) {
+        HyprClient *c = g_ptr_array_index(matches, i);
+        items[i] = g_strdup_printf("%s — %s (workspace %s)", hypr_client_get_class(c),
+                                   hypr_client_get_title(c), hypr_client_get_workspace(c));
+    }
+    guint old = g_list_model_get_n_items(G_LIST_MODEL(pd->matched));
+    gtk_string_list_splice(pd->matched, 0, old, (const char * const *)items);
+    for (guint i = 0; i < n; i++) g_free((char *)items[i]);
+    g_free(items);
+
+    if (!pd->current) gtk_label_set_text(GTK_LABEL(pd->matched_label), "Select a rule to see the windows it applies to.");
+    else if (!hypr_clients_is_live()) gtk_label_set_text(GTK_LABEL(pd->matched_label), "Hyprland is not running; no windows to match.");
+    else {
+        char *text = g_strdup_printf("Matches %u open window%s", n, n == 1 ? "" : "s");
+        gtk_label_set_text(GTK_LABEL(pd->matched_label), text);
+        g_free(text);
+    }
+}
+
+static void fill_error(WindowRulesPageData *pd)
+{
+    const char *err = pd->current ? hypr_rule_get_error(pd->current) : NULL;
+    gtk_label_set_text(GTK_LABEL(pd->error_label), err ? err : "");
+    gtk_widget_set_visible(pd->error_label, err != NULL);
+}
+
+static void on_current_matches(GObject *obj, GParamSpec *pspec, gpointer user_data)
+{
+    fill_matched((WindowRulesPageData *)user_data);
+}
+
+static void on_selection_changed(GObject *obj, GParamSpec *pspec, gpointer user_data)
+{
+    WindowRulesPageData *pd = user_data;
+    if (pd->current) {
+        g_signal_handler_disconnect(pd->current, pd->current_id);
+        g_clear_object(&pd->current);
+    }
+    HyprRule *r = gtk_single_selection_get_selected_item(pd->sel);
+    if (r) {
+        pd->current = g_object_ref(r);
+        pd->current_id = g_signal_connect(r, "notify::matches", G_CALLBACK(on_current_matches), pd);
+    }
+    pd->updating = TRUE;
+    gtk_editable_set_text(GTK_EDITABLE(pd->entry), r ? hypr_rule_get_text(r) : "");
+    pd->updating = FALSE;
+    fill_error(pd);
+    fill_matched(pd);
+    update_buttons(pd);
+}
+
+/* Only the edited rule is recompiled and re-matched, so this is cheap
+ * enough to run on every keystroke */
+static void on_entry_changed(GtkEditable *e, gpointer user_data)
+{
+    WindowRulesPageData *pd = user_data;
+    if (pd->updating || !pd->current) return;
+    hypr_rule_set_change(pd->set, pd->current, gtk_editable_get_text(e));
+    pd->dirty = TRUE;
+    fill_error(pd);
+    update_buttons(pd);
+}
+
+static void on_add_clicked(GtkButton *btn, gpointer user_data)
+{
+    WindowRulesPageData *pd = user_data;
+    hypr_rule_set_append(pd->set, NEW_RULE_TEXT, -1, -1);
+    pd->dirty = TRUE;
+    gtk_single_selection_set_selected(pd->sel, g_list_model_get_n_items(hypr_rule_set_get_model(pd->set)) - 1);
+    gtk_widget_grab_focus(pd->entry);
+    update_buttons(pd);
+}
+
+static void on_remove_clicked(GtkButton *btn, gpointer user_data)
+{
+    WindowRulesPageData *pd = user_data;
+    if (!pd->current) return;
+    RuleOrigin o;
+    hypr_rule_get_origin(pd->current, &o.file, &o.line);
+    if (o.file >= 0) g_array_append_val(pd->removed, o);
+    hypr_rule_set_remove(pd->set, pd->current);
+    pd->dirty = TRUE;
+    update_buttons(pd);
+}
+
+static void on_reload_clicked(GtkButton *btn, gpointer user_data)
+{
+    rules_reload((WindowRulesPageData *)user_data);
+}
+
+GtkWidget *create_windowrules_page(GtkLabel *status_label)
+{
+    DBG("create_windowrules_page called");
+    GtkWidget *vbox = gtk_box_new(GTK_ORIENTATION_VERTICAL, 8);
+    gtk_widget_set_margin_top(vbox, 12);
+    gtk_widget_set_margin_bottom(vbox, 12);
+    gtk_widget_set_margin_start(vbox, 12);
+    gtk_widget_set_margin_end(vbox, 12);
+
+    GtkWidget *label = gtk_label_new("Window Rules");
+    gtk_widget_set_halign(label, GTK_ALIGN_START);
+    gtk_box_append(GTK_BOX(vbox), label);
+
+    GtkWidget *desc = gtk_label_new("windowrulev2 rules from your Hyprland config, checked against the windows that are open right now. Rules overridden by a later rule with the same effect are marked; Save writes edits back to the file each rule came from.");
+    gtk_label_set_wrap(GTK_LABEL(desc), TRUE);
+    gtk_box_append(GTK_BOX(vbox), desc);
+
+    WindowRulesPageData *pd = g_new0(WindowRulesPageData, 1);
+    pd->status = status_label;
+    pd->root = g_build_filename(g_get_home_dir(), ".config", "hypr", "hyprland.conf", NULL);
+    pd->set = hypr_rule_set_new(hypr_clients_get_default());
+    pd->removed = g_array_new(FALSE, FALSE, sizeof(RuleOrigin));
+
+    pd->sel = gtk_single_selection_new(g_object_ref(hypr_rule_set_get_model(pd->set)));
+    gtk_single_selection_set_autoselect(pd->sel, FALSE);
+    gtk_single_selection_set_can_unselect(pd->sel, TRUE);
+    g_signal_connect(pd->sel, "notify::selected-item", G_CALLBACK(on_selection_changed), pd);
+    GtkWidget *view = gtk_column_view_new(GTK_SELECTION_MODEL(pd->sel));
+    gtk_column_view_set_show_column_separators(GTK_COLUMN_VIEW(view), TRUE);
+    for (guint i = 0; i < G_N_ELEMENTS(columns); i++) {
+        GtkListItemFactory *f = gtk_signal_list_item_factory_new();
+        g_signal_connect(f, "setup", G_CALLBACK(cell_setup), (gpointer)&columns[i]);
+        g_signal_connect(f, "bind", G_CALLBACK(cell_bind), (gpointer)&columns[i]);
+        g_signal_connect(f, "unbind", G_CALLBACK(cell_unbind), (gpointer)&columns[i]);
+        GtkColumnViewColumn *col = gtk_column_view_column_new(columns[i].title, f);
+        gtk_column_view_column_set_expand(col, columns[i].expand);
+        gtk_column_view_column_set_resizable(col, TRUE);
+        gtk_column_view_append_column(GTK_COLUMN_VIEW(view), col);
+        g_object_unref(col);
+    }
+    GtkWidget *scroller = gtk_scrolled_window_new();
+    gtk_scrolled_window_set_child(GTK_SCROLLED_WINDOW(scroller), view);
+    gtk_widget_set_vexpand(scroller, TRUE);
+    gtk_box_append(GTK_BOX(vbox), scroller);
+
+    pd->entry = gtk_entry_new();
+    gtk_entry_set_placeholder_text(GTK_ENTRY(pd->entry), "effect, class:regex, title:regex");
+    g_signal_connect(pd->entry, "changed", G_CALLBACK(on_entry_changed), pd);
+    gtk_box_append(GTK_BOX(vbox), pd->entry);
+
+    pd->error_label = gtk_label_new("");
+    gtk_widget_set_halign(pd->error_label, GTK_ALIGN_START);
+    gtk_label_set_wrap(GTK_LABEL(pd->error_label), TRUE);
+    gtk_widget_add_css_class(pd->error_label, "error");
+    gtk_widget_set_visible(pd->error_label, FALSE);
+    gtk_box_append(GTK_BOX(vbox), pd->error_label);
+
+    pd->matched_label = gtk_label_new("");
+    gtk_widget_set_halign(pd->matched_label, GTK_ALIGN_START);
+    gtk_box_append(GTK_BOX(vbox), pd->matched_label);
+
+    pd->matched = gtk_string_list_new(NULL);
+    GtkListItemFactory *mf = gtk_signal_list_item_factory_new();
+    g_signal_connect(mf, "setup", G_CALLBACK(cell_setup), NULL);
+    g_signal_connect(mf, "bind", G_CALLBACK(matched_bind), NULL);
+    GtkWidget *matched_view = gtk_list_view_new(GTK_SELECTION_MODEL(gtk_no_selection_new(G_LIST_MODEL(pd->matched))), NULL);
+    gtk_list_view_set_factory(GTK_LIST_VIEW(matched_view), mf);
+    g_object_unref(mf);
+    GtkWidget *matched_scroll = gtk_scrolled_window_new();
+    gtk_scrolled_window_set_child(GTK_SCROLLED_WINDOW(matched_scroll), matched_view);
+    gtk_widget_set_size_request(matched_scroll, -1, 120);
+    gtk_box_append(GTK_BOX(vbox), matched_scroll);
+
+    GtkWidget *h = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 8);
+    GtkWidget *btn_reload = gtk_button_new_with_label("Reload");
+    g_signal_connect(btn_reload, "clicked", G_CALLBACK(on_reload_clicked), pd);
+    gtk_box_append(GTK_BOX(h), btn_reload);
+    GtkWidget *btn_add = gtk_button_new_with_label("Add");
+    g_signal_connect(btn_add, "clicked", G_CALLBACK(on_add_clicked), pd);
+    gtk_box_append(GTK_BOX(h), btn_add);
+    pd->remove_btn = gtk_button_new_with_label("Remove");
+    g_signal_connect(pd->remove_btn, "clicked", G_CALLBACK(on_remove_clicked), pd);
+    gtk_box_append(GTK_BOX(h), pd->remove_btn);
+    pd->save_btn = gtk_button_new_with_label("Save");
+    g_signal_connect(pd->save_btn, "clicked", G_CALLBACK(on_save_clicked), pd);
+    gtk_box_append(GTK_BOX(h), pd->save_btn);
+    gtk_widget_set_halign(h, GTK_ALIGN_END);
+    gtk_box_append(GTK_BOX(vbox), h);
+
+    fill_matched(pd);
+    update_buttons(pd);
+    rules_reload(pd);
+    return vbox;
+}
@@ -0,0 +1,9 @@
+/* Window Rules page header */
+#ifndef PAGES_WINDOWRULES_H
+#define PAGES_WINDOWRULES_H
+
+#include <gtk/gtk.h>
+
+GtkWidget *create_windowrules_page(GtkLabel *status_label);
+
+#endif /* PAGES_WINDOWRULES_H */
@@ -0,0 +1,209 @@
+/* workspaces.c - live overview of workspaces and their clients */
+#include "../common.h"
+#include "../hyprclients.h"
+#include <gtk/gtk.h>
+
+typedef struct {
+    GtkLabel *status;
+    GtkWidget *summary;
+    GListModel *clients;
+    GtkSorter *sorter;
+    guint resort_id;
+} WorkspacesPageData;
+
+typedef struct {
+    const char *title;
+    const char *prop;      /* property whose notify refreshes the cell */
+    char *(*text)(HyprClient *c);
+    gboolean expand;
+} ColumnDef;
+
+static char *col_workspace(HyprClient *c)
+{
+    const char *name = hypr_client_get_workspace(c);
+    return g_strdup(*name ? name : "?");
+}
+
+static char *col_class(HyprClient *c) { return g_strdup(hypr_client_get_class(c)); }
+static char *col_title(HyprClient *c) { return g_strdup(hypr_client_get_title(c)); }
+
+static char *col_size(HyprClient *c)
+{
+    if (hypr_client_get_width(c) <= 0) return g_strdup("");
+    return g_strdup_printf("%d×%d", hypr_client_get_width(c), hypr_client_get_height(c));
+}
+
+static char *col_floating(HyprClient *c) { return g_strdup(hypr_client_get_floating(c) ? "yes" : ""); }
+
+static char *col_pid(HyprClient *c)
+{
+    return hypr_client_get_pid(c) > 0 ? g_strdup_printf("%d", hypr_client_get_pid(c)) : g_strdup("");
+}
+
+static const ColumnDef columns[] = {
+    { "Workspace", "workspace", col_workspace, FALSE },
+    { "Class", "class", col_class, FALSE },
+    { "Title", "title", col_title, TRUE },
+    { "Size", "size", col_size, FALSE },
+    { "Floating", "floating", col_floating, FALSE },
+    { "PID", "pid", col_pid, FALSE },
+};
+
+static void cell_update(GtkLabel *label, HyprClient *c)
+{
+    const ColumnDef *col = g_object_get_data(G_OBJECT(label), "column");
+    char *text = col->text(c);
+    gtk_label_set_text(label, text);
+    g_free(text);
+}
+
+static void on_client_notify(GObject *item, GParamSpec *pspec, gpointer user_data)
+{
+    cell_update(GTK_LABEL(user_data), HYPR_CLIENT(item));
+}
+
+static void cell_setup(GtkSignalListItemFactory *f, GtkListItem *li, gpointer user_data)
+{
+    GtkWidget *label = gtk_label_new("");
+    gtk_label_set_xalign(GTK_LABEL(label), 0);
+    gtk_label_set_ellipsize(GTK_LABEL(label), PANGO_ELLIPSIZE_END);
+    g_object_set_data(G_OBJECT(label), "column", user_data);
+    gtk_list_item_set_child(li, label);
+}
+
+/* Cells follow their item's property notifications, so an event that
+ * changes one window touches one label instead of rebuilding the view */
+static void cell_bind(GtkSignalListItemFactory *f, GtkListItem *li, gpointer user_data)
+{
+    const ColumnDef *col = user_data;
+    GtkWidget *label = gtk_list_item_get_child(li);
+    HyprClient *c = gtk_list_item_get_item(li);
+    cell_update(GTK_LABEL(label), c);
+    char *signal = g_strconcat("notify::", col->prop, NULL);
+    gulong id = g_signal_connect(c, signal, G_CALLBACK(on_client_notify), label);
+    g_free(signal);
+    g_object_set_data(G_OBJECT(label), "notify-id", GSIZE_TO_POINTER(id));
+}
+
+static void cell_unbind(GtkSignalListItemFactory *f, GtkListItem *li, gpointer user_data)
+{
+    GtkWidget *label = gtk_list_item_get_child(li);
+    gulong id = GPOINTER_TO_SIZE(g_object_get_data(G_OBJECT(label), "notify-id"));
+    GObject *item = gtk_list_item_get_item(li);
+    if (id && item) g_signal_handler_disconnect(item, id);
+    g_object_set_data(G_OBJECT(label), "notify-id", NULL);
+}
+
+/* Workspace id first (named/special workspaces with negative ids last),
+ * then class, then title */
+static int compare_clients(gconstpointer a, gconstpointer b, gpointer user_data)
+{
+    HyprClient *ca = HYPR_CLIENT((gpointer)a), *cb = HYPR_CLIENT((gpointer)b);
+    int wa = hypr_client_get_workspace_id(ca), wb = hypr_client_get_workspace_id(cb);
+    if (wa != wb) {
+        if ((wa < 0) != (wb < 0)) return wa < 0 ? 1 : -1;
+        return wa < wb ? -1 : 1;
+    }
+    int r = g_utf8_collate(hypr_client_get_class(ca), hypr_client_get_class(cb));
+    return r ? r : g_utf8_collate(hypr_client_get_title(ca), hypr_client_get_title(cb));
+}
+
+static void update_summary(WorkspacesPageData *pd)
+{
+    guint n = g_list_model_get_n_items(pd->clients);
+    if (!hypr_clients_is_live() && n == 0) {
+        gtk_label_set_text(GTK_LABEL(pd->summary), "Hyprland is not running");
+        return;
+    }
+    GHashTable *ws = g_hash_table_new(g_direct_hash, g_direct_equal);
+    for (guint i = 0; i < n; i++) {
+        HyprClient *c = g_list_model_get_item(pd->clients, i);
+        g_hash_table_add(ws, GINT_TO_POINTER(hypr_client_get_workspace_id(c)));
+        g_object_unref(c);
+    }
+    char *text = g_strdup_printf("%u window%s on %u workspace%s%s", n, n == 1 ? "" : "s",
+                                 g_hash_table_size(ws), g_hash_table_size(ws) == 1 ? "" : "s",
+                                 hypr_clients_is_live() ? "" : " (not updating)");
+    gtk_label_set_text(GTK_LABEL(pd->summary), text);
+    g_free(text);
+    g_hash_table_destroy(ws);
+}
+
+/* GtkSortListModel only sorts on insertion; a move between workspaces
+ * needs an explicit re-sort, batched so a burst of moves re-sorts once */
+static gboolean resort_idle(gpointer user_data)
+{
+    WorkspacesPageData *pd = user_data;
+    pd->resort_id = 0;
+    gtk_sorter_changed(pd->sorter, GTK_SORTER_CHANGE_DIFFERENT);
+    update_summary(pd);
+    return G_SOURCE_REMOVE;
+}
+
+static void on_workspace_changed(GObject *item, GParamSpec *pspec, gpointer user_data)
+{
+    WorkspacesPageData *pd = user_data;
+    if (!pd->resort_id) pd->resort_id = g_idle_add(resort_idle, pd);
+}
+
+static void on_clients_changed(GListModel *model, guint pos, guint removed, guint added, gpointer user_data)
+{
+    WorkspacesPageData *pd = user_data;
+    for (guint i = pos; i < pos + added; i++) {
+        HyprClient *c = g_list_model_get_item(model, i);
+        g_signal_connect(c, "notify::workspace", G_CALLBACK(on_workspace_changed), pd);
+        g_object_unref(c);
+    }
+    update_summary(pd);
+}
+
+GtkWidget *create_workspaces_page(GtkLabel *status_label)
+{
+    DBG("create_workspaces_page called");
+    GtkWidget *vbox = gtk_box_new(GTK_ORIENTATION_VERTICAL, 8);
+    gtk_widget_set_margin_top(vbox, 12);
+    gtk_widget_set_margin_bottom(vbox, 12);
+    gtk_widget_set_margin_start(vbox, 12);
+    gtk_widget_set_margin_end(vbox, 12);
+
+    GtkWidget *label = gtk_label_new("Workspaces");
+    gtk_widget_set_halign(label, GTK_ALIGN_START);
+    gtk_box_append(GTK_BOX(vbox), label);
+
+    GtkWidget *desc = gtk_label_new("Open windows grouped by workspace. The list follows Hyprland's event socket, so it stays current as windows open, close, move or change title.");
+    gtk_label_set_wrap(GTK_LABEL(desc), TRUE);
+    gtk_box_append(GTK_BOX(vbox), desc);
+
+    WorkspacesPageData *pd = g_new0(WorkspacesPageData, 1);
+    pd->status = status_label;
+    pd->clients = hypr_clients_get_default();
+
+    pd->summary = gtk_label_new("");
+    gtk_widget_set_halign(pd->summary, GTK_ALIGN_START);
+    gtk_box_append(GTK_BOX(vbox), pd->summary);
+
+    pd->sorter = GTK_SORTER(gtk_custom_sorter_new(compare_clients, NULL, NULL));
+    GtkSortListModel *sorted = gtk_sort_list_model_new(g_object_ref(pd->clients), g_object_ref(pd->sorter));
+    GtkWidget *view = gtk_column_view_new(GTK_SELECTION_MODEL(gtk_no_selection_new(G_LIST_MODEL(sorted))));
+    gtk_column_view_set_show_column_separators(GTK_COLUMN_VIEW(view), TRUE);
+    for (guint i = 0; i < G_N_ELEMENTS(columns); i++) {
+        GtkListItemFactory *f = gtk_signal_list_item_factory_new();
+        g_signal_connect(f, "setup", G_CALLBACK(cell_setup), (gpointer)&columns[i]);
+        g_signal_connect(f, "bind", G_CALLBACK(cell_bind), (gpointer)&columns[i]);
+        g_signal_connect(f, "unbind", G_CALLBACK(cell_unbind), (gpointer)&columns[i]);
+        GtkColumnViewColumn *col = gtk_column_view_column_new(columns[i].title, f);
+        gtk_column_view_column_set_expand(col, columns[i].expand);
+        gtk_column_view_column_set_resizable(col, TRUE);
+        gtk_column_view_append_column(GTK_COLUMN_VIEW(view), col);
+        g_object_unref(col);
+    }
+
+    GtkWidget *scroller = gtk_scrolled_window_new();
+    gtk_scrolled_window_set_child(GTK_SCROLLED_WINDOW(scroller), view);
+    gtk_widget_set_vexpand(scroller, TRUE);
+    gtk_box_append(GTK_BOX(vbox), scroller);
+
+    on_clients_changed(pd->clients, 0, 0, g_list_model_get_n_items(pd->clients), pd);
+    g_signal_connect(pd->clients, "items-changed", G_CALLBACK(on_clients_changed), pd);
+    return vbox;
+}
@@ -0,0 +1,9 @@
+/* Workspaces page header */
+#ifndef PAGES_WORKSPACES_H
+#define PAGES_WORKSPACES_H
+
+#include <gtk/gtk.h>
+
+GtkWidget *create_workspaces_page(GtkLabel *status_label);
+
+#endif /* PAGES_WORKSPACES_H */
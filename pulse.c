@@ -0,0 +1,929 @@
+/* pulse.c - persistent PulseAudio (pipewire-pulse) connection on the GLib main loop */
+#include "pulse.h"
+#include "audiolevel.h"
+#include <pulse/pulseaudio.h>
+#include <pulse/glib-mainloop.h>
+#include <math.h>
+
+/* Delay before reconnecting after the server went away */
+#define PULSE_RECONNECT_S 1
+/* Volume writes go out at most once per frame */
+#define PULSE_VOLUME_FLUSH_MS 16
+#define NO_VOLUME G_MAXUINT
+/* Level meters record mono at a low rate, delivered about 30 times a second */
+#define PULSE_METER_RATE 12000
+#define PULSE_METER_FRAGMENTS 30
+
+typedef enum {
+    KIND_SINK,
+    KIND_SOURCE,
+    KIND_STREAM,
+} PulseKind;
+
+/* What sinks, sources and streams share: an object on the server with a
+ * volume we write through the coalescing path below */
+typedef struct {
+    PulseServer *server;  /* borrowed; the server outlives its objects' use */
+    PulseKind kind;
+    guint32 index;
+    pa_cvolume cvolume;
+    guint volume;
+    gboolean muted;
+    guint pending_volume;   /* latest target not yet sent, or NO_VOLUME */
+    gboolean writing;       /* a volume write is on the wire */
+    guint flush_id;
+} PulseNode;
+
+static void node_init(PulseNode *n)
+{
+    n->index = PA_INVALID_INDEX;
+    n->pending_volume = NO_VOLUME;
+    pa_cvolume_init(&n->cvolume);
+}
+
+static void node_finalize(PulseNode *n)
+{
+    if (n->flush_id) g_source_remove(n->flush_id);
+}
+
+static guint volume_percent(const pa_cvolume *cv)
+{
+    if (!pa_cvolume_valid(cv)) return 0;
+    return (guint)(((guint64)pa_cvolume_max(cv) * 100 + PA_VOLUME_NORM / 2) / PA_VOLUME_NORM);
+}
+
+/* Apply volume and mute from an info reply; notifies only on change */
+static void node_update(GObject *obj, PulseNode *n, const pa_cvolume *cv, gboolean muted,
+                        GParamSpec *volume_pspec, GParamSpec *muted_pspec)
+{
+    n->cvolume = *cv;
+    guint vol = volume_percent(cv);
+    /* while our own writes are outstanding, events report intermediate
+     * steps; the volume already holds the target */
+    if (n->writing || n->pending_volume != NO_VOLUME) vol = n->volume;
+    if (n->volume != vol) {
+        n->volume = vol;
+        g_object_notify_by_pspec(obj, volume_pspec);
+    }
+    muted = !!muted;
+    if (n->muted != muted) {
+        n->muted = muted;
+        g_object_notify_by_pspec(obj, muted_pspec);
+    }
+}
+
+struct _PulseDevice {
+    GObject parent_instance;
+    PulseNode node;
+    char *name;
+    char *description;
+    gboolean monitor;
+};
+
+enum {
+    DEV_PROP_0,
+    DEV_PROP_DESCRIPTION,
+    DEV_PROP_VOLUME,
+    DEV_PROP_MUTED,
+    DEV_N_PROPS
+};
+
+static GParamSpec *dev_props[DEV_N_PROPS];
+
+G_DEFINE_FINAL_TYPE(PulseDevice, pulse_device, G_TYPE_OBJECT)
+
+static void pulse_device_finalize(GObject *obj)
+{
+    PulseDevice *d = PULSE_DEVICE(obj);
+    node_finalize(&d->node);
+    g_free(d->name);
+    g_free(d->description);
+    G_OBJECT_CLASS(pulse_device_parent_class)->finalize(obj);
+}
+
+static void pulse_device_get_property(GObject *obj, guint id, GValue *value, GParamSpec *pspec)
+{
+    PulseDevice *d = PULSE_DEVICE(obj);
+    switch (id) {
+    case DEV_PROP_DESCRIPTION: g_value_set_string(value, d->description); break;
+    case DEV_PROP_VOLUME: g_value_set_uint(value, d->node.volume); break;
+    case DEV_PROP_MUTED: g_value_set_boolean(value, d->node.muted); break;
+    default: G_OBJECT_WARN_INVALID_PROPERTY_ID(obj, id, pspec);
+    }
+}
+
+static void pulse_device_class_init(PulseDeviceClass *klass)
+{
+    GObjectClass *oc = G_OBJECT_CLASS(klass);
+    oc->finalize = pulse_device_finalize;
+    oc->get_property = pulse_device_get_property;
+    dev_props[DEV_PROP_DESCRIPTION] = g_param_spec_string("description", NULL, NULL, NULL, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
+    dev_props[DEV_PROP_VOLUME] = g_param_spec_uint("volume", NULL, NULL, 0, G_MAXUINT, 0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
+    dev_props[DEV_PROP_MUTED] = g_param_spec_boolean("muted", NULL, NULL, FALSE, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
+    g_object_class_install_properties(oc, DEV_N_PROPS, dev_props);
+}
+
+static void pulse_device_init(PulseDevice *d)
+{
+    node_init(&d->node);
+}
+
+guint32 pulse_device_get_index(PulseDevice *d) { return d->node.index; }
+const char *pulse_device_get_name(PulseDevice *d) { return d->name; }
+const char *pulse_device_get_description(PulseDevice *d) { return d->description ? d->description : d->name; }
+guint pulse_device_get_volume(PulseDevice *d) { return d->node.volume; }
+gboolean pulse_device_get_muted(PulseDevice *d) { return d->node.muted; }
+gboolean pulse_device_is_monitor(PulseDevice *d) { return d->monitor; }
+
+static void device_update(PulseDevice *d, const char *description, const pa_cvolume *cv, gboolean muted)
+{
+    if (description && g_strcmp0(d->description, description) != 0) {
+        g_free(d->description);
+        d->description = g_strdup(description);
+        g_object_notify_by_pspec(G_OBJECT(d), dev_props[DEV_PROP_DESCRIPTION]);
+    }
+    node_update(G_OBJECT(d), &d->node, cv, muted, dev_props[DEV_PROP_VOLUME], dev_props[DEV_PROP_MUTED]);
+}
+
+struct _PulseStream {
+    GObject parent_instance;
+    PulseNode node;
+    char *app_name;
+    char *media_name;
+    char *icon_name;
+    guint32 sink;
+    gboolean internal;
+};
+
+enum {
+    STREAM_PROP_0,
+    STREAM_PROP_APP_NAME,
+    STREAM_PROP_MEDIA_NAME,
+    STREAM_PROP_ICON_NAME,
+    STREAM_PROP_VOLUME,
+    STREAM_PROP_MUTED,
+    STREAM_PROP_SINK,
+    STREAM_N_PROPS
+};
+
+static GParamSpec *stream_props[STREAM_N_PROPS];
+
+G_DEFINE_FINAL_TYPE(PulseStream, pulse_stream, G_TYPE_OBJECT)
+
+static void pulse_stream_finalize(GObject *obj)
+{
+    PulseStream *st = PULSE_STREAM(obj);
+    node_finalize(&st->node);
+    g_free(st->app_name);
+    g_free(st->media_name);
+    g_free(st->icon_name);
+    G_OBJECT_CLASS(pulse_stream_parent_class)->finalize(obj);
+}
+
+static void pulse_stream_get_property(GObject *obj, guint id, GValue *value, GParamSpec *pspec)
+{
+    PulseStream *st = PULSE_STREAM(obj);
+    switch (id) {
+    case STREAM_PROP_APP_NAME: g_value_set_string(value, st->app_name); break;
+    case STREAM_PROP_MEDIA_NAME: g_value_set_string(value, st->media_name); break;
+    case STREAM_PROP_ICON_NAME: g_value_set_string(value, st->icon_name); break;
+    case STREAM_PROP_VOLUME: g_value_set_uint(value, st->node.volume); break;
+    case STREAM_PROP_MUTED: g_value_set_boolean(value, st->node.muted); break;
+    case STREAM_PROP_SINK: g_value_set_uint(value, st->sink); break;
+    default: G_OBJECT_WARN_INVALID_PROPERTY_ID(obj, id, pspec);
+    }
+}
+
+static void pulse_stream_class_init(PulseStreamClass *klass)
+{
+    GObjectClass *oc = G_OBJECT_CLASS(klass);
+    oc->finalize = pulse_stream_finalize;
+    oc->get_property = pulse_stream_get_property;
+    stream_props[STREAM_PROP_APP_NAME] = g_param_spec_string("app-name", NULL, NULL, NULL, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
+    stream_props[STREAM_PROP_MEDIA_NAME] = g_param_spec_string("media-name", NULL, NULL, NULL, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
+    stream_props[STREAM_PROP_ICON_NAME] = g_param_spec_string("icon-name", NULL, NULL, NULL, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
+    stream_props[STREAM_PROP_VOLUME] = g_param_spec_uint("volume", NULL, NULL, 0, G_MAXUINT, 0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
+    stream_props[STREAM_PROP_MUTED] = g_param_spec_boolean("muted", NULL, NULL, FALSE, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
+    stream_props[STREAM_PROP_SINK] = g_param_spec_uint("sink", NULL, NULL, 0, G_MAXUINT32, PA_INVALID_INDEX, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
+    g_object_class_install_properties(oc, STREAM_N_PROPS, stream_props);
+}
+
+static void pulse_stream_init(PulseStream *st)
+{
+    node_init(&st->node);
+    st->node.kind = KIND_STREAM;
+    st->sink = PA_INVALID_INDEX;
+}
+
+guint32 pulse_stream_get_index(PulseStream *st) { return st->node.index; }
+const char *pulse_stream_get_app_name(PulseStream *st) { return st->app_name ? st->app_name : ""; }
+const char *pulse_stream_get_media_name(PulseStream *st) { return st->media_name ? st->media_name : ""; }
+const char *pulse_stream_get_icon_name(PulseStream *st) { return st->icon_name; }
+guint pulse_stream_get_volume(PulseStream *st) { return st->node.volume; }
+gboolean pulse_stream_get_muted(PulseStream *st) { return st->node.muted; }
+guint32 pulse_stream_get_sink(PulseStream *st) { return st->sink; }
+gboolean pulse_stream_is_internal(PulseStream *st) { return st->internal; }
+
+static void stream_set_str(PulseStream *st, char **field, const char *v, int prop)
+{
+    if (g_strcmp0(*field, v) == 0) return;
+    g_free(*field);
+    *field = g_strdup(v);
+    g_object_notify_by_pspec(G_OBJECT(st), stream_props[prop]);
+}
+
+static void stream_update(PulseStream *st, const pa_sink_input_info *i)
+{
+    const char *app = pa_proplist_gets(i->proplist, PA_PROP_APPLICATION_NAME);
+    const char *icon = pa_proplist_gets(i->proplist, PA_PROP_APPLICATION_ICON_NAME);
+    const char *media = pa_proplist_gets(i->proplist, PA_PROP_MEDIA_NAME);
+    stream_set_str(st, &st->app_name, app ? app : i->name, STREAM_PROP_APP_NAME);
+    stream_set_str(st, &st->media_name, media ? media : i->name, STREAM_PROP_MEDIA_NAME);
+    stream_set_str(st, &st->icon_name, icon, STREAM_PROP_ICON_NAME);
+    /* the output side of a filter-chain or loopback: passive/virtual, or
+     * named like filter-chain's playback node */
+    const char *node = pa_proplist_gets(i->proplist, "node.name");
+    st->internal = g_strcmp0(pa_proplist_gets(i->proplist, "node.passive"), "true") == 0 ||
+                   g_strcmp0(pa_proplist_gets(i->proplist, "node.virtual"), "true") == 0 ||
+                   g_str_has_prefix(node ? node : "", "effect_output.");
+    if (st->sink != i->sink) {
+        st->sink = i->sink;
+        g_object_notify_by_pspec(G_OBJECT(st), stream_props[STREAM_PROP_SINK]);
+    }
+    node_update(G_OBJECT(st), &st->node, &i->volume, i->mute,
+                stream_props[STREAM_PROP_VOLUME], stream_props[STREAM_PROP_MUTED]);
+}
+
+typedef struct {
+    char *name;
+    char *description;
+    gboolean available;
+} CardProfile;
+
+static void card_profile_clear(gpointer p)
+{
+    CardProfile *cp = p;
+    g_free(cp->name);
+    g_free(cp->description);
+}
+
+struct _PulseCard {
+    GObject parent_instance;
+    PulseServer *server;
+    guint32 index;
+    char *name;
+    char *description;
+    char *active_profile;
+    GArray *profiles;  /* CardProfile; replaced only when the list changes */
+};
+
+enum {
+    CARD_PROP_0,
+    CARD_PROP_DESCRIPTION,
+    CARD_PROP_ACTIVE_PROFILE,
+    CARD_PROP_PROFILES,
+    CARD_N_PROPS
+};
+
+static GParamSpec *card_props[CARD_N_PROPS];
+
+G_DEFINE_FINAL_TYPE(PulseCard, pulse_card, G_TYPE_OBJECT)
+
+static void pulse_card_finalize(GObject *obj)
+{
+    PulseCard *c = PULSE_CARD(obj);
+    g_free(c->name);
+    g_free(c->description);
+    g_free(c->active_profile);
+    g_array_unref(c->profiles);
+    G_OBJECT_CLASS(pulse_card_parent_class)->finalize(obj);
+}
+
+static void pulse_card_get_property(GObject *obj, guint id, GValue *value, GParamSpec *pspec)
+{
+    PulseCard *c = PULSE_CARD(obj);
+    switch (id) {
+    case CARD_PROP_DESCRIPTION: g_value_set_string(value, c->description); break;
+    case CARD_PROP_ACTIVE_PROFILE: g_value_set_string(value, c->active_profile); break;
+    case CARD_PROP_PROFILES: g_value_set_uint(value, c->profiles->len); break;
+    default: G_OBJECT_WARN_INVALID_PROPERTY_ID(obj, id, pspec);
+    }
+}
+
+static void pulse_card_class_init(PulseCardClass *klass)
+{
+    GObjectClass *oc = G_OBJECT_CLASS(klass);
+    oc->finalize = pulse_card_finalize;
+    oc->get_property = pulse_card_get_property;
+    card_props[CARD_PROP_DESCRIPTION] = g_param_spec_string("description", NULL, NULL, NULL, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
+    card_props[CARD_PROP_ACTIVE_PROFILE] = g_param_spec_string("active-profile", NULL, NULL, NULL, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
+    /* the number of profiles; notified whenever the list changes */
+    card_props[CARD_PROP_PROFILES] = g_param_spec_uint("profiles", NULL, NULL, 0, G_MAXUINT, 0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
+    g_object_class_install_properties(oc, CARD_N_PROPS, card_props);
+}
+
+static void pulse_card_init(PulseCard *c)
+{
+    c->index = PA_INVALID_INDEX;
+    c->profiles = g_array_new(FALSE, TRUE, sizeof(CardProfile));
+    g_array_set_clear_func(c->profiles, card_profile_clear);
+}
+
+guint32 pulse_card_get_index(PulseCard *c) { return c->index; }
+const char *pulse_card_get_name(PulseCard *c) { return c->name; }
+const char *pulse_card_get_description(PulseCard *c) { return c->description ? c->description : c->name; }
+const char *pulse_card_get_active_profile(PulseCard *c) { return c->active_profile; }
+guint pulse_card_get_n_profiles(PulseCard *c) { return c->profiles->len; }
+const char *pulse_card_get_profile_name(PulseCard *c, guint i) { return g_array_index(c->profiles, CardProfile, i).name; }
+const char *pulse_card_get_profile_description(PulseCard *c, guint i) { return g_array_index(c->profiles, CardProfile, i).description; }
+gboolean pulse_card_get_profile_available(PulseCard *c, guint i) { return g_array_index(c->profiles, CardProfile, i).available; }
+
+static gboolean profiles_equal(GArray *have, const pa_card_info *i)
+{
+    if (have->len != i->n_profiles) return FALSE;
+    for (guint k = 0; k < i->n_profiles; k++) {
+        CardProfile *cp = &g_array_index(have, CardProfile, k);
+        if (g_strcmp0(cp->name, i->profiles2[k]->name) != 0 ||
+            g_strcmp0(cp->description, i->profiles2[k]->description) != 0 ||
+            cp->available != (i->profiles2[k]->available != 0)) return FALSE;
+    }
+    return TRUE;
+}
+
+static void card_update(PulseCard *c, const pa_card_info *i)
+{
+    const char *desc = pa_proplist_gets(i->proplist, PA_PROP_DEVICE_DESCRIPTION);
+    if (desc && g_strcmp0(c->description, desc) != 0) {
+        g_free(c->description);
+        c->description = g_strdup(desc);
+        g_object_notify_by_pspec(G_OBJECT(c), card_props[CARD_PROP_DESCRIPTION]);
+    }
+    /* card events fire for port availability and the like; the profile
+     * list rarely changes, so it is kept until it does */
+    if (!profiles_equal(c->profiles, i)) {
+        g_array_set_size(c->profiles, 0);
+        for (guint k = 0; k < i->n_profiles; k++) {
+            CardProfile cp = { g_strdup(i->profiles2[k]->name), g_strdup(i->profiles2[k]->description),
+                               i->profiles2[k]->available != 0 };
+            g_array_append_val(c->profiles, cp);
+        }
+        g_object_notify_by_pspec(G_OBJECT(c), card_props[CARD_PROP_PROFILES]);
+    }
+    const char *active = i->active_profile2 ? i->active_profile2->name : NULL;
+    if (g_strcmp0(c->active_profile, active) != 0) {
+        g_free(c->active_profile);
+        c->active_profile = g_strdup(active);
+        g_object_notify_by_pspec(G_OBJECT(c), card_props[CARD_PROP_ACTIVE_PROFILE]);
+    }
+}
+
+struct _PulseServer {
+    GObject parent_instance;
+    pa_glib_mainloop *mainloop;
+    pa_context *ctx;
+    gboolean connected;
+    char *default_sink;
+    char *default_source;
+    char *info;
+    GListStore *sinks;
+    GListStore *sources;
+    GListStore *streams;
+    GListStore *cards;
+    GHashTable *sink_by_index;    /* index -> PulseDevice (borrowed from sinks) */
+    GHashTable *source_by_index;  /* index -> PulseDevice (borrowed from sources) */
+    GHashTable *stream_by_index;  /* index -> PulseStream (borrowed from streams) */
+    GHashTable *card_by_index;    /* index -> PulseCard (borrowed from cards) */
+    guint reconnect_id;
+};
+
+enum {
+    PROP_0,
+    PROP_CONNECTED,
+    PROP_DEFAULT_SINK,
+    PROP_DEFAULT_SOURCE,
+    PROP_SERVER_INFO,
+    N_PROPS
+};
+
+static GParamSpec *props[N_PROPS];
+
+G_DEFINE_FINAL_TYPE(PulseServer, pulse_server, G_TYPE_OBJECT)
+
+static void pulse_server_get_property(GObject *obj, guint id, GValue *value, GParamSpec *pspec)
+{
+    PulseServer *s = PULSE_SERVER(obj);
+    switch (id) {
+    case PROP_CONNECTED: g_value_set_boolean(value, s->connected); break;
+    case PROP_DEFAULT_SINK: g_value_set_string(value, s->default_sink); break;
+    case PROP_DEFAULT_SOURCE: g_value_set_string(value, s->default_source); break;
+    case PROP_SERVER_INFO: g_value_set_string(value, s->info); break;
+    default: G_OBJECT_WARN_INVALID_PROPERTY_ID(obj, id, pspec);
+    }
+}
+
+static void pulse_server_class_init(PulseServerClass *klass)
+{
+    GObjectClass *oc = G_OBJECT_CLASS(klass);
+    oc->get_property = pulse_server_get_property;
+    props[PROP_CONNECTED] = g_param_spec_boolean("connected", NULL, NULL, FALSE, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
+    props[PROP_DEFAULT_SINK] = g_param_spec_string("default-sink", NULL, NULL, NULL, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
+    props[PROP_DEFAULT_SOURCE] = g_param_spec_string("default-source", NULL, NULL, NULL, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
+    props[PROP_SERVER_INFO] = g_param_spec_string("server-info", NULL, NULL, NULL, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
+    g_object_class_install_properties(oc, N_PROPS, props);
+}
+
+static void pulse_server_init(PulseServer *s)
+{
+    s->sinks = g_list_store_new(PULSE_TYPE_DEVICE);
+    s->sources = g_list_store_new(PULSE_TYPE_DEVICE);
+    s->streams = g_list_store_new(PULSE_TYPE_STREAM);
+    s->cards = g_list_store_new(PULSE_TYPE_CARD);
+    s->sink_by_index = g_hash_table_new(g_direct_hash, g_direct_equal);
+    s->source_by_index = g_hash_table_new(g_direct_hash, g_direct_equal);
+    s->stream_by_index = g_hash_table_new(g_direct_hash, g_direct_equal);
+    s->card_by_index = g_hash_table_new(g_direct_hash, g_direct_equal);
+}
+
+gboolean pulse_server_is_connected(PulseServer *s) { return s->connected; }
+const char *pulse_server_get_default_sink(PulseServer *s) { return s->default_sink; }
+const char *pulse_server_get_default_source(PulseServer *s) { return s->default_source; }
+const char *pulse_server_get_info(PulseServer *s) { return s->info; }
+GListModel *pulse_server_get_sinks(PulseServer *s) { return G_LIST_MODEL(s->sinks); }
+GListModel *pulse_server_get_sources(PulseServer *s) { return G_LIST_MODEL(s->sources); }
+GListModel *pulse_server_get_streams(PulseServer *s) { return G_LIST_MODEL(s->streams); }
+GListModel *pulse_server_get_cards(PulseServer *s) { return G_LIST_MODEL(s->cards); }
+
+static void set_str(PulseServer *s, char **field, const char *v, int prop)
+{
+    if (g_strcmp0(*field, v) == 0) return;
+    g_free(*field);
+    *field = g_strdup(v);
+    g_object_notify_by_pspec(G_OBJECT(s), props[prop]);
+}
+
+static void set_connected(PulseServer *s, gboolean connected)
+{
+    if (s->connected == connected) return;
+    s->connected = connected;
+    g_object_notify_by_pspec(G_OBJECT(s), props[PROP_CONNECTED]);
+}
+
+PulseDevice *pulse_server_find_sink(PulseServer *s, const char *name)
+{
+    if (!name) return NULL;
+    GHashTableIter it;
+    gpointer d;
+    g_hash_table_iter_init(&it, s->sink_by_index);
+    while (g_hash_table_iter_next(&it, NULL, &d)) {
+        if (g_strcmp0(PULSE_DEVICE(d)->name, name) == 0) return d;
+    }
+    return NULL;
+}
+
+/* `monitor` is set before the device shows up, so filters on it see it */
+static PulseDevice *lookup_or_add(PulseServer *s, gboolean is_source, guint32 index, const char *name, gboolean monitor)
+{
+    GHashTable *by_index = is_source ? s->source_by_index : s->sink_by_index;
+    PulseDevice *d = g_hash_table_lookup(by_index, GUINT_TO_POINTER(index));
+    if (d) return d;
+    d = g_object_new(PULSE_TYPE_DEVICE, NULL);
+    d->node.server = s;
+    d->node.kind = is_source ? KIND_SOURCE : KIND_SINK;
+    d->node.index = index;
+    d->name = g_strdup(name);
+    d->monitor = monitor;
+    g_hash_table_insert(by_index, GUINT_TO_POINTER(index), d);
+    g_list_store_append(is_source ? s->sources : s->sinks, d);
+    g_object_unref(d);
+    return d;
+}
+
+static void remove_device(PulseServer *s, gboolean is_source, guint32 index)
+{
+    GHashTable *by_index = is_source ? s->source_by_index : s->sink_by_index;
+    PulseDevice *d = g_hash_table_lookup(by_index, GUINT_TO_POINTER(index));
+    guint pos;
+    if (!d) return;
+    g_hash_table_remove(by_index, GUINT_TO_POINTER(index));
+    if (g_list_store_find(is_source ? s->sources : s->sinks, d, &pos)) {
+        g_list_store_remove(is_source ? s->sources : s->sinks, pos);
+    }
+}
+
+static void on_sink_info(pa_context *c, const pa_sink_info *i, int eol, void *user_data)
+{
+    if (eol || !i) return;
+    PulseDevice *d = lookup_or_add(user_data, FALSE, i->index, i->name, FALSE);
+    device_update(d, i->description, &i->volume, i->mute);
+}
+
+static void on_source_info(pa_context *c, const pa_source_info *i, int eol, void *user_data)
+{
+    if (eol || !i) return;
+    PulseDevice *d = lookup_or_add(user_data, TRUE, i->index, i->name, i->monitor_of_sink != PA_INVALID_INDEX);
+    device_update(d, i->description, &i->volume, i->mute);
+}
+
+static void on_stream_info(pa_context *c, const pa_sink_input_info *i, int eol, void *user_data)
+{
+    PulseServer *s = user_data;
+    if (eol || !i) return;
+    PulseStream *st = g_hash_table_lookup(s->stream_by_index, GUINT_TO_POINTER(i->index));
+    if (!st) {
+        st = g_object_new(PULSE_TYPE_STREAM, NULL);
+        st->node.server = s;
+        st->node.index = i->index;
+        /* fill in before it shows up in the list */
+        stream_update(st, i);
+        g_hash_table_insert(s->stream_by_index, GUINT_TO_POINTER(i->index), st);
+        g_list_store_append(s->streams, st);
+        g_object_unref(st);
+        return;
+    }
+    stream_update(st, i);
+}
+
+static void remove_stream(PulseServer *s, guint32 index)
+{
+    PulseStream *st = g_hash_table_lookup(s->stream_by_index, GUINT_TO_POINTER(index));
+    guint pos;
+    if (!st) return;
+    g_hash_table_remove(s->stream_by_index, GUINT_TO_POINTER(index));
+    if (g_list_store_find(s->streams, st, &pos)) g_list_store_remove(s->streams, pos);
+}
+
+static void on_card_info(pa_context *c, const pa_card_info *i, int eol, void *user_data)
+{
+    PulseServer *s = user_data;
+    if (eol || !i) return;
+    PulseCard *card = g_hash_table_lookup(s->card_by_index, GUINT_TO_POINTER(i->index));
+    if (!card) {
+        card = g_object_new(PULSE_TYPE_CARD, NULL);
+        card->server = s;
+        card->index = i->index;
+        card->name = g_strdup(i->name);
+        card_update(card, i);
+        g_hash_table_insert(s->card_by_index, GUINT_TO_POINTER(i->index), card);
+        g_list_store_append(s->cards, card);
+        g_object_unref(card);
+        return;
+    }
+    card_update(card, i);
+}
+
+static void remove_card(PulseServer *s, guint32 index)
+{
+    PulseCard *card = g_hash_table_lookup(s->card_by_index, GUINT_TO_POINTER(index));
+    guint pos;
+    if (!card) return;
+    g_hash_table_remove(s->card_by_index, GUINT_TO_POINTER(index));
+    if (g_list_store_find(s->cards, card, &pos)) g_list_store_remove(s->cards, pos);
+}
+
+static void on_server_info(pa_context *c, const pa_server_info *i, void *user_data)
+{
+    PulseServer *s = user_data;
+    if (!i) return;
+    char *info = g_strdup_printf("%s %s", i->server_name, i->server_version);
+    set_str(s, &s->info, info, PROP_SERVER_INFO);
+    g_free(info);
+    set_str(s, &s->default_sink, i->default_sink_name, PROP_DEFAULT_SINK);
+    set_str(s, &s->default_source, i->default_source_name, PROP_DEFAULT_SOURCE);
+}
+
+/* libpulse returns an operation for every request; we never wait on one */
+static void drop_op(pa_operation *op)
+{
+    if (op) pa_operation_unref(op);
+}
+
+static void on_subscribe_event(pa_context *c, pa_subscription_event_type_t t, uint32_t index, void *user_data)
+{
+    PulseServer *s = user_data;
+    gboolean removed = (t & PA_SUBSCRIPTION_EVENT_TYPE_MASK) == PA_SUBSCRIPTION_EVENT_REMOVE;
+
+    switch (t & PA_SUBSCRIPTION_EVENT_FACILITY_MASK) {
+    case PA_SUBSCRIPTION_EVENT_SINK:
+        if (removed) remove_device(s, FALSE, index);
+        else drop_op(pa_context_get_sink_info_by_index(c, index, on_sink_info, s));
+        break;
+    case PA_SUBSCRIPTION_EVENT_SOURCE:
+        if (removed) remove_device(s, TRUE, index);
+        else drop_op(pa_context_get_source_info_by_index(c, index, on_source_info, s));
+        break;
+    case PA_SUBSCRIPTION_EVENT_SINK_INPUT:
+        if (removed) remove_stream(s, index);
+        else drop_op(pa_context_get_sink_input_info(c, index, on_stream_info, s));
+        break;
+    case PA_SUBSCRIPTION_EVENT_CARD:
+        if (removed) remove_card(s, index);
+        else drop_op(pa_context_get_card_info_by_index(c, index, on_card_info, s));
+        break;
+    case PA_SUBSCRIPTION_EVENT_SERVER:
+        drop_op(pa_context_get_server_info(c, on_server_info, s));
+        break;
+    default:
+        break;
+    }
+}
+
+static void clear_models(PulseServer *s)
+{
+    g_hash_table_remove_all(s->sink_by_index);
+    g_hash_table_remove_all(s->source_by_index);
+    g_hash_table_remove_all(s->stream_by_index);
+    g_hash_table_remove_all(s->card_by_index);
+    g_list_store_remove_all(s->sinks);
+    g_list_store_remove_all(s->sources);
+    g_list_store_remove_all(s->streams);
+    g_list_store_remove_all(s->cards);
+}
+
+static gboolean do_connect(gpointer user_data);
+
+static void on_context_state(pa_context *c, void *user_data)
+{
+    PulseServer *s = user_data;
+    switch (pa_context_get_state(c)) {
+    case PA_CONTEXT_READY:
+        /* subscribe before listing so nothing falls in between; a late
+         * "new" event for a listed device is applied as an update */
+        pa_context_set_subscribe_callback(c, on_subscribe_event, s);
+        drop_op(pa_context_subscribe(c, PA_SUBSCRIPTION_MASK_SINK | PA_SUBSCRIPTION_MASK_SOURCE |
+                                        PA_SUBSCRIPTION_MASK_SINK_INPUT | PA_SUBSCRIPTION_MASK_CARD |
+                                        PA_SUBSCRIPTION_MASK_SERVER,
+                                        NULL, NULL));
+        drop_op(pa_context_get_server_info(c, on_server_info, s));
+        drop_op(pa_context_get_sink_info_list(c, on_sink_info, s));
+        drop_op(pa_context_get_source_info_list(c, on_source_info, s));
+        drop_op(pa_context_get_sink_input_info_list(c, on_stream_info, s));
+        drop_op(pa_context_get_card_info_list(c, on_card_info, s));
+        set_connected(s, TRUE);
+        break;
+    case PA_CONTEXT_FAILED:
+    case PA_CONTEXT_TERMINATED:
+        /* indices are per server instance; start over on reconnect */
+        clear_models(s);
+        set_connected(s, FALSE);
+        if (!s->reconnect_id) s->reconnect_id = g_timeout_add_seconds(PULSE_RECONNECT_S, do_connect, s);
+        break;
+    default:
+        break;
+    }
+}
+
+static gboolean do_connect(gpointer user_data)
+{
+    PulseServer *s = user_data;
+    s->reconnect_id = 0;
+    /* the old context cannot be reused once it failed; dropped here rather
+     * than from inside its own state callback */
+    if (s->ctx) {
+        pa_context_set_state_callback(s->ctx, NULL, NULL);
+        pa_context_set_subscribe_callback(s->ctx, NULL, NULL);
+        pa_context_unref(s->ctx);
+    }
+    s->ctx = pa_context_new(pa_glib_mainloop_get_api(s->mainloop), "aser-settings");
+    pa_context_set_state_callback(s->ctx, on_context_state, s);
+    /* NOFAIL waits for a server that is not up yet instead of failing */
+    if (pa_context_connect(s->ctx, NULL, PA_CONTEXT_NOFAIL, NULL) < 0) {
+        g_warning("pulse: connect failed: %s", pa_strerror(pa_context_errno(s->ctx)));
+        s->reconnect_id = g_timeout_add_seconds(PULSE_RECONNECT_S, do_connect, s);
+    }
+    return G_SOURCE_REMOVE;
+}
+
+PulseServer *pulse_server_get_default(void)
+{
+    static PulseServer *server;
+    if (server) return server;
+    server = g_object_new(PULSE_TYPE_SERVER, NULL);
+    server->mainloop = pa_glib_mainloop_new(NULL);
+    do_connect(server);
+    return server;
+}
+
+static void node_set_muted(PulseNode *n, gboolean muted)
+{
+    PulseServer *s = n->server;
+    if (!s->connected) return;
+    /* the model follows from the change event, like any other client's */
+    switch (n->kind) {
+    case KIND_SINK: drop_op(pa_context_set_sink_mute_by_index(s->ctx, n->index, muted, NULL, NULL)); break;
+    case KIND_SOURCE: drop_op(pa_context_set_source_mute_by_index(s->ctx, n->index, muted, NULL, NULL)); break;
+    case KIND_STREAM: drop_op(pa_context_set_sink_input_mute(s->ctx, n->index, muted, NULL, NULL)); break;
+    }
+}
+
+static void schedule_volume_flush(GObject *obj, PulseNode *n);
+
+static PulseNode *node_of(GObject *obj)
+{
+    return PULSE_IS_DEVICE(obj) ? &PULSE_DEVICE(obj)->node : &PULSE_STREAM(obj)->node;
+}
+
+static void on_volume_written(pa_operation *op, void *user_data)
+{
+    GObject *obj = user_data;
+    PulseNode *n = node_of(obj);
+    if (pa_operation_get_state(op) == PA_OPERATION_RUNNING) return;
+    /* done, or cancelled because the connection went away */
+    pa_operation_unref(op);
+    n->writing = FALSE;
+    if (n->pending_volume != NO_VOLUME) schedule_volume_flush(obj, n);
+    g_object_unref(obj);
+}
+
+static gboolean flush_volume(gpointer user_data)
+{
+    GObject *obj = user_data;
+    PulseNode *n = node_of(obj);
+    PulseServer *s = n->server;
+    n->flush_id = 0;
+    /* one write on the wire at a time keeps them in order; whatever
+     * arrives meanwhile collapses into the next one */
+    if (n->writing || n->pending_volume == NO_VOLUME) return G_SOURCE_REMOVE;
+    if (!s->connected || !pa_cvolume_valid(&n->cvolume)) {
+        n->pending_volume = NO_VOLUME;
+        return G_SOURCE_REMOVE;
+    }
+
+    pa_cvolume cv = n->cvolume;
+    pa_cvolume_scale(&cv, (pa_volume_t)((guint64)n->pending_volume * PA_VOLUME_NORM / 100));
+    n->pending_volume = NO_VOLUME;
+
+    pa_operation *op = NULL;
+    switch (n->kind) {
+    case KIND_SINK: op = pa_context_set_sink_volume_by_index(s->ctx, n->index, &cv, NULL, NULL); break;
+    case KIND_SOURCE: op = pa_context_set_source_volume_by_index(s->ctx, n->index, &cv, NULL, NULL); break;
+    case KIND_STREAM: op = pa_context_set_sink_input_volume(s->ctx, n->index, &cv, NULL, NULL); break;
+    }
+    if (!op) return G_SOURCE_REMOVE;
+    n->writing = TRUE;
+    pa_operation_set_state_callback(op, on_volume_written, g_object_ref(obj));
+    return G_SOURCE_REMOVE;
+}
+
+static void schedule_volume_flush(GObject *obj, PulseNode *n)
+{
+    if (!n->flush_id) n->flush_id = g_timeout_add(PULSE_VOLUME_FLUSH_MS, flush_volume, obj);
+}
+
+static void node_set_volume(GObject *obj, PulseNode *n, guint percent, GParamSpec *volume_pspec)
+{
+    n->pending_volume = percent;
+    if (n->volume != percent) {
+        n->volume = percent;
+        g_object_notify_by_pspec(obj, volume_pspec);
+    }
+    /* the first step of a drag goes out right away */
+    if (!n->writing && !n->flush_id) flush_volume(obj);
+    else schedule_volume_flush(obj, n);
+}
+
+void pulse_device_set_muted(PulseDevice *d, gboolean muted)
+{
+    node_set_muted(&d->node, muted);
+}
+
+void pulse_device_set_volume(PulseDevice *d, guint percent)
+{
+    node_set_volume(G_OBJECT(d), &d->node, percent, dev_props[DEV_PROP_VOLUME]);
+}
+
+void pulse_stream_set_muted(PulseStream *st, gboolean muted)
+{
+    node_set_muted(&st->node, muted);
+}
+
+void pulse_stream_set_volume(PulseStream *st, guint percent)
+{
+    node_set_volume(G_OBJECT(st), &st->node, percent, stream_props[STREAM_PROP_VOLUME]);
+}
+
+void pulse_stream_move(PulseStream *st, PulseDevice *sink)
+{
+    PulseServer *s = st->node.server;
+    if (!s->connected || sink->node.kind != KIND_SINK || sink->node.index == st->sink) return;
+    drop_op(pa_context_move_sink_input_by_index(s->ctx, st->node.index, sink->node.index, NULL, NULL));
+}
+
+void pulse_card_set_profile(PulseCard *c, const char *profile)
+{
+    PulseServer *s = c->server;
+    if (!s->connected || g_strcmp0(c->active_profile, profile) == 0) return;
+    drop_op(pa_context_set_card_profile_by_index(s->ctx, c->index, profile, NULL, NULL));
+}
+
+void pulse_server_set_default_sink(PulseServer *s, PulseDevice *sink)
+{
+    if (!s->connected || sink->node.kind != KIND_SINK) return;
+    /* queued back to back on the one connection: the server applies the
+     * default and every move without waiting on us in between */
+    drop_op(pa_context_set_default_sink(s->ctx, sink->name, NULL, NULL));
+    for (guint i = 0; i < g_list_model_get_n_items(G_LIST_MODEL(s->streams)); i++) {
+        PulseStream *st = g_list_model_get_item(G_LIST_MODEL(s->streams), i);
+        /* a virtual sink's own output stays on its device; moving it into
+         * the virtual sink would loop it */
+        if (!st->internal && st->sink != sink->node.index) {
+            drop_op(pa_context_move_sink_input_by_index(s->ctx, st->node.index, sink->node.index, NULL, NULL));
+        }
+        g_object_unref(st);
+    }
+}
+
+typedef struct {
+    PulseServer *server;
+    guint32 target;
+} SourceMove;
+
+/* Recording streams are not modelled; they are listed once to move them */
+static void on_source_output_for_move(pa_context *c, const pa_source_output_info *i, int eol, void *user_data)
+{
+    SourceMove *mv = user_data;
+    if (eol) {
+        g_free(mv);
+        return;
+    }
+    if (!i || i->source == mv->target) return;
+    /* whatever records a sink's monitor (meters, screen recorders) does so
+     * on purpose */
+    PulseDevice *from = g_hash_table_lookup(mv->server->source_by_index, GUINT_TO_POINTER(i->source));
+    if (from && from->monitor) return;
+    drop_op(pa_context_move_source_output_by_index(c, i->index, mv->target, NULL, NULL));
+}
+
+void pulse_server_set_default_source(PulseServer *s, PulseDevice *source)
+{
+    if (!s->connected || source->node.kind != KIND_SOURCE) return;
+    drop_op(pa_context_set_default_source(s->ctx, source->name, NULL, NULL));
+    SourceMove *mv = g_new(SourceMove, 1);
+    mv->server = s;
+    mv->target = source->node.index;
+    drop_op(pa_context_get_source_output_info_list(s->ctx, on_source_output_for_move, mv));
+}
+
+struct _PulseMeter {
+    pa_stream *stream;
+    float peak;
+    double sum_sq;
+    guint64 n;
+};
+
+static void on_meter_read(pa_stream *st, size_t nbytes, void *user_data)
+{
+    PulseMeter *m = user_data;
+    const void *data;
+    size_t len;
+    while (pa_stream_readable_size(st) > 0) {
+        if (pa_stream_peek(st, &data, &len) < 0 || len == 0) return;
+        /* data is NULL for a hole in the stream; it still has to be dropped */
+        if (data) {
+            audio_level_accumulate(data, len / sizeof(float), &m->peak, &m->sum_sq);
+            m->n += len / sizeof(float);
+        }
+        pa_stream_drop(st);
+    }
+}
+
+PulseMeter *pulse_meter_new(PulseServer *s, const char *source)
+{
+    if (!s->connected || !source) return NULL;
+    pa_sample_spec ss = { PA_SAMPLE_FLOAT32NE, PULSE_METER_RATE, 1 };
+    pa_stream *st = pa_stream_new(s->ctx, "Level meter", &ss, NULL);
+    if (!st) return NULL;
+    PulseMeter *m = g_new0(PulseMeter, 1);
+    m->stream = st;
+    pa_stream_set_read_callback(st, on_meter_read, m);
+
+    pa_buffer_attr attr = { 0 };
+    attr.maxlength = (uint32_t)-1;
+    attr.fragsize = PULSE_METER_RATE / PULSE_METER_FRAGMENTS * sizeof(float);
+    /* DONT_MOVE: a meter belongs to the device it was opened on */
+    if (pa_stream_connect_record(st, source, &attr, PA_STREAM_DONT_MOVE | PA_STREAM_ADJUST_LATENCY |
+                                                   PA_STREAM_DONT_INHIBIT_AUTO_SUSPEND) < 0) {
+        pulse_meter_free(m);
+        return NULL;
+    }
+    return m;
+}
+
+void pulse_meter_free(PulseMeter *m)
+{
+    if (!m) return;
+    pa_stream_set_read_callback(m->stream, NULL, NULL);
+    if (pa_stream_get_state(m->stream) != PA_STREAM_UNCONNECTED) pa_stream_disconnect(m->stream);
+    pa_stream_unref(m->stream);
+    g_free(m);
+}
+
+gboolean pulse_meter_take(PulseMeter *m, float *peak, float *rms)
+{
+    if (!m || m->n == 0) return FALSE;
+    *peak = m->peak;
+    *rms = (float)sqrt(m->sum_sq / (double)m->n);
+    m->peak = 0;
+    m->sum_sq = 0;
+    m->n = 0;
+    return TRUE;
+}
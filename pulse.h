@@ -0,0 +1,114 @@
+/* pulse.h - persistent PulseAudio (pipewire-pulse) connection on the GLib main loop */
+#ifndef PULSE_H
+#define PULSE_H
+
+#include <gio/gio.h>
+
+#define PULSE_TYPE_DEVICE (pulse_device_get_type())
+G_DECLARE_FINAL_TYPE(PulseDevice, pulse_device, PULSE, DEVICE, GObject)
+
+/* A sink or source. Properties ("description", "volume", "muted") are
+ * notified only when a server event actually changes them. */
+guint32 pulse_device_get_index(PulseDevice *d);
+const char *pulse_device_get_name(PulseDevice *d);
+const char *pulse_device_get_description(PulseDevice *d);
+/* Percent of nominal volume of the loudest channel */
+guint pulse_device_get_volume(PulseDevice *d);
+gboolean pulse_device_get_muted(PulseDevice *d);
+/* Sources only: the monitor of a sink */
+gboolean pulse_device_is_monitor(PulseDevice *d);
+
+void pulse_device_set_muted(PulseDevice *d, gboolean muted);
+
+/* Set the volume keeping the channel balance. Cheap to call on every slider
+ * step: only the latest value is kept, writes go out at most once per frame
+ * and one at a time, so the last call always wins. "volume" reports the
+ * target right away and ignores the intermediate steps echoed back while
+ * writes are outstanding. */
+void pulse_device_set_volume(PulseDevice *d, guint percent);
+
+#define PULSE_TYPE_STREAM (pulse_stream_get_type())
+G_DECLARE_FINAL_TYPE(PulseStream, pulse_stream, PULSE, STREAM, GObject)
+
+/* An application's playback stream (sink input). "app-name", "media-name",
+ * "icon-name", "volume", "muted" and "sink" are notified on change. */
+guint32 pulse_stream_get_index(PulseStream *st);
+const char *pulse_stream_get_app_name(PulseStream *st);
+const char *pulse_stream_get_media_name(PulseStream *st);
+/* May be NULL when the application sets none */
+const char *pulse_stream_get_icon_name(PulseStream *st);
+guint pulse_stream_get_volume(PulseStream *st);
+gboolean pulse_stream_get_muted(PulseStream *st);
+/* Index of the sink it plays to */
+guint32 pulse_stream_get_sink(PulseStream *st);
+/* The playback side of a virtual device (a filter-chain such as the
+ * equalizer, a loopback), not an application. Not listed in mixers and
+ * not moved by pulse_server_set_default_sink(). */
+gboolean pulse_stream_is_internal(PulseStream *st);
+
+void pulse_stream_set_muted(PulseStream *st, gboolean muted);
+/* Coalesced like pulse_device_set_volume() */
+void pulse_stream_set_volume(PulseStream *st, guint percent);
+void pulse_stream_move(PulseStream *st, PulseDevice *sink);
+
+#define PULSE_TYPE_CARD (pulse_card_get_type())
+G_DECLARE_FINAL_TYPE(PulseCard, pulse_card, PULSE, CARD, GObject)
+
+/* A sound card and its profiles (e.g. HDMI output vs analog duplex). The
+ * profile list is cached and "profiles" is notified only when it changes;
+ * "description" and "active-profile" are notified on change. */
+guint32 pulse_card_get_index(PulseCard *c);
+const char *pulse_card_get_name(PulseCard *c);
+const char *pulse_card_get_description(PulseCard *c);
+const char *pulse_card_get_active_profile(PulseCard *c);
+guint pulse_card_get_n_profiles(PulseCard *c);
+const char *pulse_card_get_profile_name(PulseCard *c, guint i);
+const char *pulse_card_get_profile_description(PulseCard *c, guint i);
+gboolean pulse_card_get_profile_available(PulseCard *c, guint i);
+
+void pulse_card_set_profile(PulseCard *c, const char *profile);
+
+#define PULSE_TYPE_SERVER (pulse_server_get_type())
+G_DECLARE_FINAL_TYPE(PulseServer, pulse_server, PULSE, SERVER, GObject)
+
+/* The shared connection. Created on first use; connects without blocking,
+ * subscribes to sink, source, stream, card and server events and keeps the models below
+ * current from them. Reconnects when the server goes away (e.g. a
+ * PipeWire restart). Notifies "connected", "default-sink", "default-source"
+ * and "server-info" on change. */
+PulseServer *pulse_server_get_default(void);
+
+gboolean pulse_server_is_connected(PulseServer *s);
+const char *pulse_server_get_default_sink(PulseServer *s);
+const char *pulse_server_get_default_source(PulseServer *s);
+/* e.g. "PulseAudio (on PipeWire 1.0.5) 15.0.0" */
+const char *pulse_server_get_info(PulseServer *s);
+
+/* GListModels of PulseDevice, in server order */
+GListModel *pulse_server_get_sinks(PulseServer *s);
+GListModel *pulse_server_get_sources(PulseServer *s);
+/* GListModel of PulseStream */
+GListModel *pulse_server_get_streams(PulseServer *s);
+/* GListModel of PulseCard */
+GListModel *pulse_server_get_cards(PulseServer *s);
+
+/* Borrowed; NULL when not present */
+PulseDevice *pulse_server_find_sink(PulseServer *s, const char *name);
+
+/* Make `sink` the default and move every application stream to it. The default
+ * change and all moves are queued at once rather than one round trip each. */
+void pulse_server_set_default_sink(PulseServer *s, PulseDevice *sink);
+/* Same for recording; streams recording a monitor stay where they are */
+void pulse_server_set_default_source(PulseServer *s, PulseDevice *source);
+
+/* Level metering: records `source` (a source name; a sink's monitor is
+ * "<sink>.monitor") as mono float at a low rate and accumulates peak and
+ * RMS as blocks arrive. NULL when not connected. */
+typedef struct _PulseMeter PulseMeter;
+
+PulseMeter *pulse_meter_new(PulseServer *s, const char *source);
+void pulse_meter_free(PulseMeter *m);
+/* Linear peak and RMS since the last call; FALSE when nothing arrived */
+gboolean pulse_meter_take(PulseMeter *m, float *peak, float *rms);
+
+#endif /* PULSE_H */
@@ -0,0 +1,466 @@
+/* pwgraph.c - PipeWire graph (nodes, ports, links) as a diff-updated tree */
+#include "pwgraph.h"
+#include <json-glib/json-glib.h>
+#include <string.h>
+
+struct _PwGraphItem {
+    GObject parent_instance;
+    guint64 key;
+    char *label;
+    char *detail;
+    GListStore *children;
+};
+
+enum {
+    PROP_0,
+    PROP_LABEL,
+    PROP_DETAIL,
+    N_PROPS
+};
+
+static GParamSpec *props[N_PROPS];
+
+G_DEFINE_FINAL_TYPE(PwGraphItem, pw_graph_item, G_TYPE_OBJECT)
+
+static void pw_graph_item_finalize(GObject *obj)
+{
+    PwGraphItem *it = PW_GRAPH_ITEM(obj);
+    g_free(it->label);
+    g_free(it->detail);
+    g_clear_object(&it->children);
+    G_OBJECT_CLASS(pw_graph_item_parent_class)->finalize(obj);
+}
+
+static void pw_graph_item_get_property(GObject *obj, guint id, GValue *value, GParamSpec *pspec)
+{
+    PwGraphItem *it = PW_GRAPH_ITEM(obj);
+    switch (id) {
+    case PROP_LABEL: g_value_set_string(value, it->label); break;
+    case PROP_DETAIL: g_value_set_string(value, it->detail); break;
+    default: G_OBJECT_WARN_INVALID_PROPERTY_ID(obj, id, pspec);
+    }
+}
+
+static void pw_graph_item_class_init(PwGraphItemClass *klass)
+{
+    GObjectClass *oc = G_OBJECT_CLASS(klass);
+    oc->finalize = pw_graph_item_finalize;
+    oc->get_property = pw_graph_item_get_property;
+    props[PROP_LABEL] = g_param_spec_string("label", NULL, NULL, NULL, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
+    props[PROP_DETAIL] = g_param_spec_string("detail", NULL, NULL, NULL, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
+    g_object_class_install_properties(oc, N_PROPS, props);
+}
+
+static void pw_graph_item_init(PwGraphItem *it)
+{
+}
+
+const char *pw_graph_item_get_label(PwGraphItem *it) { return it->label ? it->label : ""; }
+const char *pw_graph_item_get_detail(PwGraphItem *it) { return it->detail ? it->detail : ""; }
+GListModel *pw_graph_item_get_children(PwGraphItem *it) { return it->children ? G_LIST_MODEL(it->children) : NULL; }
+
+/* Setters notify only when the value actually changes */
+static void set_str(PwGraphItem *it, char **field, const char *v, int prop)
+{
+    if (g_strcmp0(*field, v) == 0) return;
+    g_free(*field);
+    *field = g_strdup(v);
+    g_object_notify_by_pspec(G_OBJECT(it), props[prop]);
+}
+
+/* Parsed graph, before it is applied to the items. `children` is NULL for
+ * leaves (links). */
+typedef struct {
+    guint64 key;
+    char *label;
+    char *detail;
+    GArray *children;
+} Entry;
+
+static void entry_clear(gpointer p)
+{
+    Entry *e = p;
+    g_free(e->label);
+    g_free(e->detail);
+    if (e->children) g_array_unref(e->children);
+}
+
+static GArray *entries_new(void)
+{
+    GArray *a = g_array_new(FALSE, TRUE, sizeof(Entry));
+    g_array_set_clear_func(a, entry_clear);
+    return a;
+}
+
+/* Takes `label` and `detail`; returns the new entry's position */
+static guint entries_add(GArray *a, guint64 key, char *label, char *detail, gboolean branch)
+{
+    Entry e = { key, label, detail, branch ? entries_new() : NULL };
+    g_array_append_val(a, e);
+    return a->len - 1;
+}
+
+/* Make `store` hold `want`: items are matched by key and updated in place,
+ * vanished ones removed and new ones inserted where they belong */
+static void apply_entries(GListStore *store, GArray *want)
+{
+    GHashTable *keys = g_hash_table_new(g_int64_hash, g_int64_equal);
+    for (guint i = 0; i < want->len; i++) g_hash_table_add(keys, &g_array_index(want, Entry, i).key);
+
+    GHashTable *have = g_hash_table_new(g_int64_hash, g_int64_equal);
+    for (guint i = g_list_model_get_n_items(G_LIST_MODEL(store)); i-- > 0;) {
+        PwGraphItem *it = g_list_model_get_item(G_LIST_MODEL(store), i);
+        if (!g_hash_table_contains(keys, &it->key)) g_list_store_remove(store, i);
+        else g_hash_table_insert(have, &it->key, it);
+        g_object_unref(it);
+    }
+
+    for (guint i = 0; i < want->len; i++) {
+        Entry *e = &g_array_index(want, Entry, i);
+        PwGraphItem *it = g_hash_table_lookup(have, &e->key);
+        if (!it) {
+            it = g_object_new(PW_TYPE_GRAPH_ITEM, NULL);
+            it->key = e->key;
+            it->label = g_strdup(e->label);
+            it->detail = g_strdup(e->detail);
+            if (e->children) it->children = g_list_store_new(PW_TYPE_GRAPH_ITEM);
+            guint n = g_list_model_get_n_items(G_LIST_MODEL(store));
+            g_list_store_insert(store, MIN(i, n), it);
+            g_object_unref(it);
+        } else {
+            set_str(it, &it->label, e->label, PROP_LABEL);
+            set_str(it, &it->detail, e->detail, PROP_DETAIL);
+        }
+        if (it->children && e->children) apply_entries(it->children, e->children);
+    }
+    g_hash_table_destroy(have);
+    g_hash_table_destroy(keys);
+}
+
+static const char *prop_str(JsonObject *o, const char *name)
+{
+    return o ? json_object_get_string_member_with_default(o, name, NULL) : NULL;
+}
+
+static JsonObject *member_obj(JsonObject *o, const char *name)
+{
+    JsonNode *n = o ? json_object_get_member(o, name) : NULL;
+    return n && JSON_NODE_HOLDS_OBJECT(n) ? json_node_get_object(n) : NULL;
+}
+
+/* props values in pw-dump are mostly strings, but ids are numbers */
+static gint64 prop_int(JsonObject *o, const char *name)
+{
+    JsonNode *n = o ? json_object_get_member(o, name) : NULL;
+    if (!n || !JSON_NODE_HOLDS_VALUE(n)) return -1;
+    if (json_node_get_value_type(n) == G_TYPE_STRING) return g_ascii_strtoll(json_node_get_string(n), NULL, 10);
+    return json_node_get_int(n);
+}
+
+static JsonArray *parse_array(JsonParser *parser, const char *json)
+{
+    if (!json || !json_parser_load_from_data(parser, json, -1, NULL)) return NULL;
+    JsonNode *root = json_parser_get_root(parser);
+    return root && JSON_NODE_HOLDS_ARRAY(root) ? json_node_get_array(root) : NULL;
+}
+
+typedef struct {
+    guint node;  /* position in the node entries */
+    guint port;  /* position in that node's children */
+    char *name;
+} PortRef;
+
+static void port_ref_free(gpointer p)
+{
+    PortRef *r = p;
+    g_free(r->name);
+    g_free(r);
+}
+
+/* pw-dump: a flat array of objects; nodes, then their ports, then links
+ * under both ends */
+static GArray *parse_pw_dump(const char *json)
+{
+    JsonParser *parser = json_parser_new();
+    JsonArray *arr = parse_array(parser, json);
+    if (!arr) {
+        g_object_unref(parser);
+        return NULL;
+    }
+
+    GArray *nodes = entries_new();
+    GHashTable *node_pos = g_hash_table_new(g_direct_hash, g_direct_equal);  /* id -> position + 1 */
+    GHashTable *ports = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, port_ref_free);
+    guint n = json_array_get_length(arr);
+
+    for (guint i = 0; i < n; i++) {
+        JsonObject *o = json_array_get_object_element(arr, i);
+        if (g_strcmp0(prop_str(o, "type"), "PipeWire:Interface:Node") != 0) continue;
+        JsonObject *info = member_obj(o, "info");
+        JsonObject *p = member_obj(info, "props");
+        guint id = (guint)json_object_get_int_member_with_default(o, "id", 0);
+        const char *name = prop_str(p, "node.description");
+        if (!name) name = prop_str(p, "node.nick");
+        if (!name) name = prop_str(p, "application.name");
+        if (!name) name = prop_str(p, "node.name");
+        const char *klass = prop_str(p, "media.class");
+        const char *state = prop_str(info, "state");
+        char *label = name ? g_strdup(name) : g_strdup_printf("node %u", id);
+        char *detail = g_strdup_printf("%s · %s · id %u", klass ? klass : "node", state ? state : "?", id);
+        guint pos = entries_add(nodes, id, label, detail, TRUE);
+        g_hash_table_insert(node_pos, GUINT_TO_POINTER(id), GUINT_TO_POINTER(pos + 1));
+    }
+
+    for (guint i = 0; i < n; i++) {
+        JsonObject *o = json_array_get_object_element(arr, i);
+        if (g_strcmp0(prop_str(o, "type"), "PipeWire:Interface:Port") != 0) continue;
+        JsonObject *info = member_obj(o, "info");
+        JsonObject *p = member_obj(info, "props");
+        guint node_id = (guint)prop_int(p, "node.id");
+        guint pos = GPOINTER_TO_UINT(g_hash_table_lookup(node_pos, GUINT_TO_POINTER(node_id)));
+        if (!pos) continue;
+        guint id = (guint)json_object_get_int_member_with_default(o, "id", 0);
+        const char *name = prop_str(p, "port.name");
+        const char *dir = prop_str(info, "direction");
+        PortRef *ref = g_new0(PortRef, 1);
+        ref->node = pos - 1;
+        ref->name = name ? g_strdup(name) : g_strdup_printf("port %u", id);
+        GArray *children = g_array_index(nodes, Entry, ref->node).children;
+        ref->port = entries_add(children, id, g_strdup(ref->name), g_strdup(dir ? dir : ""), TRUE);
+        g_hash_table_insert(ports, GUINT_TO_POINTER(id), ref);
+    }
+
+    for (guint i = 0; i < n; i++) {
+        JsonObject *o = json_array_get_object_element(arr, i);
+        if (g_strcmp0(prop_str(o, "type"), "PipeWire:Interface:Link") != 0) continue;
+        JsonObject *info = member_obj(o, "info");
+        guint id = (guint)json_object_get_int_member_with_default(o, "id", 0);
+        PortRef *out = g_hash_table_lookup(ports, GUINT_TO_POINTER((guint)prop_int(info, "output-port-id")));
+        PortRef *in = g_hash_table_lookup(ports, GUINT_TO_POINTER((guint)prop_int(info, "input-port-id")));
+        if (!out || !in) continue;
+        const char *state = prop_str(info, "state");
+        Entry *on = &g_array_index(nodes, Entry, out->node), *inn = &g_array_index(nodes, Entry, in->node);
+        entries_add(g_array_index(on->children, Entry, out->port).children, id,
+                    g_strdup_printf("→ %s : %s", inn->label, in->name), g_strdup(state ? state : ""), FALSE);
+        entries_add(g_array_index(inn->children, Entry, in->port).children, id,
+                    g_strdup_printf("← %s : %s", on->label, out->name), g_strdup(state ? state : ""), FALSE);
+    }
+
+    g_hash_table_destroy(ports);
+    g_hash_table_destroy(node_pos);
+    g_object_unref(parser);
+    return nodes;
+}
+
+/* Fallback through pipewire-pulse: sinks and sources as nodes, streams as
+ * nodes linked to the device they play to or record from. Keys carry the
+ * kind, since pulse indices are per kind. */
+enum { PA_SINK, PA_SOURCE, PA_SINK_INPUT, PA_SOURCE_OUTPUT, N_PA };
+
+static const char *pa_kind_names[N_PA] = { "Audio/Sink", "Audio/Source", "Stream/Output/Audio", "Stream/Input/Audio" };
+
+static GArray *parse_pactl(char *const json[N_PA])
+{
+    GArray *nodes = entries_new();
+    GHashTable *pos_of[2] = {  /* device index -> position + 1, for sinks and sources */
+        g_hash_table_new(g_direct_hash, g_direct_equal),
+        g_hash_table_new(g_direct_hash, g_direct_equal),
+    };
+    JsonParser *parsers[N_PA] = { NULL };
+    JsonArray *arrs[N_PA] = { NULL };
+
+    for (int k = 0; k < N_PA; k++) {
+        parsers[k] = json_parser_new();
+        arrs[k] = parse_array(parsers[k], json[k]);
+    }
+
+    for (int k = PA_SINK; k <= PA_SOURCE; k++) {
+        for (guint i = 0; arrs[k] && i < json_array_get_length(arrs[k]); i++) {
+            JsonObject *o = json_array_get_object_element(arrs[k], i);
+            guint idx = (guint)json_object_get_int_member_with_default(o, "index", 0);
+            const char *desc = prop_str(o, "description");
+            const char *state = prop_str(o, "state");
+            guint pos = entries_add(nodes, ((guint64)k << 32) | idx, g_strdup(desc ? desc : prop_str(o, "name")),
+                                    g_strdup_printf("%s · %s · #%u", pa_kind_names[k], state ? state : "?", idx), TRUE);
+            g_hash_table_insert(pos_of[k], GUINT_TO_POINTER(idx), GUINT_TO_POINTER(pos + 1));
+        }
+    }
+
+    for (int k = PA_SINK_INPUT; k <= PA_SOURCE_OUTPUT; k++) {
+        int dev = k == PA_SINK_INPUT ? PA_SINK : PA_SOURCE;
+        for (guint i = 0; arrs[k] && i < json_array_get_length(arrs[k]); i++) {
+            JsonObject *o = json_array_get_object_element(arrs[k], i);
+            JsonObject *p = member_obj(o, "properties");
+            guint idx = (guint)json_object_get_int_member_with_default(o, "index", 0);
+            const char *app = prop_str(p, "application.name");
+            char *label = app ? g_strdup(app) : g_strdup_printf("stream #%u", idx);
+            guint pos = entries_add(nodes, ((guint64)k << 32) | idx, label,
+                                    g_strdup_printf("%s · #%u", pa_kind_names[k], idx), TRUE);
+            guint target = (guint)json_object_get_int_member_with_default(o, dev == PA_SINK ? "sink" : "source", -1);
+            guint dpos = GPOINTER_TO_UINT(g_hash_table_lookup(pos_of[dev], GUINT_TO_POINTER(target)));
+            if (!dpos) continue;
+            Entry *s = &g_array_index(nodes, Entry, pos), *d = &g_array_index(nodes, Entry, dpos - 1);
+            gboolean plays = k == PA_SINK_INPUT;
+            entries_add(s->children, idx, g_strdup_printf("%s %s", plays ? "→" : "←", d->label), g_strdup(""), FALSE);
+            entries_add(d->children, ((guint64)k << 32) | idx, g_strdup_printf("%s %s", plays ? "←" : "→", s->label),
+                        g_strdup(""), FALSE);
+        }
+    }
+
+    for (int k = 0; k < N_PA; k++) g_object_unref(parsers[k]);
+    g_hash_table_destroy(pos_of[0]);
+    g_hash_table_destroy(pos_of[1]);
+    return nodes;
+}
+
+struct _PwGraph {
+    GListStore *nodes;
+    char *version;
+};
+
+PwGraph *pw_graph_new(void)
+{
+    PwGraph *g = g_new0(PwGraph, 1);
+    g->nodes = g_list_store_new(PW_TYPE_GRAPH_ITEM);
+    return g;
+}
+
+void pw_graph_free(PwGraph *g)
+{
+    if (!g) return;
+    g_object_unref(g->nodes);
+    g_free(g->version);
+    g_free(g);
+}
+
+GListModel *pw_graph_get_nodes(PwGraph *g) { return G_LIST_MODEL(g->nodes); }
+const char *pw_graph_get_version(PwGraph *g) { return g->version; }
+
+/* Output slots of one refresh */
+enum { SLOT_VERSION, SLOT_DUMP, SLOT_PACTL, N_SLOTS = SLOT_PACTL + N_PA };
+
+typedef struct {
+    char *out[N_SLOTS];
+    int pending;
+    gboolean have_dump;
+    gboolean have_pactl;
+    gboolean tried_pactl;
+} Collect;
+
+static void collect_free(gpointer p)
+{
+    Collect *c = p;
+    for (int i = 0; i < N_SLOTS; i++) g_free(c->out[i]);
+    g_free(c);
+}
+
+static gboolean run(GTask *task, int slot, const char *const *argv);
+
+static void run_pactl(GTask *task)
+{
+    static const char *const pactl_argv[N_PA][6] = {
+        { "pactl", "-f", "json", "list", "sinks", NULL },
+        { "pactl", "-f", "json", "list", "sources", NULL },
+        { "pactl", "-f", "json", "list", "sink-inputs", NULL },
+        { "pactl", "-f", "json", "list", "source-outputs", NULL },
+    };
+    Collect *c = g_task_get_task_data(task);
+    c->tried_pactl = TRUE;
+    for (int k = 0; k < N_PA; k++) {
+        if (run(task, SLOT_PACTL + k, pactl_argv[k])) c->have_pactl = TRUE;
+    }
+}
+
+static void finish_refresh(GTask *task)
+{
+    PwGraph *g = g_object_get_data(G_OBJECT(task), "graph");
+    Collect *c = g_task_get_task_data(task);
+
+    if (g_task_return_error_if_cancelled(task)) return;
+
+    GArray *nodes = parse_pw_dump(c->out[SLOT_DUMP]);
+    if (!nodes && !c->tried_pactl) {
+        /* pw-dump ran but gave nothing usable (e.g. it could not reach the
+         * daemon): ask pipewire-pulse instead, then come back here */
+        c->pending++;
+        run_pactl(task);
+        if (--c->pending == 0) finish_refresh(task);
+        return;
+    }
+    gboolean pactl_out = FALSE;
+    for (int k = 0; k < N_PA; k++) pactl_out |= c->out[SLOT_PACTL + k] != NULL;
+    if (!nodes && pactl_out) nodes = parse_pactl(&c->out[SLOT_PACTL]);
+    if (!nodes) {
+        g_task_return_new_error(task, G_IO_ERROR, G_IO_ERROR_NOT_FOUND,
+                                c->have_dump || c->have_pactl ? "Could not read the PipeWire graph"
+                                                              : "Neither pw-dump nor pactl is available");
+        return;
+    }
+    apply_entries(g->nodes, nodes);
+    g_array_unref(nodes);
+
+    /* "pipewire\nCompiled with libpipewire X\nLinked with libpipewire Y" */
+    g_free(g->version);
+    g->version = NULL;
+    if (c->out[SLOT_VERSION]) {
+        char **lines = g_strsplit(g_strstrip(c->out[SLOT_VERSION]), "\n", -1);
+        g->version = g_strjoinv(" · ", lines);
+        g_strfreev(lines);
+    }
+    g_task_return_boolean(task, TRUE);
+}
+
+static void on_output(GObject *source, GAsyncResult *res, gpointer user_data)
+{
+    GTask *task = user_data;
+    Collect *c = g_task_get_task_data(task);
+    int slot = GPOINTER_TO_INT(g_object_get_data(source, "slot"));
+    char *out = NULL;
+    if (g_subprocess_communicate_utf8_finish(G_SUBPROCESS(source), res, &out, NULL, NULL) &&
+        g_subprocess_get_if_exited(G_SUBPROCESS(source)) && g_subprocess_get_exit_status(G_SUBPROCESS(source)) == 0) {
+        c->out[slot] = out;
+    } else {
+        g_free(out);
+    }
+    if (--c->pending == 0) finish_refresh(task);
+    g_object_unref(task);
+}
+
+static gboolean run(GTask *task, int slot, const char *const *argv)
+{
+    Collect *c = g_task_get_task_data(task);
+    GSubprocess *p = g_subprocess_newv(argv, G_SUBPROCESS_FLAGS_STDOUT_PIPE | G_SUBPROCESS_FLAGS_STDERR_SILENCE, NULL);
+    if (!p) return FALSE;
+    g_object_set_data(G_OBJECT(p), "slot", GINT_TO_POINTER(slot));
+    c->pending++;
+    g_subprocess_communicate_utf8_async(p, NULL, g_task_get_cancellable(task), on_output, g_object_ref(task));
+    g_object_unref(p);
+    return TRUE;
+}
+
+void pw_graph_refresh_async(PwGraph *g, GCancellable *cancellable, GAsyncReadyCallback cb, gpointer user_data)
+{
+    /* the graph is plain data, not a GObject source; it rides along as
+     * task data */
+    GTask *task = g_task_new(NULL, cancellable, cb, user_data);
+    g_task_set_source_tag(task, pw_graph_refresh_async);
+    Collect *c = g_new0(Collect, 1);
+    g_task_set_task_data(task, c, collect_free);
+    g_object_set_data(G_OBJECT(task), "graph", g);
+
+    /* all launched before any is waited on: the refresh costs about the
+     * slowest of them */
+    static const char *const version_argv[] = { "pipewire", "--version", NULL };
+    static const char *const dump_argv[] = { "pw-dump", NULL };
+    c->pending++;  /* held until everything is launched */
+    run(task, SLOT_VERSION, version_argv);
+    c->have_dump = run(task, SLOT_DUMP, dump_argv);
+    if (!c->have_dump) run_pactl(task);
+    if (--c->pending == 0) finish_refresh(task);
+    g_object_unref(task);
+}
+
+gboolean pw_graph_refresh_finish(PwGraph *g, GAsyncResult *res, GError **error)
+{
+    return g_task_propagate_boolean(G_TASK(res), error);
+}
@@ -0,0 +1,35 @@
+/* pwgraph.h - PipeWire graph (nodes, ports, links) as a diff-updated tree */
+#ifndef PWGRAPH_H
+#define PWGRAPH_H
+
+#include <gio/gio.h>
+
+#define PW_TYPE_GRAPH_ITEM (pw_graph_item_get_type())
+G_DECLARE_FINAL_TYPE(PwGraphItem, pw_graph_item, PW, GRAPH_ITEM, GObject)
+
+/* A node, a port or a link. "label" and "detail" are notified only when a
+ * refresh changes them. */
+const char *pw_graph_item_get_label(PwGraphItem *it);
+const char *pw_graph_item_get_detail(PwGraphItem *it);
+/* GListModel of PwGraphItem; NULL for links. Kept across refreshes, so a
+ * GtkTreeListModel over it keeps its expanded rows. */
+GListModel *pw_graph_item_get_children(PwGraphItem *it);
+
+typedef struct _PwGraph PwGraph;
+
+PwGraph *pw_graph_new(void);
+void pw_graph_free(PwGraph *g);
+
+/* Root items (nodes), in id order */
+GListModel *pw_graph_get_nodes(PwGraph *g);
+/* `pipewire --version` summary from the last refresh, or NULL */
+const char *pw_graph_get_version(PwGraph *g);
+
+/* Re-read the graph. `pw-dump` and `pipewire --version` run concurrently;
+ * when pw-dump is missing or gives no usable output, the four
+ * `pactl -f json list` queries run concurrently instead (nodes and stream
+ * links, no ports). The result is applied to the existing items in place. */
+void pw_graph_refresh_async(PwGraph *g, GCancellable *cancellable, GAsyncReadyCallback cb, gpointer user_data);
+gboolean pw_graph_refresh_finish(PwGraph *g, GAsyncResult *res, GError **error);
+
+#endif /* PWGRAPH_H */
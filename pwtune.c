@@ -0,0 +1,340 @@
+/* pwtune.c - PipeWire clock settings, per-node timing and latency tuning */
+#include "pwtune.h"
+#include "common.h"
+#include <string.h>
+#include <glib/gstdio.h>
+#include <errno.h>
+
+void pw_top_node_free(PwTopNode *n)
+{
+    if (!n) return;
+    g_free(n->name);
+    g_free(n);
+}
+
+/* ---- parsing ---- */
+
+/* `pw-metadata -n settings`:
+ *   update: id:0 key:'clock.rate' value:'48000' type:''  */
+static gboolean parse_settings(const char *out, PwClockSettings *s)
+{
+    static const struct { const char *key; gsize offset; } keys[] = {
+        { "clock.rate",          G_STRUCT_OFFSET(PwClockSettings, rate) },
+        { "clock.quantum",       G_STRUCT_OFFSET(PwClockSettings, quantum) },
+        { "clock.min-quantum",   G_STRUCT_OFFSET(PwClockSettings, min_quantum) },
+        { "clock.max-quantum",   G_STRUCT_OFFSET(PwClockSettings, max_quantum) },
+        { "clock.force-quantum", G_STRUCT_OFFSET(PwClockSettings, force_quantum) },
+        { "clock.force-rate",    G_STRUCT_OFFSET(PwClockSettings, force_rate) },
+    };
+    memset(s, 0, sizeof(*s));
+    gboolean any = FALSE;
+
+    GRegex *re = g_regex_new("key:'([^']*)' value:'([^']*)'", 0, 0, NULL);
+    GMatchInfo *mi = NULL;
+    g_regex_match(re, out, 0, &mi);
+    for (; g_match_info_matches(mi); g_match_info_next(mi, NULL)) {
+        char *key = g_match_info_fetch(mi, 1);
+        char *value = g_match_info_fetch(mi, 2);
+        for (gsize i = 0; i < G_N_ELEMENTS(keys); i++) {
+            if (strcmp(key, keys[i].key) == 0) {
+                G_STRUCT_MEMBER(guint, s, keys[i].offset) = (guint)g_ascii_strtoull(value, NULL, 10);
+                any = TRUE;
+            }
+        }
+        g_free(key);
+        g_free(value);
+    }
+    g_match_info_free(mi);
+    g_regex_unref(re);
+    return any;
+}
+
+/* `pw-top -b`: every iteration starts with the header
+ *   S   ID  QUANT   RATE    WAIT    BUSY   W/Q   B/Q  ERR FORMAT           NAME
+ * followed by one row per node; the format column is fixed-width and may be
+ * blank or contain spaces, so the name is taken at the header's NAME offset.
+ * Only the last iteration is used: the first has no measurements yet. */
+static GPtrArray *parse_top(const char *out)
+{
+    GPtrArray *nodes = g_ptr_array_new_with_free_func((GDestroyNotify)pw_top_node_free);
+    if (!out) return nodes;
+
+    char **lines = g_strsplit(out, "\n", -1);
+    gsize name_col = 0;
+    for (char **l = lines; *l; l++) {
+        const char *name = strstr(*l, " NAME");
+        if (g_str_has_prefix(*l, "S ") && strstr(*l, " ERR ") && name) {
+            g_ptr_array_set_size(nodes, 0);
+            name_col = (gsize)(name - *l) + 1;
+            continue;
+        }
+        if (name_col == 0 || strlen(*l) <= name_col) continue;
+
+        char **f = g_strsplit_set(*l, " \t", -1);
+        const char *tok[9];
+        int n = 0;
+        for (char **p = f; *p && n < 9; p++) {
+            if (**p) tok[n++] = *p;
+        }
+        if (n == 9) {
+            PwTopNode *node = g_new0(PwTopNode, 1);
+            node->id = (guint)g_ascii_strtoull(tok[1], NULL, 10);
+            node->quantum = (guint)g_ascii_strtoull(tok[2], NULL, 10);
+            node->rate = (guint)g_ascii_strtoull(tok[3], NULL, 10);
+            char *end = NULL;
+            node->busy = g_ascii_strtod(tok[7], &end);
+            if (end == tok[7]) node->busy = -1;
+            node->errors = (guint)g_ascii_strtoull(tok[8], NULL, 10);
+
+            char *name = g_strstrip(g_strdup(*l + name_col));
+            node->follower = g_str_has_prefix(name, "+ ");
+            node->name = g_strdup(node->follower ? name + 2 : name);
+            g_free(name);
+            g_ptr_array_add(nodes, node);
+        }
+        g_strfreev(f);
+    }
+    g_strfreev(lines);
+    return nodes;
+}
+
+/* ---- reading ---- */
+
+enum { SLOT_SETTINGS, SLOT_TOP, N_SLOTS };
+
+typedef struct {
+    char *out[N_SLOTS];
+    int pending;
+} Collect;
+
+typedef struct {
+    PwClockSettings settings;
+    GPtrArray *nodes;
+} Reading;
+
+static void collect_free(gpointer p)
+{
+    Collect *c = p;
+    for (int i = 0; i < N_SLOTS; i++) g_free(c->out[i]);
+    g_free(c);
+}
+
+static void reading_free(gpointer p)
+{
+    Reading *r = p;
+    if (r->nodes) g_ptr_array_unref(r->nodes);
+    g_free(r);
+}
+
+static void finish_read(GTask *task)
+{
+    Collect *c = g_task_get_task_data(task);
+    if (g_task_return_error_if_cancelled(task)) return;
+
+    Reading *r = g_new0(Reading, 1);
+    if (!c->out[SLOT_SETTINGS] || !parse_settings(c->out[SLOT_SETTINGS], &r->settings)) {
+        reading_free(r);
+        g_task_return_new_error(task, G_IO_ERROR, G_IO_ERROR_NOT_FOUND,
+                                c->out[SLOT_SETTINGS] ? "PipeWire reported no clock settings"
+                                                      : "Could not run pw-metadata");
+        return;
+    }
+    r->nodes = parse_top(c->out[SLOT_TOP]);
+    g_task_return_pointer(task, r, reading_free);
+}
+
+static void on_output(GObject *source, GAsyncResult *res, gpointer user_data)
+{
+    GTask *task = user_data;
+    Collect *c = g_task_get_task_data(task);
+    int slot = GPOINTER_TO_INT(g_object_get_data(source, "slot"));
+    char *out = NULL;
+    if (g_subprocess_communicate_utf8_finish(G_SUBPROCESS(source), res, &out, NULL, NULL) &&
+        g_subprocess_get_if_exited(G_SUBPROCESS(source)) && g_subprocess_get_exit_status(G_SUBPROCESS(source)) == 0) {
+        c->out[slot] = out;
+    } else {
+        g_free(out);
+    }
+    if (--c->pending == 0) finish_read(task);
+    g_object_unref(task);
+}
+
+static void run(GTask *task, int slot, const char *const *argv)
+{
+    Collect *c = g_task_get_task_data(task);
+    GSubprocess *p = g_subprocess_newv(argv, G_SUBPROCESS_FLAGS_STDOUT_PIPE | G_SUBPROCESS_FLAGS_STDERR_SILENCE, NULL);
+    if (!p) return;
+    g_object_set_data(G_OBJECT(p), "slot", GINT_TO_POINTER(slot));
+    c->pending++;
+    g_subprocess_communicate_utf8_async(p, NULL, g_task_get_cancellable(task), on_output, g_object_ref(task));
+    g_object_unref(p);
+}
+
+void pw_tune_read_async(GCancellable *cancellable, GAsyncReadyCallback cb, gpointer user_data)
+{
+    GTask *task = g_task_new(NULL, cancellable, cb, user_data);
+    g_task_set_source_tag(task, pw_tune_read_async);
+    Collect *c = g_new0(Collect, 1);
+    g_task_set_task_data(task, c, collect_free);
+
+    /* two iterations: pw-top prints the graph once before it has measured
+     * anything, then again a second later with timings and xrun counts */
+    static const char *const settings_argv[] = { "pw-metadata", "-n", "settings", NULL };
+    static const char *const top_argv[] = { "pw-top", "-b", "-n", "2", NULL };
+    c->pending++;  /* held until both are launched */
+    run(task, SLOT_SETTINGS, settings_argv);
+    run(task, SLOT_TOP, top_argv);
+    if (--c->pending == 0) finish_read(task);
+    g_object_unref(task);
+}
+
+gboolean pw_tune_read_finish(GAsyncResult *res, PwClockSettings *settings, GPtrArray **nodes, GError **error)
+{
+    Reading *r = g_task_propagate_pointer(G_TASK(res), error);
+    if (!r) return FALSE;
+    if (settings) *settings = r->settings;
+    if (nodes) *nodes = g_ptr_array_ref(r->nodes);
+    reading_free(r);
+    return TRUE;
+}
+
+/* ---- tuning ---- */
+
+typedef struct {
+    GSubprocess *procs[2];
+    int pending;
+    guint timeout_id;
+    GError *error;      /* first failure */
+} SetLive;
+
+static void set_live_free(gpointer p)
+{
+    SetLive *sl = p;
+    for (int i = 0; i < 2; i++) g_clear_object(&sl->procs[i]);
+    if (sl->timeout_id) g_source_remove(sl->timeout_id);
+    g_clear_error(&sl->error);
+    g_free(sl);
+}
+
+static void set_live_done(GTask *task)
+{
+    SetLive *sl = g_task_get_task_data(task);
+    if (--sl->pending > 0) return;
+    if (sl->error) g_task_return_error(task, g_steal_pointer(&sl->error));
+    else g_task_return_boolean(task, TRUE);
+}
+
+static void on_setting_written(GObject *source, GAsyncResult *res, gpointer user_data)
+{
+    GTask *task = user_data;
+    SetLive *sl = g_task_get_task_data(task);
+    GError *err = NULL;
+    if (!g_subprocess_wait_check_finish(G_SUBPROCESS(source), res, &err)) {
+        if (!sl->error) sl->error = err;
+        else g_error_free(err);
+    }
+    set_live_done(task);
+    g_object_unref(task);
+}
+
+/* pw-metadata waits for the daemon; one that does not answer must not
+ * leave the request pending forever */
+static gboolean on_set_live_timeout(gpointer user_data)
+{
+    GTask *task = user_data;
+    SetLive *sl = g_task_get_task_data(task);
+    sl->timeout_id = 0;
+    if (!sl->error) {
+        sl->error = g_error_new(G_IO_ERROR, G_IO_ERROR_TIMED_OUT, "pw-metadata did not finish in %d s", PW_TUNE_TIMEOUT_S);
+    }
+    for (int i = 0; i < 2; i++) {
+        if (sl->procs[i]) g_subprocess_force_exit(sl->procs[i]);
+    }
+    return G_SOURCE_REMOVE;
+}
+
+void pw_tune_set_live_async(guint force_quantum, guint force_rate, GCancellable *cancellable,
+                            GAsyncReadyCallback cb, gpointer user_data)
+{
+    GTask *task = g_task_new(NULL, cancellable, cb, user_data);
+    g_task_set_source_tag(task, pw_tune_set_live_async);
+    SetLive *sl = g_new0(SetLive, 1);
+    g_task_set_task_data(task, sl, set_live_free);
+
+    const char *keys[2] = { "clock.force-quantum", "clock.force-rate" };
+    guint values[2] = { force_quantum, force_rate };
+    sl->pending++;  /* held until both are launched */
+    for (int i = 0; i < 2; i++) {
+        char num[16];
+        g_snprintf(num, sizeof(num), "%u", values[i]);
+        const char *argv[] = { "pw-metadata", "-n", "settings", "0", keys[i], num, NULL };
+        GError *err = NULL;
+        sl->procs[i] = g_subprocess_newv(argv, G_SUBPROCESS_FLAGS_STDOUT_SILENCE | G_SUBPROCESS_FLAGS_STDERR_SILENCE, &err);
+        if (!sl->procs[i]) {
+            if (!sl->error) sl->error = err;
+            else g_error_free(err);
+            continue;
+        }
+        sl->pending++;
+        g_subprocess_wait_check_async(sl->procs[i], cancellable, on_setting_written, g_object_ref(task));
+    }
+    if (sl->pending > 1) sl->timeout_id = g_timeout_add_seconds(PW_TUNE_TIMEOUT_S, on_set_live_timeout, task);
+    set_live_done(task);
+    g_object_unref(task);
+}
+
+gboolean pw_tune_set_live_finish(GAsyncResult *res, GError **error)
+{
+    return g_task_propagate_boolean(G_TASK(res), error);
+}
+
+char *pw_tune_dropin_path(void)
+{
+    return g_build_filename(g_get_user_config_dir(), "pipewire", "pipewire.conf.d", "90-aser-settings.conf", NULL);
+}
+
+gboolean pw_tune_persist(guint force_quantum, guint force_rate, GError **error)
+{
+    char *path = pw_tune_dropin_path();
+    gboolean ok = TRUE;
+
+    if (force_quantum == 0 && force_rate == 0) {
+        if (g_unlink(path) != 0 && errno != ENOENT) {
+            g_set_error(error, G_FILE_ERROR, g_file_error_from_errno(errno), "Cannot remove %s: %s", path, g_strerror(errno));
+            ok = FALSE;
+        }
+        g_free(path);
+        return ok;
+    }
+
+    char *dir = g_path_get_dirname(path);
+    if (g_mkdir_with_parents(dir, 0700) != 0) {
+        g_set_error(error, G_FILE_ERROR, g_file_error_from_errno(errno), "Cannot create %s: %s", dir, g_strerror(errno));
+        g_free(dir);
+        g_free(path);
+        return FALSE;
+    }
+    g_free(dir);
+
+    /* clock.force-* only exist as runtime metadata; at startup the same
+     * effect comes from collapsing the quantum range and the allowed rates */
+    GString *conf = g_string_new("# Written by aser-settings (Audio > Latency)\n"
+                                 "context.properties = {\n");
+    if (force_quantum) {
+        g_string_append_printf(conf, "    default.clock.quantum = %u\n"
+                                     "    default.clock.min-quantum = %u\n"
+                                     "    default.clock.max-quantum = %u\n",
+                               force_quantum, force_quantum, force_quantum);
+    }
+    if (force_rate) {
+        g_string_append_printf(conf, "    default.clock.rate = %u\n"
+                                     "    default.clock.allowed-rates = [ %u ]\n",
+                               force_rate, force_rate);
+    }
+    g_string_append(conf, "}\n");
+
+    ok = save_config_file(path, conf->str, (gssize)conf->len, NULL, TRUE, error) != CONFIG_SAVE_FAILED;
+    g_string_free(conf, TRUE);
+    g_free(path);
+    return ok;
+}
@@ -0,0 +1,53 @@
+/* pwtune.h - PipeWire clock settings, per-node timing and latency tuning */
+#ifndef PWTUNE_H
+#define PWTUNE_H
+
+#include <gio/gio.h>
+
+/* The "settings" metadata; 0 where a key is absent or, for the force
+ * values, not in effect */
+typedef struct {
+    guint rate;
+    guint quantum;
+    guint min_quantum;
+    guint max_quantum;
+    guint force_quantum;
+    guint force_rate;
+} PwClockSettings;
+
+/* One row of pw-top: a driver, or a node it drives */
+typedef struct {
+    guint id;
+    gboolean follower;
+    guint quantum;
+    guint rate;
+    double busy;      /* B/Q: share of the cycle spent processing, or -1 */
+    guint errors;     /* xruns */
+    char *name;
+} PwTopNode;
+
+void pw_top_node_free(PwTopNode *n);
+
+/* Read the clock settings (pw-metadata) and one measured pw-top cycle
+ * concurrently. pw-top needs about a second to measure. */
+void pw_tune_read_async(GCancellable *cancellable, GAsyncReadyCallback cb, gpointer user_data);
+/* `nodes` receives a GPtrArray of PwTopNode (empty when pw-top is not
+ * installed); FALSE only when the settings could not be read */
+gboolean pw_tune_read_finish(GAsyncResult *res, PwClockSettings *settings, GPtrArray **nodes, GError **error);
+
+/* Seconds pw_tune_set_live_async() waits on pw-metadata before giving up */
+#define PW_TUNE_TIMEOUT_S 5
+
+/* Force quantum and rate on the running graph; 0 releases a force. Both
+ * pw-metadata writes run concurrently. */
+void pw_tune_set_live_async(guint force_quantum, guint force_rate, GCancellable *cancellable,
+                            GAsyncReadyCallback cb, gpointer user_data);
+gboolean pw_tune_set_live_finish(GAsyncResult *res, GError **error);
+
+/* The drop-in that keeps them across restarts:
+ * $XDG_CONFIG_HOME/pipewire/pipewire.conf.d/90-aser-settings.conf */
+char *pw_tune_dropin_path(void);
+/* Write the drop-in, or remove it when both are 0 */
+gboolean pw_tune_persist(guint force_quantum, guint force_rate, GError **error);
+
+#endif /* PWTUNE_H */
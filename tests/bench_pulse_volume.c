@@ -0,0 +1,276 @@
+/* bench_pulse_volume.c - volume slider path: processes spawned and slider to
+ * sink latency during a simulated drag
+ *
+ * A null sink is loaded for the run so no real device is touched. A second
+ * connection, standing in for any other client, watches its change events;
+ * each event is matched to the drag step that set that volume. Exits 77
+ * when there is no server to talk to. */
+#define _GNU_SOURCE
+#include "pulse.h"
+#include <pulse/pulseaudio.h>
+#include <pulse/glib-mainloop.h>
+#include <dlfcn.h>
+#include <spawn.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#define BENCH_SINK "aser_bench_null"
+/* A slider emits a value about every frame while dragged; go faster than
+ * that so coalescing has something to do */
+#define DRAG_STEP_MS 8
+/* 99% down to 10%, one percent a step, so every step asks for a value no
+ * other step does */
+#define DRAG_STEPS 90
+#define BENCH_TIMEOUT_S 10
+#define EXIT_SKIP 77
+
+/* ---- spawn counting: these override libc for the whole process, GLib's
+ * g_spawn and GSubprocess included ---- */
+
+static gint spawns;
+
+pid_t fork(void)
+{
+    static pid_t (*real)(void);
+    if (!real) real = (pid_t (*)(void))dlsym(RTLD_NEXT, "fork");
+    g_atomic_int_inc(&spawns);
+    return real();
+}
+
+int posix_spawn(pid_t *pid, const char *path, const posix_spawn_file_actions_t *actions,
+                const posix_spawnattr_t *attr, char *const argv[], char *const envp[])
+{
+    static int (*real)(pid_t *, const char *, const posix_spawn_file_actions_t *,
+                       const posix_spawnattr_t *, char *const[], char *const[]);
+    if (!real) real = (int (*)(pid_t *, const char *, const posix_spawn_file_actions_t *,
+                               const posix_spawnattr_t *, char *const[], char *const[]))dlsym(RTLD_NEXT, "posix_spawn");
+    g_atomic_int_inc(&spawns);
+    return real(pid, path, actions, attr, argv, envp);
+}
+
+int posix_spawnp(pid_t *pid, const char *file, const posix_spawn_file_actions_t *actions,
+                 const posix_spawnattr_t *attr, char *const argv[], char *const envp[])
+{
+    static int (*real)(pid_t *, const char *, const posix_spawn_file_actions_t *,
+                       const posix_spawnattr_t *, char *const[], char *const[]);
+    if (!real) real = (int (*)(pid_t *, const char *, const posix_spawn_file_actions_t *,
+                               const posix_spawnattr_t *, char *const[], char *const[]))dlsym(RTLD_NEXT, "posix_spawnp");
+    g_atomic_int_inc(&spawns);
+    return real(pid, file, actions, attr, argv, envp);
+}
+
+/* ---- the bench ---- */
+
+typedef struct {
+    GMainLoop *loop;
+    pa_glib_mainloop *ml;
+    pa_context *ctx;          /* the observer */
+    guint32 module;
+    guint32 sink_index;       /* as the observer sees it */
+    PulseServer *server;
+    PulseDevice *sink;
+    int exit_code;
+
+    int step;
+    guint values[DRAG_STEPS];
+    gint64 set_at[DRAG_STEPS];
+    gint64 latency[DRAG_STEPS];   /* -1 until the sink reports that step */
+    guint events;
+    guint spawns_before;
+} Bench;
+
+static guint drag_value(int step)
+{
+    return 99 - (guint)step;
+}
+
+/* Same rounding as pulse.c */
+static guint volume_percent(const pa_cvolume *cv)
+{
+    return (guint)(((guint64)pa_cvolume_max(cv) * 100 + PA_VOLUME_NORM / 2) / PA_VOLUME_NORM);
+}
+
+static void on_module_unloaded(pa_context *c, int success, void *user_data)
+{
+    Bench *b = user_data;
+    g_main_loop_quit(b->loop);
+}
+
+/* Leave once the bench sink is gone again */
+static void finish(Bench *b, int code)
+{
+    if (b->exit_code >= 0) return;
+    b->exit_code = code;
+    if (b->module != PA_INVALID_INDEX && pa_context_get_state(b->ctx) == PA_CONTEXT_READY) {
+        pa_operation *op = pa_context_unload_module(b->ctx, b->module, on_module_unloaded, b);
+        b->module = PA_INVALID_INDEX;
+        if (op) {
+            pa_operation_unref(op);
+            return;
+        }
+    }
+    g_main_loop_quit(b->loop);
+}
+
+static int compare_gint64(const void *a, const void *b)
+{
+    gint64 x = *(const gint64 *)a, y = *(const gint64 *)b;
+    return x < y ? -1 : x > y;
+}
+
+static void report(Bench *b)
+{
+    gint64 lat[DRAG_STEPS];
+    int n = 0;
+    for (int i = 0; i < DRAG_STEPS; i++) {
+        if (b->latency[i] >= 0) lat[n++] = b->latency[i];
+    }
+    qsort(lat, (size_t)n, sizeof(lat[0]), compare_gint64);
+    guint spawned = (guint)g_atomic_int_get(&spawns) - b->spawns_before;
+
+    printf("drag: %d slider steps every %d ms, %u sink change events, %d steps reached the sink\n",
+           DRAG_STEPS, DRAG_STEP_MS, b->events, n);
+    if (n > 0) {
+        printf("slider to sink: median %.1f ms, p90 %.1f ms, max %.1f ms\n",
+               lat[n / 2] / 1000.0, lat[n * 9 / 10] / 1000.0, lat[n - 1] / 1000.0);
+    }
+    printf("last step to sink: %.1f ms\n", b->latency[DRAG_STEPS - 1] / 1000.0);
+    printf("processes spawned: %u\n", spawned);
+
+    if (spawned != 0) {
+        fprintf(stderr, "FAIL: the volume path spawned %u processes\n", spawned);
+        finish(b, EXIT_FAILURE);
+        return;
+    }
+    finish(b, EXIT_SUCCESS);
+}
+
+static void on_sink_info(pa_context *c, const pa_sink_info *i, int eol, void *user_data)
+{
+    Bench *b = user_data;
+    if (eol || !i || b->step == 0) return;
+    gint64 now = g_get_monotonic_time();
+    guint vol = volume_percent(&i->volume);
+    b->events++;
+
+    for (int s = 0; s < b->step; s++) {
+        if (b->values[s] == vol && b->latency[s] < 0) b->latency[s] = now - b->set_at[s];
+    }
+    if (b->step == DRAG_STEPS && b->latency[DRAG_STEPS - 1] >= 0) report(b);
+}
+
+static void on_event(pa_context *c, pa_subscription_event_type_t t, uint32_t index, void *user_data)
+{
+    Bench *b = user_data;
+    if ((t & PA_SUBSCRIPTION_EVENT_FACILITY_MASK) != PA_SUBSCRIPTION_EVENT_SINK || index != b->sink_index) return;
+    if ((t & PA_SUBSCRIPTION_EVENT_TYPE_MASK) != PA_SUBSCRIPTION_EVENT_CHANGE) return;
+    pa_operation *op = pa_context_get_sink_info_by_index(c, index, on_sink_info, b);
+    if (op) pa_operation_unref(op);
+}
+
+static gboolean drag_step(gpointer user_data)
+{
+    Bench *b = user_data;
+    int s = b->step;
+    b->values[s] = drag_value(s);
+    b->set_at[s] = g_get_monotonic_time();
+    b->step++;
+    pulse_device_set_volume(b->sink, b->values[s]);
+    return b->step < DRAG_STEPS ? G_SOURCE_CONTINUE : G_SOURCE_REMOVE;
+}
+
+/* Wait for the app-side connection to list the bench sink */
+static gboolean wait_for_sink(gpointer user_data)
+{
+    Bench *b = user_data;
+    if (b->sink_index == PA_INVALID_INDEX || !pulse_server_is_connected(b->server)) return G_SOURCE_CONTINUE;
+    b->sink = pulse_server_find_sink(b->server, BENCH_SINK);
+    if (!b->sink) return G_SOURCE_CONTINUE;
+    g_object_ref(b->sink);
+
+    for (int i = 0; i < DRAG_STEPS; i++) b->latency[i] = -1;
+    b->spawns_before = (guint)g_atomic_int_get(&spawns);
+    g_timeout_add(DRAG_STEP_MS, drag_step, b);
+    return G_SOURCE_REMOVE;
+}
+
+static void on_sink_lookup(pa_context *c, const pa_sink_info *i, int eol, void *user_data)
+{
+    Bench *b = user_data;
+    if (eol || !i) return;
+    b->sink_index = i->index;
+}
+
+static void on_module_loaded(pa_context *c, uint32_t idx, void *user_data)
+{
+    Bench *b = user_data;
+    if (idx == PA_INVALID_INDEX) {
+        fprintf(stderr, "SKIP: cannot load module-null-sink: %s\n", pa_strerror(pa_context_errno(c)));
+        finish(b, EXIT_SKIP);
+        return;
+    }
+    b->module = idx;
+    pa_operation *op = pa_context_get_sink_info_by_name(c, BENCH_SINK, on_sink_lookup, b);
+    if (op) pa_operation_unref(op);
+    b->server = pulse_server_get_default();
+    g_timeout_add(10, wait_for_sink, b);
+}
+
+static void on_state(pa_context *c, void *user_data)
+{
+    Bench *b = user_data;
+    switch (pa_context_get_state(c)) {
+    case PA_CONTEXT_READY: {
+        pa_context_set_subscribe_callback(c, on_event, b);
+        pa_operation *op = pa_context_subscribe(c, PA_SUBSCRIPTION_MASK_SINK, NULL, NULL);
+        if (op) pa_operation_unref(op);
+        op = pa_context_load_module(c, "module-null-sink",
+                                    "sink_name=" BENCH_SINK " sink_properties=device.description=aser-bench",
+                                    on_module_loaded, b);
+        if (op) pa_operation_unref(op);
+        break;
+    }
+    case PA_CONTEXT_FAILED:
+        fprintf(stderr, "SKIP: no PulseAudio server: %s\n", pa_strerror(pa_context_errno(c)));
+        finish(b, EXIT_SKIP);
+        break;
+    default:
+        break;
+    }
+}
+
+static gboolean on_timeout(gpointer user_data)
+{
+    Bench *b = user_data;
+    if (b->step == 0) {
+        fprintf(stderr, "SKIP: the bench sink never showed up\n");
+        finish(b, EXIT_SKIP);
+    } else {
+        fprintf(stderr, "FAIL: the last step (%u%%) never reached the sink\n", b->values[DRAG_STEPS - 1]);
+        finish(b, EXIT_FAILURE);
+    }
+    return G_SOURCE_REMOVE;
+}
+
+int main(void)
+{
+    Bench b = { .module = PA_INVALID_INDEX, .sink_index = PA_INVALID_INDEX, .exit_code = -1 };
+    b.loop = g_main_loop_new(NULL, FALSE);
+    b.ml = pa_glib_mainloop_new(NULL);
+    b.ctx = pa_context_new(pa_glib_mainloop_get_api(b.ml), "aser-settings bench");
+    pa_context_set_state_callback(b.ctx, on_state, &b);
+    if (pa_context_connect(b.ctx, NULL, PA_CONTEXT_NOAUTOSPAWN, NULL) < 0) {
+        fprintf(stderr, "SKIP: no PulseAudio server: %s\n", pa_strerror(pa_context_errno(b.ctx)));
+        return EXIT_SKIP;
+    }
+    g_timeout_add_seconds(BENCH_TIMEOUT_S, on_timeout, &b);
+    g_main_loop_run(b.loop);
+
+    if (b.sink) g_object_unref(b.sink);
+    pa_context_disconnect(b.ctx);
+    pa_context_unref(b.ctx);
+    pa_glib_mainloop_free(b.ml);
+    g_main_loop_unref(b.loop);
+    return b.exit_code;
+}
@@ -0,0 +1,146 @@
+/* test_audiolevel.c - the SSE and AVX2 level kernels against the scalar one,
+ * and what metering costs at the rate the Audio page reads levels */
+#include "audiolevel.c"  /* the kernels are static */
+#include <glib.h>
+
+/* The peak stream, as PULSE_METER_RATE and PULSE_METER_FRAGMENTS in pulse.c */
+#define LEVEL_RATE 12000
+#define LEVEL_BLOCKS_PER_S 30
+#define LEVEL_BLOCK (LEVEL_RATE / LEVEL_BLOCKS_PER_S)
+
+/* Lengths around the 4- and 8-lane widths, and a real block and its odd
+ * neighbour */
+static const size_t lengths[] = { 0, 1, 3, 4, 5, 7, 8, 9, 12, 15, 16, 17, 31, 33, 63, 255,
+                                  LEVEL_BLOCK - 1, LEVEL_BLOCK, LEVEL_BLOCK + 1, 1023 };
+
+/* Deterministic samples in [-1, 1) */
+static void fill(float *s, size_t n, guint32 seed)
+{
+    for (size_t i = 0; i < n; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        s[i] = (float)((double)(seed >> 8) / (1 << 23) - 1.0);
+    }
+}
+
+static void check_kernel(AccumulateFunc kernel)
+{
+    float *buf = g_new(float, 1024);
+
+    for (gsize l = 0; l < G_N_ELEMENTS(lengths); l++) {
+        size_t n = lengths[l];
+        /* the loudest sample first, in the middle, and in the scalar tail */
+        for (int spike = 0; spike < 3; spike++) {
+            fill(buf, n, (guint32)(n * 3 + spike));
+            if (n > 0) buf[spike == 0 ? 0 : spike == 1 ? n / 2 : n - 1] = -1.5f;
+
+            float want_peak = 0, got_peak = 0;
+            double want_sum = 0, got_sum = 0;
+            accumulate_scalar(buf, n, &want_peak, &want_sum);
+            kernel(buf, n, &got_peak, &got_sum);
+
+            if (got_peak != want_peak)
+                g_test_fail_printf("n=%zu spike=%d: peak %g, want %g", n, spike, got_peak, want_peak);
+            /* float lanes, so equal to float rounding */
+            if (fabs(got_sum - want_sum) > 1e-5 * want_sum + 1e-9)
+                g_test_fail_printf("n=%zu spike=%d: sum_sq %.9g, want %.9g", n, spike, got_sum, want_sum);
+        }
+    }
+
+    /* both outputs accumulate: a higher running peak stays, sums add */
+    fill(buf, 17, 1);
+    float peak = 2.0f, want_peak = 2.0f;
+    double sum = 10.0, want_sum = 10.0;
+    accumulate_scalar(buf, 17, &want_peak, &want_sum);
+    kernel(buf, 17, &peak, &sum);
+    g_assert_cmpfloat(peak, ==, 2.0f);
+    g_assert_cmpfloat_with_epsilon(sum, want_sum, 1e-5 * want_sum);
+
+    g_free(buf);
+}
+
+static void test_scalar(void)
+{
+    float s[] = { 0.5f, -0.75f, 0.25f };
+    float peak = 0;
+    double sum = 0;
+    accumulate_scalar(s, G_N_ELEMENTS(s), &peak, &sum);
+    g_assert_cmpfloat(peak, ==, 0.75f);
+    g_assert_cmpfloat(sum, ==, 0.25 + 0.5625 + 0.0625);
+}
+
+#ifdef AUDIOLEVEL_X86
+static void test_sse(void)
+{
+    __builtin_cpu_init();
+    if (!__builtin_cpu_supports("sse2")) {
+        g_test_skip("no SSE2");
+        return;
+    }
+    check_kernel(accumulate_sse);
+}
+
+static void test_avx2(void)
+{
+    __builtin_cpu_init();
+    if (!__builtin_cpu_supports("avx2") || !__builtin_cpu_supports("fma")) {
+        g_test_skip("no AVX2/FMA");
+        return;
+    }
+    check_kernel(accumulate_avx2);
+}
+#endif
+
+/* Time one kernel over real-sized blocks; returns its share of a core at
+ * LEVEL_BLOCKS_PER_S */
+static double bench_kernel(const char *name, AccumulateFunc kernel)
+{
+    enum { ROUNDS = 200000 };
+    float *buf = g_new(float, LEVEL_BLOCK);
+    fill(buf, LEVEL_BLOCK, 7);
+
+    float peak = 0;
+    double sum = 0;
+    gint64 start = g_get_monotonic_time();
+    for (int r = 0; r < ROUNDS; r++) {
+        /* keep the calls from being folded together */
+        peak = 0;
+        kernel(buf, LEVEL_BLOCK, &peak, &sum);
+        buf[r % LEVEL_BLOCK] = -buf[r % LEVEL_BLOCK];
+    }
+    gint64 us = g_get_monotonic_time() - start;
+    g_free(buf);
+
+    double ns_per_block = us * 1000.0 / ROUNDS;
+    double share = ns_per_block * LEVEL_BLOCKS_PER_S / 1e9;
+    g_test_message("%s: %.1f ns per %d-sample block, %.5f%% of a core at %d blocks/s (peak %g, sum %g)",
+                   name, ns_per_block, LEVEL_BLOCK, share * 100, LEVEL_BLOCKS_PER_S, peak, sum);
+    return share;
+}
+
+static void test_bench(void)
+{
+    /* generous, so a loaded CI machine does not fail it; the real cost is
+     * several orders of magnitude lower */
+    const double budget = 0.01;
+    g_assert_cmpfloat(bench_kernel("scalar", accumulate_scalar), <, budget);
+#ifdef AUDIOLEVEL_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse2"))
+        g_assert_cmpfloat(bench_kernel("sse", accumulate_sse), <, budget);
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+        g_assert_cmpfloat(bench_kernel("avx2", accumulate_avx2), <, budget);
+#endif
+    g_assert_cmpfloat(bench_kernel("dispatched", pick()), <, budget);
+}
+
+int main(int argc, char **argv)
+{
+    g_test_init(&argc, &argv, NULL);
+    g_test_add_func("/audiolevel/scalar", test_scalar);
+#ifdef AUDIOLEVEL_X86
+    g_test_add_func("/audiolevel/sse", test_sse);
+    g_test_add_func("/audiolevel/avx2", test_avx2);
+#endif
+    g_test_add_func("/audiolevel/bench", test_bench);
+    return g_test_run();
+}
@@ -0,0 +1,125 @@
+/* test_edithistory.c - undo grouping and typing coalescing, driven the way
+ * the Hyprland editor drives it from GtkTextBuffer signals */
+#include "edithistory.h"
+#include <string.h>
+
+/* The "editor": a plain string edited at character offsets (ASCII here) */
+static void apply_to_string(EditKind kind, gint64 pos, const char *text, gsize len, gpointer user_data)
+{
+    GString *doc = user_data;
+    if (kind == EDIT_INSERT) g_string_insert_len(doc, (gssize)pos, text, (gssize)len);
+    else g_string_erase(doc, (gssize)pos, (gssize)len);
+}
+
+/* One keystroke: GtkTextView wraps each in begin/end-user-action */
+static void type(EditHistory *h, GString *doc, const char *text)
+{
+    for (const char *c = text; *c; c++) {
+        edit_history_begin_group(h);
+        gint64 pos = (gint64)doc->len;
+        edit_history_record(h, EDIT_INSERT, pos, c, 1);
+        apply_to_string(EDIT_INSERT, pos, c, 1, doc);
+        edit_history_end_group(h);
+    }
+}
+
+static void backspace(EditHistory *h, GString *doc, guint times)
+{
+    for (guint i = 0; i < times; i++) {
+        edit_history_begin_group(h);
+        gint64 pos = (gint64)doc->len - 1;
+        edit_history_record(h, EDIT_DELETE, pos, doc->str + pos, 1);
+        apply_to_string(EDIT_DELETE, pos, doc->str + pos, 1, doc);
+        edit_history_end_group(h);
+    }
+}
+
+static void test_typing_coalesces(void)
+{
+    GString *doc = g_string_new(NULL);
+    EditHistory *h = edit_history_new(apply_to_string, doc, TRUE);
+
+    type(h, doc, "abc");
+    g_assert_cmpstr(doc->str, ==, "abc");
+    g_assert_true(edit_history_undo(h));
+    g_assert_cmpstr(doc->str, ==, "");
+    g_assert_false(edit_history_can_undo(h));
+
+    g_assert_true(edit_history_redo(h));
+    g_assert_cmpstr(doc->str, ==, "abc");
+    g_assert_false(edit_history_can_redo(h));
+
+    /* backspacing is a run of its own */
+    backspace(h, doc, 2);
+    g_assert_cmpstr(doc->str, ==, "a");
+    g_assert_true(edit_history_undo(h));
+    g_assert_cmpstr(doc->str, ==, "abc");
+    g_assert_true(edit_history_undo(h));
+    g_assert_cmpstr(doc->str, ==, "");
+
+    g_string_free(doc, TRUE);
+}
+
+static void test_newline_splits(void)
+{
+    GString *doc = g_string_new(NULL);
+    EditHistory *h = edit_history_new(apply_to_string, doc, TRUE);
+
+    type(h, doc, "ab\ncd");
+    g_assert_true(edit_history_undo(h));
+    g_assert_cmpstr(doc->str, ==, "ab\n");
+    g_assert_true(edit_history_undo(h));
+    g_assert_cmpstr(doc->str, ==, "ab");
+    g_assert_true(edit_history_undo(h));
+    g_assert_cmpstr(doc->str, ==, "");
+
+    g_string_free(doc, TRUE);
+}
+
+/* Typing over a selection deletes and inserts in one user action; that
+ * action stays its own step rather than merging into the run before it */
+static void test_multi_edit_group(void)
+{
+    GString *doc = g_string_new(NULL);
+    EditHistory *h = edit_history_new(apply_to_string, doc, TRUE);
+
+    type(h, doc, "abc");
+    edit_history_begin_group(h);
+    edit_history_record(h, EDIT_DELETE, 1, "bc", 2);
+    apply_to_string(EDIT_DELETE, 1, "bc", 2, doc);
+    edit_history_record(h, EDIT_INSERT, 1, "X", 1);
+    apply_to_string(EDIT_INSERT, 1, "X", 1, doc);
+    edit_history_end_group(h);
+    g_assert_cmpstr(doc->str, ==, "aX");
+
+    /* the delete extends nothing, so the group is a step of its own */
+    g_assert_true(edit_history_undo(h));
+    g_assert_cmpstr(doc->str, ==, "abc");
+    g_assert_true(edit_history_undo(h));
+    g_assert_cmpstr(doc->str, ==, "");
+
+    g_string_free(doc, TRUE);
+}
+
+/* Without coalescing (the binds list) every group is one step */
+static void test_no_coalesce(void)
+{
+    GString *doc = g_string_new(NULL);
+    EditHistory *h = edit_history_new(apply_to_string, doc, FALSE);
+
+    type(h, doc, "abc");
+    g_assert_true(edit_history_undo(h));
+    g_assert_cmpstr(doc->str, ==, "ab");
+
+    g_string_free(doc, TRUE);
+}
+
+int main(int argc, char **argv)
+{
+    g_test_init(&argc, &argv, NULL);
+    g_test_add_func("/edithistory/typing-coalesces", test_typing_coalesces);
+    g_test_add_func("/edithistory/newline-splits", test_newline_splits);
+    g_test_add_func("/edithistory/multi-edit-group", test_multi_edit_group);
+    g_test_add_func("/edithistory/no-coalesce", test_no_coalesce);
+    return g_test_run();
+}
@@ -0,0 +1,206 @@
+/* test_eq.c - the biquad cascade run over signals, measured against
+ * eq_response_db(), for every band type, and what the cascade costs at
+ * playback rate */
+#include "eq.h"
+#include <math.h>
+#include <string.h>
+
+#define RATE 48000.0
+/* Long enough for the slowest band here (a 30 Hz high pass) to ring out */
+#define IMPULSE_LEN 65536
+/* Below this the curve is the stopband; only check that it is down there */
+#define FLOOR_DB -60.0
+#define TOLERANCE_DB 0.05
+
+/* One section in float, transposed direct form II like the filter-chain
+ * builtins */
+typedef struct {
+    float b0, b1, b2, a1, a2;
+    float z1, z2;
+} Biquad;
+
+static void biquad_init(Biquad *bq, const EqBand *band)
+{
+    double c[5];
+    eq_band_coeffs(band, RATE, c);
+    *bq = (Biquad){ (float)c[0], (float)c[1], (float)c[2], (float)c[3], (float)c[4], 0, 0 };
+}
+
+static void biquad_process(Biquad *bq, float *s, gsize len)
+{
+    for (gsize i = 0; i < len; i++) {
+        float x = s[i], y = bq->b0 * x + bq->z1;
+        bq->z1 = bq->b1 * x - bq->a1 * y + bq->z2;
+        bq->z2 = bq->b2 * x - bq->a2 * y;
+        s[i] = y;
+    }
+}
+
+static void run_cascade(const EqBand *bands, guint n, float *s, gsize len)
+{
+    for (guint b = 0; b < n; b++) {
+        Biquad bq;
+        biquad_init(&bq, &bands[b]);
+        biquad_process(&bq, s, len);
+    }
+}
+
+/* |H(f)| in dB from the impulse response, one DFT bin at a time */
+static double measured_db(const float *h, gsize len, double freq)
+{
+    double w = 2.0 * G_PI * freq / RATE, re = 0, im = 0;
+    for (gsize i = 0; i < len; i++) {
+        re += h[i] * cos(w * (double)i);
+        im -= h[i] * sin(w * (double)i);
+    }
+    return 10.0 * log10(MAX(re * re + im * im, 1e-30));
+}
+
+/* 1/3-octave centres from 20 Hz to 20 kHz, plus each band's own frequency */
+static void check_impulse(const EqBand *bands, guint n)
+{
+    float *h = g_new0(float, IMPULSE_LEN);
+    h[0] = 1.0f;
+    run_cascade(bands, n, h, IMPULSE_LEN);
+
+    GArray *freqs = g_array_new(FALSE, FALSE, sizeof(double));
+    for (int k = 0; k <= 30; k++) {
+        double f = 20.0 * pow(2.0, k / 3.0);
+        g_array_append_val(freqs, f);
+    }
+    for (guint b = 0; b < n; b++) g_array_append_val(freqs, bands[b].freq);
+
+    for (guint k = 0; k < freqs->len; k++) {
+        double f = g_array_index(freqs, double, k);
+        double want = eq_response_db(bands, n, RATE, f), got = measured_db(h, IMPULSE_LEN, f);
+        if (want < FLOOR_DB) {
+            if (got > FLOOR_DB + 5)
+                g_test_fail_printf("%s at %.1f Hz: %.2f dB, want below %.0f dB",
+                                   eq_band_type_label(bands[0].type), f, got, FLOOR_DB);
+        } else if (fabs(got - want) > TOLERANCE_DB) {
+            g_test_fail_printf("%s at %.1f Hz: %.3f dB, want %.3f dB",
+                               eq_band_type_label(bands[0].type), f, got, want);
+        }
+    }
+    g_array_unref(freqs);
+    g_free(h);
+}
+
+static void test_peaking(void)
+{
+    const EqBand boost = { EQ_PEAKING, 1000, 6, 1.0 }, cut = { EQ_PEAKING, 250, -9, 2.5 };
+    check_impulse(&boost, 1);
+    check_impulse(&cut, 1);
+    /* the curve and the filter agree on the band's own gain */
+    g_assert_cmpfloat_with_epsilon(eq_response_db(&boost, 1, RATE, 1000), 6.0, 1e-6);
+}
+
+static void test_low_shelf(void)
+{
+    const EqBand b = { EQ_LOW_SHELF, 200, 6, 0.7 };
+    check_impulse(&b, 1);
+}
+
+static void test_high_shelf(void)
+{
+    const EqBand b = { EQ_HIGH_SHELF, 5000, -6, 0.7 };
+    check_impulse(&b, 1);
+}
+
+static void test_low_pass(void)
+{
+    const EqBand b = { EQ_LOW_PASS, 2000, 0, 0.707 };
+    check_impulse(&b, 1);
+}
+
+static void test_high_pass(void)
+{
+    const EqBand b = { EQ_HIGH_PASS, 30, 0, 0.707 };
+    check_impulse(&b, 1);
+}
+
+/* A typical six-band setup */
+static const EqBand full_cascade[] = {
+    { EQ_HIGH_PASS,  30,    0,  0.707 },
+    { EQ_LOW_SHELF,  80,    4,  0.7 },
+    { EQ_PEAKING,    250,  -3,  1.0 },
+    { EQ_PEAKING,    1000,  2,  1.4 },
+    { EQ_PEAKING,    4000, -5,  2.0 },
+    { EQ_HIGH_SHELF, 10000, 3,  0.7 },
+};
+
+/* A steady sine through a full cascade: output RMS over input RMS, once
+ * the filters have settled */
+static void test_cascade_sine(void)
+{
+    const EqBand *bands = full_cascade;
+    const double freqs[] = { 50, 100, 250, 700, 1000, 3000, 4000, 8000, 12000 };
+    const gsize settle = 24000, len = settle + 48000;
+    float *s = g_new(float, len);
+
+    check_impulse(bands, G_N_ELEMENTS(full_cascade));
+
+    for (gsize k = 0; k < G_N_ELEMENTS(freqs); k++) {
+        double w = 2.0 * G_PI * freqs[k] / RATE, in = 0, out = 0;
+        for (gsize i = 0; i < len; i++) s[i] = (float)(0.5 * sin(w * (double)i));
+        for (gsize i = settle; i < len; i++) in += (double)s[i] * s[i];
+        run_cascade(bands, G_N_ELEMENTS(full_cascade), s, len);
+        for (gsize i = settle; i < len; i++) out += (double)s[i] * s[i];
+
+        double got = 10.0 * log10(out / in);
+        double want = eq_response_db(bands, G_N_ELEMENTS(full_cascade), RATE, freqs[k]);
+        if (fabs(got - want) > 0.1)
+            g_test_fail_printf("sine at %.0f Hz: %.3f dB, want %.3f dB", freqs[k], got, want);
+    }
+    g_free(s);
+}
+
+/* The full cascade over stereo blocks of a usual quantum, state carried from
+ * block to block as in the filter chain; reports its share of a core at
+ * RATE */
+static void test_bench(void)
+{
+    enum { CHANNELS = 2, BLOCK = 1024, ROUNDS = 20000 };
+    const guint n = G_N_ELEMENTS(full_cascade);
+    Biquad bq[CHANNELS][G_N_ELEMENTS(full_cascade)];
+    float *in = g_new(float, BLOCK), *buf = g_new(float, BLOCK);
+    for (int c = 0; c < CHANNELS; c++) {
+        for (guint b = 0; b < n; b++) biquad_init(&bq[c][b], &full_cascade[b]);
+    }
+    for (int i = 0; i < BLOCK; i++) in[i] = (float)(0.5 * sin(2.0 * G_PI * 440.0 * i / RATE));
+
+    float acc = 0;
+    gint64 start = g_get_monotonic_time();
+    for (int r = 0; r < ROUNDS; r++) {
+        /* fresh input each time, so nothing compounds into denormals */
+        for (int c = 0; c < CHANNELS; c++) {
+            memcpy(buf, in, sizeof(float) * BLOCK);
+            for (guint b = 0; b < n; b++) biquad_process(&bq[c][b], buf, BLOCK);
+            acc += buf[r % BLOCK];
+        }
+    }
+    gint64 us = g_get_monotonic_time() - start;
+    g_free(in);
+    g_free(buf);
+
+    double ns_per_block = us * 1000.0 / ROUNDS;
+    double share = ns_per_block * (RATE / BLOCK) / 1e9;
+    g_test_message("%u bands, %d channels: %.0f ns per %d-frame block, %.3f%% of a core at %.0f Hz (%g)",
+                   n, CHANNELS, ns_per_block, BLOCK, share * 100, RATE, acc);
+    /* generous, so a loaded CI machine does not fail it; the real cost is
+     * well under a percent */
+    g_assert_cmpfloat(share, <, 0.05);
+}
+
+int main(int argc, char **argv)
+{
+    g_test_init(&argc, &argv, NULL);
+    g_test_add_func("/eq/peaking", test_peaking);
+    g_test_add_func("/eq/low-shelf", test_low_shelf);
+    g_test_add_func("/eq/high-shelf", test_high_shelf);
+    g_test_add_func("/eq/low-pass", test_low_pass);
+    g_test_add_func("/eq/high-pass", test_high_pass);
+    g_test_add_func("/eq/cascade-sine", test_cascade_sine);
+    g_test_add_func("/eq/bench", test_bench);
+    return g_test_run();
+}
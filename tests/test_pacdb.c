@@ -0,0 +1,252 @@
+/* test_pacdb.c - pac_vercmp against pacman's vercmp cases, and the pending
+ * update list over a fixture DBPath (tests/data/pacdb) */
+#include "pacdb.h"
+#include <glib/gstdio.h>
+#include <string.h>
+
+/* pacman test/util/vercmptest.sh; each pair is also checked reversed */
+static const struct {
+    const char *a, *b;
+    int ret;
+} vercmp_cases[] = {
+    /* all similar length, no pkgrel */
+    { "1.5.0", "1.5.0", 0 },
+    { "1.5.1", "1.5.0", 1 },
+    /* mixed length */
+    { "1.5.1", "1.5", 1 },
+    /* with pkgrel, simple */
+    { "1.5.0-1", "1.5.0-1", 0 },
+    { "1.5.0-1", "1.5.0-2", -1 },
+    { "1.5.0-1", "1.5.1-1", -1 },
+    { "1.5.0-2", "1.5.1-1", -1 },
+    /* with pkgrel, mixed lengths */
+    { "1.5-1", "1.5.1-1", -1 },
+    { "1.5-2", "1.5.1-1", -1 },
+    { "1.5-2", "1.5.1-2", -1 },
+    /* mixed pkgrel inclusion */
+    { "1.5", "1.5-1", 0 },
+    { "1.5-1", "1.5", 0 },
+    { "1.1-1", "1.1", 0 },
+    { "1.0-1", "1.1", -1 },
+    { "1.1-1", "1.0", 1 },
+    /* alphanumeric versions */
+    { "1.5b-1", "1.5-1", -1 },
+    { "1.5b", "1.5", -1 },
+    { "1.5b-1", "1.5", -1 },
+    { "1.5b", "1.5.1", -1 },
+    /* from the manpage */
+    { "1.0a", "1.0alpha", -1 },
+    { "1.0alpha", "1.0b", -1 },
+    { "1.0b", "1.0beta", -1 },
+    { "1.0beta", "1.0rc", -1 },
+    { "1.0rc", "1.0", -1 },
+    /* alpha-dotted versions */
+    { "1.5.a", "1.5", 1 },
+    { "1.5.b", "1.5.a", 1 },
+    { "1.5.1", "1.5.b", 1 },
+    /* alpha dots and dashes */
+    { "1.5.b-1", "1.5.b", 0 },
+    { "1.5-1", "1.5.b", -1 },
+    /* same/similar content, differing separators */
+    { "2.0", "2_0", 0 },
+    { "2.0_a", "2_0.a", 0 },
+    { "2.0a", "2.0.a", -1 },
+    { "2___a", "2_a", 1 },
+    /* epoch included version comparisons */
+    { "0:1.0", "0:1.0", 0 },
+    { "0:1.0", "0:1.1", -1 },
+    { "1:1.0", "0:1.0", 1 },
+    { "1:1.0", "0:1.1", 1 },
+    { "1:1.0", "2:1.1", -1 },
+    /* epoch + sometimes present pkgrel */
+    { "1:1.0", "0:1.0-1", 1 },
+    { "1:1.0-1", "0:1.1-1", 1 },
+    /* epoch included on one version */
+    { "0:1.0", "1.0", 0 },
+    { "0:1.0", "1.1", -1 },
+    { "0:1.1", "1.0", 1 },
+    { "1:1.0", "1.0", 1 },
+    { "1:1.0", "1.1", 1 },
+    { "1:1.1", "1.1", 1 },
+    /* numeric runs compare by value, leading zeros aside */
+    { "1.010", "1.9", 1 },
+    { "1.001", "1.1", 0 },
+    { "20240101", "9999", 1 },
+};
+
+static void test_vercmp(void)
+{
+    for (gsize i = 0; i < G_N_ELEMENTS(vercmp_cases); i++) {
+        const char *a = vercmp_cases[i].a, *b = vercmp_cases[i].b;
+        int want = vercmp_cases[i].ret;
+        int got = pac_vercmp(a, b), back = pac_vercmp(b, a);
+        if (got != want || back != -want)
+            g_test_fail_printf("vercmp %s %s: got %d / %d reversed, want %d", a, b, got, back, want);
+    }
+    g_assert_cmpint(pac_vercmp(NULL, NULL), ==, 0);
+    g_assert_cmpint(pac_vercmp(NULL, "1.0"), <, 0);
+    g_assert_cmpint(pac_vercmp("1.0", NULL), >, 0);
+}
+
+/* A pacman.conf in a fresh directory pointing at the fixture; the caller
+ * frees the path and removes the file */
+static char *write_conf(const char *body)
+{
+    GError *err = NULL;
+    char *dir = g_dir_make_tmp("pacdb-test-XXXXXX", &err);
+    g_assert_no_error(err);
+    char *path = g_build_filename(dir, "pacman.conf", NULL);
+    char *contents = g_strdup_printf("[options]\nDBPath = %s/\n%s", PACDB_TEST_DATA, body);
+    g_file_set_contents(path, contents, -1, &err);
+    g_assert_no_error(err);
+    g_free(contents);
+    g_free(dir);
+    return path;
+}
+
+static void remove_conf(char *path)
+{
+    char *dir = g_path_get_dirname(path);
+    g_unlink(path);
+    g_rmdir(dir);
+    g_free(dir);
+    g_free(path);
+}
+
+/* What the Packages page shows */
+static char *format_updates(GPtrArray *updates)
+{
+    GString *out = g_string_new(NULL);
+    for (guint i = 0; i < updates->len; i++) {
+        PacUpdate *u = g_ptr_array_index(updates, i);
+        g_string_append_printf(out, "%s %s -> %s%s\n", u->name, u->local_version, u->new_version,
+                               u->ignored ? " [ignored]" : "");
+    }
+    return g_string_free(out, FALSE);
+}
+
+/* core.db is gzip with directory entries, extra.db plain ustar with only
+ * desc entries. bash is in both (core wins); pacman is current; vim is
+ * newer locally; foo 1.0a -> 1.0 is an update. */
+static const char expected_updates[] =
+    "bash 5.2.026-1 -> 5.2.032-1\n"
+    "firefox 126.0-1 -> 127.0-1\n"
+    "foo 1.0a-1 -> 1.0-1\n"
+    "linux 6.9.1.arch1-1 -> 6.9.3.arch1-1 [ignored]\n"
+    "zlib 1:1.3.1-1 -> 1:1.3.1-2\n";
+
+/* longnames.db holds names past the 100 bytes of a tar header, each as
+ * one archiver writes it: a GNU 'L' entry, a ustar prefix and a pax
+ * path record */
+#define LONG_TAIL "-package-whose-directory-does-not-fit-in-the-hundred-name-bytes-of-a-tar-header"
+static const char expected_long_names[] =
+    "longname-gnu" LONG_TAIL " 1.0-1 -> 1.1-1\n"
+    "longname-pax" LONG_TAIL " 1.0-1 -> 1.1-1\n"
+    "longname-ustar" LONG_TAIL " 1.0-1 -> 1.1-1\n";
+
+static void test_pending_updates(void)
+{
+    GError *err = NULL;
+    char *conf = write_conf("IgnorePkg = linux* nvidia\n\n[core]\nInclude = /etc/pacman.d/mirrorlist\n\n[extra]\n");
+    GPtrArray *updates = pac_db_pending_updates(conf, &err);
+    g_assert_no_error(err);
+    g_assert_nonnull(updates);
+
+    char *text = format_updates(updates);
+    g_assert_cmpstr(text, ==, expected_updates);
+    g_free(text);
+
+    PacUpdate *bash = g_ptr_array_index(updates, 0);
+    g_assert_cmpstr(bash->repo, ==, "core");
+    PacUpdate *firefox = g_ptr_array_index(updates, 1);
+    g_assert_cmpstr(firefox->repo, ==, "extra");
+
+    g_ptr_array_unref(updates);
+    remove_conf(conf);
+}
+
+/* Repository order decides which version is offered */
+static void test_repo_order(void)
+{
+    GError *err = NULL;
+    char *conf = write_conf("[extra]\n[core]\n");
+    GPtrArray *updates = pac_db_pending_updates(conf, &err);
+    g_assert_no_error(err);
+
+    char *text = format_updates(updates);
+    g_assert_true(g_str_has_prefix(text, "bash 5.2.026-1 -> 9.9-1\n"));
+    g_assert_nonnull(strstr(text, "linux 6.9.1.arch1-1 -> 6.9.3.arch1-1\n"));
+    g_free(text);
+
+    g_ptr_array_unref(updates);
+    remove_conf(conf);
+}
+
+/* Without repository sections every sync database is read, alphabetically */
+static void test_no_repos(void)
+{
+    GError *err = NULL;
+    char *conf = write_conf("IgnorePkg = linux\n");
+    GPtrArray *updates = pac_db_pending_updates(conf, &err);
+    g_assert_no_error(err);
+
+    char *text = format_updates(updates);
+    const char *zlib = strstr(expected_updates, "zlib");
+    char *want = g_strdup_printf("%.*s%s%s", (int)(zlib - expected_updates), expected_updates, expected_long_names, zlib);
+    g_assert_cmpstr(text, ==, want);
+    g_free(want);
+    g_free(text);
+
+    g_ptr_array_unref(updates);
+    remove_conf(conf);
+}
+
+static void test_long_names(void)
+{
+    GError *err = NULL;
+    char *conf = write_conf("[longnames]\n");
+    GPtrArray *updates = pac_db_pending_updates(conf, &err);
+    g_assert_no_error(err);
+
+    char *text = format_updates(updates);
+    g_assert_cmpstr(text, ==, expected_long_names);
+    g_free(text);
+
+    g_ptr_array_unref(updates);
+    remove_conf(conf);
+}
+
+static void test_missing_db(void)
+{
+    GError *err = NULL;
+    char *conf = write_conf("[core]\n[nonexistent]\n");
+    /* one readable database is enough; the other is only warned about */
+    g_test_expect_message(NULL, G_LOG_LEVEL_WARNING, "Skipping sync database*nonexistent.db*");
+    GPtrArray *updates = pac_db_pending_updates(conf, &err);
+    g_test_assert_expected_messages();
+    g_assert_no_error(err);
+    g_assert_nonnull(updates);
+    g_ptr_array_unref(updates);
+    remove_conf(conf);
+
+    conf = write_conf("[nonexistent]\n");
+    g_test_expect_message(NULL, G_LOG_LEVEL_WARNING, "Skipping sync database*");
+    updates = pac_db_pending_updates(conf, &err);
+    g_test_assert_expected_messages();
+    g_assert_null(updates);
+    g_assert_nonnull(err);
+    g_clear_error(&err);
+    remove_conf(conf);
+}
+
+int main(int argc, char **argv)
+{
+    g_test_init(&argc, &argv, NULL);
+    g_test_add_func("/pacdb/vercmp", test_vercmp);
+    g_test_add_func("/pacdb/pending-updates", test_pending_updates);
+    g_test_add_func("/pacdb/repo-order", test_repo_order);
+    g_test_add_func("/pacdb/no-repos", test_no_repos);
+    g_test_add_func("/pacdb/long-names", test_long_names);
+    g_test_add_func("/pacdb/missing-db", test_missing_db);
+    return g_test_run();
+}
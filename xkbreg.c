@@ -0,0 +1,328 @@
+/* xkbreg.c - indexed XKB registry (layouts, variants, options)
+ *
+ * evdev.xml is about 1 MiB of XML. It is parsed once with GMarkup into a
+ * flat GVariant of entries (kind, parent, name, description, search key)
+ * and stored in the user cache directory together with the source's mtime
+ * and size; later loads map that file and only collect pointers into it. */
+#include "xkbreg.h"
+#include <glib/gstdio.h>
+#include <string.h>
+
+#define XKB_INDEX_FORMAT_VERSION 1
+#define XKB_INDEX_VARIANT_TYPE "(uxta(uisss))"
+
+struct XkbRegistry {
+    GVariant *index;
+    XkbRegEntry *entries;
+    guint n;
+};
+
+typedef struct {
+    XkbRegKind kind;
+    int parent;
+    char *name;
+    char *description;
+} ParsedEntry;
+
+typedef struct {
+    GArray *entries;       /* ParsedEntry */
+    GArray *open;          /* indices of the layout/variant/group/option elements being parsed */
+    int layout, group;
+    int capture;           /* 1 = name, 2 = description of the innermost entry */
+    GString *text;
+} XmlState;
+
+static char *xkb_rules_path(void)
+{
+    const char *root = g_getenv("XKB_CONFIG_ROOT");
+    return g_build_filename(root && *root ? root : "/usr/share/X11/xkb", "rules", "evdev.xml", NULL);
+}
+
+static void parsed_entry_clear(gpointer p)
+{
+    ParsedEntry *e = p;
+    g_free(e->name);
+    g_free(e->description);
+}
+
+static void xml_start(GMarkupParseContext *ctx, const char *element, const char **names, const char **values,
+                      gpointer user_data, GError **error)
+{
+    XmlState *st = user_data;
+    ParsedEntry e = { XKB_REG_LAYOUT, -1, NULL, NULL };
+    if (strcmp(element, "layout") == 0) {
+        st->layout = (int)st->entries->len;
+    } else if (strcmp(element, "variant") == 0) {
+        e.kind = XKB_REG_VARIANT;
+        e.parent = st->layout;
+    } else if (strcmp(element, "group") == 0) {
+        e.kind = XKB_REG_OPTION_GROUP;
+        st->group = (int)st->entries->len;
+    } else if (strcmp(element, "option") == 0) {
+        e.kind = XKB_REG_OPTION;
+        e.parent = st->group;
+    } else {
+        /* only name/description of the configItem directly inside an open
+         * layout/variant/group/option count (the stack starts at `element`) */
+        const GSList *stack = g_markup_parse_context_get_element_stack(ctx);
+        if (st->open->len == 0 || !stack->next || !stack->next->next ||
+            strcmp(stack->next->data, "configItem") != 0) return;
+        const char *owner = stack->next->next->data;
+        if (strcmp(owner, "layout") != 0 && strcmp(owner, "variant") != 0 &&
+            strcmp(owner, "group") != 0 && strcmp(owner, "option") != 0) return;
+        if (strcmp(element, "name") == 0) st->capture = 1;
+        else if (strcmp(element, "description") == 0) st->capture = 2;
+        g_string_truncate(st->text, 0);
+        return;
+    }
+    int idx = (int)st->entries->len;
+    g_array_append_val(st->entries, e);
+    g_array_append_val(st->open, idx);
+}
+
+static void xml_end(GMarkupParseContext *ctx, const char *element, gpointer user_data, GError **error)
+{
+    XmlState *st = user_data;
+    if (st->capture && (strcmp(element, "name") == 0 || strcmp(element, "description") == 0)) {
+        ParsedEntry *e = &g_array_index(st->entries, ParsedEntry, g_array_index(st->open, int, st->open->len - 1));
+        char **field = st->capture == 1 ? &e->name : &e->description;
+        if (!*field) *field = g_strstrip(g_strdup(st->text->str));
+        st->capture = 0;
+        return;
+    }
+    if (strcmp(element, "layout") == 0 || strcmp(element, "variant") == 0 ||
+        strcmp(element, "group") == 0 || strcmp(element, "option") == 0) {
+        if (st->open->len > 0) g_array_set_size(st->open, st->open->len - 1);
+    }
+}
+
+static void xml_text(GMarkupParseContext *ctx, const char *text, gsize len, gpointer user_data, GError **error)
+{
+    XmlState *st = user_data;
+    if (st->capture) g_string_append_len(st->text, text, (gssize)len);
+}
+
+static GVariant *index_build(const char *xml_path, gint64 mtime, guint64 size, GError **error)
+{
+    gchar *xml = NULL;
+    gsize len = 0;
+    if (!g_file_get_contents(xml_path, &xml, &len, error)) return NULL;
+
+    static const GMarkupParser parser = { xml_start, xml_end, xml_text, NULL, NULL };
+    XmlState st = { 0 };
+    st.entries = g_array_new(FALSE, TRUE, sizeof(ParsedEntry));
+    g_array_set_clear_func(st.entries, parsed_entry_clear);
+    st.open = g_array_new(FALSE, FALSE, sizeof(int));
+    st.layout = st.group = -1;
+    st.text = g_string_new(NULL);
+    GMarkupParseContext *ctx = g_markup_parse_context_new(&parser, G_MARKUP_IGNORE_QUALIFIED, &st, NULL);
+    gboolean ok = g_markup_parse_context_parse(ctx, xml, (gssize)len, error) &&
+                  g_markup_parse_context_end_parse(ctx, error);
+    g_markup_parse_context_free(ctx);
+    g_free(xml);
+
+    GVariant *v = NULL;
+    if (ok) {
+        GVariantBuilder b;
+        g_variant_builder_init(&b, G_VARIANT_TYPE("a(uisss)"));
+        for (guint i = 0; i < st.entries->len; i++) {
+            ParsedEntry *e = &g_array_index(st.entries, ParsedEntry, i);
+            const char *name = e->name ? e->name : "";
+            const char *desc = e->description ? e->description : name;
+            char *plain = g_strconcat(name, " ", desc, NULL);
+            char *key = g_utf8_casefold(plain, -1);
+            g_variant_builder_add(&b, "(uisss)", (guint32)e->kind, e->parent, name, desc, key);
+            g_free(key);
+            g_free(plain);
+        }
+        v = g_variant_ref_sink(g_variant_new("(uxt@a(uisss))", XKB_INDEX_FORMAT_VERSION, mtime, size,
+                                             g_variant_builder_end(&b)));
+    }
+    g_array_unref(st.entries);
+    g_array_unref(st.open);
+    g_string_free(st.text, TRUE);
+    return v;
+}
+
+static GVariant *index_load_cached(const char *path, gint64 mtime, guint64 size)
+{
+    GMappedFile *mf = g_mapped_file_new(path, FALSE, NULL);
+    if (!mf) return NULL;
+    GBytes *bytes = g_mapped_file_get_bytes(mf);
+    g_mapped_file_unref(mf);
+
+    GVariant *v = g_variant_ref_sink(g_variant_new_from_bytes(G_VARIANT_TYPE(XKB_INDEX_VARIANT_TYPE), bytes, FALSE));
+    g_bytes_unref(bytes);
+
+    guint32 fmt = 0;
+    gint64 vmtime = 0;
+    guint64 vsize = 0;
+    g_variant_get_child(v, 0, "u", &fmt);
+    g_variant_get_child(v, 1, "x", &vmtime);
+    g_variant_get_child(v, 2, "t", &vsize);
+    if (fmt != XKB_INDEX_FORMAT_VERSION || vmtime != mtime || vsize != size) {
+        g_variant_unref(v);
+        return NULL;
+    }
+    return v;
+}
+
+static XkbRegistry *registry_from_variant(GVariant *v)
+{
+    XkbRegistry *reg = g_new0(XkbRegistry, 1);
+    reg->index = g_variant_ref(v);
+    GVariant *arr = g_variant_get_child_value(v, 3);
+    reg->n = (guint)g_variant_n_children(arr);
+    reg->entries = g_new0(XkbRegEntry, reg->n);
+    for (guint i = 0; i < reg->n; i++) {
+        XkbRegEntry *e = &reg->entries[i];
+        guint32 kind = 0;
+        gint32 parent = -1;
+        g_variant_get_child(arr, i, "(ui&s&s&s)", &kind, &parent, &e->name, &e->description, &e->key);
+        e->kind = kind <= XKB_REG_OPTION ? (XkbRegKind)kind : XKB_REG_OPTION_GROUP;
+        /* a damaged cache must not send us outside the array */
+        e->parent = parent >= 0 && (guint)parent < reg->n ? parent : -1;
+    }
+    g_variant_unref(arr);
+    return reg;
+}
+
+static void load_thread(GTask *task, gpointer source, gpointer task_data, GCancellable *cancellable)
+{
+    char *xml = xkb_rules_path();
+    GStatBuf st;
+    if (g_stat(xml, &st) != 0) {
+        g_task_return_new_error(task, G_IO_ERROR, G_IO_ERROR_NOT_FOUND, "XKB registry %s not found", xml);
+        g_free(xml);
+        return;
+    }
+
+    char *dir = g_build_filename(g_get_user_cache_dir(), "aser-settings", NULL);
+    char *path = g_build_filename(dir, "xkb-evdev.gvariant", NULL);
+    GError *err = NULL;
+    GVariant *v = index_load_cached(path, (gint64)st.st_mtime, (guint64)st.st_size);
+    if (!v) {
+        v = index_build(xml, (gint64)st.st_mtime, (guint64)st.st_size, &err);
+        if (v) {
+            g_mkdir_with_parents(dir, 0700);
+            g_file_set_contents(path, g_variant_get_data(v), (gssize)g_variant_get_size(v), NULL);
+        }
+    }
+    if (v) {
+        g_task_return_pointer(task, registry_from_variant(v), (GDestroyNotify)xkb_reg_free);
+        g_variant_unref(v);
+    } else {
+        g_task_return_error(task, err);
+    }
+    g_free(path);
+    g_free(dir);
+    g_free(xml);
+}
+
+void xkb_reg_load_async(GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+{
+    GTask *task = g_task_new(NULL, cancellable, callback, user_data);
+    g_task_run_in_thread(task, load_thread);
+    g_object_unref(task);
+}
+
+XkbRegistry *xkb_reg_load_finish(GAsyncResult *res, GError **error)
+{
+    return g_task_propagate_pointer(G_TASK(res), error);
+}
+
+void xkb_reg_free(XkbRegistry *reg)
+{
+    if (!reg) return;
+    g_variant_unref(reg->index);
+    g_free(reg->entries);
+    g_free(reg);
+}
+
+const XkbRegEntry *xkb_reg_entries(XkbRegistry *reg, guint *n_entries)
+{
+    if (n_entries) *n_entries = reg->n;
+    return reg->entries;
+}
+
+static gboolean at_word_start(const char *key, const char *p)
+{
+    return p == key || !g_unichar_isalnum(g_utf8_get_char(g_utf8_prev_char(p)));
+}
+
+/* Score one casefolded word against a key; -1 when it does not occur */
+static int word_score(const char *key, const char *word)
+{
+    const char *hit = strstr(key, word);
+    if (hit) {
+        int score = 100 + (int)strlen(word) * 4;
+        if (hit == key) score += 60;
+        else if (at_word_start(key, hit)) score += 30;
+        return score;
+    }
+
+    int score = 0;
+    const char *k = key, *last = NULL;
+    for (const char *w = word; *w; w = g_utf8_next_char(w)) {
+        gunichar wc = g_utf8_get_char(w);
+        const char *found = NULL;
+        for (const char *p = k; *p; p = g_utf8_next_char(p)) {
+            if (g_utf8_get_char(p) == wc) {
+                found = p;
+                break;
+            }
+        }
+        if (!found) return -1;
+        score += 2;
+        if (last && found == k) score += 6;
+        if (at_word_start(key, found)) score += 4;
+        last = found;
+        k = g_utf8_next_char(found);
+    }
+    return score;
+}
+
+typedef struct {
+    guint index;
+    int score;
+} Scored;
+
+static int compare_scored(gconstpointer a, gconstpointer b, gpointer user_data)
+{
+    const Scored *sa = a, *sb = b;
+    XkbRegistry *reg = user_data;
+    if (sa->score != sb->score) return sb->score - sa->score;
+    const XkbRegEntry *ea = &reg->entries[sa->index], *eb = &reg->entries[sb->index];
+    if (ea->kind != eb->kind) return (int)ea->kind - (int)eb->kind;
+    return (int)strlen(ea->key) - (int)strlen(eb->key);
+}
+
+GArray *xkb_reg_search(XkbRegistry *reg, const char *query, guint limit)
+{
+    GArray *out = g_array_new(FALSE, FALSE, sizeof(guint));
+    char *folded = g_utf8_casefold(query, -1);
+    char **words = g_strsplit_set(g_strstrip(folded), " \t", -1);
+    g_free(folded);
+
+    GArray *hits = g_array_new(FALSE, FALSE, sizeof(Scored));
+    for (guint i = 0; i < reg->n; i++) {
+        const XkbRegEntry *e = &reg->entries[i];
+        if (e->kind == XKB_REG_OPTION_GROUP) continue;
+        int total = 0;
+        for (guint w = 0; words[w] && total >= 0; w++) {
+            if (!*words[w]) continue;
+            int s = word_score(e->key, words[w]);
+            total = s < 0 ? -1 : total + s;
+        }
+        if (total < 0) continue;
+        if (words[0] && !words[1] && g_ascii_strcasecmp(e->name, words[0]) == 0) total += 200;
+        Scored sc = { i, total };
+        g_array_append_val(hits, sc);
+    }
+    g_strfreev(words);
+
+    g_array_sort_with_data(hits, compare_scored, reg);
+    for (guint i = 0; i < hits->len && i < limit; i++) g_array_append_val(out, g_array_index(hits, Scored, i).index);
+    g_array_unref(hits);
+    return out;
+}
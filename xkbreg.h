@@ -0,0 +1,41 @@
+/* xkbreg.h - indexed XKB registry (layouts, variants, options) */
+#ifndef XKBREG_H
+#define XKBREG_H
+
+#include <gio/gio.h>
+
+typedef enum {
+    XKB_REG_LAYOUT,
+    XKB_REG_VARIANT,        /* parent: its layout */
+    XKB_REG_OPTION_GROUP,
+    XKB_REG_OPTION          /* parent: its group */
+} XkbRegKind;
+
+/* Strings point into the index and live as long as the registry */
+typedef struct {
+    XkbRegKind kind;
+    int parent;             /* entry index, -1 for layouts and groups */
+    const char *name;       /* "de", "nodeadkeys", "caps:escape" */
+    const char *description;
+    const char *key;        /* casefolded "name description" for search */
+} XkbRegEntry;
+
+typedef struct XkbRegistry XkbRegistry;
+
+/* Load the registry of the evdev ruleset. The XML is parsed once and kept
+ * as a GVariant in the user cache directory keyed by the file's mtime and
+ * size; later loads map that file instead of parsing. Runs on a worker. */
+void xkb_reg_load_async(GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data);
+XkbRegistry *xkb_reg_load_finish(GAsyncResult *res, GError **error);
+void xkb_reg_free(XkbRegistry *reg);
+
+const XkbRegEntry *xkb_reg_entries(XkbRegistry *reg, guint *n_entries);
+
+/* Fuzzy search over layouts, variants and options (groups are skipped).
+ * Every whitespace-separated word of `query` must occur in an entry's key,
+ * either as a substring or with its characters in order; substring,
+ * word-start and exact-name matches rank higher. Returns up to `limit`
+ * entry indices (guint), best first. */
+GArray *xkb_reg_search(XkbRegistry *reg, const char *query, guint limit);
+
+#endif /* XKBREG_H */